@@ -0,0 +1,80 @@
+# search speed benchmark of the clause database (option -wcl) on random weighted partial Max-SAT and on cnf/wcnf instances
+# make bench_clause => solves each instance without and with the clause database and reports the number of nodes per second
+# (the clause database explores more nodes, as it only extends unary costs to a clause when all its satisfying values have a positive cost)
+
+IF (CMAKE_SCRIPT_MODE_FILE)
+	# called by the bench_clause target: runs ${TOULBAR2} on ${INSTANCE} with ${OPTIONS} and prints the number of nodes per second
+	separate_arguments(OPTIONS)
+	execute_process(COMMAND ${TOULBAR2} ${INSTANCE} ${OPTIONS} -timer=60 OUTPUT_VARIABLE OUT)
+	get_filename_component(NAME ${INSTANCE} NAME)
+	IF (OUT MATCHES "Optimum: ([-0-9.]+) in [0-9]+ backtracks and ([0-9]+) nodes.* and ([0-9.]+) seconds")
+		SET(NODES ${CMAKE_MATCH_2})
+		SET(TIME ${CMAKE_MATCH_3})
+		SET(RES "optimum ${CMAKE_MATCH_1}")
+	ELSEIF (OUT MATCHES "Time limit expired")
+		STRING(REGEX MATCHALL "[0-9]+ nodes" NODES "${OUT}")
+		LIST(LENGTH NODES LEN)
+		IF (LEN EQUAL 0)
+			SET(NODES 0)
+		ELSE()
+			MATH(EXPR LEN "${LEN} - 1")
+			LIST(GET NODES ${LEN} NODES)
+			STRING(REPLACE " nodes" "" NODES ${NODES})
+		ENDIF()
+		SET(TIME 60)
+		SET(RES "time limit")
+	ELSE()
+		MESSAGE(FATAL_ERROR "${NAME} ${OPTIONS}: no result\n${OUT}")
+	ENDIF()
+	STRING(REGEX MATCH "c ([0-9]+) clauses of arity" DB "${OUT}")
+	IF (DB)
+		SET(RES "${RES}, ${CMAKE_MATCH_1} clauses in the database")
+	ENDIF()
+	# CMake math is integer only, time in milliseconds
+	STRING(FIND "${TIME}" "." DOT)
+	IF (DOT LESS 0)
+		SET(SEC ${TIME})
+		SET(MSEC "000")
+	ELSE()
+		STRING(SUBSTRING "${TIME}" 0 ${DOT} SEC)
+		MATH(EXPR DOT "${DOT} + 1")
+		STRING(SUBSTRING "${TIME}000" ${DOT} 3 MSEC)
+	ENDIF()
+	IF (SEC STREQUAL "")
+		SET(SEC 0)
+	ENDIF()
+	MATH(EXPR MS "${SEC} * 1000 + 1${MSEC} - 1000")
+	IF (MS LESS 1)
+		SET(MS 1)
+	ENDIF()
+	MATH(EXPR NPS "${NODES} * 1000 / ${MS}")
+	MESSAGE("${NAME} [${OPTIONS}]: ${RES}, ${NODES} nodes in ${TIME} seconds, ${NPS} nodes/s")
+	RETURN()
+ENDIF()
+
+add_executable(tb2benchclause EXCLUDE_FROM_ALL ${My_Source}/tb2benchclause.cpp)
+set_property(
+		TARGET tb2benchclause
+		PROPERTY COMPILE_DEFINITIONS NARYCHAR WCSPFORMATONLY ${COST} LINUX ${WIDE_STRING} ${PROBABILITY}
+	    )
+
+SET(bench_clause_commands)
+SET(bench_clause_file
+	${PROJECT_SOURCE_DIR}/${Default_validation_dir}/default/ssa0432-003.cnf
+	${PROJECT_SOURCE_DIR}/web/EXAMPLES/brock200_4.clq.wcnf
+	)
+FOREACH (SEED 1 2 3)
+	LIST(APPEND bench_clause_commands COMMAND tb2benchclause 150 1100 300 8 ${SEED} > ${CMAKE_CURRENT_BINARY_DIR}/bench_clause${SEED}.wcnf)
+	LIST(APPEND bench_clause_file ${CMAKE_CURRENT_BINARY_DIR}/bench_clause${SEED}.wcnf)
+ENDFOREACH(SEED)
+FOREACH (BTEST ${bench_clause_file})
+	FOREACH (BOPT "" "-wcl=4" "-wcl=2")
+		LIST(APPEND bench_clause_commands COMMAND ${CMAKE_COMMAND} -DTOULBAR2=${EXECUTABLE_OUTPUT_PATH}/toulbar2${EXE} -DINSTANCE=${BTEST} "-DOPTIONS=${BOPT}" -P ${My_cmake_script}/bench_clause.cmake)
+	ENDFOREACH(BOPT)
+ENDFOREACH(BTEST)
+
+add_custom_target (bench_clause
+	${bench_clause_commands}
+	WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR}
+	COMMENT " make bench_clause " )
+add_dependencies (bench_clause toulbar2${EXE} tb2benchclause)
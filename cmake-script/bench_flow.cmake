@@ -0,0 +1,53 @@
+# propagation benchmark of the flow-based global cost functions (salldiff and sgcc) on random instances
+# make bench_flow => solves each instance and reports the propagation time per search node
+# (run it before and after a change of the flow graph code, with the same build options)
+
+IF (CMAKE_SCRIPT_MODE_FILE)
+	# called by the bench_flow target: runs ${TOULBAR2} on ${INSTANCE} and prints the time per search node
+	execute_process(COMMAND ${TOULBAR2} ${INSTANCE} -timer=300 OUTPUT_VARIABLE OUT)
+	get_filename_component(NAME ${INSTANCE} NAME)
+	IF (OUT MATCHES "Optimum: ([-0-9.]+) in [0-9]+ backtracks and ([0-9]+) nodes.* and ([0-9.]+) seconds")
+		SET(NODES ${CMAKE_MATCH_2})
+		SET(TIME ${CMAKE_MATCH_3})
+		SET(RES "optimum ${CMAKE_MATCH_1}")
+	ELSE()
+		MESSAGE(FATAL_ERROR "${NAME}: no optimum\n${OUT}")
+	ENDIF()
+	# CMake math is integer only, time in microseconds
+	STRING(FIND "${TIME}" "." DOT)
+	IF (DOT LESS 0)
+		SET(SEC ${TIME})
+		SET(MSEC "000")
+	ELSE()
+		STRING(SUBSTRING "${TIME}" 0 ${DOT} SEC)
+		MATH(EXPR DOT "${DOT} + 1")
+		STRING(SUBSTRING "${TIME}000" ${DOT} 3 MSEC)
+	ENDIF()
+	IF (SEC STREQUAL "")
+		SET(SEC 0)
+	ENDIF()
+	IF (NODES LESS 1)
+		SET(NODES 1)
+	ENDIF()
+	MATH(EXPR USPN "(${SEC} * 1000 + 1${MSEC} - 1000) * 1000 / ${NODES}")
+	MESSAGE("${NAME}: ${RES}, ${NODES} nodes in ${TIME} seconds, ${USPN} microseconds per node")
+	RETURN()
+ENDIF()
+
+add_executable(tb2benchflow EXCLUDE_FROM_ALL ${My_Source}/tb2benchflow.cpp)
+set_property(
+		TARGET tb2benchflow
+		PROPERTY COMPILE_DEFINITIONS NARYCHAR WCSPFORMATONLY ${COST} LINUX ${WIDE_STRING} ${PROBABILITY}
+	    )
+
+SET(bench_flow_commands)
+FOREACH (SEED 1 2 3)
+	LIST(APPEND bench_flow_commands COMMAND tb2benchflow 24 12 ${SEED} > ${CMAKE_CURRENT_BINARY_DIR}/bench_flow${SEED}.cfn)
+	LIST(APPEND bench_flow_commands COMMAND ${CMAKE_COMMAND} -DTOULBAR2=${EXECUTABLE_OUTPUT_PATH}/toulbar2${EXE} -DINSTANCE=${CMAKE_CURRENT_BINARY_DIR}/bench_flow${SEED}.cfn -P ${My_cmake_script}/bench_flow.cmake)
+ENDFOREACH(SEED)
+
+add_custom_target (bench_flow
+	${bench_flow_commands}
+	WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR}
+	COMMENT " make bench_flow " )
+add_dependencies (bench_flow toulbar2${EXE} tb2benchflow)
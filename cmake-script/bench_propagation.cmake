@@ -0,0 +1,27 @@
+# propagation micro-benchmark on CELAR6 sub-instances
+# make bench_propagation => solves each instance with its known upper bound and reports the solving time
+# (run it before and after a change of the propagation code, with the same build options)
+
+file ( GLOB
+                       bench_propagation_file
+                       ${PROJECT_SOURCE_DIR}/${Default_cover_dir}/CELAR6-SUB*.wcsp
+                                    )
+
+SET(bench_propagation_commands)
+FOREACH (BTEST ${bench_propagation_file})
+	STRING(REPLACE ".wcsp" ".ub" BUBF ${BTEST})
+	IF (EXISTS ${BUBF})
+	FILE(READ ${BUBF} BUB)
+	STRING(REPLACE "\n" "" BUB ${BUB})
+	MATH(EXPR BUB "1+${BUB}")
+	LIST(APPEND bench_propagation_commands COMMAND ${EXECUTABLE_OUTPUT_PATH}/toulbar2${EXE} ${BTEST} -ub=${BUB})
+	ELSE()
+	LIST(APPEND bench_propagation_commands COMMAND ${EXECUTABLE_OUTPUT_PATH}/toulbar2${EXE} ${BTEST})
+	ENDIF()
+ENDFOREACH(BTEST)
+
+add_custom_target (bench_propagation
+	${bench_propagation_commands}
+	WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR}
+	COMMENT " make bench_propagation " )
+add_dependencies (bench_propagation toulbar2${EXE})
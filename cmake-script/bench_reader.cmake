@@ -0,0 +1,22 @@
+# parsing throughput benchmark on plain and compressed (gzip, xz) problem files
+# make bench_reader => reads each instance, saves it without solving, and reports its reading time
+# (run it before and after a change of the readers, with the same build options)
+
+file ( GLOB
+                       bench_reader_file
+                       ${PROJECT_SOURCE_DIR}/${Default_validation_dir}/default/*.wcsp
+                       ${PROJECT_SOURCE_DIR}/${Default_validation_dir}/default/*.wcsp.xz
+                       ${PROJECT_SOURCE_DIR}/${Default_validation_dir}/default/*.cfn
+                       ${PROJECT_SOURCE_DIR}/${Default_validation_dir}/default/*.cfn.gz
+                                    )
+
+SET(bench_reader_commands)
+FOREACH (BTEST ${bench_reader_file})
+	LIST(APPEND bench_reader_commands COMMAND ${EXECUTABLE_OUTPUT_PATH}/toulbar2${EXE} ${BTEST} -v=1 -z=${CMAKE_CURRENT_BINARY_DIR}/bench_reader.wcsp | grep -e ^loading -e ^Read)
+ENDFOREACH(BTEST)
+
+add_custom_target (bench_reader
+	${bench_reader_commands}
+	WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR}
+	COMMENT " make bench_reader " )
+add_dependencies (bench_reader toulbar2${EXE})
@@ -0,0 +1,17 @@
+# memory and lookup benchmark of the hash table of tuples (TupleMap) against std::map
+# make bench_tuplemap => inserts random tuples, looks them up (half of the lookups are misses), and reports time and heap memory of both tables
+# (sparse n-ary cost tables of small and large arities)
+
+add_executable(tb2benchtuplemap EXCLUDE_FROM_ALL ${My_Source}/tb2benchtuplemap.cpp)
+set_property(
+		TARGET tb2benchtuplemap
+		PROPERTY COMPILE_DEFINITIONS NARYCHAR WCSPFORMATONLY ${COST} LINUX ${WIDE_STRING} ${PROBABILITY}
+	    )
+
+add_custom_target (bench_tuplemap
+	COMMAND tb2benchtuplemap 100000 4 20
+	COMMAND tb2benchtuplemap 1000000 8 10
+	COMMAND tb2benchtuplemap 1000000 30 2
+	WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR}
+	COMMENT " make bench_tuplemap " )
+add_dependencies (bench_tuplemap tb2benchtuplemap)
@@ -15,6 +15,7 @@ MESSAGE(STATUS "\n##############COVER  liste #############\n")
                        ${Default_cover_dir}/*.bep
                        ${Default_cover_dir}/*.bep
                        ${Default_cover_dir}/*.uai
+                       ${Default_cover_dir}/*.wcnf
                                     )
 
 
@@ -42,8 +43,8 @@ FOREACH (UTEST ${cover_file})
 	GET_FILENAME_COMPONENT(tfile ${UTEST} NAME ) # filname with extension
 	GET_FILENAME_COMPONENT(tfile_WE ${UTEST} NAME_WE ) # filname without extension
 	#reset ub end enum from the previous iteration
-	STRING(REPLACE ".wcsp" ".ub" UBF ${UTEST})
-	STRING(REPLACE ".wcsp" ".enum" ENUM_file ${UTEST})
+	STRING(REGEX REPLACE "\\.(wcsp|wcnf)$" ".ub" UBF ${UTEST})
+	STRING(REGEX REPLACE "\\.(wcsp|wcnf)$" ".enum" ENUM_file ${UTEST})
 	
 
 	IF (EXISTS ${TPATH}/${FOPT})
@@ -88,6 +89,37 @@ FOREACH (UTEST ${cover_file})
 		UNSET (ARGS)
 	ENDFOREACH()
 
+	# tests checking the optimum (sequences of commands run one after the other, the last one must report the optimum)
+	IF (EXISTS ${UBF})
+	FILE(READ ${UBF} OPTIMUM)
+	STRING(REPLACE "\n" "" OPTIMUM ${OPTIMUM})
+	SET (INDEX 0)
+	FOREACH (OPTTEST ${${tfile}.optimum})
+		STRING(REPLACE "INSTANCE" "${UTEST}" OPTTEST ${OPTTEST})
+		STRING(REPLACE "|" ";" COMMANDS ${OPTTEST})
+		LIST(LENGTH COMMANDS NBCOMMANDS)
+		SET (STEP 0)
+		FOREACH (COMMAND ${COMMANDS})
+			STRING(REGEX REPLACE "^ +| +$" "" COMMAND ${COMMAND})
+			STRING_SPLIT(ARGS " " ${COMMAND})
+			MATH(EXPR STEP "1+${STEP}")
+			SET (OTNAME Phase2_${TNAME}_optimum_${INDEX}_${STEP})
+			add_test(${OTNAME} ${EXECUTABLE_OUTPUT_PATH}/toulbar2${EXE} ${ARGS})
+			IF (STEP EQUAL NBCOMMANDS)
+				set_tests_properties (${OTNAME} PROPERTIES PASS_REGULAR_EXPRESSION "Optimum: ${OPTIMUM} in" TIMEOUT "${test_timeout}")
+			ELSE ()
+				set_tests_properties (${OTNAME} PROPERTIES TIMEOUT "${test_timeout}")
+			ENDIF ()
+			IF (STEP GREATER 1)
+				set_tests_properties (${OTNAME} PROPERTIES DEPENDS ${PREVIOUS})
+			ENDIF ()
+			SET (PREVIOUS ${OTNAME})
+			UNSET (ARGS)
+		ENDFOREACH()
+		MATH(EXPR INDEX "1+${INDEX}")
+	ENDFOREACH()
+	ENDIF()
+
 
 	ENDFOREACH(UTEST)
 
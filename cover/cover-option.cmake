@@ -8,7 +8,7 @@
 # on foo.wcsp with option declare on each tuple of the foo.wcsp (set)
 
 SET (instances 
-	CELAR6-SUB0.wcsp CELAR6-SUB1.wcsp pedigree1.wcsp 10_1.bep CELAR7-SUB0.wcsp  )
+	CELAR6-SUB0.wcsp CELAR6-SUB1.wcsp pedigree1.wcsp 10_1.bep CELAR7-SUB0.wcsp wpms40.wcnf  )
 
 #please beware to space 
 # remove multiple space separtor between argument if there are not required 
@@ -26,6 +26,7 @@ SET (CELAR6-SUB0.wcsp
     "-B=1"
     "-B=1 -Z"
     "-B=1 -Z -R=1"
+    "-B=1 -sepmem=1 -v=1"
     "-B=2"
     "-B=3"
     "-O=CELAR6-SUB0.mcs.order -B=1"
@@ -50,9 +51,16 @@ SET (CELAR6-SUB0.wcsp
     "-O=CELAR6-SUB0.mcs.order -B=2 -j=1"
     "-O=CELAR6-SUB0.mcs.order -B=2 -j=1 -Z"
     "-O=CELAR6-SUB0.mcs.order -B=2 -j=1 -k=1 -Z"
+    "-checkpoint=CELAR6-SUB0.ckpt -checkpointtime=0"
+    "-dumpbin=CELAR6-SUB0.wbin"
     "-n -t -i"
     "-n -t -ub=160"
     "-n -ub=160"
+    "-para=2"
+    "-para=4 -hbfs:"
+    "-para=4 -ws"
+    "-vns -para=2"
+    "--rsdgvns -para=3"
     "-w"
     "-x"
     "-x=,1=1,2=1"
@@ -102,7 +110,9 @@ SET (pedigree1.wcsp
     "-n -t -o"
     "-n -t -ub=76911690 -i"
     "-n=4"
+    "-p=-8 -v=1"
     "-q: -e"
+    "-qc:"
     "-t -n"
     "-ub=1000"
     "-ub=1000000"
@@ -137,6 +147,8 @@ SET (CELAR7-SUB0.wcsp
     "-Z -v=2"
     "-Z=2 -v=1"
     "-Z=3 -v=1"
+    "-trws=0.001"
+    "-trws=0.001 -A"
     "-v=1"
     "-w"
     "-x"
@@ -157,3 +169,22 @@ SET (zebre-ext.wcsp
     "-a -B=1 -hbfs:"
     "-a -B=1 -D -hbfs:"
 )
+
+# tests which must report the optimum given in the .ub file of the instance
+# each test is a sequence of commands separated by "|" run one after the other in the build directory (INSTANCE is replaced by the path of the instance)
+SET (CELAR6-SUB0.wcsp.optimum
+    "INSTANCE -dumpbin=CELAR6-SUB0-optimum.wbin|CELAR6-SUB0-optimum.wbin"
+    "INSTANCE -A=-1 -V"
+    "INSTANCE -B=1 -sepmem=0.001"
+    "INSTANCE -para=2 -ws -hbfs=1 -open=3"
+)
+
+SET (CELAR6-SUB1.wcsp.optimum
+    "INSTANCE -checkpoint=CELAR6-SUB1.ckpt -checkpointbt=5000|INSTANCE -resume=CELAR6-SUB1.ckpt"
+)
+
+SET (wpms40.wcnf.optimum
+    "INSTANCE -wcl=4"
+    "INSTANCE -wcl=2 -A -hbfs:"
+    "INSTANCE -wcl=2 -i"
+)
@@ -46,7 +46,7 @@ public:
             if (ToulBar2::verbose >= 3)
                 cout << "reconnect " << this << endl;
             assert(linkX->prev == NULL && linkX->next == NULL);
-            x->getConstrs()->push_back(linkX, true);
+            x->reconnect(linkX);
         }
     }
 
@@ -152,9 +152,9 @@ public:
             if (ToulBar2::verbose >= 3)
                 cout << "reconnect " << this << endl;
             assert(linkX->prev == NULL && linkX->next == NULL);
-            x->getConstrs()->push_back(linkX, true);
+            x->reconnect(linkX);
             assert(linkY->prev == NULL && linkY->next == NULL);
-            y->getConstrs()->push_back(linkY, true);
+            y->reconnect(linkY);
         }
     }
 
@@ -286,15 +286,15 @@ public:
             assert(linkX->prev == NULL && linkX->next == NULL);
             //			if (linkX->content.constr->isTriangle()) x->getTriangles()->push_back(linkX, true);
             //			else
-            x->getConstrs()->push_back(linkX, true);
+            x->reconnect(linkX);
             assert(linkY->prev == NULL && linkY->next == NULL);
             //			if (linkY->content.constr->isTriangle()) y->getTriangles()->push_back(linkY, true);
             //			else
-            y->getConstrs()->push_back(linkY, true);
+            y->reconnect(linkY);
             assert(linkZ->prev == NULL && linkZ->next == NULL);
             //			if (linkZ->content.constr->isTriangle()) z->getTriangles()->push_back(linkZ, true);
             //			else
-            z->getConstrs()->push_back(linkZ, true);
+            z->reconnect(linkZ);
         }
     }
 
@@ -554,7 +554,7 @@ public:
                 cout << "reconnect " << this << endl;
             for (int i = 0; i < arity_; i++) {
                 assert(links[i]->prev == NULL && links[i]->next == NULL);
-                scope[i]->getConstrs()->push_back(links[i], true);
+                scope[i]->reconnect(links[i]);
             }
         }
     }
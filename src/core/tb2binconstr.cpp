@@ -120,6 +120,68 @@ void BinaryConstraint::extend(EnumeratedVariable* x, Value value, Cost cost, vec
     x->extend(value, cost);
 }
 
+void BinaryConstraint::rowOffsets(EnumeratedVariable* y, bool full, vector<Cost>& offsets, vector<Long>& valid)
+{
+    vector<StoreCost>& deltaCosts = (getIndex(y) == 0) ? deltaCostsX : deltaCostsY;
+    offsets.assign(y->getDomainInitSize(), MIN_COST);
+    valid.assign(y->getDomainInitSize(), 0);
+    for (EnumeratedVariable::iterator iterY = y->begin(); iterY != y->end(); ++iterY) {
+        unsigned int yindex = y->toIndex(*iterY);
+        offsets[yindex] = -deltaCosts[yindex];
+        if (full)
+            offsets[yindex] += y->getCost(*iterY);
+        valid[yindex] = -1;
+    }
+}
+
+Value BinaryConstraint::findRowSupport(EnumeratedVariable* x, EnumeratedVariable* y, unsigned int ix, const vector<Cost>& offsets, const vector<Long>& valid, Cost& minCost)
+{
+    // costs are stored row by row for the first variable in the scope and column by column for the second one
+    bool first = (getIndex(x) == 0);
+    int iy = minCostRow(rawCosts(costs) + ((first) ? ix * sizeY : ix), (first) ? 1 : sizeY, offsets.data(), valid.data(), y->getDomainInitSize(), minCost);
+    assert(iy >= 0);
+    minCost -= (first) ? deltaCostsX[ix] : deltaCostsY[ix];
+    assert(minCost >= MIN_COST);
+    return y->toValue(iy);
+}
+
+Cost BinaryConstraint::messageTRWS(EnumeratedVariable* s, const vector<Cost>& theta, vector<Cost>& offsets, vector<Long>& valid)
+{
+    // costs are stored row by row for the first variable in the scope and column by column for the second one
+    bool first = (getIndex(s) == 0);
+    EnumeratedVariable* t = (first) ? y : x;
+    vector<StoreCost>& deltaCostsS = (first) ? deltaCostsX : deltaCostsY;
+    vector<StoreCost>& deltaCostsT = (first) ? deltaCostsY : deltaCostsX;
+    unsigned int sizeS = s->getDomainInitSize();
+    offsets.assign(sizeS, MIN_COST);
+    valid.assign(sizeS, 0);
+    for (EnumeratedVariable::iterator iterS = s->begin(); iterS != s->end(); ++iterS) {
+        unsigned int j = s->toIndex(*iterS);
+        offsets[j] = theta[j] - trwsM[j] - deltaCostsS[j];
+        valid[j] = -1;
+    }
+    bool kernel = COST_KERNEL && sizeS >= MIN_KERNEL_ROW;
+    ptrdiff_t stride = (first) ? sizeY : 1;
+    Cost minMessage = numeric_limits<Cost>::max();
+    for (EnumeratedVariable::iterator iterT = t->begin(); iterT != t->end(); ++iterT) {
+        unsigned int k = t->toIndex(*iterT);
+        const Cost* row = rawCosts(costs) + ((first) ? k : k * sizeY);
+        Cost message = numeric_limits<Cost>::max();
+        if (kernel) {
+            minCostRow(row, stride, offsets.data(), valid.data(), sizeS, message);
+        } else {
+            for (EnumeratedVariable::iterator iterS = s->begin(); iterS != s->end(); ++iterS) {
+                unsigned int j = s->toIndex(*iterS);
+                message = min<Cost>(message, row[j * stride] + offsets[j]);
+            }
+        }
+        message -= deltaCostsT[k];
+        trwsM[k] = message;
+        minMessage = min<Cost>(minMessage, message);
+    }
+    return minMessage;
+}
+
 void BinaryConstraint::permute(EnumeratedVariable* xin, Value a, Value b)
 {
     EnumeratedVariable* yin = y;
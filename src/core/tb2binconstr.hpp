@@ -9,6 +9,7 @@
 #include "tb2abstractconstr.hpp"
 #include "tb2enumvar.hpp"
 #include "tb2wcsp.hpp"
+#include "tb2costkernel.hpp"
 
 struct Functor_getCost {
     BinaryConstraint& obj;
@@ -54,6 +55,11 @@ protected:
     bool project(EnumeratedVariable* x, Value value, Cost cost, vector<StoreCost>& deltaCostsX);
     void extend(EnumeratedVariable* x, Value value, Cost cost, vector<StoreCost>& deltaCostsX);
 
+    // offsets (minus delta costs, plus unary costs if full) and validity masks of the values of y for minCostRow
+    void rowOffsets(EnumeratedVariable* y, bool full, vector<Cost>& offsets, vector<Long>& valid);
+    // returns the first value of y minimizing the cost with value index ix of x (with unary costs of y if given in offsets)
+    Value findRowSupport(EnumeratedVariable* x, EnumeratedVariable* y, unsigned int ix, const vector<Cost>& offsets, const vector<Long>& valid, Cost& minCost);
+
     void findSupportX() { findSupport(Functor_getCost(*this), x, y, supportX, deltaCostsX); }
     void findSupportY() { findSupport(Functor_getCostReverse(*this), y, x, supportY, deltaCostsY); }
     void findFullSupportX() { findFullSupport(Functor_getCost(*this), x, y, supportX, deltaCostsX, supportY, deltaCostsY); }
@@ -101,6 +107,13 @@ public:
         deltaCosts[var->toIndex(value)] += cost;
         var->project(value, cost, true);
     }
+    /// \brief sends the TRW-S message from \a s to the other variable: trwsM[k] = min_j theta[j] - trwsM[j] + cost(j, k) for value indexes j of \a s and k of the other variable in the current domains
+    /// \param theta scaled unary costs of \a s (indexed by value index)
+    /// \param offsets buffer
+    /// \param valid buffer
+    /// \return the minimum of the message (not yet subtracted)
+    /// \note the message is stored for the values of the other variable in its current domain, other entries are left unchanged
+    Cost messageTRWS(EnumeratedVariable* s, const vector<Cost>& theta, vector<Cost>& offsets, vector<Long>& valid);
     Cost normalizeTRWS()
     {
         Cost minCost = numeric_limits<Cost>::max();
@@ -164,9 +177,8 @@ public:
 
     void setCost(Cost c)
     {
-        for (unsigned int a = 0; a < sizeX; a++)
-            for (unsigned int b = 0; b < sizeY; b++)
-                costs[a * sizeY + b] = c;
+        Cost* table = StoreCost::storeArray(costs.data(), sizeX * sizeY);
+        std::fill(table, table + sizeX * sizeY, c);
     }
 
     void setcost(EnumeratedVariable* xin, EnumeratedVariable* yin, Value vx, Value vy, Cost mincost)
@@ -222,15 +234,11 @@ public:
     void clearCosts()
     {
         assert(ToulBar2::verbose < 4 || ((cout << "clear cost (C" << getVar(0)->getName() << "," << getVar(1)->getName() << ")" << endl), true));
-        for (unsigned int i = 0; i < sizeX; i++)
-            deltaCostsX[i] = MIN_COST;
-        for (unsigned int j = 0; j < sizeY; j++)
-            deltaCostsY[j] = MIN_COST;
-        for (unsigned int i = 0; i < sizeX; i++) {
-            for (unsigned int j = 0; j < sizeY; j++) {
-                costs[i * sizeY + j] = MIN_COST;
-            }
-        }
+        Cost* deltas = StoreCost::storeArray(deltaCostsX.data(), sizeX);
+        std::fill(deltas, deltas + sizeX, MIN_COST);
+        deltas = StoreCost::storeArray(deltaCostsY.data(), sizeY);
+        std::fill(deltas, deltas + sizeY, MIN_COST);
+        setCost(MIN_COST);
     }
 
     void setInfiniteCost(Cost ub)
@@ -621,17 +629,28 @@ void BinaryConstraint::findSupport(T getCost, EnumeratedVariable* x, EnumeratedV
     if (ToulBar2::verbose >= 3)
         cout << "findSupport C" << x->getName() << "," << y->getName() << endl;
     bool supportBroken = false;
+    const bool kernel = COST_KERNEL && y->getDomainInitSize() >= MIN_KERNEL_ROW;
+    vector<Cost> offsets; // computed on the first broken support (y is not modified inside the loop)
+    vector<Long> valid;
     for (EnumeratedVariable::iterator iterX = x->begin(); iterX != x->end(); ++iterX) {
         unsigned int xindex = x->toIndex(*iterX);
         Value support = supportX[xindex];
         if (y->cannotbe(support) || getCost(x, y, *iterX, support) > MIN_COST) {
-            Value minCostValue = y->getInf();
-            Cost minCost = getCost(x, y, *iterX, minCostValue);
-            EnumeratedVariable::iterator iterY = y->begin();
-            for (++iterY; minCost > MIN_COST && iterY != y->end(); ++iterY) {
-                Cost cost = getCost(x, y, *iterX, *iterY);
-                if (GLB(&minCost, cost)) {
-                    minCostValue = *iterY;
+            Value minCostValue;
+            Cost minCost;
+            if (kernel) {
+                if (valid.empty())
+                    rowOffsets(y, false, offsets, valid);
+                minCostValue = findRowSupport(x, y, xindex, offsets, valid, minCost);
+            } else {
+                minCostValue = y->getInf();
+                minCost = getCost(x, y, *iterX, minCostValue);
+                EnumeratedVariable::iterator iterY = y->begin();
+                for (++iterY; minCost > MIN_COST && iterY != y->end(); ++iterY) {
+                    Cost cost = getCost(x, y, *iterX, *iterY);
+                    if (GLB(&minCost, cost)) {
+                        minCostValue = *iterY;
+                    }
                 }
             }
             if (minCost > MIN_COST) {
@@ -657,17 +676,28 @@ void BinaryConstraint::findFullSupport(T getCost, EnumeratedVariable* x, Enumera
     if (ToulBar2::verbose >= 3)
         cout << "findFullSupport C" << x->getName() << "," << y->getName() << endl;
     bool supportBroken = false;
+    const bool kernel = COST_KERNEL && y->getDomainInitSize() >= MIN_KERNEL_ROW;
+    vector<Cost> offsets; // computed on the first broken support (extensions to y keep unary plus binary costs unchanged)
+    vector<Long> valid;
     for (EnumeratedVariable::iterator iterX = x->begin(); iterX != x->end(); ++iterX) {
         unsigned int xindex = x->toIndex(*iterX);
         Value support = supportX[xindex];
         if (y->cannotbe(support) || getCost(x, y, *iterX, support) + y->getCost(support) > MIN_COST) {
-            Value minCostValue = y->getInf();
-            Cost minCost = getCost(x, y, *iterX, minCostValue) + y->getCost(minCostValue);
-            EnumeratedVariable::iterator iterY = y->begin();
-            for (++iterY; minCost > MIN_COST && iterY != y->end(); ++iterY) {
-                Cost cost = getCost(x, y, *iterX, *iterY) + y->getCost(*iterY);
-                if (GLB(&minCost, cost)) {
-                    minCostValue = *iterY;
+            Value minCostValue;
+            Cost minCost;
+            if (kernel) {
+                if (valid.empty())
+                    rowOffsets(y, true, offsets, valid);
+                minCostValue = findRowSupport(x, y, xindex, offsets, valid, minCost);
+            } else {
+                minCostValue = y->getInf();
+                minCost = getCost(x, y, *iterX, minCostValue) + y->getCost(minCostValue);
+                EnumeratedVariable::iterator iterY = y->begin();
+                for (++iterY; minCost > MIN_COST && iterY != y->end(); ++iterY) {
+                    Cost cost = getCost(x, y, *iterX, *iterY) + y->getCost(*iterY);
+                    if (GLB(&minCost, cost)) {
+                        minCostValue = *iterY;
+                    }
                 }
             }
             if (minCost > MIN_COST) {
@@ -15,7 +15,6 @@ class WeightedClause : public AbstractNaryConstraint {
     vector<StoreCost> deltaCosts; // extended costs from unary costs to the cost function
     int support; // index of a variable in the scope with a zero unary cost on its value which satisfies the clause
     StoreInt nonassigned; // number of non-assigned variables during search, must be backtrackable!
-    String evalTuple; // temporary data structure
     vector<Long> conflictWeights; // used by weighted degree heuristics
 
     Value getTuple(int i) { return scope[i]->toValue(tuple[i] - CHAR_FIRST); }
@@ -87,15 +86,10 @@ public:
         if (tuple_in.empty() && arity_in > 0)
             tuple = String(arity_in, CHAR_FIRST);
         deltaCosts = vector<StoreCost>(arity_in, StoreCost(MIN_COST));
-        Char* tbuf = new Char[arity_in + 1];
-        tbuf[arity_in] = '\0';
+        conflictWeights = vector<Long>(arity_in, 0);
         for (int i = 0; i < arity_in; i++) {
             assert(scope_in[i]->getDomainInitSize() == 2);
-            tbuf[i] = CHAR_FIRST;
-            conflictWeights.push_back(0);
         }
-        evalTuple = String(tbuf);
-        delete[] tbuf;
     }
 
     virtual ~WeightedClause() {}
@@ -138,6 +132,7 @@ public:
                     conflictWeights[index]++;
                 }
             }
+            conflictWeightChanged();
         }
     }
 
@@ -243,11 +238,15 @@ public:
     // propagates the minimum between the remaining clause weight and unary costs of all literals to the problem lower bound
     void propagate()
     {
-        Cost mincost = (connected() && scope[support]->unassigned()) ? scope[support]->getCost(getClause(support)) : MAX_COST;
-        for (int i = 0; connected() && i < arity_; i++) {
+        if (!connected())
+            return;
+        Cost mincost = (scope[support]->unassigned()) ? scope[support]->getCost(getClause(support)) : MAX_COST;
+        for (int i = 0; i < arity_; i++) {
             EnumeratedVariable* x = scope[i];
             if (x->assigned()) {
                 assign(i);
+                if (!connected()) // connected() is linear in the arity, only an assignment can disconnect the clause
+                    return;
             } else if (mincost > MIN_COST) {
                 Cost ucost = x->getCost(getClause(i));
                 if (ucost < mincost) {
@@ -256,7 +255,7 @@ public:
                 }
             }
         }
-        if (connected() && mincost < MAX_COST && mincost > MIN_COST && cost > lb) {
+        if (mincost < MAX_COST && mincost > MIN_COST && cost > lb) {
             extend(min(cost - lb, mincost));
         }
     };
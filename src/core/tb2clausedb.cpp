@@ -0,0 +1,443 @@
+/*
+ * ****** Database of weighted clauses with two watched literals *******
+ */
+
+#include "tb2clausedb.hpp"
+#include "tb2abstractconstr.hpp"
+#include "tb2wcsp.hpp"
+
+/*
+ * Constructors and misc.
+ *
+ */
+
+WeightedClauseDatabase::WeightedClauseDatabase(WCSP* wcsp, EnumeratedVariable** scope_in, int arity_in)
+    : Constraint(wcsp)
+    , scope(scope_in, scope_in + arity_in)
+    , scope_dac(scope_in, scope_in + arity_in)
+    , links(arity_in, NULL)
+    , clauseStart(1, 0)
+    , watches(2 * arity_in)
+    , occurrences(2 * arity_in)
+    , nbExtended(2 * arity_in, StoreInt(0))
+    , conflictWeights(arity_in, 0)
+    , lastConflict(-1)
+{
+    assert(arity_in > 0);
+    for (int i = 0; i < arity_in; i++) {
+        assert(scope[i]->getDomainInitSize() == 2);
+        if (scope[i]->wcspIndex >= (int)scopeIndex.size())
+            scopeIndex.resize(scope[i]->wcspIndex + 1, -1);
+        assert(scopeIndex[scope[i]->wcspIndex] == -1);
+        scopeIndex[scope[i]->wcspIndex] = i;
+        links[i] = scope[i]->link(this, i);
+    }
+    setDACScopeIndex();
+}
+
+WeightedClauseDatabase::~WeightedClauseDatabase()
+{
+    for (unsigned int i = 0; i < links.size(); i++)
+        delete links[i];
+}
+
+void WeightedClauseDatabase::addClause(const int* lits, int size, Cost weight)
+{
+    assert(Store::getDepth() == 0);
+    assert(size >= 2);
+    if ((Long)literals.size() + size > (Long)UINT_MAX) {
+        cerr << "Error: too many literals in the clause database." << endl;
+        exit(EXIT_FAILURE);
+    }
+    int c = weights.size();
+    literals.insert(literals.end(), lits, lits + size);
+    clauseStart.push_back(literals.size());
+    weights.push_back(weight);
+    extended.push_back(StoreCost(MIN_COST));
+    if ((c & 63) == 0)
+        projected.push_back(StoreBits(0));
+    for (int k = 0; k < size; k++) {
+        assert(lits[k] >= 0 && lits[k] < 2 * arity());
+        conflictWeights[lits[k] >> 1]++;
+        occurrences[lits[k]].push_back(c);
+    }
+}
+
+void WeightedClauseDatabase::deconnect(bool reuse)
+{
+    if (connected()) {
+        if (ToulBar2::verbose >= 3)
+            cout << "deconnect " << this << endl;
+        for (unsigned int i = 0; i < links.size(); i++)
+            scope[i]->deconnect(links[i], reuse);
+    }
+}
+
+void WeightedClauseDatabase::reconnect()
+{
+    if (deconnected()) {
+        if (ToulBar2::verbose >= 3)
+            cout << "reconnect " << this << endl;
+        for (unsigned int i = 0; i < links.size(); i++) {
+            assert(links[i]->prev == NULL && links[i]->next == NULL);
+            scope[i]->reconnect(links[i]);
+        }
+    }
+}
+
+int WeightedClauseDatabase::getSmallestVarIndexInScope(int forbiddenScopeIndex)
+{
+    int indexmin = INT_MAX;
+    for (int i = 0; i < arity(); i++)
+        if (i != forbiddenScopeIndex && scope[i]->wcspIndex < indexmin)
+            indexmin = scope[i]->wcspIndex;
+    return indexmin;
+}
+
+void WeightedClauseDatabase::setDACScopeIndex()
+{
+    qsort(scope_dac.data(), scope_dac.size(), sizeof(EnumeratedVariable*), cmpDAC);
+}
+
+int WeightedClauseDatabase::getSmallestDACIndexInScope(int forbiddenScopeIndex)
+{
+    int indexmin = INT_MAX;
+    for (int i = 0; i < arity(); i++)
+        if (i != forbiddenScopeIndex && scope[i]->getDACOrder() < indexmin)
+            indexmin = scope[i]->getDACOrder();
+    return indexmin;
+}
+
+void WeightedClauseDatabase::incConflictWeight(Constraint* from)
+{
+    if (from == this && lastConflict >= 0) {
+        for (unsigned int k = clauseStart[lastConflict]; k < clauseStart[lastConflict + 1]; k++) {
+            conflictWeights[literals[k] >> 1]++;
+            scope[literals[k] >> 1]->conflictWeightChanged();
+        }
+    }
+}
+
+// sum of the mean costs of the clauses
+double WeightedClauseDatabase::computeTightness()
+{
+    tight = 0;
+    for (unsigned int c = 0; c < weights.size(); c++)
+        tight += (double)min(weights[c], wcsp->getUb()) / pow(2., (double)(clauseStart[c + 1] - clauseStart[c]));
+    return tight;
+}
+
+// the cost of a clause is its weight if all its literals are false, plus its extended cost for each true literal, minus its extended cost
+Cost WeightedClauseDatabase::getCost()
+{
+    Cost res = MIN_COST;
+    for (unsigned int c = 0; c < weights.size(); c++) {
+        if (isProjected(c))
+            continue;
+        int nbtrue = 0;
+        for (unsigned int k = clauseStart[c]; k < clauseStart[c + 1]; k++)
+            if (isTrue(literals[k]))
+                nbtrue++;
+        res += ((nbtrue == 0) ? weights[c] : (Cost)nbtrue * extended[c]) - extended[c];
+    }
+    return res;
+}
+
+Cost WeightedClauseDatabase::getMaxFiniteCost()
+{
+    Cost res = MIN_COST;
+    for (unsigned int c = 0; c < weights.size(); c++) {
+        if (isProjected(c))
+            continue;
+        Cost maxext = (Cost)(clauseStart[c + 1] - clauseStart[c] - 1) * extended[c];
+        res += (CUT(weights[c], wcsp->getUb())) ? maxext : max(weights[c] - extended[c], maxext);
+    }
+    return res;
+}
+
+void WeightedClauseDatabase::setInfiniteCost(Cost ub)
+{
+    Cost mult_ub = ((ub < (MAX_COST / MEDIUM_COST)) ? (max(LARGE_COST, ub * MEDIUM_COST)) : ub);
+    for (unsigned int c = 0; c < weights.size(); c++)
+        if (CUT(weights[c], ub))
+            weights[c] = mult_ub;
+}
+
+Long WeightedClauseDatabase::space() const
+{
+    Long res = literals.size() * sizeof(int) + clauseStart.size() * sizeof(unsigned int) + weights.size() * (sizeof(Cost) + sizeof(StoreCost)) + projected.size() * sizeof(StoreBits);
+    for (unsigned int l = 0; l < watches.size(); l++)
+        res += (watches[l].capacity() + occurrences[l].size()) * sizeof(int);
+    return res;
+}
+
+bool WeightedClauseDatabase::getClause(unsigned int c, vector<pair<EnumeratedVariable*, Value>>& lits, Cost& cost, Cost& extension)
+{
+    lits.clear();
+    if (isProjected(c))
+        return false;
+    for (unsigned int k = clauseStart[c]; k < clauseStart[c + 1]; k++) {
+        if (isTrue(literals[k]))
+            return false;
+        EnumeratedVariable* x = scope[literals[k] >> 1];
+        if (x->unassigned())
+            lits.push_back(make_pair(x, x->toValue(literals[k] & 1)));
+    }
+    cost = weights[c] - extended[c];
+    extension = extended[c];
+    return true;
+}
+
+void WeightedClauseDatabase::print(ostream& os)
+{
+    unsigned int nbprojected = 0;
+    for (unsigned int c = 0; c < weights.size(); c++)
+        if (isProjected(c))
+            nbprojected++;
+    os << endl
+       << this << " clause database: " << weights.size() << " clauses (" << nbprojected << " projected), " << literals.size() << " literals, arity: " << arity() << endl;
+    if (ToulBar2::verbose >= 4) {
+        for (unsigned int c = 0; c < weights.size(); c++) {
+            os << "  clause(";
+            for (unsigned int k = clauseStart[c]; k < clauseStart[c + 1]; k++) {
+                if ((literals[k] & 1) == 0)
+                    os << "-";
+                os << scope[literals[k] >> 1]->wcspIndex;
+                if (k < clauseStart[c + 1] - 1)
+                    os << ",";
+            }
+            os << ") / " << weights[c] << " - " << extended[c] << ((isProjected(c)) ? " projected" : "") << endl;
+        }
+    }
+}
+
+/*
+ * Propagation methods
+ *
+ */
+
+// marks clause c as projected
+void WeightedClauseDatabase::release(int c)
+{
+    setProjected(c);
+    if (extended[c] > MIN_COST)
+        for (unsigned int k = clauseStart[c]; k < clauseStart[c + 1]; k++)
+            nbExtended[literals[k]] = nbExtended[literals[k]] - 1;
+}
+
+// moves the remaining cost of clause c to the unary cost of the value falsifying its last unassigned literal
+void WeightedClauseDatabase::unit(int c, int lit)
+{
+    EnumeratedVariable* x = scope[lit >> 1];
+    assert(x->unassigned());
+    release(c);
+    x->project(x->toValue(1 - (lit & 1)), weights[c] - extended[c], true);
+    unitVars.push_back(x);
+}
+
+// gives back the extended cost of clause c to the other literals when literal lit becomes true (see WeightedClause::satisfied)
+void WeightedClauseDatabase::satisfied(int c, int lit)
+{
+    assert(isTrue(lit));
+    Cost ext = extended[c];
+    release(c);
+    for (unsigned int k = clauseStart[c]; k < clauseStart[c + 1]; k++) {
+        if (literals[k] == lit)
+            continue;
+        EnumeratedVariable* x = scope[literals[k] >> 1];
+        Value v = x->toValue(literals[k] & 1);
+        if (x->unassigned()) {
+            x->project(v, ext, true);
+            x->findSupport();
+        } else if (x->getValue() == v) {
+            Constraint::projectLB(ext);
+        }
+    }
+}
+
+// extends the minimum unary cost of the values satisfying the unassigned literals of clause c to the clause and projects it to the lower bound (see WeightedClause::propagate)
+void WeightedClauseDatabase::extend(int c)
+{
+    Cost mincost = weights[c] - extended[c];
+    for (unsigned int k = clauseStart[c]; k < clauseStart[c + 1]; k++) {
+        EnumeratedVariable* x = scope[literals[k] >> 1];
+        if (x->assigned()) {
+            if (isTrue(literals[k]))
+                return;
+        } else {
+            mincost = min(mincost, x->getCost(x->toValue(literals[k] & 1)));
+            if (mincost == MIN_COST)
+                return;
+        }
+    }
+    if (extended[c] == MIN_COST)
+        for (unsigned int k = clauseStart[c]; k < clauseStart[c + 1]; k++)
+            nbExtended[literals[k]] = nbExtended[literals[k]] + 1;
+    extended[c] += mincost;
+    for (unsigned int k = clauseStart[c]; k < clauseStart[c + 1]; k++) {
+        EnumeratedVariable* x = scope[literals[k] >> 1];
+        if (x->unassigned())
+            x->extend(x->toValue(literals[k] & 1), mincost);
+    }
+    Constraint::projectLB(mincost);
+}
+
+// visits the clauses watching literal lit which has just become false
+// returns the weight of the clauses which are now falsified
+Cost WeightedClauseDatabase::falsified(int lit)
+{
+    vector<int>& ws = watches[lit];
+    Cost delta = MIN_COST;
+    size_t j = 0;
+    for (size_t i = 0; i < ws.size(); i++) {
+        int c = ws[i];
+        int* first = &literals[clauseStart[c]];
+        int* last = &literals[clauseStart[c + 1]];
+        if (first[0] != lit && first[1] != lit)
+            continue; // obsolete entry
+        if (isProjected(c)) {
+            ws[j++] = c;
+            continue;
+        }
+        if (first[0] == lit) {
+            first[0] = first[1];
+            first[1] = lit;
+        }
+        int other = first[0];
+        if (isTrue(other)) {
+            ws[j++] = c;
+            continue;
+        }
+        int* k = first + 2;
+        while (k != last && isFalse(*k))
+            ++k;
+        if (k == last) {
+            ws[j++] = c;
+            if (isFalse(other)) {
+                release(c);
+                delta += weights[c] - extended[c];
+                lastConflict = c;
+            } else {
+                unit(c, other);
+            }
+            continue;
+        }
+        // watches a new literal instead of lit
+        first[1] = *k;
+        *k = lit;
+        watches[first[1]].push_back(c);
+        if (isFalse(other)) {
+            // the other watched literal was already false (this may happen after a backtrack), also replaces it if possible
+            int* k2 = k + 1;
+            while (k2 != last && isFalse(*k2))
+                ++k2;
+            if (k2 != last) {
+                first[0] = *k2;
+                *k2 = other;
+                watches[first[0]].push_back(c); // the entry of this clause in the watches of other becomes obsolete
+            } else {
+                // keeps watching lit which has been assigned after other
+                first[0] = lit;
+                *k = other;
+                ws[j++] = c;
+                if (!isTrue(first[1]))
+                    unit(c, first[1]);
+            }
+        }
+    }
+    ws.resize(j);
+    return delta;
+}
+
+// moves the weight of falsified clauses to the lower bound and updates the unary supports of unit clauses
+void WeightedClauseDatabase::projectUnits(Cost delta)
+{
+    if (delta > MIN_COST) {
+        wcsp->revise(this);
+        projectLB(delta);
+    }
+    for (unsigned int i = 0; i < unitVars.size(); i++)
+        if (unitVars[i]->unassigned())
+            unitVars[i]->findSupport();
+}
+
+void WeightedClauseDatabase::assign(int varIndex)
+{
+    EnumeratedVariable* x = scope[varIndex];
+    assert(x->assigned());
+    int lit = 2 * varIndex + x->toIndex(x->getValue());
+    if (nbExtended[lit] > 0) {
+        vector<int>& occ = occurrences[lit];
+        for (size_t i = 0; i < occ.size(); i++)
+            if (!isProjected(occ[i]) && extended[occ[i]] > MIN_COST)
+                satisfied(occ[i], lit);
+    }
+    unitVars.clear();
+    projectUnits(falsified(lit ^ 1));
+}
+
+// a value of variable index has just got a positive unary cost, checks if some clauses where it satisfies the literal can get an extended cost
+void WeightedClauseDatabase::projectFromZero(int index)
+{
+    EnumeratedVariable* x = scope[index];
+    if (x->assigned())
+        return;
+    for (int lit = 2 * index; lit < 2 * index + 2; lit++) {
+        if (x->getCost(x->toValue(lit & 1)) == MIN_COST)
+            continue;
+        vector<int>& occ = occurrences[lit];
+        for (size_t i = 0; i < occ.size(); i++)
+            if (!isProjected(occ[i]) && weights[occ[i]] > extended[occ[i]])
+                extend(occ[i]);
+    }
+}
+
+// (re)initializes the watched literals of all the clauses
+void WeightedClauseDatabase::propagate()
+{
+    if (deconnected())
+        return;
+    unitVars.clear();
+    for (unsigned int l = 0; l < watches.size(); l++)
+        watches[l].clear();
+    Cost delta = MIN_COST;
+    for (unsigned int c = 0; c < weights.size(); c++) {
+        int* first = &literals[clauseStart[c]];
+        int* last = &literals[clauseStart[c + 1]];
+        int nbwatched = 0;
+        int* truelit = last;
+        for (int* k = first; k != last && nbwatched < 2; ++k) {
+            if (!isFalse(*k)) {
+                swap(first[nbwatched++], *k);
+            }
+        }
+        watches[first[0]].push_back(c);
+        watches[first[1]].push_back(c);
+        if (isProjected(c))
+            continue;
+        for (int* k = first; k != last && truelit == last; ++k)
+            if (isTrue(*k))
+                truelit = k;
+        if (truelit != last) {
+            if (extended[c] > MIN_COST)
+                satisfied(c, *truelit);
+        } else if (nbwatched == 1) {
+            unit(c, first[0]);
+        } else if (nbwatched == 0) {
+            release(c);
+            delta += weights[c] - extended[c];
+            lastConflict = c;
+        }
+    }
+    projectUnits(delta);
+    for (unsigned int c = 0; c < weights.size(); c++)
+        if (!isProjected(c) && weights[c] > extended[c])
+            extend(c);
+}
+
+/* Local Variables: */
+/* c-basic-offset: 4 */
+/* tab-width: 4 */
+/* indent-tabs-mode: nil */
+/* c-default-style: "k&r" */
+/* End: */
@@ -0,0 +1,124 @@
+/** \file tb2clausedb.hpp
+ *  \brief Database of weighted clauses with two watched literals per clause.
+ *
+ */
+
+#ifndef TB2CLAUSEDB_HPP_
+#define TB2CLAUSEDB_HPP_
+
+#include "tb2constraint.hpp"
+#include "tb2enumvar.hpp"
+
+/* A single cost function made of many weighted clauses over Boolean
+   variables (see option -wcl). The literals of all the clauses are
+   stored in one arena, a literal being its variable index in the scope
+   times two plus the value index which satisfies it. The first two
+   literals of each clause are watched: a clause is visited only when
+   one of its watched literals becomes false. When a single literal
+   remains unassigned, the clause weight is moved to the unary cost of
+   its falsifying value, and when all literals are false, it is moved
+   to the problem lower bound. As in WeightedClause, when the values
+   satisfying the unassigned literals of a clause all have a positive
+   unary cost, their minimum is extended to the clause and projected to
+   the lower bound. It is given back to the other literals when the
+   clause becomes satisfied. Only the clauses containing a literal whose
+   satisfying value has just got a positive unary cost are checked (see
+   projectFromZero), and only the clauses with an extended cost are
+   visited when one of their literals becomes true.
+*/
+class WeightedClauseDatabase : public Constraint {
+    vector<EnumeratedVariable*> scope;
+    vector<EnumeratedVariable*> scope_dac; // scope sorted by increasing DAC order
+    vector<int> scopeIndex; // position in the scope of each variable given by its wcspIndex (-1 if not in the scope)
+    vector<DLink<ConstraintLink>*> links;
+
+    vector<int> literals; // literals of all the clauses, the first two literals of each clause are watched
+    vector<unsigned int> clauseStart; // position of the first literal of each clause in literals, plus the total number of literals
+    vector<Cost> weights; // weight of each clause
+    vector<StoreCost> extended; // cost extended from unary costs to each clause and projected to the lower bound, must be backtrackable!
+    vector<StoreBits> projected; // one bit per clause set when its cost has been moved to unary costs or to the lower bound, must be backtrackable!
+    vector<vector<int>> watches; // clauses watching each literal (may contain obsolete entries, see falsified)
+    vector<vector<int>> occurrences; // clauses containing each literal
+    vector<StoreInt> nbExtended; // number of clauses with an extended cost containing each literal, must be backtrackable!
+    vector<Long> conflictWeights; // used by weighted degree heuristics, initialized to the number of clauses of each variable
+    int lastConflict; // last clause moved to the lower bound
+    vector<EnumeratedVariable*> unitVars; // temporary data structure
+
+    bool isFalse(int lit) const
+    {
+        EnumeratedVariable* x = scope[lit >> 1];
+        return x->assigned() && x->toIndex(x->getValue()) != (unsigned int)(lit & 1);
+    }
+    bool isTrue(int lit) const
+    {
+        EnumeratedVariable* x = scope[lit >> 1];
+        return x->assigned() && x->toIndex(x->getValue()) == (unsigned int)(lit & 1);
+    }
+    bool isProjected(int c) const { return ((uint64_t)projected[c >> 6] >> (c & 63)) & 1; }
+    void setProjected(int c) { projected[c >> 6] = (uint64_t)projected[c >> 6] | ((uint64_t)1 << (c & 63)); }
+
+    void release(int c);
+    void unit(int c, int lit);
+    Cost falsified(int lit);
+    void satisfied(int c, int lit);
+    void extend(int c);
+    void projectUnits(Cost delta);
+
+public:
+    WeightedClauseDatabase(WCSP* wcsp, EnumeratedVariable** scope_in, int arity_in);
+    ~WeightedClauseDatabase();
+
+    /// \brief adds a clause given by its literals (index in the scope times two plus the value index satisfying the literal)
+    /// \warning only before search, with at least two literals on distinct variables
+    void addClause(const int* lits, int size, Cost weight);
+    unsigned int numberOfClauses() const { return weights.size(); }
+    /// \brief returns the unassigned literals of clause \a c given by a variable and its value satisfying the literal, the cost of the clause if they are all false, and its extended cost (see WeightedClauseDatabase::getCost)
+    /// \return false if the clause is satisfied or its cost has already been moved
+    bool getClause(unsigned int c, vector<pair<EnumeratedVariable*, Value>>& lits, Cost& cost, Cost& extension);
+
+    bool extension() const FINAL { return false; }
+
+    bool connected() const FINAL { return !links[0]->removed; }
+    bool deconnected() const FINAL { return links[0]->removed; }
+    void deconnect(bool reuse = false) FINAL;
+    void reconnect() FINAL;
+
+    int arity() const FINAL { return scope.size(); }
+    Variable* getVar(int varCtrIndex) const FINAL { return scope[varCtrIndex]; }
+    int getIndex(Variable* var) const FINAL { return (var->wcspIndex < (int)scopeIndex.size()) ? scopeIndex[var->wcspIndex] : -1; }
+    int getSmallestVarIndexInScope(int forbiddenScopeIndex) FINAL;
+    int getSmallestVarIndexInScope() FINAL { return getSmallestVarIndexInScope(-1); }
+    void setDACScopeIndex() FINAL;
+    int getSmallestDACIndexInScope(int forbiddenScopeIndex) FINAL;
+    Variable* getDACVar(int varCtrIndex) const FINAL { return scope_dac[varCtrIndex]; }
+
+    void propagate() override;
+    void assign(int varIndex) override;
+    void increase(int index) override {}
+    void decrease(int index) override {}
+    void remove(int index) override {}
+    void projectFromZero(int index) override;
+
+    Long getConflictWeight(int varIndex) const override { return conflictWeights[varIndex]; }
+    void incConflictWeight(Constraint* from) override;
+    void conflictWeightChanged() override {} // the conflict weight of the database itself is not used by weighted degree heuristics
+    double computeTightness() override;
+
+    Cost getCost() override;
+    Cost getMaxFiniteCost() override;
+    void setInfiniteCost(Cost ub) override;
+    Long size() const override { return weights.size(); }
+    Long space() const override;
+
+    void print(ostream& os) override;
+    void dump(ostream&, bool) override { cerr << "warning! clause database cannot be dump." << endl; }
+};
+
+#endif /* TB2CLAUSEDB_HPP_ */
+
+/* Local Variables: */
+/* c-basic-offset: 4 */
+/* tab-width: 4 */
+/* indent-tabs-mode: nil */
+/* c-default-style: "k&r" */
+/* End: */
@@ -12,7 +12,7 @@
 
 //#define PROPAGATE_CLIQUE_WITH_BINARIES
 
-int CliqueConstraint::nextid{ 0 };
+std::atomic<int> CliqueConstraint::nextid{ 0 };
 
 CliqueConstraint::CliqueConstraint(WCSP* wcsp, EnumeratedVariable** scope_in,
     int arity_in, vector<vector<int>> clq_in,
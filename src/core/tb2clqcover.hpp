@@ -90,6 +90,7 @@ public:
                     conflictWeights[index]++;
                 }
             }
+            conflictWeightChanged();
         }
     }
     double computeTightness() override;
@@ -189,7 +190,7 @@ private:
 
     int run{ 0 };
     int id{ 0 };
-    static int nextid;
+    static std::atomic<int> nextid;
 
 public:
     struct state {
@@ -57,6 +57,12 @@ void Constraint::conflict()
     wcsp->conflict();
 }
 
+void Constraint::conflictWeightChanged()
+{
+    for (int i = 0; i < arity(); i++)
+        getVar(i)->conflictWeightChanged();
+}
+
 void Constraint::projectLB(Cost cost)
 {
     if (cost == MIN_COST)
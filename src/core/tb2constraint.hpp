@@ -57,15 +57,31 @@ public:
     virtual Long getConflictWeight(int varIndex) const { return conflictWeight; }
     virtual void incConflictWeight(Constraint* from)
     {
-        if (from == this || deconnected())
+        if (from == this || deconnected()) {
             conflictWeight++;
+            conflictWeightChanged();
+        }
         if (fromElim1)
             fromElim1->incConflictWeight(from);
         if (fromElim2)
             fromElim2->incConflictWeight(from);
     }
-    void incConflictWeight(Long incval) { conflictWeight += incval; }
-    void resetConflictWeight() { conflictWeight = 1 + ((ToulBar2::weightedTightness) ? getTightness() : 0); }
+    void incConflictWeight(Long incval)
+    {
+        conflictWeight += incval;
+        conflictWeightChanged();
+    }
+    void setConflictWeight(Long weight)
+    {
+        conflictWeight = weight;
+        conflictWeightChanged();
+    }
+    void resetConflictWeight()
+    {
+        conflictWeight = 1 + ((ToulBar2::weightedTightness) ? getTightness() : 0);
+        conflictWeightChanged();
+    }
+    virtual void conflictWeightChanged(); ///< \brief invalidates the cached weighted degree of the variables in the scope (see Variable::getWeightedDegree)
     void elimFrom(Constraint* from1, Constraint* from2 = NULL)
     {
         fromElim1 = from1;
@@ -271,7 +287,11 @@ public:
     void assignCluster();
 
     bool isSep_;
-    void setSep() { isSep_ = true; }
+    void setSep()
+    {
+        isSep_ = true;
+        conflictWeightChanged();
+    }
     bool isSep() { return isSep_; }
 
     bool isDuplicate_;
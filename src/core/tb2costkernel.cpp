@@ -0,0 +1,163 @@
+/*
+ * ****** Minimum cost along a row of a cost table (scalar, AVX2 and AVX-512 versions)
+ */
+
+#include "tb2costkernel.hpp"
+
+#if defined(LONGLONG_COST) && defined(__GNUC__) && defined(__x86_64__)
+#define COST_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+typedef int (*MinCostRowKernel)(const Cost* row, ptrdiff_t stride, const Cost* offsets, const Long* valid, unsigned int n, Cost& minCost);
+
+static int minCostRowScalar(const Cost* row, ptrdiff_t stride, const Cost* offsets, const Long* valid, unsigned int n, Cost& minCost)
+{
+    int pos = -1;
+    for (unsigned int i = 0; i < n; i++) {
+        if (valid[i]) {
+            Cost cost = row[i * stride] + offsets[i];
+            if (pos < 0 || cost < minCost) {
+                minCost = cost;
+                pos = i;
+            }
+        }
+    }
+    return pos;
+}
+
+#ifdef COST_KERNEL_X86
+static const Long NOCOST = numeric_limits<Long>::max(); // cost given to removed values
+
+__attribute__((target("avx2"))) static inline __m256i loadRow4(const Cost* row, ptrdiff_t stride, unsigned int i, __m256i gatherIndex)
+{
+    if (stride == 1)
+        return _mm256_loadu_si256((const __m256i*)(row + i));
+    return _mm256_i64gather_epi64((const long long*)(row + i * stride), gatherIndex, 8);
+}
+
+__attribute__((target("avx2"))) static int minCostRowAVX2(const Cost* row, ptrdiff_t stride, const Cost* offsets, const Long* valid, unsigned int n, Cost& minCost)
+{
+    const unsigned int n4 = n & ~3u;
+    const __m256i nocost = _mm256_set1_epi64x(NOCOST);
+    const __m256i gatherIndex = _mm256_set_epi64x(3 * stride, 2 * stride, stride, 0);
+    // first pass: minimum cost
+    __m256i vmin = nocost;
+    __m256i vfound = _mm256_setzero_si256();
+    for (unsigned int i = 0; i < n4; i += 4) {
+        __m256i m = _mm256_loadu_si256((const __m256i*)(valid + i));
+        vfound = _mm256_or_si256(vfound, m);
+        __m256i v = _mm256_add_epi64(loadRow4(row, stride, i, gatherIndex), _mm256_loadu_si256((const __m256i*)(offsets + i)));
+        v = _mm256_blendv_epi8(nocost, v, m);
+        vmin = _mm256_blendv_epi8(vmin, v, _mm256_cmpgt_epi64(vmin, v));
+    }
+    Long lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, vmin);
+    Long best = min(min(lanes[0], lanes[1]), min(lanes[2], lanes[3]));
+    bool found = !_mm256_testz_si256(vfound, vfound);
+    for (unsigned int i = n4; i < n; i++) {
+        if (valid[i]) {
+            Cost cost = row[i * stride] + offsets[i];
+            if (!found || cost < best)
+                best = cost;
+            found = true;
+        }
+    }
+    if (!found)
+        return -1;
+    minCost = best;
+    // second pass: first position reaching the minimum
+    const __m256i vbest = _mm256_set1_epi64x(best);
+    for (unsigned int i = 0; i < n4; i += 4) {
+        __m256i v = _mm256_add_epi64(loadRow4(row, stride, i, gatherIndex), _mm256_loadu_si256((const __m256i*)(offsets + i)));
+        __m256i eq = _mm256_and_si256(_mm256_cmpeq_epi64(v, vbest), _mm256_loadu_si256((const __m256i*)(valid + i)));
+        int mask = _mm256_movemask_pd(_mm256_castsi256_pd(eq));
+        if (mask)
+            return i + __builtin_ctz(mask);
+    }
+    for (unsigned int i = n4; i < n; i++) {
+        if (valid[i] && row[i * stride] + offsets[i] == best)
+            return i;
+    }
+    assert(false);
+    return -1;
+}
+
+__attribute__((target("avx512f"))) static inline __m512i loadRow8(const Cost* row, ptrdiff_t stride, unsigned int i, __m512i gatherIndex)
+{
+    if (stride == 1)
+        return _mm512_loadu_si512((const void*)(row + i));
+    return _mm512_mask_i64gather_epi64(_mm512_setzero_si512(), 0xFF, gatherIndex, (const void*)(row + i * stride), 8);
+}
+
+__attribute__((target("avx512f"))) static int minCostRowAVX512(const Cost* row, ptrdiff_t stride, const Cost* offsets, const Long* valid, unsigned int n, Cost& minCost)
+{
+    const unsigned int n8 = n & ~7u;
+    const __m512i gatherIndex = _mm512_set_epi64(7 * stride, 6 * stride, 5 * stride, 4 * stride, 3 * stride, 2 * stride, stride, 0);
+    // first pass: minimum cost
+    __m512i vmin = _mm512_set1_epi64(NOCOST);
+    bool found = false;
+    for (unsigned int i = 0; i < n8; i += 8) {
+        __m512i m = _mm512_loadu_si512((const void*)(valid + i));
+        __mmask8 k = _mm512_test_epi64_mask(m, m);
+        found |= (k != 0);
+        __m512i v = _mm512_add_epi64(loadRow8(row, stride, i, gatherIndex), _mm512_loadu_si512((const void*)(offsets + i)));
+        vmin = _mm512_mask_min_epi64(vmin, k, vmin, v);
+    }
+    Long lanes[8];
+    _mm512_storeu_si512((void*)lanes, vmin);
+    Long best = *min_element(lanes, lanes + 8);
+    for (unsigned int i = n8; i < n; i++) {
+        if (valid[i]) {
+            Cost cost = row[i * stride] + offsets[i];
+            if (!found || cost < best)
+                best = cost;
+            found = true;
+        }
+    }
+    if (!found)
+        return -1;
+    minCost = best;
+    // second pass: first position reaching the minimum
+    const __m512i vbest = _mm512_set1_epi64(best);
+    for (unsigned int i = 0; i < n8; i += 8) {
+        __m512i m = _mm512_loadu_si512((const void*)(valid + i));
+        __m512i v = _mm512_add_epi64(loadRow8(row, stride, i, gatherIndex), _mm512_loadu_si512((const void*)(offsets + i)));
+        __mmask8 eq = _mm512_mask_cmpeq_epi64_mask(_mm512_test_epi64_mask(m, m), v, vbest);
+        if (eq)
+            return i + __builtin_ctz(eq);
+    }
+    for (unsigned int i = n8; i < n; i++) {
+        if (valid[i] && row[i * stride] + offsets[i] == best)
+            return i;
+    }
+    assert(false);
+    return -1;
+}
+#endif
+
+static MinCostRowKernel selectKernel()
+{
+#ifdef COST_KERNEL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return minCostRowAVX512;
+    if (__builtin_cpu_supports("avx2"))
+        return minCostRowAVX2;
+#endif
+    return minCostRowScalar;
+}
+
+static const MinCostRowKernel kernel = selectKernel();
+
+int minCostRow(const Cost* row, ptrdiff_t stride, const Cost* offsets, const Long* valid, unsigned int n, Cost& minCost)
+{
+    return kernel(row, stride, offsets, valid, n, minCost);
+}
+
+/* Local Variables: */
+/* c-basic-offset: 4 */
+/* tab-width: 4 */
+/* indent-tabs-mode: nil */
+/* c-default-style: "k&r" */
+/* End: */
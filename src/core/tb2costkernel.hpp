@@ -0,0 +1,42 @@
+/** \file tb2costkernel.hpp
+ *  \brief Minimum cost along a row of a cost table, vectorized when the processor allows it.
+ *
+ * Convention:
+ *
+ * a row is given by its first cost and a stride (in number of costs) between two consecutive positions
+ * each position \e i has an offset added to its cost (typically minus a delta cost of the variable along the row)
+ * and a validity mask (\e -1 if the value is in the current domain, \e 0 otherwise)
+ *
+ * the returned position is the first one reaching the minimum, as with a scalar loop using ::GLB
+ *
+ * the kernel (AVX-512, AVX2 or scalar) is selected once at program start from the processor features
+ *
+ */
+
+#ifndef TB2COSTKERNEL_HPP_
+#define TB2COSTKERNEL_HPP_
+
+#include "tb2types.hpp"
+
+const unsigned int MIN_KERNEL_ROW = 16; ///< \brief shorter rows are scanned by the usual loops over domain iterators
+const bool COST_KERNEL = !PARTIALORDER; ///< \brief kernels need a total order on costs
+
+/// \brief gives direct read access to a table of backtrackable costs
+template <class StoreCostType>
+inline const Cost* rawCosts(const vector<StoreCostType>& costs)
+{
+    return reinterpret_cast<const Cost*>(costs.data());
+}
+
+/// \brief returns the first position minimizing row[i * stride] + offsets[i] for i in [0,n) and valid[i] != 0, or -1 if there is no valid position
+/// \param minCost the minimum cost (unchanged if there is no valid position)
+int minCostRow(const Cost* row, ptrdiff_t stride, const Cost* offsets, const Long* valid, unsigned int n, Cost& minCost);
+
+#endif /*TB2COSTKERNEL_HPP_*/
+
+/* Local Variables: */
+/* c-basic-offset: 4 */
+/* tab-width: 4 */
+/* indent-tabs-mode: nil */
+/* c-default-style: "k&r" */
+/* End: */
@@ -10,22 +10,28 @@
  */
 
 Domain::Domain(Value inf, Value sup)
-    : BTList<Value>(&Store::storeDomain)
+    : BTList<Value>(&Store::getContext()->storeDomain)
     , initSize(sup - inf + 1)
     , distanceToZero(inf)
+    , all(NULL)
+    , bits((initSize <= MAX_BITS_SIZE) ? bitsUpTo(initSize - 1) : UINT64_C(0))
 {
     init(inf, sup);
 }
 
 Domain::Domain(Value* d, int dsize)
-    : BTList<Value>(&Store::storeDomain)
+    : BTList<Value>(&Store::getContext()->storeDomain)
     , initSize(max(d, dsize) - min(d, dsize) + 1)
     , distanceToZero(min(d, dsize))
+    , all(NULL)
+    , bits((initSize <= MAX_BITS_SIZE) ? initBits(d, dsize) : UINT64_C(0))
 {
     assert(dsize >= 1);
     assert(dsize <= MAX_DOMAIN_SIZE);
     qsort(d, dsize, sizeof(Value), cmpValue);
     init(d[0], d[dsize - 1]);
+    if (isBits())
+        return;
     int i = 0;
     for (iterator iter = begin(); iter != end(); ++iter) {
         if (*iter < d[i])
@@ -35,6 +41,16 @@ Domain::Domain(Value* d, int dsize)
     }
 }
 
+uint64_t Domain::initBits(Value* d, int dsize)
+{
+    Value inf = min(d, dsize);
+    uint64_t b = UINT64_C(0);
+    for (int i = 0; i < dsize; i++) {
+        b |= bit(d[i] - inf);
+    }
+    return b;
+}
+
 void Domain::init(Value inf, Value sup)
 {
     assert(sup - inf + 1 >= 1);
@@ -42,6 +58,8 @@ void Domain::init(Value inf, Value sup)
 #if defined(WCSPFORMATONLY) && !defined(NUMBERJACK)
     assert(distanceToZero == 0);
 #endif
+    if (initSize <= MAX_BITS_SIZE)
+        return; // bitmask already initialized
     all = new DLink<Value>[sup - inf + 1];
     for (int idx = 0; idx < sup - inf + 1; idx++) {
         all[idx].content = idx + inf;
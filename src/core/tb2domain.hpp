@@ -1,6 +1,9 @@
 /** \file tb2domain.hpp
  *  \brief Storable enumerated domain.
- * 
+ *
+ *  Small domains (initial size at most Domain::MAX_BITS_SIZE) are represented by a backtrackable bitmask (see ::StoreBits)
+ *  with constant-time size, membership, and bound updates. Larger domains use a backtrackable double-linked list of values.
+ *  Both representations share the same interface and iterators.
  */
 
 #ifndef TB2DOMAIN_HPP_
@@ -11,36 +14,154 @@
 extern int cmpValue(const void* v1, const void* v2);
 
 class Domain : public BTList<Value> {
+public:
+    static const unsigned int MAX_BITS_SIZE = 64; ///< \brief maximum initial domain size for the bitmask representation
+
+private:
     const unsigned int initSize;
     const Value distanceToZero;
-    DLink<Value>* all;
+    DLink<Value>* all; // NULL if bitmask representation
+    StoreBits bits; // i-th bit is set if value toValue(i) is in the domain (bitmask representation only)
 
     vector<string> valueNames;
     void init(Value inf, Value sup);
 
+    static uint64_t initBits(Value* d, int dsize);
+
+#ifdef __GNUC__
+    static int bitCount(uint64_t b) { return __builtin_popcountll(b); }
+    static int firstBit(uint64_t b) { return __builtin_ctzll(b); }
+    static int lastBit(uint64_t b) { return 63 - __builtin_clzll(b); }
+#else
+    static int bitCount(uint64_t b)
+    {
+        int n = 0;
+        for (; b; b &= b - 1)
+            n++;
+        return n;
+    }
+    static int firstBit(uint64_t b)
+    {
+        int i = 0;
+        for (; !(b & 1); b >>= 1)
+            i++;
+        return i;
+    }
+    static int lastBit(uint64_t b)
+    {
+        int i = 63;
+        for (; !(b >> 63); b <<= 1)
+            i--;
+        return i;
+    }
+#endif
+    static uint64_t bit(unsigned int idx) { return UINT64_C(1) << idx; }
+    static uint64_t bitsFrom(unsigned int idx) { return (idx < MAX_BITS_SIZE) ? (~UINT64_C(0) << idx) : UINT64_C(0); } // bits idx and above
+    static uint64_t bitsUpTo(unsigned int idx) { return ~UINT64_C(0) >> (MAX_BITS_SIZE - 1 - idx); } // bits idx and below
+
     // make it private because we don't want copy nor assignment
     Domain(const Domain& s);
     Domain& operator=(const Domain& s);
 
 public:
-    typedef BTList<Value>::iterator iterator;
-
     Domain(Value inf, Value sup);
 
     Domain(Value* d, int dsize);
 
     ~Domain()
     {
-        if (initSize >= 1)
+        if (all)
             delete[] all;
     }
 
+    class iterator;
+    friend class iterator;
+    class iterator {
+        const Domain* dom; // NULL for the list representation
+        DLink<Value>* elt; // current element (list representation)
+        int idx; // current bit index (bitmask representation), -1 at the end
+
+    public:
+        iterator()
+            : dom(NULL)
+            , elt(NULL)
+            , idx(-1)
+        {
+        }
+        iterator(DLink<Value>* e)
+            : dom(NULL)
+            , elt(e)
+            , idx(-1)
+        {
+        }
+        iterator(const Domain* d, int i)
+            : dom(d)
+            , elt(NULL)
+            , idx(i)
+        {
+        }
+
+        ALWAYS_INLINE Value operator*() const
+        {
+            if (dom) {
+                assert(idx >= 0);
+                return idx + dom->distanceToZero;
+            }
+            assert(elt != NULL);
+            return elt->content;
+        }
+
+        ALWAYS_INLINE iterator& operator++()
+        { // Prefix form
+            if (dom) {
+                if (idx >= 0) {
+                    uint64_t next = (dom->bits >> idx) >> 1;
+                    idx = (next) ? idx + 1 + firstBit(next) : -1;
+                }
+            } else if (elt != NULL) {
+                while (elt->next != NULL && elt->next->removed) {
+                    elt = elt->next;
+                }
+                elt = elt->next;
+            }
+            assert(elt == NULL || !elt->removed);
+            return *this;
+        }
+
+        ALWAYS_INLINE iterator& operator--()
+        { // Prefix form
+            if (dom) {
+                if (idx >= 0) {
+                    uint64_t prev = (dom->bits << (MAX_BITS_SIZE - 1 - idx)) << 1;
+                    idx = (prev) ? lastBit(prev) - (int)MAX_BITS_SIZE + idx : -1;
+                }
+            } else if (elt != NULL) {
+                while (elt->prev != NULL && elt->prev->removed) {
+                    elt = elt->prev;
+                }
+                elt = elt->prev;
+            }
+            assert(elt == NULL || !elt->removed);
+            return *this;
+        }
+
+        // To see if you're at the end:
+        bool operator==(const iterator& iter) const { return elt == iter.elt && idx == iter.idx; }
+        bool operator!=(const iterator& iter) const { return elt != iter.elt || idx != iter.idx; }
+    };
+
+    bool isBits() const { return all == NULL; } ///< \brief true if the domain is represented by a bitmask
+
     unsigned int getInitSize() const { return initSize; }
+    int getSize() const { return (isBits()) ? bitCount(bits) : BTList<Value>::getSize(); }
+    bool empty() const { return (isBits()) ? (bits == UINT64_C(0)) : BTList<Value>::empty(); }
     unsigned int toIndex(Value v) const { return v - distanceToZero; }
     Value toValue(int idx) const { return idx + distanceToZero; }
     unsigned int toCurrentIndex(Value v)
     {
         assert(canbe(v));
+        if (isBits())
+            return (toIndex(v) > 0) ? bitCount(bits & bitsUpTo(toIndex(v) - 1)) : 0;
         unsigned int pos = 0;
         for (iterator iter = begin(); iter != end(); ++iter) {
             if (*iter == v)
@@ -51,15 +172,26 @@ public:
         exit(EXIT_FAILURE);
     }
 
-    bool canbe(Value v) const { return !all[toIndex(v)].removed; }
-    bool cannotbe(Value v) const { return all[toIndex(v)].removed; }
+    bool canbe(Value v) const { return (isBits()) ? ((bits & bit(toIndex(v))) != UINT64_C(0)) : !all[toIndex(v)].removed; }
+    bool cannotbe(Value v) const { return (isBits()) ? ((bits & bit(toIndex(v))) == UINT64_C(0)) : all[toIndex(v)].removed; }
 
-    void erase(Value v) { BTList<Value>::erase(&all[toIndex(v)], true); }
+    void erase(Value v)
+    {
+        if (isBits()) {
+            assert(canbe(v));
+            bits = bits & ~bit(toIndex(v));
+        } else
+            BTList<Value>::erase(&all[toIndex(v)], true);
+    }
 
     Value increase(Value v)
     {
         iterator newInf = lower_bound(v);
         assert(canbe(*newInf));
+        if (isBits()) {
+            bits = bits & bitsFrom(toIndex(*newInf));
+            return *newInf;
+        }
         for (iterator iter = begin(); iter != newInf; ++iter) {
             erase(*iter);
         }
@@ -69,16 +201,29 @@ public:
     {
         iterator newSup = upper_bound(v);
         assert(canbe(*newSup));
+        if (isBits()) {
+            bits = bits & bitsUpTo(toIndex(*newSup));
+            return *newSup;
+        }
         for (iterator iter = rbegin(); iter != newSup; --iter) {
             erase(*iter);
         }
         return *newSup;
     }
 
+    iterator begin() { return (isBits()) ? iterator(this, (bits) ? firstBit(bits) : -1) : iterator(BTList<Value>::begin().getElt()); }
+    iterator end() { return iterator(); }
+    iterator rbegin() { return (isBits()) ? iterator(this, (bits) ? lastBit(bits) : -1) : iterator(BTList<Value>::rbegin().getElt()); }
+    iterator rend() { return end(); }
+
     //Finds the first available element whose value is greater or equal to v
     iterator lower_bound(Value v)
     {
         assert(toIndex(v) >= 0 && toIndex(v) < initSize);
+        if (isBits()) {
+            uint64_t next = bits & bitsFrom(toIndex(v));
+            return iterator(this, (next) ? firstBit(next) : -1);
+        }
         iterator iter(&all[toIndex(v)]);
         if (cannotbe(v)) {
             ++iter;
@@ -90,6 +235,10 @@ public:
     iterator upper_bound(Value v)
     {
         assert(toIndex(v) >= 0 && toIndex(v) < initSize);
+        if (isBits()) {
+            uint64_t prev = bits & bitsUpTo(toIndex(v));
+            return iterator(this, (prev) ? lastBit(prev) : -1);
+        }
         iterator iter(&all[toIndex(v)]);
         if (cannotbe(v)) {
             --iter;
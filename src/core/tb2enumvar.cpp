@@ -61,6 +61,15 @@ void EnumeratedVariable::init()
     queueDEE();
 }
 
+Domain::iterator EnumeratedVariable::nextAssigned(Value current, bool forward)
+{
+    assert(assigned());
+    if ((forward) ? (current < getValue()) : (current > getValue()))
+        return domain.lower_bound(getValue());
+    else
+        return domain.end();
+}
+
 void EnumeratedVariable::getDomain(Value* array)
 {
     for (iterator iter = begin(); iter != end(); ++iter) {
@@ -132,6 +132,8 @@ public:
     void mergeTo(BinaryConstraint* xy, map<Value, Value>& functional);
     bool canbeMerged(EnumeratedVariable* x);
 
+    Domain::iterator nextAssigned(Value current, bool forward); // next domain iterator position if the variable is assigned (kept out of inlined iterations)
+
     class iterator;
     friend class iterator;
     class iterator {
@@ -148,29 +150,21 @@ public:
 
         Value operator*() const { return *diter; }
 
-        iterator& operator++()
+        ALWAYS_INLINE iterator& operator++()
         { // Prefix form //TODO: add a const_iterator to speed-up iterations (should be inlined?)
             if (var->unassigned())
                 ++diter;
-            else {
-                if (*diter < var->getValue())
-                    diter = var->domain.lower_bound(var->getValue());
-                else
-                    diter = var->domain.end();
-            }
+            else
+                diter = var->nextAssigned(*diter, true);
             return *this;
         }
 
-        iterator& operator--()
+        ALWAYS_INLINE iterator& operator--()
         { // Prefix form
             if (var->unassigned())
                 --diter;
-            else {
-                if (*diter > var->getValue())
-                    diter = var->domain.lower_bound(var->getValue());
-                else
-                    diter = var->domain.end();
-            }
+            else
+                diter = var->nextAssigned(*diter, false);
             return *this;
         }
 
@@ -2,6 +2,7 @@
 #include "tb2naryconstr.hpp"
 #include "tb2vac.hpp"
 #include "search/tb2clusters.hpp"
+#include "utils/tb2tensor.hpp"
 
 NaryConstraint::NaryConstraint(WCSP* wcsp, EnumeratedVariable** scope_in, int arity_in, Cost defval, Long nbtuples)
     : AbstractNaryConstraint(wcsp, scope_in, arity_in)
@@ -919,9 +920,9 @@ void NaryConstraint::project(EnumeratedVariable* x)
         Value val;
         TUPLES fproj;
         TUPLES::iterator it;
+        fproj.reserve(pf->size());
         // First part of the projection: complexity O(|f|) we swap positions between the projected variable and the last variable
-        while (!pf->empty()) {
-            it = pf->begin();
+        for (it = pf->begin(); it != pf->end(); ++it) {
             t = it->first;
             c = it->second;
             assert(x->getDegree() == 1);
@@ -934,8 +935,9 @@ void NaryConstraint::project(EnumeratedVariable* x)
             tswap[arity_ - 1] = tswap[xindex];
             tswap[xindex] = a;
             fproj[tswap] = c;
-            pf->erase(it);
         }
+        pf->clear();
+        fproj.sort();
 
         // Second part of the projection: complexity O(|f|) as the projected variable is in the last position,
         // it is sufficient to look for tuples with the same arity-1 prefix. If there are less than d (domain of
@@ -1003,47 +1005,42 @@ void NaryConstraint::project(EnumeratedVariable* x)
         Cost* costs_ = new Cost[sz];
         std::fill(costs_, costs_ + sz, Top);
         int a = arity_;
-        vector<unsigned int> t(a, 0);
-        for (ptrdiff_t idx = 0; idx < costSize; idx++) {
-            bool ok = true;
-            for (int i = 0; i < a && ok; i++) {
-                EnumeratedVariable* var = (EnumeratedVariable*)getVar(i);
-                ok = ok && var->canbe(var->toValue(t[i]));
-            }
-            Cost c = ((ok) ? costs[idx] : Top);
+        // the resulting table has variable x replaced by the last variable (see the update of the scope below)
+        vector<ptrdiff_t> strides_(a, 0);
+        ptrdiff_t base_ = 1;
+        for (int i = a - 2; i >= 0; --i) {
+            int j = (i == xindex) ? (a - 1) : i;
+            strides_[j] = base_;
+            base_ *= ((EnumeratedVariable*)getVar(j))->getDomainInitSize();
+        }
+        assert(base_ == sz);
+        vector<Cost> xcosts(x->getDomainInitSize(), Top);
+        for (EnumeratedVariable::iterator itv = x->begin(); itv != x->end(); ++itv)
+            xcosts[x->toIndex(*itv)] = x->getCost(*itv);
+        // scans the current table, the resulting table, and the unary costs of x together
+        vector<DenseDimension<3>> dims;
+        for (int i = 0; i < a; i++) {
+            dims.push_back(DenseDimension<3>((EnumeratedVariable*)getVar(i)));
+            dims[i].strides[0] = getCostsStride(i);
+            dims[i].strides[1] = strides_[i];
+            dims[i].strides[2] = (i == xindex) ? 1 : 0;
+        }
+        bool isZ = ToulBar2::isZ;
+        denseForEach(dims, array<ptrdiff_t, 3>(), [&](const array<ptrdiff_t, 3>& p, bool ok) {
+            Cost c = Top;
             if (ok) {
-                c += x->getCost(x->toValue(t[xindex]));
+                c = costs[p[0]] + xcosts[p[2]];
                 if (c > Top)
                     c = Top;
             }
-
-            vector<unsigned int> tswap(t);
-            tswap[xindex] = tswap[a - 1];
-            ptrdiff_t idx_ = 0;
-            ptrdiff_t base_ = 1;
-            for (int i = a - 2; i >= 0; --i) {
-                idx_ += tswap[i] * base_;
-                base_ *= ((EnumeratedVariable*)getVar((i == xindex) ? (a - 1) : i))->getDomainInitSize();
-            }
-            assert(base_ == sz);
-            assert(idx_ < sz);
-            assert(idx_ >= 0);
-            if (ToulBar2::isZ) {
-                c = wcsp->LogSumExp(costs_[idx_], c);
+            if (isZ) {
+                c = wcsp->LogSumExp(costs_[p[1]], c);
                 if (c < negcost)
                     negcost = c;
-                costs_[idx_] = c;
-            } else
-                costs_[idx_] = min(costs_[idx_], c);
-
-            int i = a - 1;
-            while (i >= 0 && t[i] == ((EnumeratedVariable*)getVar(i))->getDomainInitSize() - 1) {
-                t[i] = 0;
-                i--;
-            }
-            if (i >= 0)
-                t[i]++;
-        }
+                costs_[p[1]] = c;
+            } else if (c < costs_[p[1]])
+                costs_[p[1]] = c;
+        });
         costSize = sz;
         delete[] costs;
         costs = costs_;
@@ -1052,7 +1049,7 @@ void NaryConstraint::project(EnumeratedVariable* x)
     if (negcost < 0) {
         if (pf) {
             for (TUPLES::iterator it = pf->begin(); it != pf->end(); ++it) {
-                (*pf)[(*it).first] = (*it).second - negcost;
+                it->second -= negcost;
             }
         } else {
             for (ptrdiff_t idx = 0; idx < costSize; idx++) {
@@ -5,9 +5,10 @@
 #include "tb2ternaryconstr.hpp"
 #include "tb2enumvar.hpp"
 #include "tb2wcsp.hpp"
+#include "utils/tb2tuplemap.hpp"
 
 class NaryConstraint : public AbstractNaryConstraint {
-    typedef map<String, Cost> TUPLES;
+    typedef TupleMap<Cost> TUPLES;
     TUPLES* pf;
     Cost* costs;
     ptrdiff_t costSize;
@@ -55,6 +56,7 @@ public:
                     conflictWeights[index]++;
                 }
             }
+            conflictWeightChanged();
         }
     }
 
@@ -71,6 +73,14 @@ public:
         assert(index >= 0);
         return index;
     }
+    Cost* getDenseCosts() { return costs; } ///< \brief dense table of costs in lexicographic order (NULL if tuples are stored in a map)
+    ptrdiff_t getCostsStride(int i) const ///< \brief distance in the dense table between two consecutive value indexes of the i-th variable
+    {
+        ptrdiff_t stride = 1;
+        for (int j = arity_ - 1; j > i; --j)
+            stride *= ((EnumeratedVariable*)getVar(j))->getDomainInitSize();
+        return stride;
+    }
     Long size() const FINAL { return (Long)(pf) ? pf->size() : ((costs) ? costSize : 0); }
     Long space() const FINAL { return ((pf) ? ((Long)pf->size() * (sizeof(Cost) + arity_ * sizeof(Char))) : ((costs) ? ((Long)costSize * sizeof(Cost)) : 0)); } // actual memory space (not taking into account map space overhead)
     Long space(Long nbtuples) const { return (nbtuples < LONGLONG_MAX / ((Long)(sizeof(Cost) + arity_ * sizeof(Char)))) ? (nbtuples * (sizeof(Cost) + arity_ * sizeof(Char))) : LONGLONG_MAX; } // putative memory space
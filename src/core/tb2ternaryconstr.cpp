@@ -312,6 +312,28 @@ void TernaryConstraint::extend(EnumeratedVariable* x, Value value, Cost cost, ve
     x->extend(value, cost);
 }
 
+void TernaryConstraint::rowOffsets(EnumeratedVariable* z, vector<Cost>& offsets, vector<Long>& valid)
+{
+    vector<StoreCost>& deltaCosts = getDeltaCosts(z);
+    offsets.assign(z->getDomainInitSize(), MIN_COST);
+    valid.assign(z->getDomainInitSize(), 0);
+    for (EnumeratedVariable::iterator iterZ = z->begin(); iterZ != z->end(); ++iterZ) {
+        unsigned int zindex = z->toIndex(*iterZ);
+        offsets[zindex] = -deltaCosts[zindex];
+        valid[zindex] = -1;
+    }
+}
+
+Value TernaryConstraint::findRowSupport(EnumeratedVariable* x, EnumeratedVariable* y, EnumeratedVariable* z, unsigned int ix, unsigned int iy, const vector<Cost>& offsets, const vector<Long>& valid, Cost& minCost)
+{
+    assert(!costs.empty());
+    const ptrdiff_t stride[3] = { (ptrdiff_t)sizeY * sizeZ, (ptrdiff_t)sizeZ, 1 };
+    int iz = minCostRow(rawCosts(costs) + ix * stride[getIndex(x)] + iy * stride[getIndex(y)], stride[getIndex(z)], offsets.data(), valid.data(), z->getDomainInitSize(), minCost);
+    assert(iz >= 0);
+    minCost -= (Cost)getDeltaCosts(x)[ix] + (Cost)getDeltaCosts(y)[iy];
+    return z->toValue(iz);
+}
+
 pair<pair<Cost, Cost>, pair<Cost, Cost>> TernaryConstraint::getMaxCost(int varIndex, Value a, Value b)
 {
     Cost maxcosta = MIN_COST;
@@ -570,6 +592,7 @@ void TernaryConstraint::fillxy()
         xy = xy_;
     if (xy->isDuplicate())
         setDuplicate();
+    conflictWeightChanged(); // the weighted degree depends on xy
 }
 
 void TernaryConstraint::fillxz()
@@ -594,6 +617,7 @@ void TernaryConstraint::fillxz()
         xz = xz_;
     if (xz->isDuplicate())
         setDuplicate();
+    conflictWeightChanged(); // the weighted degree depends on xz
 }
 
 void TernaryConstraint::fillyz()
@@ -616,6 +640,7 @@ void TernaryConstraint::fillyz()
         yz = yz_;
     if (yz->isDuplicate())
         setDuplicate();
+    conflictWeightChanged(); // the weighted degree depends on yz
 }
 
 void TernaryConstraint::fillElimConstrBinaries()
@@ -676,6 +701,7 @@ void TernaryConstraint::setDuplicates()
             setDuplicate();
         }
     }
+    conflictWeightChanged(); // the weighted degree depends on xy, xz, and yz
 }
 
 bool TernaryConstraint::verify(EnumeratedVariable* x, EnumeratedVariable* y, EnumeratedVariable* z)
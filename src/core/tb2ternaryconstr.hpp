@@ -235,6 +235,12 @@ protected:
     bool project(EnumeratedVariable* x, Value value, Cost cost, vector<StoreCost>& deltaCostsX);
     void extend(EnumeratedVariable* x, Value value, Cost cost, vector<StoreCost>& deltaCostsX);
 
+    vector<StoreCost>& getDeltaCosts(EnumeratedVariable* var) { return (var == x) ? deltaCostsX : ((var == y) ? deltaCostsY : deltaCostsZ); }
+    // offsets (minus delta costs) and validity masks of the values of z for minCostRow
+    void rowOffsets(EnumeratedVariable* z, vector<Cost>& offsets, vector<Long>& valid);
+    // returns the first value of z minimizing the cost with value indexes ix of x and iy of y (cost table must not be empty)
+    Value findRowSupport(EnumeratedVariable* x, EnumeratedVariable* y, EnumeratedVariable* z, unsigned int ix, unsigned int iy, const vector<Cost>& offsets, const vector<Long>& valid, Cost& minCost);
+
     template <typename T1, typename T2, typename T3>
     void project(T1 getCost, T2 addCost, bool functionalZ, T3 getFunctionZ, BinaryConstraint* xy, EnumeratedVariable* x, EnumeratedVariable* y, EnumeratedVariable* z, Value valx, Value valy, Cost cost);
     template <typename T1, typename T2, typename T3>
@@ -306,6 +312,7 @@ public:
         xy = xyin;
         xz = xzin;
         yz = yzin;
+        conflictWeightChanged();
     }
 
     BinaryConstraint* xy;
@@ -1350,6 +1357,9 @@ void TernaryConstraint::findSupport(T1 getCost, bool functionalY, T2 getFunction
              << *z << endl
              << *this;
     bool supportBroken = false;
+    const bool kernel = COST_KERNEL && !costs.empty() && z->getDomainInitSize() >= MIN_KERNEL_ROW;
+    vector<Cost> offsets; // computed on the first broken support (y and z are not modified inside the loop)
+    vector<Long> valid;
     for (EnumeratedVariable::iterator iterX = x->begin(); iterX != x->end(); ++iterX) {
         unsigned int xindex = x->toIndex(*iterX);
         pair<Value, Value> support = supportX[xindex];
@@ -1376,6 +1386,16 @@ void TernaryConstraint::findSupport(T1 getCost, bool functionalY, T2 getFunction
                         }
                     }
                 }
+            } else if (kernel) {
+                if (valid.empty())
+                    rowOffsets(z, offsets, valid);
+                for (EnumeratedVariable::iterator iterY = y->begin(); minCost > MIN_COST && iterY != y->end(); ++iterY) {
+                    Cost cost;
+                    Value valZ = findRowSupport(x, y, z, xindex, y->toIndex(*iterY), offsets, valid, cost);
+                    if (GLB(&minCost, cost)) {
+                        support = make_pair(*iterY, valZ);
+                    }
+                }
             } else {
                 for (EnumeratedVariable::iterator iterY = y->begin(); minCost > MIN_COST && iterY != y->end(); ++iterY) {
                     for (EnumeratedVariable::iterator iterZ = z->begin(); minCost > MIN_COST && iterZ != z->end(); ++iterZ) {
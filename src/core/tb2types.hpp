@@ -365,162 +365,175 @@ struct ValueCost {
 };
 
 ///contains all global variables (mainly solver's command-line options)
+/// \note each thread has its own copy of the global variables (see ::tb2getOptions and ::tb2setOptions), except ToulBar2::interrupted, ToulBar2::version, and ToulBar2::vnsOutput
 class ToulBar2 {
 protected:
     virtual ~ToulBar2() = 0; // Trick to avoid any instantiation of ToulBar2
 public:
     static string version;
-    static int verbose;
-    static int debug;
-    static string externalUB;
-    static int showSolutions;
-    static char* writeSolution;
-    static FILE* solutionFile;
-    static Long allSolutions;
-    static int dumpWCSP;
-    static bool approximateCountingBTD;
-    static bool binaryBranching;
-    static int dichotomicBranching;
-    static unsigned int dichotomicBranchingSize;
-    static bool sortDomains;
-    static map<int, ValueCost*> sortedDomains;
-    static bool solutionBasedPhaseSaving;
-    static int elimDegree;
-    static int elimDegree_preprocessing;
-    static int elimDegree_;
-    static int elimDegree_preprocessing_;
-    static int elimSpaceMaxMB;
-    static int minsumDiffusion;
-    static int preprocessTernaryRPC;
-    static int preprocessFunctional;
-    static bool costfuncSeparate;
-    static int preprocessNary;
-    static bool QueueComplexity;
-    static bool Static_variable_ordering; // flag for static variable ordering during search (dynamic ordering is default value)
-    static bool lastConflict;
-    static int weightedDegree;
-    static int weightedTightness;
-    static bool MSTDAC;
-    static int DEE;
-    static int DEE_;
-    static int nbDecisionVars;
-    static int lds;
-    static bool limited;
-    static Long restart;
-    static externalevent setvalue;
-    static externalevent setmin;
-    static externalevent setmax;
-    static externalevent removevalue;
-    static externalcostevent setminobj;
-    static externalsolution newsolution;
-    static Pedigree* pedigree;
-    static Haplotype* haplotype;
-    static string map_file;
-    static bool cfn;
-    static bool gz;
-    static bool xz;
-    static bool bayesian;
-    static int uai;
-    static int resolution;
-    static TProb errorg;
-    static TLogProb NormFactor;
-    static int foundersprob_class;
-    static vector<TProb> allelefreqdistrib;
-    static bool consecutiveAllele;
-    static bool generation;
-    static int pedigreeCorrectionMode;
-    static int pedigreePenalty;
-    static int vac;
-    static string costThresholdS;
-    static string costThresholdPreS;
-    static Cost costThreshold;
-    static Cost costThresholdPre;
-    static double trwsAccuracy;
-    static bool trwsOrder;
-    static unsigned int trwsNIter;
-    static unsigned int trwsNIterNoChange;
-    static unsigned int trwsNIterComputeUb;
-    static double costMultiplier;
-    static unsigned int decimalPoint;
-    static string deltaUbS;
-    static Cost deltaUb;
-    static bool singletonConsistency;
-    static bool vacValueHeuristic;
-    static BEP* bep;
-    static LcLevelType LcLevel;
-    static bool wcnf;
-    static bool qpbo;
-    static double qpboQuadraticCoefMultiplier;
-
-    static char* varOrder;
-    static int btdMode;
-    static int btdSubTree;
-    static int btdRootCluster;
-
-    static bool maxsateval;
-    static bool xmlflag;
-    static TLogProb markov_log;
-    static string evidence_file;
-    static FILE* solution_uai_file;
-    static string solution_uai_filename;
-    static string problemsaved_filename;
-    static bool isZ;
-    static TLogProb logZ;
-    static TLogProb logU; // upper bound on rejected potentials
-    static TLogProb logepsilon;
-    static bool uaieval;
-    static string stdin_format; // stdin format declaration
-
-    static double startCpuTime;
-
-    static int splitClusterMaxSize;
-    static double boostingBTD;
-    static int maxSeparatorSize;
-    static int minProperVarSize;
-    static int smallSeparatorSize;
-
-    static int Berge_Dec; // flag for berge acyclic decomposition
-    static int nbvar; // initial number of variable (read in the file)
-    static bool learning; // if true, perform pseudoboolean learning
-    static externalfunc timeOut;
-    static bool interrupted;
-    static int seed;
-
-    static string incop_cmd;
-
-    static SearchMethod searchMethod;
-
-    static string clusterFile; // cluster tree decomposition file (without running intersection property)
+    static thread_local int verbose;
+    static thread_local int debug;
+    static thread_local string externalUB;
+    static thread_local int showSolutions;
+    static thread_local char* writeSolution;
+    static thread_local FILE* solutionFile;
+    static thread_local Long allSolutions;
+    static thread_local int dumpWCSP;
+    static thread_local bool approximateCountingBTD;
+    static thread_local bool binaryBranching;
+    static thread_local int dichotomicBranching;
+    static thread_local unsigned int dichotomicBranchingSize;
+    static thread_local bool sortDomains;
+    static thread_local map<int, ValueCost*> sortedDomains;
+    static thread_local bool solutionBasedPhaseSaving;
+    static thread_local int elimDegree;
+    static thread_local int elimDegree_preprocessing;
+    static thread_local int elimDegree_;
+    static thread_local int elimDegree_preprocessing_;
+    static thread_local int elimSpaceMaxMB;
+    static thread_local int minsumDiffusion;
+    static thread_local int preprocessTernaryRPC;
+    static thread_local int preprocessFunctional;
+    static thread_local bool costfuncSeparate;
+    static thread_local int preprocessNary;
+    static thread_local bool QueueComplexity;
+    static thread_local bool Static_variable_ordering; // flag for static variable ordering during search (dynamic ordering is default value)
+    static thread_local bool lastConflict;
+    static thread_local int weightedDegree;
+    static thread_local int weightedTightness;
+    static thread_local bool weightedDegreeCache; // caches the weighted degree of each variable until its cost functions or their conflict weights change
+    static thread_local bool MSTDAC;
+    static thread_local int DEE;
+    static thread_local int DEE_;
+    static thread_local int nbDecisionVars;
+    static thread_local int lds;
+    static thread_local bool limited;
+    static thread_local Long restart;
+    static thread_local externalevent setvalue;
+    static thread_local externalevent setmin;
+    static thread_local externalevent setmax;
+    static thread_local externalevent removevalue;
+    static thread_local externalcostevent setminobj;
+    static thread_local externalsolution newsolution;
+    static thread_local Pedigree* pedigree;
+    static thread_local Haplotype* haplotype;
+    static thread_local string map_file;
+    static thread_local bool cfn;
+    static thread_local bool gz;
+    static thread_local bool xz;
+    static thread_local bool bayesian;
+    static thread_local int uai;
+    static thread_local int resolution;
+    static thread_local TProb errorg;
+    static thread_local TLogProb NormFactor;
+    static thread_local int foundersprob_class;
+    static thread_local vector<TProb> allelefreqdistrib;
+    static thread_local bool consecutiveAllele;
+    static thread_local bool generation;
+    static thread_local int pedigreeCorrectionMode;
+    static thread_local int pedigreePenalty;
+    static thread_local int vac;
+    static thread_local string costThresholdS;
+    static thread_local string costThresholdPreS;
+    static thread_local Cost costThreshold;
+    static thread_local Cost costThresholdPre;
+    static thread_local double trwsAccuracy;
+    static thread_local bool trwsOrder;
+    static thread_local unsigned int trwsNIter;
+    static thread_local unsigned int trwsNIterNoChange;
+    static thread_local unsigned int trwsNIterComputeUb;
+    static thread_local double costMultiplier;
+    static thread_local unsigned int decimalPoint;
+    static thread_local string deltaUbS;
+    static thread_local Cost deltaUb;
+    static thread_local bool singletonConsistency;
+    static thread_local bool vacValueHeuristic;
+    static thread_local BEP* bep;
+    static thread_local LcLevelType LcLevel;
+    static thread_local bool wcnf;
+    static thread_local bool qpbo;
+    static thread_local double qpboQuadraticCoefMultiplier;
+    static thread_local int clauseDatabase; // minimum arity of the wcnf clauses stored in a WeightedClauseDatabase (0 if no database)
+    static thread_local bool binaryFormat; // problem file in binary format (see tb2binformat.hpp)
+
+    static thread_local char* varOrder;
+    static thread_local int btdMode;
+    static thread_local int btdSubTree;
+    static thread_local int btdRootCluster;
+    static thread_local double separatorMemoryMB; // memory limit in MB for the nogoods and #goods recorded on each separator (0 if no limit)
+
+    static thread_local bool maxsateval;
+    static thread_local bool xmlflag;
+    static thread_local TLogProb markov_log;
+    static thread_local string evidence_file;
+    static thread_local FILE* solution_uai_file;
+    static thread_local string solution_uai_filename;
+    static thread_local string problemsaved_filename;
+    static thread_local string binaryDumpFile; // file where the original problem is saved in binary format (empty if none)
+    static thread_local bool isZ;
+    static thread_local TLogProb logZ;
+    static thread_local TLogProb logU; // upper bound on rejected potentials
+    static thread_local TLogProb logepsilon;
+    static thread_local bool uaieval;
+    static thread_local string stdin_format; // stdin format declaration
+
+    static thread_local double startCpuTime;
+
+    static thread_local int splitClusterMaxSize;
+    static thread_local double boostingBTD;
+    static thread_local int maxSeparatorSize;
+    static thread_local int minProperVarSize;
+    static thread_local int smallSeparatorSize;
+
+    static thread_local int Berge_Dec; // flag for berge acyclic decomposition
+    static thread_local int nbvar; // initial number of variable (read in the file)
+    static thread_local bool learning; // if true, perform pseudoboolean learning
+    static thread_local externalfunc timeOut;
+    static std::atomic<bool> interrupted; // shared by all threads
+    static thread_local int seed;
+
+    static thread_local string incop_cmd;
+
+    static thread_local SearchMethod searchMethod;
+
+    static thread_local string clusterFile; // cluster tree decomposition file (without running intersection property)
     static ofstream vnsOutput; // output file for VNS
 
-    static VNSSolutionInitMethod vnsInitSol; // initial solution strategy (search with max discrepancy limit if positive value)
-    static int vnsLDSmin; // discrepancy initial value
-    static int vnsLDSmax; // discrepancy maximum value
-    static VNSInc vnsLDSinc; // discrepancy increment strategy inside VNS
-    static int vnsKmin; // neighborhood initial size
-    static int vnsKmax; // neighborhood maximum size
-    static VNSInc vnsKinc; // neighborhood size increment strategy inside VNS
-
-    static int vnsLDScur; // current discrepancy (used only for debugging display)
-    static int vnsKcur; // current neighborhood size (used only for debugging display)
-    static VNSVariableHeuristic vnsNeighborVarHeur; // variable heuristic to build a neighborhood (used to differentiate VNS/DGVNS)
-    static bool vnsNeighborChange; // true if change neighborhood cluster only when not improved (only in RADGVNS)
-    static bool vnsNeighborSizeSync; // true if neighborhood size is synchronized (only in RADGVNS)
-    static bool vnsParallelLimit; // true if number of parallel slaves limited by number of clusters (only in RSDGVNS and RADGVNS)
-    static bool vnsParallelSync; // true if RSGDVNS else RADGVNS
-    static string vnsOptimumS;
-    static Cost vnsOptimum; // stops VNS if solution found with this cost (or better)
-    static bool vnsParallel; // true if in master/slaves paradigm
-
-    static Long hbfs; // hybrid best-first search mode (used as a limit on the number of backtracks before visiting another open search node)
-    static Long hbfsGlobalLimit; // limit on the number of nodes before stopping the search on the current cluster subtree problem
-    static Long hbfsAlpha; // inverse of minimum node redundancy goal limit
-    static Long hbfsBeta; // inverse of maximum node redundancy goal limit
-    static ptrdiff_t hbfsCPLimit; // limit on the number of choice points stored inside open node list
-    static ptrdiff_t hbfsOpenNodeLimit; // limit on the number of open nodes
-
-    static bool verifyOpt; // if true, for debugging purposes, checks the given optimal solution (problem.sol) is not pruned during search
-    static Cost verifiedOptimum; // for debugging purposes, cost of the given optimal solution
+    static thread_local VNSSolutionInitMethod vnsInitSol; // initial solution strategy (search with max discrepancy limit if positive value)
+    static thread_local int vnsLDSmin; // discrepancy initial value
+    static thread_local int vnsLDSmax; // discrepancy maximum value
+    static thread_local VNSInc vnsLDSinc; // discrepancy increment strategy inside VNS
+    static thread_local int vnsKmin; // neighborhood initial size
+    static thread_local int vnsKmax; // neighborhood maximum size
+    static thread_local VNSInc vnsKinc; // neighborhood size increment strategy inside VNS
+
+    static thread_local int vnsLDScur; // current discrepancy (used only for debugging display)
+    static thread_local int vnsKcur; // current neighborhood size (used only for debugging display)
+    static thread_local VNSVariableHeuristic vnsNeighborVarHeur; // variable heuristic to build a neighborhood (used to differentiate VNS/DGVNS)
+    static thread_local bool vnsNeighborChange; // true if change neighborhood cluster only when not improved (only in RADGVNS)
+    static thread_local bool vnsNeighborSizeSync; // true if neighborhood size is synchronized (only in RADGVNS)
+    static thread_local bool vnsParallelLimit; // true if number of parallel slaves limited by number of clusters (only in RSDGVNS and RADGVNS)
+    static thread_local bool vnsParallelSync; // true if RSGDVNS else RADGVNS
+    static thread_local string vnsOptimumS;
+    static thread_local Cost vnsOptimum; // stops VNS if solution found with this cost (or better)
+    static thread_local bool vnsParallel; // true if in master/slaves paradigm
+
+    static thread_local Long hbfs; // hybrid best-first search mode (used as a limit on the number of backtracks before visiting another open search node)
+    static thread_local Long hbfsGlobalLimit; // limit on the number of nodes before stopping the search on the current cluster subtree problem
+    static thread_local Long hbfsAlpha; // inverse of minimum node redundancy goal limit
+    static thread_local Long hbfsBeta; // inverse of maximum node redundancy goal limit
+    static thread_local ptrdiff_t hbfsCPLimit; // limit on the number of choice points stored inside open node list
+    static thread_local ptrdiff_t hbfsOpenNodeLimit; // limit on the number of open nodes
+
+    static thread_local int portfolio; // number of solver threads running in parallel with diverse configurations (see Portfolio)
+    static thread_local bool hbfsWorkStealing; // if true then solver threads share the open nodes of hybrid best-first search instead of running diverse configurations (see OpenNodePool)
+    static thread_local string checkpointFile; // binary file where the state of hybrid best-first search is periodically saved (empty if none)
+    static thread_local double checkpointPeriod; // minimum CPU time in seconds between two checkpoints
+    static thread_local Long checkpointBacktracks; // if positive, minimum number of backtracks between two checkpoints (replaces checkpointPeriod)
+    static thread_local string resumeFile; // checkpoint file to resume search from (empty if none)
+
+    static thread_local bool verifyOpt; // if true, for debugging purposes, checks the given optimal solution (problem.sol) is not pruned during search
+    static thread_local Cost verifiedOptimum; // for debugging purposes, cost of the given optimal solution
 };
 
 #ifdef INT_COST
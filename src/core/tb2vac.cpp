@@ -34,7 +34,7 @@ bool cmp_function(tVACStat* v1, tVACStat* v2)
 
 VACExtension::VACExtension(WCSP* w)
     : wcsp(w)
-    , VAC2(&Store::storeVariable)
+    , VAC2(&Store::getContext()->storeVariable)
     , nbIterations(0)
     , inconsistentVariable(-1)
 {
@@ -127,7 +127,7 @@ void VACExtension::iniThreshold()
     nearIncVar = NULL;
 }
 
-void VACExtension::nextScaleCost()
+void VACExtension::nextScaleCost(int depth)
 {
     Cost c = MAX_COST;
     bool done = false;
@@ -140,7 +140,7 @@ void VACExtension::nextScaleCost()
     if (!done)
         c = itThreshold / (UNIT_COST + UNIT_COST);
 
-    if (Store::getDepth() == 0) {
+    if (depth == 0) {
         if (c < ToulBar2::costThresholdPre)
             c = MIN_COST;
     } else if (c < ToulBar2::costThreshold)
@@ -153,13 +153,64 @@ void VACExtension::nextScaleCost()
 void VACExtension::reset()
 {
     wcsp->revise(NULL);
-    VACVariable* x;
-    TreeDecomposition* td = wcsp->getTreeDec();
     clear();
     while (!queueP->empty())
         queueP->pop();
     while (!queueR->empty())
         queueR->pop();
+    previousDeletions.swap(deletions);
+    deletions.clear();
+    queueThreshold();
+    //   for (BTQueue::iterator it = VAC2.begin(); it != VAC2.end(); ++it) {
+    //     x = (VACVariable*) (*it);
+    //     if (td) { if(td->isActiveAndInCurrentClusterSubTree(x->getCluster())) x->queueVAC(); }
+    //  else x->queueVAC();
+    //   }
+}
+
+// Bool(P) for a smaller threshold only has more deletions (with the same killers), so Pass1 is resumed from the previous fixpoint:
+// a value may lose all its supports only in a constraint with a variable having a deleted value or a non-null unary cost
+void VACExtension::resume()
+{
+    wcsp->revise(NULL);
+    clear();
+    queueThreshold();
+    for (vector<pair<VACVariable*, Value>>::iterator iter = deletions.begin(); iter != deletions.end(); ++iter) {
+        iter->first->queueVAC();
+    }
+}
+
+// Between two VAC iterations or two search nodes, costs moved by soft arc consistency or Pass3 and the search decisions may invalidate some deletions
+// of the previous Bool(P), so each of them is checked again in deletion order (its killer must still have no support for it) before being done again.
+// Invalid deletions are skipped: every replayed deletion is justified by the current costs and the current Bool(P), so Pass1 ends at the same fixpoint,
+// the variables with a replayed deletion being queued like in resume()
+bool VACExtension::replay()
+{
+    TreeDecomposition* td = wcsp->getTreeDec();
+    for (vector<pair<VACVariable*, Value>>::iterator iter = previousDeletions.begin(); iter != previousDeletions.end(); ++iter) {
+        VACVariable* xi = iter->first;
+        Value v = iter->second;
+        if (xi->assigned() || xi->cannotbe(v) || (td && !td->isActiveAndInCurrentClusterSubTree(xi->getCluster())))
+            continue;
+        if (xi->getVACCost(v) != MIN_COST) {
+            xi->removeVAC(v); // xi is already in the AC2001 queue (see queueThreshold)
+            continue;
+        }
+        VACVariable* xj = (VACVariable*)wcsp->getVar(xi->getKiller(v));
+        if (xj == xi || xj->assigned())
+            continue;
+        BinaryConstraint* c = xi->getConstr(xj);
+        if (c && c->connected() && ((VACBinaryConstraint*)c)->revise(xi, v) && kill(xi, v, xj))
+            return true;
+    }
+    previousDeletions.clear();
+    return false;
+}
+
+void VACExtension::queueThreshold()
+{
+    VACVariable* x;
+    TreeDecomposition* td = wcsp->getTreeDec();
     //  int bucket = cost2log2glb(ToulBar2::costThreshold);
     int bucket = cost2log2glb(itThreshold);
     if (bucket < 0)
@@ -179,11 +230,6 @@ void VACExtension::reset()
             ++iter;
         }
     }
-    //   for (BTQueue::iterator it = VAC2.begin(); it != VAC2.end(); ++it) {
-    //     x = (VACVariable*) (*it);
-    //     if (td) { if(td->isActiveAndInCurrentClusterSubTree(x->getCluster())) x->queueVAC(); }
-    //  else x->queueVAC();
-    //   }
 }
 
 bool VACExtension::propagate()
@@ -202,19 +248,25 @@ bool VACExtension::propagate()
 
     bool isvac = true;
     bool util = true;
+    bool resumed = false; // true if Bool(P) of the previous threshold is kept for the current one
 
     breakCycles = 0;
 
-    static vector<pair<VACVariable*, Value>> acSupport; /// \warning NOT SAFE FOR MULTITHREADING!!!
     bool acSupportOK = false;
 
     while ((!util || isvac) && itThreshold != MIN_COST) {
         minlambda = wcsp->getUb() - wcsp->getLb();
         nbIterations++;
-        reset();
+        if (resumed) {
+            resume();
+            enforcePass1();
+        } else {
+            reset();
+            Store::store();
+            if (!replay())
+                enforcePass1();
+        }
         //		if (ToulBar2::verbose>=8) cout << *wcsp;
-        Store::store();
-        enforcePass1();
         isvac = isVAC();
         if (!isvac && CSP(wcsp->getLb(), wcsp->getUb())) {
             if (ToulBar2::weightedDegree)
@@ -222,8 +274,12 @@ bool VACExtension::propagate()
             throw Contradiction();
         }
         if (ToulBar2::vacValueHeuristic && isvac) {
+            // supports found for a greater threshold are kept if they still belong to Bool(P), else their variable has a new deletion and is in SeekSupport
+            if (!resumed)
+                acSupport.clear();
+            else
+                acSupport.erase(remove_if(acSupport.begin(), acSupport.end(), [](const pair<VACVariable*, Value>& s) { return s.first->cannotbe(s.second); }), acSupport.end());
             acSupportOK = true;
-            acSupport.clear();
             // fill SeekSupport with ALL variables if in preprocessing (i.e. before the search)
             if (Store::getDepth() <= 1 || ToulBar2::debug) {
                 for (unsigned int i = 0;
@@ -255,16 +311,20 @@ bool VACExtension::propagate()
             if (ToulBar2::debug && nbassignedzero > 0)
                 cout << "[" << Store::getDepth() << "] " << nbassignedzero << "/" << nbassigned - nbassignedzero << "/" << wcsp->numberOfUnassignedVariables() << " fixed/singletonnonzerocost/unassigned" << endl;
         }
-        Store::restore();
 
         if (!isvac) {
+            Store::restore();
+            resumed = false;
             enforcePass2();
             if (ToulBar2::verbose > 0)
                 cout << "VAC dual bound: " << std::fixed << std::setprecision(ToulBar2::decimalPoint) << wcsp->getDDualBound() << std::setprecision(DECIMAL_POINT) << "    incvar: " << inconsistentVariable << "    minlambda: " << minlambda << "      itThreshold: " << itThreshold << endl;
             util = enforcePass3();
         } else {
-            nextScaleCost();
+            nextScaleCost(Store::getDepth() - 1);
             //if(nearIncVar) cout << "var: " << nearIncVar->wcspIndex << "  at Cost: " << atThreshold << endl;
+            resumed = (itThreshold != MIN_COST);
+            if (!resumed)
+                Store::restore();
         }
     }
 
@@ -296,9 +356,24 @@ int VACExtension::getHeuristic()
     return -1;
 }
 
+bool VACExtension::kill(VACVariable* xi, Value v, VACVariable* xj)
+{
+    bool wipeout = xi->removeVAC(v);
+    xi->setKiller(v, xj->wcspIndex);
+    xj->killedOne(); // HEUR
+    queueP->push(pair<int, int>(xi->wcspIndex, v));
+    xi->queueVAC();
+    if (ToulBar2::vacValueHeuristic)
+        xi->queueSeekSupport();
+    if (wipeout) {
+        inconsistentVariable = xi->wcspIndex;
+        return true;
+    }
+    return false;
+}
+
 bool VACExtension::enforcePass1(VACVariable* xj, VACBinaryConstraint* cij)
 {
-    bool wipeout = false;
     VACVariable* xi;
     xi = (VACVariable*)cij->getVarDiffFrom(xj);
     for (EnumeratedVariable::iterator it = xi->begin(); it != xi->end();
@@ -307,18 +382,8 @@ bool VACExtension::enforcePass1(VACVariable* xj, VACBinaryConstraint* cij)
         if (xi->getVACCost(v) != MIN_COST) {
             xi->removeVAC(v);
         } // xi->queueVAC(); }
-        else if (cij->revise(xi, v)) {
-            wipeout = xi->removeVAC(v);
-            xi->setKiller(v, xj->wcspIndex);
-            xj->killedOne(); // HEUR
-            queueP->push(pair<int, int>(xi->wcspIndex, v));
-            xi->queueVAC();
-            if (ToulBar2::vacValueHeuristic)
-                xi->queueSeekSupport();
-            if (wipeout) {
-                inconsistentVariable = xi->wcspIndex;
-                return true;
-            }
+        else if (cij->revise(xi, v) && kill(xi, v, xj)) {
+            return true;
         }
     }
     //  if((xi->getDomainSize() == 1) && (!nearIncVar)) {
@@ -37,12 +37,20 @@ private:
 
     void enforcePass1(); /**< Enforces instrumented hard AC (Phase 1) */
     bool enforcePass1(VACVariable* xj, VACBinaryConstraint* cij); /**< Revises /a xj wrt /a cij and updates /a k */
+    bool kill(VACVariable* xi, Value v, VACVariable* xj); /**< Deletes \a v from Bool(P) because it has no support in \a xj, returns true if wipe-out */
+    bool replay(); /**< Deletes again the values of the previous Bool(P) whose deletion is still valid, returns true if wipe-out */
     bool checkPass1() const; /**< Checks if Bool(P) is AC */
     void enforcePass2(); /**< Finds a minimal set of deletions needed for wipeout and computes k and lambda */
     bool enforcePass3(); /**< Project and extends costs to increase c0 according to the plan */
     void enforcePass3VACDecomposition(); /**< Enforces VAC decomposition pass 3 (substract cost and decrease top) */
 
-    void reset(); /**< Cleanup for next iteration: clean Q, selects variables for AC2001 queue */
+    void reset(); /**< Cleanup for next iteration: clean Q, selects variables for AC2001 queue, keeps the deletions of the previous Bool(P) for replay */
+    void resume(); /**< Prepares Pass1 for a smaller threshold starting from the current Bool(P) of the same search node: selects variables for AC2001 queue */
+    void queueThreshold(); /**< Selects unassigned variables with a non-null unary cost for AC2001 queue */
+
+    vector<pair<VACVariable*, Value>> deletions; /**< Values deleted in Bool(P) since the last reset, in deletion order (each value at most once) */
+    vector<pair<VACVariable*, Value>> previousDeletions; /**< Values deleted in the previous Bool(P), possibly at another search node, checked again by replay */
+    vector<pair<VACVariable*, Value>> acSupport; /**< First arc consistent domain values in Bool(P) for the last VAC thresholds (see vacValueHeuristic) */
 
     map<int, tVACStat*> heapAccess;
     vector<tVACStat*> heap;
@@ -73,12 +81,13 @@ public:
     void queueVAC(DLink<VariableWithTimeStamp>* link);
     void queueSeekSupport(DLink<VariableWithTimeStamp>* link);
     void queueVAC2(DLink<Variable*>* link);
+    void deleted(VACVariable* x, Value v) { deletions.push_back(make_pair(x, v)); }
     void dequeueVAC2(DLink<Variable*>* link);
 
     void init();
     void iniThreshold(); /**< Initialize itThreshold to the strongest cost in the cost scale */
     Cost getThreshold() { return itThreshold; }
-    void nextScaleCost(); /**< Sets ItThreshold to the next scale */
+    void nextScaleCost(int depth); /**< Sets ItThreshold to the next scale (\a depth is the current search depth) */
     void histogram(Cost c);
     void histogram(); /**< Computes the ScaleVAC splitting the cost scale in 20 buckets or less */
 
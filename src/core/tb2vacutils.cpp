@@ -72,11 +72,14 @@ bool VACVariable::decreaseVAC(Value newSup)
 
 bool VACVariable::removeVAC(Value v)
 {
+    if (cannotbe(v))
+        return false;
+    vac->deleted(this, v);
     if (v == inf)
         return increaseVAC(v + 1);
     else if (v == sup)
         return decreaseVAC(v - 1);
-    else if (canbe(v))
+    else
         domain.erase(v);
     return false;
 }
@@ -21,10 +21,15 @@ Variable::Variable(WCSP* w, string n, Value iinf, Value isup)
     , pos(-1)
     , inf(iinf)
     , sup(isup)
-    , constrs(&Store::storeConstraint)
+    , constrs(&Store::getContext()->storeConstraint)
     ,
-    //triangles(&Store::storeConstraint),
-    maxCost(MIN_COST)
+    //triangles(&Store::getContext()->storeConstraint),
+    constrsVersion(0)
+    , weightsVersion(0)
+    , wdegConstrsVersion(UINT64_MAX)
+    , wdegWeightsVersion(UINT64_MAX)
+    , wdeg(0)
+    , maxCost(MIN_COST)
     , maxCostValue(iinf)
     , NCBucket(-1)
     , cluster(-1)
@@ -56,6 +61,7 @@ DLink<ConstraintLink>* Variable::link(Constraint* c, int index)
     //    if (c->isTriangle()) triangles.push_back(elt,true);
     //    else
     constrs.push_back(elt, true);
+    constrsVersion = wcsp->newWeightedDegreeVersion();
     return elt;
 }
 
@@ -140,6 +146,7 @@ void Variable::deconnect(DLink<ConstraintLink>* link, bool reuse)
         //        if (link->content.constr->isTriangle()) getTriangles()->erase(link, true);
         //        else
         getConstrs()->erase(link, true);
+        constrsVersion = wcsp->newWeightedDegreeVersion();
 
         if (getDegree() <= ToulBar2::elimDegree_ || (ToulBar2::elimDegree_preprocessing_ >= 0 && (getDegree() <= min(1, ToulBar2::elimDegree_preprocessing_) || getTrueDegree() <= ToulBar2::elimDegree_preprocessing_)))
             queueEliminate();
@@ -151,6 +158,12 @@ void Variable::deconnect(DLink<ConstraintLink>* link, bool reuse)
     }
 }
 
+void Variable::reconnect(DLink<ConstraintLink>* link)
+{
+    getConstrs()->push_back(link, true);
+    constrsVersion = wcsp->newWeightedDegreeVersion();
+}
+
 int Variable::getTrueDegree()
 {
     //	if (constrs.getSize() >= ToulBar2::weightedDegree) return getDegree(); ///\warning returns an approximate degree if the constraint list is too large!
@@ -201,7 +214,21 @@ Double Variable::getMaxElimSize()
     return sz;
 }
 
+/// \note the result is cached until a cost function is connected to or deconnected from this variable or its conflict weight changes (ToulBar2::weightedDegreeCache)
+/// \note a version number restored on backtrack cannot identify a different set of cost functions because new version numbers are never reused
 Long Variable::getWeightedDegree()
+{
+    if (ToulBar2::weightedDegreeCache && wdegConstrsVersion == constrsVersion && wdegWeightsVersion == weightsVersion) {
+        assert(wdeg == getWeightedDegreeNoCache());
+        return wdeg;
+    }
+    wdeg = getWeightedDegreeNoCache();
+    wdegConstrsVersion = constrsVersion;
+    wdegWeightsVersion = weightsVersion;
+    return wdeg;
+}
+
+Long Variable::getWeightedDegreeNoCache()
 {
     Long res = 0;
     for (ConstraintList::iterator iter = constrs.begin(); iter != constrs.end(); ++iter) {
@@ -213,6 +240,11 @@ Long Variable::getWeightedDegree()
     return res;
 }
 
+void Variable::conflictWeightChanged()
+{
+    weightsVersion = wcsp->newWeightedDegreeVersion();
+}
+
 void Variable::resetWeightedDegree()
 {
     for (ConstraintList::iterator iter = constrs.begin(); iter != constrs.end(); ++iter) {
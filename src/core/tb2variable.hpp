@@ -30,6 +30,13 @@ protected:
     ConstraintList constrs;
     //ConstraintList triangles;
 
+    // cached weighted degree (see getWeightedDegree), valid if both versions did not change since it was computed
+    StoreBits constrsVersion; // new version number each time a cost function is added to or removed from constrs (restored on backtrack)
+    uint64_t weightsVersion; // new version number each time the conflict weight of a cost function in constrs changes
+    uint64_t wdegConstrsVersion;
+    uint64_t wdegWeightsVersion;
+    Long wdeg;
+
     // incremental NC data
     StoreCost maxCost;
     StoreValue maxCostValue;
@@ -58,6 +65,7 @@ public:
     string getName() const { return name; }
     void newValueName(const string& vname) { valueNames.push_back(vname); }
     string& getValueName(int idx) { return valueNames[idx]; }
+    unsigned int getNbValueNames() const { return valueNames.size(); }
     int getDACOrder() const { return dac; }
     void setDACOrder(int order) { dac = order; }
     Value getInf() const { return inf; }
@@ -88,7 +96,9 @@ public:
     int getTrueDegree();
     Double getMaxElimSize(); /// \brief returns estimated size of the resulting cost function (including this variable) to eliminate itself
     Long getWeightedDegree();
+    Long getWeightedDegreeNoCache();
     void resetWeightedDegree();
+    void conflictWeightChanged(); ///< \brief invalidates the cached weighted degree
     DLink<ConstraintLink>* link(Constraint* c, int index);
     void sortConstraints();
     virtual void eliminate(){};
@@ -98,6 +108,7 @@ public:
     TernaryConstraint* existTernary();
     double strongLinkedby(Variable*& strvar, TernaryConstraint*& tctr1, TernaryConstraint*& tctr2);
     void deconnect(DLink<ConstraintLink>* link, bool reuse = false);
+    void reconnect(DLink<ConstraintLink>* link);
 
     void projectLB(Cost cost);
 
@@ -33,189 +33,209 @@
 #include "globals/tb2maxconstr.hpp"
 #include "tb2clause.hpp"
 #include "tb2clqcover.hpp"
+#include "utils/tb2binformat.hpp"
+#include "utils/tb2tensor.hpp"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 /*
  * Global variables with their default value
  *
  */
 
-int Store::depth = 0;
-StoreStack<BTList<Value>, DLink<Value>*> Store::storeDomain(STORE_SIZE);
-StoreStack<BTList<ConstraintLink>, DLink<ConstraintLink>*> Store::storeConstraint(STORE_SIZE);
-StoreStack<BTList<Variable*>, DLink<Variable*>*> Store::storeVariable(STORE_SIZE);
-StoreStack<BTList<Separator*>, DLink<Separator*>*> Store::storeSeparator(STORE_SIZE);
-
-int WCSP::wcspCounter = 0;
-
-int ToulBar2::verbose;
-int ToulBar2::debug;
-string ToulBar2::externalUB;
-int ToulBar2::showSolutions;
-char* ToulBar2::writeSolution;
-FILE* ToulBar2::solutionFile;
-Long ToulBar2::allSolutions;
-int ToulBar2::dumpWCSP;
-bool ToulBar2::approximateCountingBTD;
-int ToulBar2::elimDegree;
-int ToulBar2::elimDegree_preprocessing;
-int ToulBar2::elimDegree_;
-int ToulBar2::elimDegree_preprocessing_;
-int ToulBar2::elimSpaceMaxMB;
-int ToulBar2::preprocessTernaryRPC;
-int ToulBar2::preprocessFunctional;
-bool ToulBar2::costfuncSeparate;
-int ToulBar2::preprocessNary;
-LcLevelType ToulBar2::LcLevel;
-bool ToulBar2::QueueComplexity;
-bool ToulBar2::binaryBranching;
-bool ToulBar2::lastConflict;
-int ToulBar2::dichotomicBranching;
-unsigned int ToulBar2::dichotomicBranchingSize;
-bool ToulBar2::sortDomains;
-map<int, ValueCost*> ToulBar2::sortedDomains;
-bool ToulBar2::solutionBasedPhaseSaving;
-int ToulBar2::lds;
-bool ToulBar2::limited;
-Long ToulBar2::restart;
-bool ToulBar2::generation;
-int ToulBar2::minsumDiffusion;
-bool ToulBar2::Static_variable_ordering;
-int ToulBar2::weightedDegree;
-int ToulBar2::weightedTightness;
-bool ToulBar2::MSTDAC;
-int ToulBar2::DEE;
-int ToulBar2::DEE_;
-int ToulBar2::nbDecisionVars;
-bool ToulBar2::singletonConsistency;
-bool ToulBar2::vacValueHeuristic;
-
-externalevent ToulBar2::setvalue;
-externalevent ToulBar2::setmin;
-externalevent ToulBar2::setmax;
-externalevent ToulBar2::removevalue;
-externalcostevent ToulBar2::setminobj;
-externalsolution ToulBar2::newsolution;
-Pedigree* ToulBar2::pedigree;
-Haplotype* ToulBar2::haplotype;
-
-bool ToulBar2::cfn;
-bool ToulBar2::gz;
-bool ToulBar2::xz;
-bool ToulBar2::bayesian;
-int ToulBar2::uai;
-string ToulBar2::evidence_file;
-string ToulBar2::stdin_format;
-FILE* ToulBar2::solution_uai_file;
-string ToulBar2::solution_uai_filename;
-string ToulBar2::problemsaved_filename;
-TLogProb ToulBar2::markov_log;
-bool ToulBar2::xmlflag;
-string ToulBar2::map_file;
-bool ToulBar2::maxsateval;
-bool ToulBar2::uaieval;
-
-int ToulBar2::resolution;
-TProb ToulBar2::errorg;
-TLogProb ToulBar2::NormFactor;
+thread_local StoreContext* Store::current = NULL;
+thread_local StoreContext* Store::defaultContext = NULL;
+
+StoreContext* Store::getDefaultContext()
+{
+    static thread_local StoreContext context(STORE_SIZE);
+    defaultContext = &context;
+    return &context;
+}
+
+std::atomic<int> WCSP::wcspCounter(0);
+
+thread_local int ToulBar2::verbose;
+thread_local int ToulBar2::debug;
+thread_local string ToulBar2::externalUB;
+thread_local int ToulBar2::showSolutions;
+thread_local char* ToulBar2::writeSolution;
+thread_local FILE* ToulBar2::solutionFile;
+thread_local Long ToulBar2::allSolutions;
+thread_local int ToulBar2::dumpWCSP;
+thread_local bool ToulBar2::approximateCountingBTD;
+thread_local int ToulBar2::elimDegree;
+thread_local int ToulBar2::elimDegree_preprocessing;
+thread_local int ToulBar2::elimDegree_;
+thread_local int ToulBar2::elimDegree_preprocessing_;
+thread_local int ToulBar2::elimSpaceMaxMB;
+thread_local int ToulBar2::preprocessTernaryRPC;
+thread_local int ToulBar2::preprocessFunctional;
+thread_local bool ToulBar2::costfuncSeparate;
+thread_local int ToulBar2::preprocessNary;
+thread_local LcLevelType ToulBar2::LcLevel;
+thread_local bool ToulBar2::QueueComplexity;
+thread_local bool ToulBar2::binaryBranching;
+thread_local bool ToulBar2::lastConflict;
+thread_local int ToulBar2::dichotomicBranching;
+thread_local unsigned int ToulBar2::dichotomicBranchingSize;
+thread_local bool ToulBar2::sortDomains;
+thread_local map<int, ValueCost*> ToulBar2::sortedDomains;
+thread_local bool ToulBar2::solutionBasedPhaseSaving;
+thread_local int ToulBar2::lds;
+thread_local bool ToulBar2::limited;
+thread_local Long ToulBar2::restart;
+thread_local bool ToulBar2::generation;
+thread_local int ToulBar2::minsumDiffusion;
+thread_local bool ToulBar2::Static_variable_ordering;
+thread_local int ToulBar2::weightedDegree;
+thread_local int ToulBar2::weightedTightness;
+thread_local bool ToulBar2::weightedDegreeCache;
+thread_local bool ToulBar2::MSTDAC;
+thread_local int ToulBar2::DEE;
+thread_local int ToulBar2::DEE_;
+thread_local int ToulBar2::nbDecisionVars;
+thread_local bool ToulBar2::singletonConsistency;
+thread_local bool ToulBar2::vacValueHeuristic;
+
+thread_local externalevent ToulBar2::setvalue;
+thread_local externalevent ToulBar2::setmin;
+thread_local externalevent ToulBar2::setmax;
+thread_local externalevent ToulBar2::removevalue;
+thread_local externalcostevent ToulBar2::setminobj;
+thread_local externalsolution ToulBar2::newsolution;
+thread_local Pedigree* ToulBar2::pedigree;
+thread_local Haplotype* ToulBar2::haplotype;
+
+thread_local bool ToulBar2::cfn;
+thread_local bool ToulBar2::gz;
+thread_local bool ToulBar2::xz;
+thread_local bool ToulBar2::bayesian;
+thread_local int ToulBar2::uai;
+thread_local string ToulBar2::evidence_file;
+thread_local string ToulBar2::stdin_format;
+thread_local FILE* ToulBar2::solution_uai_file;
+thread_local string ToulBar2::solution_uai_filename;
+thread_local string ToulBar2::problemsaved_filename;
+thread_local string ToulBar2::binaryDumpFile;
+thread_local TLogProb ToulBar2::markov_log;
+thread_local bool ToulBar2::xmlflag;
+thread_local string ToulBar2::map_file;
+thread_local bool ToulBar2::maxsateval;
+thread_local bool ToulBar2::uaieval;
+
+thread_local int ToulBar2::resolution;
+thread_local TProb ToulBar2::errorg;
+thread_local TLogProb ToulBar2::NormFactor;
 /// Allele frequencies of founders
 /// - 0: 			equal frequencies
 /// - 1: 			probs depending on the frequencies found in the problem
 /// - otherwise:  read probability distribution from command line
-int ToulBar2::foundersprob_class;
-vector<TProb> ToulBar2::allelefreqdistrib;
-bool ToulBar2::consecutiveAllele;
-int ToulBar2::pedigreeCorrectionMode;
-int ToulBar2::pedigreePenalty;
-
-int ToulBar2::vac;
-Cost ToulBar2::costThreshold;
-Cost ToulBar2::costThresholdPre;
-string ToulBar2::costThresholdS;
-string ToulBar2::costThresholdPreS;
-double ToulBar2::trwsAccuracy;
-bool ToulBar2::trwsOrder;
-unsigned int ToulBar2::trwsNIter;
-unsigned int ToulBar2::trwsNIterNoChange;
-unsigned int ToulBar2::trwsNIterComputeUb;
-double ToulBar2::costMultiplier;
-unsigned int ToulBar2::decimalPoint;
-string ToulBar2::deltaUbS;
-Cost ToulBar2::deltaUb;
-
-BEP* ToulBar2::bep;
-bool ToulBar2::wcnf;
-bool ToulBar2::qpbo;
-double ToulBar2::qpboQuadraticCoefMultiplier;
-
-char* ToulBar2::varOrder;
-int ToulBar2::btdMode;
-int ToulBar2::btdSubTree;
-int ToulBar2::btdRootCluster;
-
-double ToulBar2::startCpuTime;
-
-int ToulBar2::splitClusterMaxSize;
-double ToulBar2::boostingBTD;
-int ToulBar2::maxSeparatorSize;
-int ToulBar2::minProperVarSize;
-
-int ToulBar2::smallSeparatorSize;
-
-bool ToulBar2::isZ;
-TLogProb ToulBar2::logZ;
-TLogProb ToulBar2::logU;
-TLogProb ToulBar2::logepsilon;
-int ToulBar2::Berge_Dec = 0; // berge decomposition flag  > 0 if wregular found in the problem
-int ToulBar2::nbvar = 0; // berge decomposition flag  > 0 if wregular found in the problem
-
-externalfunc ToulBar2::timeOut;
-bool ToulBar2::interrupted;
-
-bool ToulBar2::learning;
-
-int ToulBar2::seed;
-
-string ToulBar2::incop_cmd;
-
-string ToulBar2::clusterFile;
+thread_local int ToulBar2::foundersprob_class;
+thread_local vector<TProb> ToulBar2::allelefreqdistrib;
+thread_local bool ToulBar2::consecutiveAllele;
+thread_local int ToulBar2::pedigreeCorrectionMode;
+thread_local int ToulBar2::pedigreePenalty;
+
+thread_local int ToulBar2::vac;
+thread_local Cost ToulBar2::costThreshold;
+thread_local Cost ToulBar2::costThresholdPre;
+thread_local string ToulBar2::costThresholdS;
+thread_local string ToulBar2::costThresholdPreS;
+thread_local double ToulBar2::trwsAccuracy;
+thread_local bool ToulBar2::trwsOrder;
+thread_local unsigned int ToulBar2::trwsNIter;
+thread_local unsigned int ToulBar2::trwsNIterNoChange;
+thread_local unsigned int ToulBar2::trwsNIterComputeUb;
+thread_local double ToulBar2::costMultiplier;
+thread_local unsigned int ToulBar2::decimalPoint;
+thread_local string ToulBar2::deltaUbS;
+thread_local Cost ToulBar2::deltaUb;
+
+thread_local BEP* ToulBar2::bep;
+thread_local bool ToulBar2::wcnf;
+thread_local bool ToulBar2::qpbo;
+thread_local bool ToulBar2::binaryFormat;
+thread_local double ToulBar2::qpboQuadraticCoefMultiplier;
+thread_local int ToulBar2::clauseDatabase;
+
+thread_local char* ToulBar2::varOrder;
+thread_local int ToulBar2::btdMode;
+thread_local int ToulBar2::btdSubTree;
+thread_local int ToulBar2::btdRootCluster;
+thread_local double ToulBar2::separatorMemoryMB;
+
+thread_local double ToulBar2::startCpuTime;
+
+thread_local int ToulBar2::splitClusterMaxSize;
+thread_local double ToulBar2::boostingBTD;
+thread_local int ToulBar2::maxSeparatorSize;
+thread_local int ToulBar2::minProperVarSize;
+
+thread_local int ToulBar2::smallSeparatorSize;
+
+thread_local bool ToulBar2::isZ;
+thread_local TLogProb ToulBar2::logZ;
+thread_local TLogProb ToulBar2::logU;
+thread_local TLogProb ToulBar2::logepsilon;
+thread_local int ToulBar2::Berge_Dec = 0; // berge decomposition flag  > 0 if wregular found in the problem
+thread_local int ToulBar2::nbvar = 0; // berge decomposition flag  > 0 if wregular found in the problem
+
+thread_local externalfunc ToulBar2::timeOut;
+std::atomic<bool> ToulBar2::interrupted;
+
+thread_local bool ToulBar2::learning;
+
+thread_local int ToulBar2::seed;
+
+thread_local string ToulBar2::incop_cmd;
+
+thread_local string ToulBar2::clusterFile;
 ofstream ToulBar2::vnsOutput;
 
-SearchMethod ToulBar2::searchMethod;
-
-VNSSolutionInitMethod ToulBar2::vnsInitSol;
-int ToulBar2::vnsLDSmin;
-int ToulBar2::vnsLDSmax;
-VNSInc ToulBar2::vnsLDSinc;
-int ToulBar2::vnsKmin;
-int ToulBar2::vnsKmax;
-VNSInc ToulBar2::vnsKinc;
-
-int ToulBar2::vnsLDScur;
-int ToulBar2::vnsKcur;
-VNSVariableHeuristic ToulBar2::vnsNeighborVarHeur;
-bool ToulBar2::vnsNeighborChange;
-bool ToulBar2::vnsNeighborSizeSync;
-bool ToulBar2::vnsParallelLimit;
-bool ToulBar2::vnsParallelSync;
-string ToulBar2::vnsOptimumS;
-Cost ToulBar2::vnsOptimum;
-bool ToulBar2::vnsParallel;
-
-Long ToulBar2::hbfs;
-Long ToulBar2::hbfsGlobalLimit;
-Long ToulBar2::hbfsAlpha; // inverse of minimum node redundancy goal limit
-Long ToulBar2::hbfsBeta; // inverse of maximum node redundancy goal limit
-ptrdiff_t ToulBar2::hbfsCPLimit; // limit on the number of choice points stored inside open node list
-ptrdiff_t ToulBar2::hbfsOpenNodeLimit; // limit on the number of open nodes
-
-bool ToulBar2::verifyOpt;
-Cost ToulBar2::verifiedOptimum;
+thread_local SearchMethod ToulBar2::searchMethod;
+
+thread_local VNSSolutionInitMethod ToulBar2::vnsInitSol;
+thread_local int ToulBar2::vnsLDSmin;
+thread_local int ToulBar2::vnsLDSmax;
+thread_local VNSInc ToulBar2::vnsLDSinc;
+thread_local int ToulBar2::vnsKmin;
+thread_local int ToulBar2::vnsKmax;
+thread_local VNSInc ToulBar2::vnsKinc;
+
+thread_local int ToulBar2::vnsLDScur;
+thread_local int ToulBar2::vnsKcur;
+thread_local VNSVariableHeuristic ToulBar2::vnsNeighborVarHeur;
+thread_local bool ToulBar2::vnsNeighborChange;
+thread_local bool ToulBar2::vnsNeighborSizeSync;
+thread_local bool ToulBar2::vnsParallelLimit;
+thread_local bool ToulBar2::vnsParallelSync;
+thread_local string ToulBar2::vnsOptimumS;
+thread_local Cost ToulBar2::vnsOptimum;
+thread_local bool ToulBar2::vnsParallel;
+
+thread_local Long ToulBar2::hbfs;
+thread_local Long ToulBar2::hbfsGlobalLimit;
+thread_local Long ToulBar2::hbfsAlpha; // inverse of minimum node redundancy goal limit
+thread_local Long ToulBar2::hbfsBeta; // inverse of maximum node redundancy goal limit
+thread_local ptrdiff_t ToulBar2::hbfsCPLimit; // limit on the number of choice points stored inside open node list
+thread_local ptrdiff_t ToulBar2::hbfsOpenNodeLimit; // limit on the number of open nodes
+
+thread_local int ToulBar2::portfolio;
+thread_local bool ToulBar2::hbfsWorkStealing;
+thread_local string ToulBar2::checkpointFile;
+thread_local double ToulBar2::checkpointPeriod;
+thread_local Long ToulBar2::checkpointBacktracks;
+thread_local string ToulBar2::resumeFile;
+
+thread_local bool ToulBar2::verifyOpt;
+thread_local Cost ToulBar2::verifiedOptimum;
 
 /// \brief initialization of ToulBar2 global variables needed by numberjack/toulbar2
 void tb2init()
 {
-    Store::depth = 0;
-
     ToulBar2::stdin_format = "";
     ToulBar2::externalUB = "";
     ToulBar2::verbose = 0;
@@ -251,6 +271,7 @@ void tb2init()
     ToulBar2::Static_variable_ordering = false;
     ToulBar2::weightedDegree = 1000000;
     ToulBar2::weightedTightness = 0;
+    ToulBar2::weightedDegreeCache = true;
     ToulBar2::MSTDAC = false;
     ToulBar2::DEE = 1;
     ToulBar2::DEE_ = 0;
@@ -275,6 +296,7 @@ void tb2init()
     ToulBar2::solution_uai_file = NULL;
     ToulBar2::solution_uai_filename = "sol";
     ToulBar2::problemsaved_filename = "problem.wcsp";
+    ToulBar2::binaryDumpFile = "";
     ToulBar2::markov_log = 0;
     ToulBar2::xmlflag = false;
     ToulBar2::maxsateval = false;
@@ -306,12 +328,15 @@ void tb2init()
     ToulBar2::bep = NULL;
     ToulBar2::wcnf = false;
     ToulBar2::qpbo = false;
+    ToulBar2::binaryFormat = false;
     ToulBar2::qpboQuadraticCoefMultiplier = 2.;
+    ToulBar2::clauseDatabase = 0;
 
     ToulBar2::varOrder = NULL;
     ToulBar2::btdMode = 0;
     ToulBar2::btdSubTree = -1;
     ToulBar2::btdRootCluster = -1;
+    ToulBar2::separatorMemoryMB = 0;
 
     ToulBar2::startCpuTime = 0;
 
@@ -371,6 +396,219 @@ void tb2init()
 
     ToulBar2::verifyOpt = false;
     ToulBar2::verifiedOptimum = MAX_COST;
+
+    ToulBar2::portfolio = 1;
+    ToulBar2::hbfsWorkStealing = false;
+    ToulBar2::checkpointFile = "";
+    ToulBar2::checkpointPeriod = 60;
+    ToulBar2::checkpointBacktracks = 0;
+    ToulBar2::resumeFile = "";
+}
+
+/*
+ * Copy of ToulBar2 global variables from one thread to another
+ *
+ */
+
+class OptionsGetter {
+    vector<const void*>& options;
+
+public:
+    OptionsGetter(vector<const void*>& options_)
+        : options(options_)
+    {
+    }
+
+    template <class T>
+    void operator()(T& x) { options.push_back(&x); }
+};
+
+class OptionsSetter {
+    const vector<const void*>& options;
+    size_t pos;
+
+public:
+    OptionsSetter(const vector<const void*>& options_)
+        : options(options_)
+        , pos(0)
+    {
+    }
+
+    template <class T>
+    void operator()(T& x)
+    {
+        assert(pos < options.size());
+        x = *static_cast<const T*>(options[pos++]);
+    }
+};
+
+/// \brief applies \a f to every thread-local ToulBar2 global variable, always in the same order
+template <class F>
+static void forEachOption(F& f)
+{
+    f(ToulBar2::verbose);
+    f(ToulBar2::debug);
+    f(ToulBar2::externalUB);
+    f(ToulBar2::showSolutions);
+    f(ToulBar2::writeSolution);
+    f(ToulBar2::solutionFile);
+    f(ToulBar2::allSolutions);
+    f(ToulBar2::dumpWCSP);
+    f(ToulBar2::approximateCountingBTD);
+    f(ToulBar2::binaryBranching);
+    f(ToulBar2::dichotomicBranching);
+    f(ToulBar2::dichotomicBranchingSize);
+    f(ToulBar2::sortDomains);
+    f(ToulBar2::sortedDomains);
+    f(ToulBar2::solutionBasedPhaseSaving);
+    f(ToulBar2::elimDegree);
+    f(ToulBar2::elimDegree_preprocessing);
+    f(ToulBar2::elimDegree_);
+    f(ToulBar2::elimDegree_preprocessing_);
+    f(ToulBar2::elimSpaceMaxMB);
+    f(ToulBar2::minsumDiffusion);
+    f(ToulBar2::preprocessTernaryRPC);
+    f(ToulBar2::preprocessFunctional);
+    f(ToulBar2::costfuncSeparate);
+    f(ToulBar2::preprocessNary);
+    f(ToulBar2::QueueComplexity);
+    f(ToulBar2::Static_variable_ordering);
+    f(ToulBar2::lastConflict);
+    f(ToulBar2::weightedDegree);
+    f(ToulBar2::weightedTightness);
+    f(ToulBar2::weightedDegreeCache);
+    f(ToulBar2::MSTDAC);
+    f(ToulBar2::DEE);
+    f(ToulBar2::DEE_);
+    f(ToulBar2::nbDecisionVars);
+    f(ToulBar2::lds);
+    f(ToulBar2::limited);
+    f(ToulBar2::restart);
+    f(ToulBar2::setvalue);
+    f(ToulBar2::setmin);
+    f(ToulBar2::setmax);
+    f(ToulBar2::removevalue);
+    f(ToulBar2::setminobj);
+    f(ToulBar2::newsolution);
+    f(ToulBar2::pedigree);
+    f(ToulBar2::haplotype);
+    f(ToulBar2::map_file);
+    f(ToulBar2::cfn);
+    f(ToulBar2::gz);
+    f(ToulBar2::xz);
+    f(ToulBar2::bayesian);
+    f(ToulBar2::uai);
+    f(ToulBar2::resolution);
+    f(ToulBar2::errorg);
+    f(ToulBar2::NormFactor);
+    f(ToulBar2::foundersprob_class);
+    f(ToulBar2::allelefreqdistrib);
+    f(ToulBar2::consecutiveAllele);
+    f(ToulBar2::generation);
+    f(ToulBar2::pedigreeCorrectionMode);
+    f(ToulBar2::pedigreePenalty);
+    f(ToulBar2::vac);
+    f(ToulBar2::costThresholdS);
+    f(ToulBar2::costThresholdPreS);
+    f(ToulBar2::costThreshold);
+    f(ToulBar2::costThresholdPre);
+    f(ToulBar2::trwsAccuracy);
+    f(ToulBar2::trwsOrder);
+    f(ToulBar2::trwsNIter);
+    f(ToulBar2::trwsNIterNoChange);
+    f(ToulBar2::trwsNIterComputeUb);
+    f(ToulBar2::costMultiplier);
+    f(ToulBar2::decimalPoint);
+    f(ToulBar2::deltaUbS);
+    f(ToulBar2::deltaUb);
+    f(ToulBar2::singletonConsistency);
+    f(ToulBar2::vacValueHeuristic);
+    f(ToulBar2::bep);
+    f(ToulBar2::LcLevel);
+    f(ToulBar2::wcnf);
+    f(ToulBar2::qpbo);
+    f(ToulBar2::binaryFormat);
+    f(ToulBar2::qpboQuadraticCoefMultiplier);
+    f(ToulBar2::clauseDatabase);
+    f(ToulBar2::varOrder);
+    f(ToulBar2::btdMode);
+    f(ToulBar2::btdSubTree);
+    f(ToulBar2::btdRootCluster);
+    f(ToulBar2::separatorMemoryMB);
+    f(ToulBar2::maxsateval);
+    f(ToulBar2::xmlflag);
+    f(ToulBar2::markov_log);
+    f(ToulBar2::evidence_file);
+    f(ToulBar2::solution_uai_file);
+    f(ToulBar2::solution_uai_filename);
+    f(ToulBar2::problemsaved_filename);
+    f(ToulBar2::binaryDumpFile);
+    f(ToulBar2::isZ);
+    f(ToulBar2::logZ);
+    f(ToulBar2::logU);
+    f(ToulBar2::logepsilon);
+    f(ToulBar2::uaieval);
+    f(ToulBar2::stdin_format);
+    f(ToulBar2::startCpuTime);
+    f(ToulBar2::splitClusterMaxSize);
+    f(ToulBar2::boostingBTD);
+    f(ToulBar2::maxSeparatorSize);
+    f(ToulBar2::minProperVarSize);
+    f(ToulBar2::smallSeparatorSize);
+    f(ToulBar2::Berge_Dec);
+    f(ToulBar2::nbvar);
+    f(ToulBar2::learning);
+    f(ToulBar2::timeOut);
+    f(ToulBar2::seed);
+    f(ToulBar2::incop_cmd);
+    f(ToulBar2::searchMethod);
+    f(ToulBar2::clusterFile);
+    f(ToulBar2::vnsInitSol);
+    f(ToulBar2::vnsLDSmin);
+    f(ToulBar2::vnsLDSmax);
+    f(ToulBar2::vnsLDSinc);
+    f(ToulBar2::vnsKmin);
+    f(ToulBar2::vnsKmax);
+    f(ToulBar2::vnsKinc);
+    f(ToulBar2::vnsLDScur);
+    f(ToulBar2::vnsKcur);
+    f(ToulBar2::vnsNeighborVarHeur);
+    f(ToulBar2::vnsNeighborChange);
+    f(ToulBar2::vnsNeighborSizeSync);
+    f(ToulBar2::vnsParallelLimit);
+    f(ToulBar2::vnsParallelSync);
+    f(ToulBar2::vnsOptimumS);
+    f(ToulBar2::vnsOptimum);
+    f(ToulBar2::vnsParallel);
+    f(ToulBar2::hbfs);
+    f(ToulBar2::hbfsGlobalLimit);
+    f(ToulBar2::hbfsAlpha);
+    f(ToulBar2::hbfsBeta);
+    f(ToulBar2::hbfsCPLimit);
+    f(ToulBar2::hbfsOpenNodeLimit);
+    f(ToulBar2::portfolio);
+    f(ToulBar2::hbfsWorkStealing);
+    f(ToulBar2::checkpointFile);
+    f(ToulBar2::checkpointPeriod);
+    f(ToulBar2::checkpointBacktracks);
+    f(ToulBar2::resumeFile);
+    f(ToulBar2::verifyOpt);
+    f(ToulBar2::verifiedOptimum);
+}
+
+/// \brief collects the addresses of ToulBar2 global variables of the calling thread
+void tb2getOptions(vector<const void*>& options)
+{
+    options.clear();
+    OptionsGetter getter(options);
+    forEachOption(getter);
+}
+
+/// \brief copies ToulBar2 global variables collected by ::tb2getOptions into the calling thread
+void tb2setOptions(const vector<const void*>& options)
+{
+    OptionsSetter setter(options);
+    forEachOption(setter);
 }
 
 /// \brief checks compatibility between selected options of ToulBar2 needed by numberjack/toulbar2
@@ -491,6 +729,14 @@ void tb2checkOptions()
         ToulBar2::elimDegree = -1;
         ToulBar2::elimDegree_preprocessing = -1;
     }
+    if (ToulBar2::clauseDatabase && ToulBar2::btdMode >= 1) {
+        cerr << "Error: BTD-like search methods are not compatible with a clause database. Deactivate either '-B' or '-wcl'" << endl;
+        exit(1);
+    }
+    if (ToulBar2::clauseDatabase && ToulBar2::elimDegree_preprocessing >= 0) {
+        cout << "Warning! Cannot perform generic variable elimination with a clause database." << endl;
+        ToulBar2::elimDegree_preprocessing = -1;
+    }
     if (ToulBar2::verifyOpt && ToulBar2::preprocessFunctional > 0) {
         cout << "Warning! Cannot perform functional elimination while verifying that the optimal solution is preserved." << endl;
         ToulBar2::preprocessFunctional = 0;
@@ -499,6 +745,30 @@ void tb2checkOptions()
         cout << "Warning! Cannot perform dead-end elimination while verifying that the optimal solution is preserved." << endl;
         ToulBar2::DEE = 0;
     }
+    if (ToulBar2::portfolio > 1 && (ToulBar2::allSolutions || ToulBar2::isZ || ToulBar2::approximateCountingBTD)) {
+        cerr << "Error: cannot find all solutions or compute a partition function with a parallel portfolio (remove -para option)." << endl;
+        exit(1);
+    }
+#ifdef OPENMPI
+    if (ToulBar2::portfolio > 1 && ToulBar2::searchMethod != DFBB) {
+#else
+    if (ToulBar2::portfolio > 1 && ToulBar2::searchMethod != DFBB && !ToulBar2::vnsParallel) {
+#endif
+        cerr << "Error: parallel portfolio not compatible with VNS. Deactivate either '-para' or '-vns'" << endl;
+        exit(1);
+    }
+    if (ToulBar2::portfolio > 1 && (ToulBar2::pedigree || ToulBar2::haplotype || ToulBar2::bep || ToulBar2::xmlflag || ToulBar2::stdin_format.length() > 0)) {
+        cerr << "Error: parallel portfolio not implemented for this file format or for reading from a pipe (remove -para option)." << endl;
+        exit(1);
+    }
+    if (ToulBar2::portfolio > 1 && ToulBar2::hbfsWorkStealing && (!ToulBar2::hbfs || ToulBar2::btdMode >= 1 || ToulBar2::restart >= 0 || ToulBar2::lds)) {
+        cerr << "Error: parallel hybrid best-first search with work stealing requires HBFS without tree decomposition, restarts, and LDS (remove -ws option)." << endl;
+        exit(1);
+    }
+    if ((ToulBar2::checkpointFile.size() > 0 || ToulBar2::resumeFile.size() > 0) && (!ToulBar2::hbfs || ToulBar2::btdMode >= 1 || ToulBar2::restart >= 0 || ToulBar2::lds || ToulBar2::portfolio > 1 || ToulBar2::searchMethod != DFBB || ToulBar2::allSolutions || ToulBar2::isZ)) {
+        cerr << "Error: checkpoints require sequential HBFS optimization without tree decomposition, restarts, LDS, and VNS (remove -checkpoint and -resume options)." << endl;
+        exit(1);
+    }
 }
 
 /*
@@ -514,8 +784,8 @@ WCSP::WCSP(Cost upperBound, void* _solver_)
     , negCost(MIN_COST)
     , solutionCost(MAX_COST)
     , NCBucketSize(cost2log2gub(upperBound) + 1)
-    , NCBuckets(NCBucketSize, VariableList(&Store::storeVariable))
-    , PendingSeparator(&Store::storeSeparator)
+    , NCBuckets(NCBucketSize, VariableList(&Store::getContext()->storeVariable))
+    , PendingSeparator(&Store::getContext()->storeSeparator)
     , objectiveChanged(false)
     , nbNodes(0)
     , nbDEE(0)
@@ -530,6 +800,7 @@ WCSP::WCSP(Cost upperBound, void* _solver_)
     ,
 #endif
     isPartOfOptimalSolution(0)
+    , lastWeightedDegreeVersion(0)
     , elimOrder(0)
     , elimBinOrder(0)
     , elimTernOrder(0)
@@ -2441,6 +2712,123 @@ void WCSP::dump(ostream& os, bool original)
     }
 }
 
+/// \note only binary, ternary, and n-ary cost functions in extension, weighted clauses, and monolithic global cost functions can be saved
+void WCSP::dumpBinary(ostream& os)
+{
+    vector<Constraint*> ctrs;
+    for (unsigned int i = 0; i < constrs.size(); i++)
+        if (constrs[i]->connected() && !constrs[i]->isSep())
+            ctrs.push_back(constrs[i]);
+    for (int i = 0; i < elimBinOrder; i++)
+        if (elimBinConstrs[i]->connected() && !elimBinConstrs[i]->isSep())
+            ctrs.push_back(elimBinConstrs[i]);
+    for (int i = 0; i < elimTernOrder; i++)
+        if (elimTernConstrs[i]->connected() && !elimTernConstrs[i]->isSep())
+            ctrs.push_back(elimTernConstrs[i]);
+
+    BinaryProblemWriter writer(os);
+    BinaryProblemHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BinaryProblemMagic, sizeof(header.magic));
+    header.version = BinaryProblemVersion;
+    header.costSize = sizeof(Cost);
+    header.nbvars = vars.size();
+    header.nbctrs = ctrs.size();
+    header.decimalPoint = ToulBar2::decimalPoint;
+    header.ub = getUb();
+    header.lb = getLb();
+    header.negCost = getNegativeLb();
+    header.costMultiplier = ToulBar2::costMultiplier;
+    writer.write(header);
+
+    vector<Value> values;
+    vector<Cost> costs;
+    for (unsigned int i = 0; i < vars.size(); i++) {
+        if (vars[i]->enumerated()) {
+            EnumeratedVariable* x = (EnumeratedVariable*)vars[i];
+            unsigned int domsize = x->getDomainInitSize();
+            writer.write((unsigned int)BIN_ENUMERATED);
+            writer.writeString(x->getName());
+            writer.write(domsize);
+            values.clear();
+            costs.clear();
+            for (unsigned int a = 0; a < domsize; a++) {
+                Value v = x->toValue(a);
+                values.push_back(v);
+                costs.push_back(x->canbe(v) ? x->getCost(v) : getUb());
+            }
+            writer.writeArray(values.data(), domsize);
+            writer.write(x->getNbValueNames());
+            for (unsigned int a = 0; a < x->getNbValueNames(); a++)
+                writer.writeString(x->getValueName(a));
+            writer.writeArray(costs.data(), domsize);
+        } else {
+            writer.write((unsigned int)BIN_INTERVAL);
+            writer.writeString(vars[i]->getName());
+            writer.write(vars[i]->getInf());
+            writer.write(vars[i]->getSup());
+        }
+    }
+
+    for (unsigned int c = 0; c < ctrs.size(); c++) {
+        Constraint* ctr = ctrs[c];
+        int arity = ctr->arity();
+        vector<int> scope(arity);
+        for (int i = 0; i < arity; i++)
+            scope[i] = ctr->getVar(i)->wcspIndex;
+        if (ctr->isBinary() || ctr->isTernary()) {
+            EnumeratedVariable* x = (EnumeratedVariable*)ctr->getVar(0);
+            EnumeratedVariable* y = (EnumeratedVariable*)ctr->getVar(1);
+            EnumeratedVariable* z = (arity == 3) ? (EnumeratedVariable*)ctr->getVar(2) : NULL;
+            costs.clear();
+            for (unsigned int a = 0; a < x->getDomainInitSize(); a++) {
+                Value vx = x->toValue(a);
+                for (unsigned int b = 0; b < y->getDomainInitSize(); b++) {
+                    Value vy = y->toValue(b);
+                    if (z) {
+                        for (unsigned int k = 0; k < z->getDomainInitSize(); k++) {
+                            Value vz = z->toValue(k);
+                            costs.push_back((x->canbe(vx) && y->canbe(vy) && z->canbe(vz)) ? ((TernaryConstraint*)ctr)->getCost(vx, vy, vz) : MIN_COST);
+                        }
+                    } else {
+                        costs.push_back((x->canbe(vx) && y->canbe(vy)) ? ((BinaryConstraint*)ctr)->getCost(vx, vy) : MIN_COST);
+                    }
+                }
+            }
+            writer.write((unsigned int)BIN_DENSE);
+            writer.write(arity);
+            writer.writeArray(scope.data(), arity);
+            writer.writeArray(costs.data(), costs.size());
+        } else if (ctr->isNary()) {
+            vector<Value> tuples;
+            String t;
+            Cost cost;
+            costs.clear();
+            ctr->first();
+            while (ctr->next(t, cost)) {
+                for (int i = 0; i < arity; i++)
+                    tuples.push_back(t[i] - CHAR_FIRST);
+                costs.push_back(cost);
+            }
+            writer.write((unsigned int)BIN_SPARSE);
+            writer.write(arity);
+            writer.writeArray(scope.data(), arity);
+            writer.write(ctr->getDefCost());
+            writer.write((Long)costs.size());
+            writer.writeArray(tuples.data(), tuples.size());
+            writer.writeArray(costs.data(), costs.size());
+        } else if (ctr->isGlobal() || dynamic_cast<WeightedClause*>(ctr)) {
+            ostringstream text;
+            ctr->dump(text, true);
+            writer.write((unsigned int)BIN_TEXT);
+            writer.writeString(text.str());
+        } else {
+            cerr << "Error: cannot save cost function " << ctr->getName() << " of arity " << arity << " in binary format." << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
 ostream& operator<<(ostream& os, WCSP& wcsp)
 {
     wcsp.print(os);
@@ -2605,6 +2993,135 @@ void WCSP::propagateDAC()
     }
 }
 
+const Double MIN_PARALLEL_TRWS_WORK = 1 << 14; // minimum mean number of cost evaluations per level to run a TRW-S pass in several threads
+
+/// \brief synchronizes the threads of a parallel TRW-S pass at the end of each level
+class TRWSBarrier {
+    std::mutex mutex;
+    std::condition_variable released;
+    unsigned int nbThreads;
+    unsigned int nbWaiting;
+    unsigned int generation;
+    bool stop;
+
+public:
+    TRWSBarrier(unsigned int n)
+        : nbThreads(n)
+        , nbWaiting(0)
+        , generation(0)
+        , stop(false)
+    {
+    }
+
+    /// \brief waits for all the threads and returns false if one of them asked to stop
+    bool wait(bool interrupt)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (interrupt)
+            stop = true;
+        unsigned int current = generation;
+        if (++nbWaiting == nbThreads) {
+            nbWaiting = 0;
+            generation++;
+            released.notify_all();
+        } else {
+            released.wait(lock, [&] { return generation != current; });
+        }
+        return !stop;
+    }
+};
+
+/// \brief calls \a f(i, thread) on every index \a i of every level in increasing order of levels, the indexes of a level in \a nbThreads threads
+/// \return false if interrupted (see ToulBar2::interrupted)
+/// \warning \a f must not use ToulBar2 global variables except in thread 0 (they are thread_local)
+template <class F>
+static bool parallelLevels(const vector<vector<int>>& levels, unsigned int nbThreads, F f)
+{
+    if (nbThreads <= 1) {
+        for (unsigned int l = 0; l < levels.size(); l++)
+            for (unsigned int i = 0; i < levels[l].size(); i++) {
+                if (ToulBar2::interrupted)
+                    return false;
+                f(levels[l][i], 0);
+            }
+        return true;
+    }
+    TRWSBarrier barrier(nbThreads);
+    vector<std::thread> threads;
+    for (unsigned int t = 1; t < nbThreads; t++) {
+        threads.push_back(std::thread([=, &levels, &barrier, &f] {
+            for (unsigned int l = 0; l < levels.size(); l++) {
+                for (unsigned int i = t; i < levels[l].size(); i += nbThreads)
+                    f(levels[l][i], t);
+                if (!barrier.wait(false))
+                    return;
+            }
+        }));
+    }
+    bool completed = true;
+    for (unsigned int l = 0; l < levels.size() && completed; l++) {
+        for (unsigned int i = 0; i < levels[l].size(); i += nbThreads)
+            f(levels[l][i], 0);
+        completed = barrier.wait(ToulBar2::interrupted);
+    }
+    for (auto& thread : threads)
+        thread.join();
+    return completed;
+}
+
+/// \brief normalizes the reparametrized unary costs of \a s and sends its messages to its neighbors with a greater rank
+/// \return the lower bound increase
+/// \note only the messages of the binary cost functions of \a s are modified, neighbors with the same level can be updated in parallel
+static Cost updateTRWS(EnumeratedVariable* s, const vector<unsigned int>& rank, vector<Cost>& thetaHat, vector<Cost>& offsets, vector<Long>& valid)
+{
+    Cost ebound = MIN_COST;
+    // step 1: normalize unary costs
+    thetaHat.assign(s->getDomainInitSize(), MIN_COST);
+    Cost delta = numeric_limits<Cost>::max();
+    for (EnumeratedVariable::iterator sIter = s->begin(); sIter != s->end(); ++sIter) {
+        unsigned int j = s->toIndex(*sIter);
+        thetaHat[j] = s->getCost(*sIter);
+        for (ConstraintList::iterator iter = s->getConstrs()->begin(); iter != s->getConstrs()->end(); ++iter) {
+            Constraint* constraint = (*iter).constr;
+            if (constraint->isBinary()) {
+                BinaryConstraint* binctr = static_cast<BinaryConstraint*>(constraint);
+                thetaHat[j] += binctr->trwsM[j];
+            }
+        }
+        delta = min<Cost>(delta, thetaHat[j]);
+    }
+    if (delta != MIN_COST) {
+        for (EnumeratedVariable::iterator sIter = s->begin(); sIter != s->end(); ++sIter) {
+            unsigned int j = s->toIndex(*sIter);
+            thetaHat[j] -= delta;
+        }
+        ebound += delta;
+    }
+    for (EnumeratedVariable::iterator sIter = s->begin(); sIter != s->end(); ++sIter) {
+        unsigned int j = s->toIndex(*sIter);
+        thetaHat[j] = static_cast<Cost>(trunc(s->getTRWSGamma() * thetaHat[j]));
+    }
+    // step 2: message update
+    for (ConstraintList::iterator iter = s->getConstrs()->begin(); iter != s->getConstrs()->end(); ++iter) {
+        Constraint* constraint = (*iter).constr;
+        if (constraint->isBinary()) {
+            BinaryConstraint* binctr = static_cast<BinaryConstraint*>(constraint);
+            EnumeratedVariable* t = static_cast<EnumeratedVariable*>(binctr->getVarDiffFrom(s));
+            if (rank[s->wcspIndex] < rank[t->wcspIndex]) {
+                delta = binctr->messageTRWS(s, thetaHat, offsets, valid);
+                if (delta != MIN_COST) {
+                    for (EnumeratedVariable::iterator tIter = t->begin(); tIter != t->end(); ++tIter) {
+                        unsigned int k = t->toIndex(*tIter);
+                        binctr->trwsM[k] -= delta;
+                    }
+                    ebound += delta;
+                }
+            }
+        }
+    }
+    return ebound;
+}
+
 void WCSP::propagateTRWS()
 {
     bool forwardPass = true;
@@ -2708,82 +3225,66 @@ void WCSP::propagateTRWS()
         Constraint* ctr = getCtr(i);
         if (ctr->connected() && ctr->isBinary()) {
             BinaryConstraint* binctr = static_cast<BinaryConstraint*>(ctr);
-            binctr->trwsM.clear();
+            binctr->trwsM.assign(binctr->trwsM.size(), MIN_COST);
         }
     }
     for (int i = 0; i < elimBinOrder; i++) {
         Constraint* ctr = elimBinConstrs[i];
         if (ctr->connected()) {
             BinaryConstraint* binctr = static_cast<BinaryConstraint*>(ctr);
-            binctr->trwsM.clear();
+            binctr->trwsM.assign(binctr->trwsM.size(), MIN_COST);
         }
     }
 
-    do {
-        vector<int>& order = (forwardPass) ? orders[0] : orders[1];
-        vector<unsigned int>& rank = (forwardPass) ? ranks[0] : ranks[1];
-        ebound = MIN_COST;
+    // Preprocessing: compute levels such that a variable only depends on its neighbors with a smaller rank in previous levels
+    vector<vector<int>> levels[2];
+    unsigned int nbThreads[2] = { 1, 1 };
+    for (int pass = 0; pass < 2; pass++) {
+        vector<int> level(numberOfVariables(), -1);
+        Double work = 0.;
         for (unsigned int i = 0; i < numberOfVariables(); ++i) {
-            if (unassigned(order[i]) && enumerated(order[i])) {
-                if (ToulBar2::interrupted)
-                    throw TimeOut();
-                EnumeratedVariable* s = static_cast<EnumeratedVariable*>(getVar(order[i]));
-                // step 1: normalize unary costs
-                vector<Cost> thetaHat(s->getDomainInitSize(), MIN_COST);
-                Cost delta = numeric_limits<Cost>::max();
-                for (EnumeratedVariable::iterator sIter = s->begin(); sIter != s->end(); ++sIter) {
-                    unsigned int j = s->toIndex(*sIter);
-                    thetaHat[j] = s->getCost(*sIter);
-                    for (ConstraintList::iterator iter = s->getConstrs()->begin(); iter != s->getConstrs()->end(); ++iter) {
-                        Constraint* constraint = (*iter).constr;
-                        if (constraint->isBinary()) {
-                            BinaryConstraint* binctr = static_cast<BinaryConstraint*>(constraint);
-                            thetaHat[j] += binctr->trwsM[j];
-                        }
-                    }
-                    delta = min<Cost>(delta, thetaHat[j]);
-                }
-                if (delta != MIN_COST) {
-                    for (EnumeratedVariable::iterator sIter = s->begin(); sIter != s->end(); ++sIter) {
-                        unsigned int j = s->toIndex(*sIter);
-                        thetaHat[j] -= delta;
-                    }
-                    ebound += delta;
-                }
-                // step 2: message update
+            if (unassigned(orders[pass][i]) && enumerated(orders[pass][i])) {
+                EnumeratedVariable* s = static_cast<EnumeratedVariable*>(getVar(orders[pass][i]));
+                int l = 0;
                 for (ConstraintList::iterator iter = s->getConstrs()->begin(); iter != s->getConstrs()->end(); ++iter) {
                     Constraint* constraint = (*iter).constr;
                     if (constraint->isBinary()) {
-                        BinaryConstraint* binctr = static_cast<BinaryConstraint*>(constraint);
-                        EnumeratedVariable* t = static_cast<EnumeratedVariable*>(binctr->getVarDiffFrom(s));
-                        if (rank[s->wcspIndex] < rank[t->wcspIndex]) {
-                            std::function<Cost(unsigned int, unsigned int)> getCost1 = [binctr](unsigned int x, unsigned int y) { return binctr->getCost(x, y); };
-                            std::function<Cost(unsigned int, unsigned int)> getCost2 = [binctr](unsigned int y, unsigned int x) { return binctr->getCost(x, y); };
-                            auto getCost = (s == binctr->getVar(0)) ? getCost1 : getCost2;
-                            delta = numeric_limits<Cost>::max();
-                            tmpM.resize(max(s->getDomainInitSize(), t->getDomainInitSize()), numeric_limits<Cost>::max());
-                            for (EnumeratedVariable::iterator tIter = t->begin(); tIter != t->end(); ++tIter) {
-                                unsigned int k = t->toIndex(*tIter);
-                                tmpM[k] = numeric_limits<Cost>::max();
-                                for (EnumeratedVariable::iterator sIter = s->begin(); sIter != s->end(); ++sIter) {
-                                    unsigned int j = s->toIndex(*sIter);
-                                    tmpM[k] = min<Cost>(tmpM[k], static_cast<Cost>(trunc(s->getTRWSGamma() * thetaHat[j])) - binctr->trwsM[j] + getCost(j, k));
-                                }
-                                delta = min<Cost>(delta, tmpM[k]);
-                            }
-                            binctr->trwsM = tmpM;
-                            if (delta != MIN_COST) {
-                                for (EnumeratedVariable::iterator tIter = t->begin(); tIter != t->end(); ++tIter) {
-                                    unsigned int k = t->toIndex(*tIter);
-                                    binctr->trwsM[k] -= delta;
-                                }
-                                ebound += delta;
-                            }
-                        }
+                        EnumeratedVariable* t = static_cast<EnumeratedVariable*>(static_cast<BinaryConstraint*>(constraint)->getVarDiffFrom(s));
+                        if (ranks[pass][t->wcspIndex] < ranks[pass][s->wcspIndex])
+                            l = max(l, level[t->wcspIndex] + 1);
+                        else
+                            work += (Double)s->getDomainSize() * t->getDomainSize();
                     }
                 }
+                level[s->wcspIndex] = l;
+                if (l >= (int)levels[pass].size())
+                    levels[pass].resize(l + 1);
+                levels[pass][l].push_back(s->wcspIndex);
             }
         }
+        if (ToulBar2::portfolio <= 1 && levels[pass].size() > 0 && work / levels[pass].size() >= MIN_PARALLEL_TRWS_WORK)
+            nbThreads[pass] = max(1u, std::thread::hardware_concurrency());
+    }
+    if (ToulBar2::verbose >= 1)
+        cout << "TRW-S levels: " << levels[0].size() << " forward, " << levels[1].size() << " backward, using " << max(nbThreads[0], nbThreads[1]) << " thread(s)" << endl;
+    unsigned int maxThreads = max(nbThreads[0], nbThreads[1]);
+    vector<vector<Cost>> thetaHats(maxThreads), offsets(maxThreads);
+    vector<vector<Long>> valids(maxThreads);
+    vector<Cost> eboundThreads(maxThreads);
+
+    do {
+        int pass = (forwardPass) ? 0 : 1;
+        vector<int>& order = orders[pass];
+        vector<unsigned int>& rank = ranks[pass];
+        eboundThreads.assign(maxThreads, MIN_COST);
+        if (!parallelLevels(levels[pass], nbThreads[pass], [&](int i, unsigned int thread) {
+                EnumeratedVariable* s = static_cast<EnumeratedVariable*>(getVar(i));
+                eboundThreads[thread] += updateTRWS(s, rank, thetaHats[thread], offsets[thread], valids[thread]);
+            }))
+            throw TimeOut();
+        ebound = MIN_COST;
+        for (unsigned int thread = 0; thread < maxThreads; thread++)
+            ebound += eboundThreads[thread];
         // step 3: compute ub
         if ((!forwardPass) && (ToulBar2::trwsNIterComputeUb > 0) && (nIteration > 0) && (nIteration % ToulBar2::trwsNIterComputeUb == 0)) {
             for (unsigned int i = 0; i < numberOfVariables(); ++i) {
@@ -3018,9 +3519,12 @@ void WCSP::propagateDEE()
 
 void WCSP::eliminate()
 {
+    int lookahead = 0; // number of eliminations before looking again for independent eliminations (see WCSP::sumIndependentBuckets)
     while (!Eliminate.empty()) {
         if (ToulBar2::interrupted)
             throw TimeOut();
+        if (--lookahead <= 0)
+            lookahead = sumIndependentBuckets();
         EnumeratedVariable* x = (EnumeratedVariable*)Eliminate.pop();
         if (x->unassigned()) {
             if (td) {
@@ -3030,6 +3534,7 @@ void WCSP::eliminate()
                 x->eliminate();
         }
     }
+    elimBuckets.clear();
 }
 
 /// \defgroup softac Soft arc consistency and problem reformulation
@@ -3391,6 +3896,101 @@ TernaryConstraint* WCSP::newTernaryConstr(EnumeratedVariable* x, EnumeratedVaria
     return ctr;
 }
 
+const Double MIN_PARALLEL_ELIM_WORK = 1 << 18; // minimum number of cost evaluations to compute a cost table in several threads
+
+/// \brief calls \a f on every index of [0,n), in several threads if the number of cost evaluations \a work is large enough
+/// \param sequential reason why \a f cannot run in several threads (NULL if it can)
+/// \warning \a f must only read the problem (no trailing, no propagation) and must not use ToulBar2 global variables (they are thread_local)
+/// \note used to fill the cost table of one elimination or the tables of independent eliminations (see WCSP::sumIndependentBuckets)
+template <class F>
+static void parallelElim(unsigned int n, Double work, F f, const char* sequential = NULL)
+{
+    unsigned int nbThreads = (work >= MIN_PARALLEL_ELIM_WORK) ? min(n, std::thread::hardware_concurrency()) : 1;
+    if (nbThreads > 1 && (sequential || ToulBar2::portfolio > 1)) {
+        if (ToulBar2::verbose >= 1)
+            cout << "Sequential cost table computation in variable elimination (" << ((sequential) ? sequential : "parallel portfolio") << ")" << endl;
+        nbThreads = 1;
+    }
+    if (nbThreads <= 1) {
+        for (unsigned int i = 0; i < n; i++)
+            f(i);
+        return;
+    }
+    vector<std::thread> threads;
+    for (unsigned int t = 1; t < nbThreads; t++) {
+        threads.push_back(std::thread([=, &f] {
+            for (unsigned int i = t; i < n; i += nbThreads)
+                f(i);
+        }));
+    }
+    for (unsigned int i = 0; i < n; i += nbThreads)
+        f(i);
+    for (auto& thread : threads)
+        thread.join();
+}
+
+/// \brief returns the costs of a binary, ternary, or n-ary cost function in extension as a dense table over the initial domains of its scope
+/// \note only the costs of tuples in the current domains are meaningful, \a buffer is used if the cost function is not already stored as a dense table
+static const Cost* denseCosts(Constraint* ctr, vector<Cost>& buffer)
+{
+    if (ctr->isNary()) {
+        NaryConstraint* nctr = (NaryConstraint*)ctr;
+        if (nctr->getDenseCosts())
+            return nctr->getDenseCosts();
+        vector<ptrdiff_t> strides(nctr->arity());
+        for (int i = 0; i < nctr->arity(); i++)
+            strides[i] = nctr->getCostsStride(i);
+        buffer.assign(nctr->getDomainInitSizeProduct(), nctr->getDefCost());
+        String t;
+        Cost c;
+        nctr->first();
+        while (nctr->next(t, c)) {
+            ptrdiff_t idx = 0;
+            for (int i = 0; i < nctr->arity(); i++)
+                idx += (t[i] - CHAR_FIRST) * strides[i];
+            buffer[idx] = c;
+        }
+    } else if (ctr->isTernary()) {
+        TernaryConstraint* tctr = (TernaryConstraint*)ctr;
+        EnumeratedVariable* x = (EnumeratedVariable*)tctr->getVar(0);
+        EnumeratedVariable* y = (EnumeratedVariable*)tctr->getVar(1);
+        EnumeratedVariable* z = (EnumeratedVariable*)tctr->getVar(2);
+        unsigned int sizeY = y->getDomainInitSize();
+        unsigned int sizeZ = z->getDomainInitSize();
+        buffer.assign(x->getDomainInitSize() * sizeY * sizeZ, MAX_COST);
+        for (EnumeratedVariable::iterator itx = x->begin(); itx != x->end(); ++itx)
+            for (EnumeratedVariable::iterator ity = y->begin(); ity != y->end(); ++ity)
+                for (EnumeratedVariable::iterator itz = z->begin(); itz != z->end(); ++itz)
+                    buffer[(x->toIndex(*itx) * sizeY + y->toIndex(*ity)) * sizeZ + z->toIndex(*itz)] = tctr->getCost(x, y, z, *itx, *ity, *itz);
+    } else {
+        assert(ctr->isBinary());
+        BinaryConstraint* bctr = (BinaryConstraint*)ctr;
+        EnumeratedVariable* x = (EnumeratedVariable*)bctr->getVar(0);
+        EnumeratedVariable* y = (EnumeratedVariable*)bctr->getVar(1);
+        unsigned int sizeY = y->getDomainInitSize();
+        buffer.assign(x->getDomainInitSize() * sizeY, MAX_COST);
+        for (EnumeratedVariable::iterator itx = x->begin(); itx != x->end(); ++itx)
+            for (EnumeratedVariable::iterator ity = y->begin(); ity != y->end(); ++ity)
+                buffer[x->toIndex(*itx) * sizeY + y->toIndex(*ity)] = bctr->getCost(x, y, *itx, *ity);
+    }
+    return buffer.data();
+}
+
+/// \brief stride of each variable of the cost function \a ctr in its dense table (see denseCosts), zero for the other variables of \a scope
+static vector<ptrdiff_t> denseStrides(Constraint* ctr, EnumeratedVariable** scope, int arity)
+{
+    vector<ptrdiff_t> strides(arity, 0);
+    ptrdiff_t stride = 1;
+    for (int i = ctr->arity() - 1; i >= 0; --i) {
+        EnumeratedVariable* var = (EnumeratedVariable*)ctr->getVar(i);
+        for (int j = 0; j < arity; j++)
+            if (scope[j] == var)
+                strides[j] = stride;
+        stride *= var->getDomainInitSize();
+    }
+    return strides;
+}
+
 Constraint* WCSP::sum(Constraint* ctr1, Constraint* ctr2)
 {
     assert(ctr1 != ctr2);
@@ -3453,7 +4053,6 @@ Constraint* WCSP::sum(Constraint* ctr1, Constraint* ctr2)
     EnumeratedVariable* y = scopeU[1];
 
     Cost Top = getUb();
-    unsigned int vxi, vyi, vzi;
     String tuple, tuple1, tuple2;
     Cost cost, cost1, cost2;
     int ctrIndex = -INT_MAX;
@@ -3468,9 +4067,36 @@ Constraint* WCSP::sum(Constraint* ctr1, Constraint* ctr2)
 
         nary->fillFilters();
 
+        // the result is computed as a dense table whenever it fits in memory (see NaryConstraint::expand)
+        bool dense = (ctr1->isBinary() || ctr1->isTernary() || ctr1->isNary()) && (ctr2->isBinary() || ctr2->isTernary() || ctr2->isNary());
+        if (dense)
+            nary->expand();
+        dense = dense && nary->getDenseCosts();
+
         bool tupleXtuple = (ctr1->getDefCost() >= Top) && (ctr2->getDefCost() >= Top);
 
-        if (tupleXtuple) {
+        if (dense) {
+            vector<Cost> buffer1, buffer2;
+            const Cost* costs1 = denseCosts(ctr1, buffer1);
+            const Cost* costs2 = denseCosts(ctr2, buffer2);
+            Cost* costsU = nary->getDenseCosts();
+            vector<ptrdiff_t> strides1 = denseStrides(ctr1, scopeU, arityU);
+            vector<ptrdiff_t> strides2 = denseStrides(ctr2, scopeU, arityU);
+            vector<DenseDimension<3>> dims;
+            for (i = 0; i < arityU; i++) {
+                dims.push_back(DenseDimension<3>(scopeU[i]));
+                dims[i].strides[0] = nary->getCostsStride(i);
+                dims[i].strides[1] = strides1[i];
+                dims[i].strides[2] = strides2[i];
+            }
+            denseForEach(dims, array<ptrdiff_t, 3>(), [&](const array<ptrdiff_t, 3>& p, bool ok) {
+                if (ok) {
+                    Cost c = costs1[p[1]] + costs2[p[2]];
+                    if (c < Top)
+                        costsU[p[0]] = c;
+                }
+            });
+        } else if (tupleXtuple) {
             ctr1->first();
             while (ctr1->next(tuple1, cost1)) {
                 ctr2->first();
@@ -3490,11 +4116,16 @@ Constraint* WCSP::sum(Constraint* ctr1, Constraint* ctr2)
     } else if (arityU == 3) {
         EnumeratedVariable* z = scopeU[2];
         EnumeratedVariable* scopeTernary[3] = { x, y, z };
-        String t;
-        t.resize(3);
-        for (vxi = 0; vxi < x->getDomainInitSize(); vxi++)
-            for (vyi = 0; vyi < y->getDomainInitSize(); vyi++)
-                for (vzi = 0; vzi < z->getDomainInitSize(); vzi++) {
+        unsigned int sizeY = y->getDomainInitSize();
+        unsigned int sizeZ = z->getDomainInitSize();
+        costs.resize(x->getDomainInitSize() * sizeY * sizeZ);
+        // n-ary cost functions use an internal buffer for evaluation
+        const char* sequential = (ctr1->isNary() || ctr2->isNary()) ? "n-ary cost function" : NULL;
+        parallelElim(x->getDomainInitSize(), (Double)costs.size(), [&](unsigned int vxi) {
+            String t;
+            t.resize(3);
+            for (unsigned int vyi = 0; vyi < sizeY; vyi++)
+                for (unsigned int vzi = 0; vzi < sizeZ; vzi++) {
                     Value vx = x->toValue(vxi);
                     Value vy = y->toValue(vyi);
                     Value vz = z->toValue(vzi);
@@ -3549,14 +4180,17 @@ Constraint* WCSP::sum(Constraint* ctr1, Constraint* ctr2)
                         if (costsum > Top)
                             costsum = Top;
                     }
-                    costs.push_back(costsum);
+                    costs[(vxi * sizeY + vyi) * sizeZ + vzi] = costsum;
                 }
+        }, sequential);
         ctrIndex = postTernaryConstraint(x->wcspIndex, y->wcspIndex, z->wcspIndex, costs);
     } else if (arityU == 2) {
         BinaryConstraint* bctr1 = (BinaryConstraint*)ctr1;
         BinaryConstraint* bctr2 = (BinaryConstraint*)ctr2;
-        for (vxi = 0; vxi < x->getDomainInitSize(); vxi++)
-            for (vyi = 0; vyi < y->getDomainInitSize(); vyi++) {
+        unsigned int sizeY = y->getDomainInitSize();
+        costs.resize(x->getDomainInitSize() * sizeY);
+        parallelElim(x->getDomainInitSize(), (Double)costs.size(), [&](unsigned int vxi) {
+            for (unsigned int vyi = 0; vyi < sizeY; vyi++) {
                 Value vx = x->toValue(vxi);
                 Value vy = y->toValue(vyi);
                 Cost costsum = Top;
@@ -3565,8 +4199,9 @@ Constraint* WCSP::sum(Constraint* ctr1, Constraint* ctr2)
                     if (costsum > Top)
                         costsum = Top;
                 }
-                costs.push_back(costsum);
+                costs[vxi * sizeY + vyi] = costsum;
             }
+        });
         ctrIndex = postBinaryConstraint(x->wcspIndex, y->wcspIndex, costs);
     }
     assert(ctrIndex > -INT_MAX);
@@ -3641,32 +4276,69 @@ void WCSP::project(Constraint*& ctr_inout, EnumeratedVariable* var)
                     t[ctr_inout->getIndex(ctr_inout->getVar(i))] = ((EnumeratedVariable*)ctr_inout->getVar(i))->toIndex(ctr_inout->getVar(i)->getValue()) + CHAR_FIRST;
             }
         }
-        for (vxi = 0; vxi < evars[0]->getDomainInitSize(); vxi++) {
-            for (vyi = 0; vyi < evars[1]->getDomainInitSize(); vyi++) {
-                for (vzi = 0; vzi < evars[2]->getDomainInitSize(); vzi++) {
-                    Value v0 = evars[0]->toValue(vxi);
-                    Value v1 = evars[1]->toValue(vyi);
-                    Value v2 = evars[2]->toValue(vzi);
-                    Cost mincost = Top;
-                    if (evars[0]->canbe(v0) && evars[1]->canbe(v1) && evars[2]->canbe(v2)) {
-                        t[ctr_inout->getIndex(evars[0])] = vxi + CHAR_FIRST;
-                        t[ctr_inout->getIndex(evars[1])] = vyi + CHAR_FIRST;
-                        t[ctr_inout->getIndex(evars[2])] = vzi + CHAR_FIRST;
-
-                        for (EnumeratedVariable::iterator itv = var->begin(); itv != var->end(); ++itv) {
-                            t[ctr_inout->getIndex(var)] = var->toIndex(*itv) + CHAR_FIRST;
-                            t[arity] = '\0';
-                            String strt(t);
-                            Cost c = nctr->eval(strt) + var->getCost(*itv);
-                            if (ToulBar2::isZ)
-                                mincost = LogSumExp(mincost, c);
-                            else if (c < mincost)
-                                mincost = c;
+        if (nctr->getDenseCosts()) {
+            // scans the dense table of nctr with the resulting ternary table and the unary costs of var, assigned variables are fixed
+            unsigned int size1 = evars[1]->getDomainInitSize();
+            unsigned int size2 = evars[2]->getDomainInitSize();
+            costs.assign(evars[0]->getDomainInitSize() * size1 * size2, Top);
+            vector<Cost> varcosts(var->getDomainInitSize(), Top);
+            for (EnumeratedVariable::iterator itv = var->begin(); itv != var->end(); ++itv)
+                varcosts[var->toIndex(*itv)] = var->getCost(*itv);
+            vector<DenseDimension<3>> dims;
+            array<ptrdiff_t, 3> origin = array<ptrdiff_t, 3>();
+            for (i = 0; i < arity; i++) {
+                EnumeratedVariable* v = (EnumeratedVariable*)ctr_inout->getVar(i);
+                if (v != var && v != evars[0] && v != evars[1] && v != evars[2]) {
+                    assert(v->assigned());
+                    origin[0] += v->toIndex(v->getValue()) * nctr->getCostsStride(i);
+                    continue;
+                }
+                dims.push_back(DenseDimension<3>(v));
+                dims.back().strides[0] = nctr->getCostsStride(i);
+                dims.back().strides[1] = (v == evars[0]) ? size1 * size2 : ((v == evars[1]) ? size2 : ((v == evars[2]) ? 1 : 0));
+                dims.back().strides[2] = (v == var) ? 1 : 0;
+            }
+            const Cost* ncosts = nctr->getDenseCosts();
+            bool isZ = ToulBar2::isZ;
+            denseForEach(dims, origin, [&](const array<ptrdiff_t, 3>& p, bool ok) {
+                if (ok) {
+                    Cost c = ncosts[p[0]] + varcosts[p[2]];
+                    if (isZ)
+                        costs[p[1]] = LogSumExp(costs[p[1]], c);
+                    else if (c < costs[p[1]])
+                        costs[p[1]] = c;
+                }
+            });
+            if (ToulBar2::isZ)
+                negcost = min(negcost, *min_element(costs.begin(), costs.end()));
+        } else {
+            for (vxi = 0; vxi < evars[0]->getDomainInitSize(); vxi++) {
+                for (vyi = 0; vyi < evars[1]->getDomainInitSize(); vyi++) {
+                    for (vzi = 0; vzi < evars[2]->getDomainInitSize(); vzi++) {
+                        Value v0 = evars[0]->toValue(vxi);
+                        Value v1 = evars[1]->toValue(vyi);
+                        Value v2 = evars[2]->toValue(vzi);
+                        Cost mincost = Top;
+                        if (evars[0]->canbe(v0) && evars[1]->canbe(v1) && evars[2]->canbe(v2)) {
+                            t[ctr_inout->getIndex(evars[0])] = vxi + CHAR_FIRST;
+                            t[ctr_inout->getIndex(evars[1])] = vyi + CHAR_FIRST;
+                            t[ctr_inout->getIndex(evars[2])] = vzi + CHAR_FIRST;
+
+                            for (EnumeratedVariable::iterator itv = var->begin(); itv != var->end(); ++itv) {
+                                t[ctr_inout->getIndex(var)] = var->toIndex(*itv) + CHAR_FIRST;
+                                t[arity] = '\0';
+                                String strt(t);
+                                Cost c = nctr->eval(strt) + var->getCost(*itv);
+                                if (ToulBar2::isZ)
+                                    mincost = LogSumExp(mincost, c);
+                                else if (c < mincost)
+                                    mincost = c;
+                            }
                         }
+                        if (ToulBar2::isZ && mincost < negcost)
+                            negcost = mincost;
+                        costs.push_back(mincost);
                     }
-                    if (ToulBar2::isZ && mincost < negcost)
-                        negcost = mincost;
-                    costs.push_back(mincost);
                 }
             }
         }
@@ -3686,24 +4358,30 @@ void WCSP::project(Constraint*& ctr_inout, EnumeratedVariable* var)
     } break;
     case 2: {
         TernaryConstraint* tctr = (TernaryConstraint*)ctr_inout;
-        for (vxi = 0; vxi < evars[0]->getDomainInitSize(); vxi++)
-            for (vyi = 0; vyi < evars[1]->getDomainInitSize(); vyi++) {
+        unsigned int size1 = evars[1]->getDomainInitSize();
+        costs.resize(evars[0]->getDomainInitSize() * size1);
+        // LogSumExp depends on thread_local ToulBar2::NormFactor
+        const char* sequential = (ToulBar2::isZ) ? "partition function" : NULL;
+        bool isZ = ToulBar2::isZ;
+        parallelElim(evars[0]->getDomainInitSize(), (Double)costs.size() * var->getDomainSize(), [&](unsigned int vxi) {
+            for (unsigned int vyi = 0; vyi < size1; vyi++) {
                 Value v0 = evars[0]->toValue(vxi);
                 Value v1 = evars[1]->toValue(vyi);
                 Cost mincost = Top;
                 if (evars[0]->canbe(v0) && evars[1]->canbe(v1)) {
                     for (EnumeratedVariable::iterator itv = var->begin(); itv != var->end(); ++itv) {
                         Cost c = tctr->getCost(evars[0], evars[1], var, v0, v1, *itv) + var->getCost(*itv);
-                        if (ToulBar2::isZ)
+                        if (isZ)
                             mincost = LogSumExp(mincost, c);
                         else if (c < mincost)
                             mincost = c;
                     }
                 }
-                if (ToulBar2::isZ && mincost < negcost)
-                    negcost = mincost;
-                costs.push_back(mincost);
+                costs[vxi * size1 + vyi] = mincost;
             }
+        }, sequential);
+        if (ToulBar2::isZ)
+            negcost = min(negcost, *min_element(costs.begin(), costs.end()));
         assert(negcost <= 0);
         if (negcost < 0) {
             for (vxi = 0; vxi < evars[0]->getDomainInitSize(); vxi++) {
@@ -3758,6 +4436,175 @@ void WCSP::project(Constraint*& ctr_inout, EnumeratedVariable* var)
     }
 }
 
+const int PARALLEL_ELIM_LOOKAHEAD = 16; // number of variables per thread looked ahead in the elimination queue to find independent eliminations
+const Double PARALLEL_ELIM_SPACE = 128. * 1024. * 1024.; // memory budget in bytes of the cost tables computed at the same time by independent eliminations (if ToulBar2::elimSpaceMaxMB is not set)
+
+/// \brief sums the cost functions of the bucket \a b as a dense table over its scope
+/// \warning runs in parallel with other buckets having disjoint scopes, it must only read the problem (see parallelElim)
+static void sumBucketCosts(WCSP::elimBucket& b)
+{
+    int arity = b.scope.size();
+    vector<DenseDimension<2>> dims;
+    for (int i = 0; i < arity; i++)
+        dims.push_back(DenseDimension<2>(b.scope[i]));
+    ptrdiff_t size = 1;
+    for (int i = arity - 1; i >= 0; --i) {
+        dims[i].strides[0] = size;
+        size *= dims[i].size;
+    }
+    b.costs.assign(size, MIN_COST);
+    for (unsigned int c = 0; c < b.constrs.size(); c++) {
+        vector<Cost> buffer;
+        const Cost* costs = denseCosts(b.constrs[c], buffer);
+        vector<ptrdiff_t> strides = denseStrides(b.constrs[c], b.scope.data(), arity);
+        for (int i = 0; i < arity; i++)
+            dims[i].strides[1] = strides[i];
+        denseForEach(dims, array<ptrdiff_t, 2>(), [&](const array<ptrdiff_t, 2>& p, bool ok) {
+            Cost cost = (ok) ? b.costs[p[0]] + costs[p[1]] : b.top;
+            b.costs[p[0]] = min(cost, b.top);
+        });
+    }
+}
+
+/// \brief computes in parallel the sums of the cost functions of the next variables to be eliminated in preprocessing if their neighborhoods are disjoint
+/// \return number of eliminations before calling this function again
+/// \note eliminations are still done one after the other in the queue order, using the precomputed sums if their neighborhoods have not changed in the meantime (see WCSP::sumBucket)
+/// \note the tables computed at the same time must fit in the remaining ToulBar2::elimSpaceMaxMB budget, large tables are left to WCSP::sum which fills them in parallel
+int WCSP::sumIndependentBuckets()
+{
+    elimBuckets.clear();
+    if (ToulBar2::elimDegree_preprocessing_ < 0 || td || ToulBar2::portfolio > 1)
+        return INT_MAX;
+    unsigned int nbThreads = std::thread::hardware_concurrency();
+    if (nbThreads <= 1)
+        return INT_MAX;
+
+    vector<Variable*> next;
+    Eliminate.peek(next, PARALLEL_ELIM_LOOKAHEAD * nbThreads);
+    Double budget = (ToulBar2::elimSpaceMaxMB) ? (Double)ToulBar2::elimSpaceMaxMB * 1024. * 1024. - (Double)elimSpace : PARALLEL_ELIM_SPACE;
+    Double work = 0.;
+    vector<bool> used(vars.size(), false); // variables in the neighborhood of a previous elimination
+    vector<elimBucket*> buckets;
+    for (unsigned int k = 0; k < next.size(); k++) {
+        EnumeratedVariable* x = (EnumeratedVariable*)next[k];
+        if (x->assigned() || x->isSep() || x->getTrueDegree() > ToulBar2::elimDegree_preprocessing_)
+            continue;
+        elimBucket b;
+        b.top = getUb();
+        b.scope.push_back(x);
+        bool dense = (x->getDegree() >= 2);
+        for (ConstraintList::iterator iter = x->getConstrs()->begin(); iter != x->getConstrs()->end(); ++iter) {
+            Constraint* ctr = (*iter).constr;
+            b.constrs.push_back(ctr);
+            bool extension = !ctr->isSep() && (ctr->isBinary() || ctr->isTernary() || (ctr->isNary() && ((NaryConstraint*)ctr)->getDenseCosts()));
+            for (int i = 0; i < ctr->arity(); i++) {
+                EnumeratedVariable* y = (EnumeratedVariable*)ctr->getVar(i);
+                extension = extension && y->unassigned();
+                if (find(b.scope.begin(), b.scope.end(), y) == b.scope.end())
+                    b.scope.push_back(y);
+            }
+            dense = dense && extension;
+        }
+        bool independent = true;
+        Double size = 1.;
+        for (unsigned int i = 0; i < b.scope.size(); i++) {
+            independent = independent && !used[b.scope[i]->wcspIndex];
+            used[b.scope[i]->wcspIndex] = true; // the next eliminations in this neighborhood may depend on this one
+            b.domainSizes.push_back(b.scope[i]->getDomainSize());
+            size *= b.scope[i]->getDomainInitSize();
+        }
+        if (!independent || !dense || size >= MIN_PARALLEL_ELIM_WORK || size * sizeof(Cost) > budget)
+            continue;
+        budget -= size * sizeof(Cost);
+        work += size * b.constrs.size();
+        elimBucket& bucket = elimBuckets[x->wcspIndex];
+        bucket = std::move(b);
+        buckets.push_back(&bucket);
+    }
+    if (buckets.size() >= 2 && work >= MIN_PARALLEL_ELIM_WORK) {
+        if (ToulBar2::verbose >= 1)
+            cout << "Parallel sum of cost functions for " << buckets.size() << " independent variable eliminations" << endl;
+        parallelElim(buckets.size(), work, [&](unsigned int i) {
+            sumBucketCosts(*buckets[i]);
+        });
+    } else
+        elimBuckets.clear();
+    return max((int)next.size(), 1);
+}
+
+/// \brief posts the sum of all the cost functions of \a var if it has been computed by WCSP::sumIndependentBuckets and is still valid
+/// \return the resulting cost function or NULL if it has to be computed by WCSP::sum
+Constraint* WCSP::sumBucket(EnumeratedVariable* var)
+{
+    map<int, elimBucket>::iterator it = elimBuckets.find(var->wcspIndex);
+    if (it == elimBuckets.end())
+        return NULL;
+    elimBucket b = std::move(it->second);
+    elimBuckets.erase(it);
+    // the cost functions of the bucket can only change if a variable of its scope has been eliminated or has lost some values in the meantime
+    bool valid = (b.top == getUb() && var->getDegree() == (int)b.constrs.size());
+    for (unsigned int i = 0; valid && i < b.scope.size(); i++)
+        valid = b.scope[i]->unassigned() && b.scope[i]->getDomainSize() == b.domainSizes[i];
+    for (ConstraintList::iterator iter = var->getConstrs()->begin(); valid && iter != var->getConstrs()->end(); ++iter)
+        valid = (find(b.constrs.begin(), b.constrs.end(), (*iter).constr) != b.constrs.end());
+    if (!valid) {
+        if (ToulBar2::verbose >= 1)
+            cout << endl
+                 << "Parallel sum of cost functions of " << var->getName() << " is obsolete" << endl;
+        return NULL;
+    }
+    if (ToulBar2::verbose >= 1) {
+        cout << endl
+             << "Sum of constraints computed in parallel:";
+        for (unsigned int c = 0; c < b.constrs.size(); c++)
+            cout << " " << *b.constrs[c];
+        cout << endl;
+    }
+    for (unsigned int c = 0; c < b.constrs.size(); c++)
+        b.constrs[c]->deconnect();
+
+    int arity = b.scope.size();
+    vector<int> scopeIndex;
+    for (int i = 0; i < arity; i++)
+        scopeIndex.push_back(b.scope[i]->wcspIndex);
+    int ctrIndex = -INT_MAX;
+    if (arity > NARYPROJECTIONSIZE) {
+        ctrIndex = postNaryConstraintBegin(scopeIndex.data(), arity, b.top, b.costs.size());
+        assert(getCtr(ctrIndex)->isNary());
+        NaryConstraint* nary = (NaryConstraint*)getCtr(ctrIndex);
+        nary->fillFilters();
+        nary->expand();
+        if (nary->getDenseCosts()) {
+            copy(b.costs.begin(), b.costs.end(), nary->getDenseCosts());
+        } else {
+            String t(arity, CHAR_FIRST);
+            for (size_t idx = 0; idx < b.costs.size(); idx++) {
+                if (b.costs[idx] < b.top)
+                    nary->setTuple(t, b.costs[idx]);
+                int i = arity - 1;
+                while (i >= 0 && (unsigned int)(t[i] - CHAR_FIRST) == b.scope[i]->getDomainInitSize() - 1) {
+                    t[i] = CHAR_FIRST;
+                    i--;
+                }
+                if (i >= 0)
+                    t[i]++;
+            }
+        }
+    } else if (arity == 3) {
+        ctrIndex = postTernaryConstraint(scopeIndex[0], scopeIndex[1], scopeIndex[2], b.costs);
+    } else {
+        assert(arity == 2);
+        ctrIndex = postBinaryConstraint(scopeIndex[0], scopeIndex[1], b.costs);
+    }
+    assert(ctrIndex > -INT_MAX);
+    Constraint* ctr = getCtr(ctrIndex);
+    ctr->propagate();
+    if (ToulBar2::verbose >= 1)
+        cout << endl
+             << "Has result: " << *ctr << endl;
+    return ctr;
+}
+
 void WCSP::variableElimination(EnumeratedVariable* var)
 {
     int degree = var->getTrueDegree();
@@ -3774,8 +4621,10 @@ void WCSP::variableElimination(EnumeratedVariable* var)
         ConstraintList::iterator it2;
         Constraint* c1 = (*it1).constr;
         Constraint* c2 = NULL;
-        Constraint* csum = c1;
+        Constraint* csum = sumBucket(var);
         Constraint* csumcopy = NULL;
+        if (!csum)
+            csum = c1;
 
         while (var->getDegree() > 1) {
             it1 = var->getConstrs()->begin();
@@ -34,7 +34,7 @@ class RegularFlowConstraint;
  */
 
 class WCSP FINAL : public WeightedCSP {
-    static int wcspCounter; ///< count the number of instances of WCSP class
+    static std::atomic<int> wcspCounter; ///< count the number of instances of WCSP class
     int instance; ///< instance number
     string name; ///< problem name
     void* solver; ///< special hook to access solver information
@@ -67,6 +67,7 @@ class WCSP FINAL : public WeightedCSP {
     bool isDelayedNaryCtr; ///< postpone naryctr propagation after all variables have been created
     vector<vector<int>> listofsuccessors; ///< list of topologic order of var used when q variables are  added for decomposing global constraint (berge acyclic)
     StoreInt isPartOfOptimalSolution; ///< true if the current assignment belongs to an optimal solution recorded into bestValues
+    uint64_t lastWeightedDegreeVersion; ///< last version number given to the cached weighted degrees of the variables (never reused, see Variable::getWeightedDegree)
 
     // make it private because we don't want copy nor assignment
     WCSP(const WCSP& wcsp);
@@ -100,6 +101,15 @@ public:
         }
     };
 
+    /// \brief sum of the cost functions of a variable computed in advance, in parallel with other variables having disjoint neighborhoods (see WCSP::sumIndependentBuckets)
+    struct elimBucket {
+        vector<EnumeratedVariable*> scope; ///< variable to be eliminated followed by its neighbors
+        vector<unsigned int> domainSizes; ///< current domain sizes of the scope variables when the table was computed
+        vector<Constraint*> constrs; ///< cost functions of the variable to be eliminated
+        Cost top; ///< upper bound when the table was computed
+        vector<Cost> costs; ///< dense table over the initial domains of the scope (see tb2tensor.hpp)
+    };
+
     StoreInt elimOrder; ///< current number of eliminated variables
     vector<elimInfo> elimInfos; ///< variable elimination information used in backward phase to get a solution
     StoreInt elimBinOrder; ///< current number of extra binary cost functions consumed in the corresponding pool
@@ -108,6 +118,7 @@ public:
     vector<Constraint*> elimTernConstrs; ///< pool of (fresh) ternary cost functions
     int maxDegree; ///< maximum degree of eliminated variables found in preprocessing
     Long elimSpace; ///< estimate of total space required for generic variable elimination
+    map<int, elimBucket> elimBuckets; ///< sums of cost functions of the next variables to be eliminated in preprocessing (indexed by variable)
 
     VACExtension* vac; ///< link to VAC management system
 
@@ -295,6 +306,7 @@ public:
     int getDegree(int varIndex) const { return vars[varIndex]->getDegree(); } ///< \brief approximate degree of a variable (\e ie number of active cost functions, see \ref varelim)
     int getTrueDegree(int varIndex) const { return vars[varIndex]->getTrueDegree(); } ///< \brief degree of a variable
     Long getWeightedDegree(int varIndex) const { return vars[varIndex]->getWeightedDegree(); } ///< \brief weighted degree heuristic
+    uint64_t newWeightedDegreeVersion() { return ++lastWeightedDegreeVersion; } ///< \brief new version number for the cached weighted degree of a variable
     void resetWeightedDegree(int varIndex) { vars[varIndex]->resetWeightedDegree(); } ///< \brief initialize weighted degree heuristic
     void revise(Constraint* c) { lastConflictConstr = c; } ///< \internal last conflict heuristic
     /// \internal last conflict heuristic
@@ -438,6 +450,7 @@ public:
     void read_uai2008(const char* fileName); ///< \brief load problem in UAI 2008 format (see http://graphmod.ics.uci.edu/uai08/FileFormat and http://www.cs.huji.ac.il/project/UAI10/fileFormat.php) \warning UAI10 evidence file format not recognized by toulbar2 as it does not allow multiple evidence (you should remove the first value in the file)
     void read_random(int n, int m, vector<int>& p, int seed, bool forceSubModular = false, string globalname = ""); ///< \brief create a random WCSP with \e n variables, domain size \e m, array \e p where the first element is a percentage of tuples with a nonzero cost and next elements are the number of random cost functions for each different arity (starting with arity two), random seed, a flag to have a percentage (last element in the array \e p) of the binary cost functions being permutated submodular, and a string to use a specific global cost function instead of random cost functions in extension
     void read_wcnf(const char* fileName); ///< \brief load problem in (w)cnf format (see http://www.maxsat.udl.cat/08/index.php?disp=requirements)
+    void read_binary(const char* fileName); ///< \brief load problem in binary format (see tb2binformat.hpp and WCSP::dumpBinary) using a memory-mapped file
     void read_qpbo(const char* fileName); ///< \brief load quadratic pseudo-Boolean optimization problem in unconstrained quadratic programming text format (first text line with n, number of variables and m, number of triplets, followed by the m triplets (x,y,cost) describing the sparse symmetric nXn cost matrix with variable indexes such that x <= y and any positive or negative real numbers for costs)
 
     void read_XML(const char* fileName); ///< \brief load problem in XML format (see http://www.cril.univ-artois.fr/~lecoutre/benchmarks.html)
@@ -486,6 +499,7 @@ public:
 
     void print(ostream& os); ///< \brief print current domains and active cost functions (see \ref verbosity)
     void dump(ostream& os, bool original = true); ///< \brief output the current WCSP into a file in wcsp format \param os output file \param original if true then keeps all variables with their original domain size else uses unassigned variables and current domains recoding variable indexes
+    void dumpBinary(ostream& os); ///< \brief output the current WCSP with original domains into a file in binary format (see tb2binformat.hpp) \param os output file opened in binary mode
     friend ostream& operator<<(ostream& os, WCSP& wcsp); ///< \relates WCSP::print
 
     // -----------------------------------------------------------
@@ -585,6 +599,8 @@ public:
     void restoreSolution(Cluster* c = NULL);
 
     Constraint* sum(Constraint* ctr1, Constraint* ctr2);
+    int sumIndependentBuckets();
+    Constraint* sumBucket(EnumeratedVariable* var);
     void project(Constraint*& ctr_inout, EnumeratedVariable* var);
     void variableElimination(EnumeratedVariable* var);
 
@@ -7,6 +7,34 @@
 
 #include "tb2globalconstr.hpp"
 
+/// \brief dynamic programming table with rows of the same size stored contiguously (table[row][column])
+template <class T>
+class DPTable {
+    T* cells;
+    int rowSize;
+
+    // do not allow copy
+    DPTable(const DPTable& t);
+    DPTable& operator=(const DPTable& t);
+
+public:
+    DPTable()
+        : cells(NULL)
+        , rowSize(0)
+    {
+    }
+    ~DPTable() { delete[] cells; }
+
+    void resize(int nbRows, int rowSize_)
+    {
+        delete[] cells;
+        rowSize = rowSize_;
+        cells = new T[(size_t)nbRows * rowSize_]();
+    }
+
+    T* operator[](int row) { return cells + (size_t)row * rowSize; }
+};
+
 class DPGlobalConstraint : public GlobalConstraint {
 private:
     vector<bool>* zero;
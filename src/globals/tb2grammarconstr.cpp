@@ -2,6 +2,8 @@
 
 GrammarConstraint::GrammarConstraint(WCSP* wcsp, EnumeratedVariable** scope, int arity)
     : DPGlobalConstraint(wcsp, scope, arity)
+    , top(MAX_COST)
+    , upToDate(false)
 {
     modeEnum["var"] = GrammarConstraint::VAR;
     modeEnum["weight"] = GrammarConstraint::WEIGHTED;
@@ -9,15 +11,6 @@ GrammarConstraint::GrammarConstraint(WCSP* wcsp, EnumeratedVariable** scope, int
 
 GrammarConstraint::~GrammarConstraint(void)
 {
-    deleteTable(f);
-    deleteTable(curf);
-    deleteTable(marked);
-    deleteTable(curf);
-
-    for (int i = 0; i < arity(); i++) {
-        delete[] u[i];
-    }
-    delete[] u;
 }
 
 void GrammarConstraint::read(istream& file, bool mult)
@@ -134,16 +127,14 @@ void GrammarConstraint::initMemoization()
     resizeTable(up);
     resizeTable(curf);
     resizeTable(marked);
-
-    u = new Cost*[arity() + 1];
-    for (int i = 0; i < arity(); i++) {
-        u[i] = new Cost[cfg.getNumNonTerminals()];
-    }
+    u.resize(arity(), cfg.getNumTerminals());
+    upToDate = false;
 }
 
 Cost GrammarConstraint::minCostOriginal()
 {
     int n = arity();
+    upToDate = false;
     for (int i = 0; i < n; i++) {
         for (int j = 0; j < cfg.getNumTerminals(); j++) {
             u[i][j] = top;
@@ -157,7 +148,7 @@ Cost GrammarConstraint::minCostOriginal()
 
     recomputeTable(curf);
 
-    int minCost = curf[0][n - 1][cfg.getStartSymbol()];
+    int minCost = curf[span(0, n - 1)][cfg.getStartSymbol()];
 
     return minCost;
 }
@@ -170,6 +161,7 @@ Cost GrammarConstraint::minCostOriginal(int var, Value val, bool changed)
 Cost GrammarConstraint::eval(const String& s)
 {
     int n = arity();
+    upToDate = false;
     for (int i = 0; i < n; i++) {
         for (int j = 0; j < cfg.getNumTerminals(); j++) {
             u[i][j] = unary(cfg.toValue(j), i, s[i] - CHAR_FIRST);
@@ -177,27 +169,38 @@ Cost GrammarConstraint::eval(const String& s)
     }
 
     recomputeTable(curf);
-    int minCost = curf[0][n - 1][cfg.getStartSymbol()];
+    int minCost = curf[span(0, n - 1)][cfg.getStartSymbol()];
 
     return minCost - projectedCost;
 }
 
+// only the sequences of variables containing modified unary costs are recomputed in f
 void GrammarConstraint::recompute()
 {
     int n = arity();
+    int first = n;
+    int last = -1;
     for (int i = 0; i < n; i++) {
+        EnumeratedVariable* x = scope[i];
         for (int j = 0; j < cfg.getNumTerminals(); j++) {
-            u[i][j] = top;
-            EnumeratedVariable* x = scope[i];
+            Cost ucost = top;
             for (EnumeratedVariable::iterator it = x->begin(); it != x->end(); ++it) {
-                if (u[i][j] > unary(cfg.toValue(j), i, *it)) {
-                    u[i][j] = unary(cfg.toValue(j), i, *it);
-                }
+                ucost = min(ucost, unary(cfg.toValue(j), i, *it));
+            }
+            if (u[i][j] != ucost) {
+                u[i][j] = ucost;
+                first = min(first, i);
+                last = max(last, i);
             }
         }
     }
 
-    recomputeTable(f, up);
+    if (!upToDate) {
+        recomputeTable(f, &up);
+        upToDate = true;
+    } else if (first <= last) {
+        recomputeTable(f, &up, first, last);
+    }
 }
 
 DPGlobalConstraint::Result GrammarConstraint::minCost(int var, Value val, bool changed)
@@ -210,33 +213,28 @@ DPGlobalConstraint::Result GrammarConstraint::minCost(int var, Value val, bool c
 
     for (WCNFCFG::TermProdIterator r = cfg.beginTermProd();
          r != cfg.endTermProd(); r++) {
-        if ((r->to[0] == val) && marked[var][var][r->from]) {
+        if ((r->to[0] == val) && marked[span(var, var)][r->from]) {
             minCost = min(minCost,
-                unary(r->to[0], var, val) + r->weight - up[var][var][r->from] + f[0][n - 1][cfg.getStartSymbol()]);
+                unary(r->to[0], var, val) + r->weight - up[span(var, var)][r->from] + f[span(0, n - 1)][cfg.getStartSymbol()]);
         }
     }
 
     return DPGlobalConstraint::Result(minCost, NULL);
 }
 
-void GrammarConstraint::recomputeTable(Cost*** table, Cost*** upTable)
+void GrammarConstraint::recomputeTable(DPTable<Cost>& table, DPTable<Cost>* upTable, int first, int last)
 {
     int n = arity();
+    int N = cfg.getNumNonTerminals();
 
-    for (int i = 0; i < n; i++) {
-        for (int A = 0; A < cfg.getNumNonTerminals(); A++) {
-            table[i][i][A] = top;
+    for (int i = max(0, first); i < n && i <= last; i++) {
+        Cost* cell = table[span(i, i)];
+        for (int A = 0; A < N; A++) {
+            cell[A] = top;
         }
-        /*for (vector<Rule>::iterator r = nonTerm2term.begin(); r != nonTerm2term.end(); r++) {
-
-            if (table[i][i][r->from] > u[i][r->to[0]] + r->weight) {
-                table[i][i][r->from] = u[i][r->to[0]] + r->weight;
-            }
-
-        }*/
         for (WCNFCFG::TermProdIterator r = cfg.beginTermProd(); r != cfg.endTermProd(); ++r) {
-            if (table[i][i][r->from] > u[i][cfg.toIndex(r->to[0])] + r->weight) {
-                table[i][i][r->from] = u[i][cfg.toIndex(r->to[0])] + r->weight;
+            if (cell[r->from] > u[i][cfg.toIndex(r->to[0])] + r->weight) {
+                cell[r->from] = u[i][cfg.toIndex(r->to[0])] + r->weight;
             }
         }
     }
@@ -244,55 +242,54 @@ void GrammarConstraint::recomputeTable(Cost*** table, Cost*** upTable)
     for (int len = 2; len <= n; len++) {
         for (int i = 0; i < n - len + 1; i++) {
             int j = i + len - 1;
-            for (int A = 0; A < cfg.getNumNonTerminals(); A++) {
-                table[i][j][A] = top;
+            if (j < first || i > last)
+                continue;
+            Cost* cell = table[span(i, j)];
+            for (int A = 0; A < N; A++) {
+                cell[A] = top;
             }
-            /*for (vector<Rule>::iterator r = nonTerm2nonTerm.begin(); r != nonTerm2nonTerm.end(); r++) {
-                for (int k = i; k < j; k++) {
-                    int tmp = table[i][k][r->to[0]] + table[k + 1][j][r->to[1]] + r->weight;
-                    if (table[i][j][r->from] > tmp) {
-                        table[i][j][r->from] = tmp;
-                    }
-                }
-            }*/
-            for (WCNFCFG::NonTermProdIterator r = cfg.beginNonTermProd(); r != cfg.endNonTermProd(); ++r) {
-                for (int k = i; k < j; k++) {
-                    Cost tmp = table[i][k][r->to[0]] + table[k + 1][j][r->to[1]] + r->weight;
-                    table[i][j][r->from] = min(table[i][j][r->from], tmp);
+            for (int k = i; k < j; k++) {
+                Cost* left = table[span(i, k)];
+                Cost* right = table[span(k + 1, j)];
+                for (WCNFCFG::NonTermProdIterator r = cfg.beginNonTermProd(); r != cfg.endNonTermProd(); ++r) {
+                    Cost tmp = left[r->to[0]] + right[r->to[1]] + r->weight;
+                    cell[r->from] = min(cell[r->from], tmp);
                 }
             }
         }
     }
 
     if (upTable != NULL) {
+        DPTable<Cost>& upT = *upTable;
         for (int i = 0; i < n; i++) {
             for (int j = 0; j < n; j++) {
-                for (int A = 0; A < cfg.getNumNonTerminals(); A++) {
-                    marked[i][j][A] = false;
-                    upTable[i][j][A] = -top;
+                for (int A = 0; A < N; A++) {
+                    marked[span(i, j)][A] = false;
+                    upT[span(i, j)][A] = -top;
                 }
             }
         }
-        upTable[0][n - 1][cfg.getStartSymbol()] = table[0][n - 1][cfg.getStartSymbol()];
-        marked[0][n - 1][cfg.getStartSymbol()] = true;
+        upT[span(0, n - 1)][cfg.getStartSymbol()] = table[span(0, n - 1)][cfg.getStartSymbol()];
+        marked[span(0, n - 1)][cfg.getStartSymbol()] = true;
         for (int len = n; len >= 2; len--) {
             for (int i = 0; i < n - len + 1; i++) {
                 int j = i + len - 1;
-                //for (vector<Rule>::iterator r = nonTerm2nonTerm.begin(); r != nonTerm2nonTerm.end(); r++) {
-                for (WCNFCFG::NonTermProdIterator r = cfg.beginNonTermProd(); r != cfg.endNonTermProd(); ++r) {
-                    if (marked[i][j][r->from]) {
-                        for (int k = i; k < j; k++) {
-                            Cost tmp = table[i][k][r->to[0]] + table[k + 1][j][r->to[1]] + r->weight;
-                            //if (tmp <= upTable[i][j][r->from])
-                            {
-                                marked[i][k][r->to[0]] = true;
-                                tmp = upTable[i][j][r->from] - table[k + 1][j][r->to[1]] - r->weight;
-                                upTable[i][k][r->to[0]] = max(upTable[i][k][r->to[0]], tmp);
-
-                                marked[k + 1][j][r->to[1]] = true;
-                                tmp = upTable[i][j][r->from] - table[i][k][r->to[0]] - r->weight;
-                                upTable[k + 1][j][r->to[1]] = max(upTable[k + 1][j][r->to[1]], tmp);
-                            }
+                bool* markedCell = marked[span(i, j)];
+                Cost* upCell = upT[span(i, j)];
+                for (int k = i; k < j; k++) {
+                    Cost* left = table[span(i, k)];
+                    Cost* right = table[span(k + 1, j)];
+                    bool* markedLeft = marked[span(i, k)];
+                    bool* markedRight = marked[span(k + 1, j)];
+                    Cost* upLeft = upT[span(i, k)];
+                    Cost* upRight = upT[span(k + 1, j)];
+                    for (WCNFCFG::NonTermProdIterator r = cfg.beginNonTermProd(); r != cfg.endNonTermProd(); ++r) {
+                        if (markedCell[r->from]) {
+                            markedLeft[r->to[0]] = true;
+                            upLeft[r->to[0]] = max(upLeft[r->to[0]], upCell[r->from] - right[r->to[1]] - r->weight);
+
+                            markedRight[r->to[1]] = true;
+                            upRight[r->to[1]] = max(upRight[r->to[1]], upCell[r->from] - left[r->to[0]] - r->weight);
                         }
                     }
                 }
@@ -10,15 +10,15 @@
 
 class GrammarConstraint : public DPGlobalConstraint {
 private:
-    // dimension: i x j x |N|
-    Cost*** f;
-    Cost*** up;
-    bool*** marked;
+    // dimension: (i x j) x |N| (see span)
+    DPTable<Cost> f;
+    DPTable<Cost> up;
+    DPTable<bool> marked;
 
-    Cost*** curf;
+    DPTable<Cost> curf;
 
     // dimension: i x |sigma|
-    Cost** u;
+    DPTable<Cost> u;
 
     // grammar, assuming in CNF
 
@@ -33,33 +33,18 @@ private:
     vector<Rule> nonTerm2term;*/
     WCNFCFG cfg;
     Cost top;
+    bool upToDate; // true if f, up, and marked correspond to u
 
-    template <class T>
-    void resizeTable(T***& table)
-    {
-        table = new T**[arity() + 1];
-        for (int i = 0; i < arity() + 1; i++) {
-            table[i] = new T*[arity() + 1];
-            for (int j = 0; j < arity() + 1; j++) {
-                table[i][j] = new T[cfg.getNumNonTerminals()];
-            }
-        }
-    }
+    int span(int i, int j) const { return i * arity_ + j; } ///< \brief row of the tables for the sequence of variables from i to j
 
     template <class T>
-    void deleteTable(T***& table)
+    void resizeTable(DPTable<T>& table)
     {
-        for (int i = 0; i < arity() + 1; i++) {
-            for (int j = 0; j < arity() + 1; j++) {
-                delete[] table[i][j];
-            }
-            delete[] table[i];
-        }
-        delete[] table;
-        table = NULL;
+        table.resize(arity() * arity(), cfg.getNumNonTerminals());
     }
 
-    void recomputeTable(Cost*** table, Cost*** upTable = NULL);
+    // recompute the cells of table for the sequences of variables intersecting [first, last] and then all the cells of upTable
+    void recomputeTable(DPTable<Cost>& table, DPTable<Cost>* upTable = NULL, int first = 0, int last = INT_MAX);
     void recompute();
 
     Cost unary(int ch, int var, Value v);
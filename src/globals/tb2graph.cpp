@@ -1,29 +1,21 @@
 #include "tb2graph.hpp"
 
 Graph::Graph(int n, int depth_)
-    : adjlist(n)
-    , vertexList(n)
-    //, potential(n, StoreCost(0))
+    : rowStart(n + 1, 0)
+    , buildRows(n)
+    , compressed(false)
+    , potential(n, StoreCost(MIN_COST))
+    , validPotential(false)
     , p(n)
     , counter(n)
     , d(n)
+    , reducedDist(n)
     , gsize(n)
-    , depth(depth_)
-    , intDLinkStore(n * n)
 {
-    for (int i = 0; i < n; i++)
-        vertexList[i] = new Vertex(n, depth_, &intDLinkStore);
 }
 
 Graph::~Graph()
 {
-    for (int i = 0; i < gsize; i++) {
-        delete vertexList[i];
-        for (vector<List_Node*>::iterator it = adjlist[i].begin();
-             it != adjlist[i].end(); it++) {
-            delete *it;
-        }
-    }
 }
 
 int Graph::addEdgeInternal(int u, int v, Cost w, Cost capacity, int tag,
@@ -35,156 +27,160 @@ int Graph::addEdgeInternal(int u, int v, Cost w, Cost capacity, int tag,
     if ((v < 0) || (v >= size()))
         return -1;
 
+    assert(!compressed);
     int eIndex = -1;
-    if (tag == NO_TAG) {
-        adjlist[u].push_back(new List_Node(depth, v, w, capacity, tag, index));
-        eIndex = adjlist[u].size() - 1;
-        if (capacity > 0) {
-            vertexList[u]->edgeList[v]->push_back(adjlist[u].size() - 1);
-            if (vertexList[u]->edgeList[v]->size() == 1) {
-                vertexList[u]->neighbor.push_back(v);
-            }
-        }
-    } else {
-        bool exist = false;
-        for (BTListWrapper<int>::iterator i = vertexList[u]->edgeList[v]->begin(); i != vertexList[u]->edgeList[v]->end() && !exist; ++i) {
-            List_Node& edge = *(adjlist[u][*i]);
-            if (edge.tag == tag)
-                exist = true;
-        }
-
-        if (!exist) {
-            adjlist[u].push_back(new List_Node(depth, v, w, capacity, tag, index));
-            eIndex = adjlist[u].size() - 1;
-            if (capacity > 0) {
-                vertexList[u]->edgeList[v]->push_back(adjlist[u].size() - 1);
-                if (vertexList[u]->edgeList[v]->size() == 1) {
-                    vertexList[u]->neighbor.push_back(v);
-                }
-            }
-        }
+    if ((tag == NO_TAG) || !findEdge(u, v, [&](int e) { return edgeTag[e] == tag; })) {
+        eIndex = edgeAdj.size();
+        edgeAdj.push_back(v);
+        edgeTag.push_back(tag);
+        edgeRev.push_back(index);
+        edgeWeight.push_back(StoreCost(w));
+        edgeCap.push_back(StoreCost(capacity));
+        buildRows[u].push_back(eIndex);
     }
 
     if (addReverse) {
         int rEdgeIndex = addEdgeInternal(v, u, -w, 0, tag, false, eIndex);
-        adjlist[u][eIndex]->rEdgeIndex = rEdgeIndex;
+        if (eIndex >= 0)
+            edgeRev[eIndex] = rEdgeIndex;
     }
 
     return eIndex;
 }
 
-bool Graph::removeEdge(int u, int v, int tag)
+void Graph::compressEdges()
 {
 
-    bool exist = false;
+    // new position of each edge, sorted by source node and then by adjacent node
+    int m = edgeAdj.size();
+    vector<int> position(m);
+    int pos = 0;
+    for (int u = 0; u < gsize; u++) {
+        rowStart[u] = pos;
+        vector<int>& row = buildRows[u];
+        stable_sort(row.begin(), row.end(), [this](int e1, int e2) { return edgeAdj[e1] < edgeAdj[e2]; });
+        for (vector<int>::iterator it = row.begin(); it != row.end(); ++it) {
+            position[*it] = pos++;
+        }
+    }
+    rowStart[gsize] = pos;
+    assert(pos == m);
+
+    vector<int> adj(m), tag(m), rev(m);
+    vector<StoreCost> weight(m, StoreCost(MIN_COST)), cap(m, StoreCost(MIN_COST));
+    for (int e = 0; e < m; e++) {
+        adj[position[e]] = edgeAdj[e];
+        tag[position[e]] = edgeTag[e];
+        rev[position[e]] = (edgeRev[e] >= 0) ? position[edgeRev[e]] : -1;
+        weight[position[e]] = StoreCost(edgeWeight[e]);
+        cap[position[e]] = StoreCost(edgeCap[e]);
+    }
+    edgeAdj.swap(adj);
+    edgeTag.swap(tag);
+    edgeRev.swap(rev);
+    edgeWeight.swap(weight);
+    edgeCap.swap(cap);
+
+    vector<vector<int>>().swap(buildRows);
+    compressed = true;
+}
+
+// removing an edge keeps the potentials valid
+bool Graph::removeEdge(int u, int v, int tag)
+{
 
     if ((u < 0) || (u >= size()))
-        return exist;
+        return false;
     if ((v < 0) || (v >= size()))
-        return exist;
-
-    for (BTListWrapper<int>::iterator i = vertexList[u]->edgeList[v]->begin(); i != vertexList[u]->edgeList[v]->end() && !exist; ++i) {
-        List_Node& edge = *(adjlist[u][*i]);
-        if ((tag == NO_TAG) || (tag == edge.tag)) {
-            edge.cap = 0;
-            vertexList[u]->edgeList[v]->erase(i);
-            if (vertexList[u]->edgeList[v]->size() == 0) {
-                vertexList[u]->neighbor.remove(v);
-            }
-            exist = true;
-            break;
-        }
-    }
+        return false;
 
-    return exist;
+    compress();
+    return findEdge(u, v, [&](int e) {
+        if ((tag == NO_TAG) || (tag == edgeTag[e])) {
+            edgeCap[e] = 0;
+            return true;
+        }
+        return false;
+    });
 }
 
 bool Graph::modifyCost(int u, int v, Cost cost, int tag)
 {
 
-    bool exist = false;
-
     if ((u < 0) || (u >= size()))
-        return exist;
+        return false;
     if ((v < 0) || (v >= size()))
-        return exist;
-
-    //int originalWeight = -1;
-    int rEdgeIndex = -1;
-
-    for (BTListWrapper<int>::iterator i = vertexList[u]->edgeList[v]->begin(); i != vertexList[u]->edgeList[v]->end(); ++i) {
-        List_Node& edge = *(adjlist[u][*i]);
-        if ((tag == NO_TAG) || (tag == edge.tag)) {
-            //originalWeight = edge.weight;
-            rEdgeIndex = edge.rEdgeIndex;
-            edge.weight = cost;
-            exist = true;
-            break;
+        return false;
+
+    compress();
+    int e = -1;
+    findEdge(u, v, [&](int k) {
+        if ((tag == NO_TAG) || (tag == edgeTag[k])) {
+            e = k;
+            return true;
         }
-    }
+        return false;
+    });
 
-    if (exist) {
-        if (rEdgeIndex >= 0) {
-            List_Node& edge = *(adjlist[v][rEdgeIndex]);
-            if (edge.cap == 0) {
-                edge.weight = -cost;
-            }
-        }
+    if (e < 0)
+        return false;
+
+    edgeWeight[e] = cost;
+    checkReducedCost(u, e);
+    int rEdgeIndex = edgeRev[e];
+    if ((rEdgeIndex >= 0) && (edgeCap[rEdgeIndex] == 0)) {
+        edgeWeight[rEdgeIndex] = -cost;
     }
 
-    return exist;
+    return true;
 }
 
 bool Graph::increaseCost(int u, int v, Cost cost, int tag)
 {
 
-    bool exist = false;
-
     if ((u < 0) || (u >= size()))
-        return exist;
+        return false;
     if ((v < 0) || (v >= size()))
-        return exist;
-
-    //int originalWeight = -1;
-    int rEdgeIndex = -1;
-    for (BTListWrapper<int>::iterator i = vertexList[u]->edgeList[v]->begin(); i != vertexList[u]->edgeList[v]->end(); ++i) {
-        List_Node& edge = *(adjlist[u][*i]);
-        if ((tag == NO_TAG) || (tag == edge.tag)) {
-            //originalWeight = edge.weight;
-            rEdgeIndex = edge.rEdgeIndex;
-            edge.weight += cost;
-            exist = true;
-            break;
+        return false;
+
+    compress();
+    int e = -1;
+    findEdge(u, v, [&](int k) {
+        if ((tag == NO_TAG) || (tag == edgeTag[k])) {
+            e = k;
+            return true;
         }
-    }
+        return false;
+    });
 
-    if (exist) {
-        if (rEdgeIndex >= 0) {
-            List_Node& edge = *(adjlist[v][rEdgeIndex]);
-            if (edge.cap == 0) {
-                edge.weight -= cost;
-            }
-        }
+    if (e < 0)
+        return false;
+
+    edgeWeight[e] += cost;
+    checkReducedCost(u, e);
+    int rEdgeIndex = edgeRev[e];
+    if ((rEdgeIndex >= 0) && (edgeCap[rEdgeIndex] == 0)) {
+        edgeWeight[rEdgeIndex] -= cost;
     }
 
-    return exist;
+    return true;
 }
 
 bool Graph::edgeExist(int u, int v)
 {
-    return !(vertexList[u]->edgeList[v]->empty());
+    return findEdge(u, v, [](int e) { return true; });
 }
 
 vector<Cost> Graph::getWeight(int u, int v, int tag)
 {
 
     vector<Cost> weight;
-    for (BTListWrapper<int>::iterator i = vertexList[u]->edgeList[v]->begin(); i != vertexList[u]->edgeList[v]->end(); ++i) {
-        List_Node& edge = *(adjlist[u][*i]);
-        if ((tag == NO_TAG) || (tag == edge.tag)) {
-            weight.push_back(edge.weight);
+    findEdge(u, v, [&](int e) {
+        if ((tag == NO_TAG) || (tag == edgeTag[e])) {
+            weight.push_back(edgeWeight[e]);
         }
-    }
+        return false;
+    });
 
     return weight;
 }
@@ -193,12 +189,12 @@ Cost Graph::getMinWeight(int u, int v, int tag)
 {
 
     Cost minWeight = MAX_COST + 2;
-    for (BTListWrapper<int>::iterator i = vertexList[u]->edgeList[v]->begin(); i != vertexList[u]->edgeList[v]->end(); ++i) {
-        List_Node& edge = *(adjlist[u][*i]);
-        if ((tag == NO_TAG) || (tag == edge.tag)) {
-            minWeight = min(minWeight, (Cost)edge.weight);
+    findEdge(u, v, [&](int e) {
+        if ((tag == NO_TAG) || (tag == edgeTag[e])) {
+            minWeight = min(minWeight, (Cost)edgeWeight[e]);
         }
-    }
+        return false;
+    });
 
     return minWeight;
 }
@@ -206,46 +202,32 @@ Cost Graph::getMinWeight(int u, int v, int tag)
 void Graph::addFlow(int u, int v, Cost flowval)
 {
 
+    compress();
     Cost target = getMinWeight(u, v);
-    for (BTListWrapper<int>::iterator i = vertexList[u]->edgeList[v]->begin(); i != vertexList[u]->edgeList[v]->end(); ++i) {
-        List_Node& edge = *(adjlist[u][*i]);
-        if (edge.weight == target) {
-            edge.cap -= flowval;
-            if (edge.cap <= 0) {
-                vertexList[u]->edgeList[v]->erase(i);
-                if (vertexList[u]->edgeList[v]->size() == 0) {
-                    vertexList[u]->neighbor.remove(v);
-                }
-            }
-            assert(edge.rEdgeIndex >= 0);
-            List_Node& redge = *(adjlist[v][edge.rEdgeIndex]);
-            if ((redge.cap == 0) && (flowval > 0)) {
-                vertexList[v]->edgeList[u]->push_back(edge.rEdgeIndex);
-                if (vertexList[v]->edgeList[u]->size() == 1) {
-                    vertexList[v]->neighbor.push_back(u);
-                }
-            }
-            redge.cap += flowval;
-            break;
+    findEdge(u, v, [&](int e) {
+        if (edgeWeight[e] == target) {
+            edgeCap[e] -= flowval;
+            int r = edgeRev[e];
+            assert(r >= 0);
+            edgeCap[r] += flowval;
+            checkReducedCost(v, r);
+            return true;
         }
-    }
+        return false;
+    });
 }
 
 pair<int, Cost> Graph::minCostFlow(int s, int t)
 {
 
-    //int n = size();
     Cost flow = 0;
     Cost cost = 0;
     bool stopped = false;
 
-    //shortest_path(s);
-    //for (int i=0;i<n;i++) potential[i] = d[i];
     int iterationCount = 0;
     while (!stopped) {
         iterationCount++;
         stopped = false;
-        //shortest_path_with_potential(s);
         shortest_path(s);
         int u = t;
         Cost minc = MAX_COST + 1;
@@ -256,11 +238,11 @@ pair<int, Cost> Graph::minCostFlow(int s, int t)
                 break;
             } else {
                 Cost minw = MAX_COST + 2;
-                for (BTListWrapper<int>::iterator j = vertexList[v]->edgeList[u]->begin(); j != vertexList[v]->edgeList[u]->end(); ++j) {
-                    List_Node& edge = *(adjlist[v][*j]);
-                    if ((minw > edge.weight) && (minc > edge.cap))
-                        minc = edge.cap;
-                }
+                findEdge(v, u, [&](int e) {
+                    if ((minw > edgeWeight[e]) && (minc > edgeCap[e]))
+                        minc = edgeCap[e];
+                    return false;
+                });
                 u = v;
             }
         }
@@ -268,12 +250,13 @@ pair<int, Cost> Graph::minCostFlow(int s, int t)
         if (!stopped) {
             flow += minc;
             cost += d[t] * minc;
+            if (validPotential)
+                updatePotentials();
             int u = t;
             while (p[u] != u) {
                 addFlow(p[u], u, minc);
                 u = p[u];
             }
-            //for (int i=0;i<n;i++) potential[i] += d[i];
         }
     }
 
@@ -293,19 +276,18 @@ pair<Cost, bool> Graph::augment(int s, int t, bool can_change)
     bool exist = false;
 
     Cost minw = MAX_COST + 3;
-    for (BTListWrapper<int>::iterator i = vertexList[t]->edgeList[s]->begin(); i != vertexList[t]->edgeList[s]->end(); ++i) {
-        List_Node& edge = *(adjlist[t][*i]);
-        assert(edge.cap != 0);
-        if (minw >= edge.weight) {
-            minc = edge.cap;
+    findEdge(t, s, [&](int e) {
+        assert(edgeCap[e] != 0);
+        if (minw >= edgeWeight[e]) {
+            minc = edgeCap[e];
             exist = true;
         }
-    }
+        return false;
+    });
     int count = 0;
 
     assert(minc > 0);
 
-    std::ostringstream ss;
     while (p[u] != u && result.second) {
         int v = p[u];
         count++;
@@ -316,13 +298,13 @@ pair<Cost, bool> Graph::augment(int s, int t, bool can_change)
             break;
         } else {
             Cost minw = MAX_COST + 2;
-            for (BTListWrapper<int>::iterator i = vertexList[v]->edgeList[u]->begin(); i != vertexList[v]->edgeList[u]->end(); ++i) {
-                List_Node& edge = *(adjlist[v][*i]);
-                if (minw >= edge.weight) {
-                    if (minc > edge.cap)
-                        minc = edge.cap;
+            findEdge(v, u, [&](int e) {
+                if (minw >= edgeWeight[e]) {
+                    if (minc > edgeCap[e])
+                        minc = edgeCap[e];
                 }
-            }
+                return false;
+            });
             u = v;
         }
     }
@@ -334,6 +316,8 @@ pair<Cost, bool> Graph::augment(int s, int t, bool can_change)
     assert(minc > 0);
 
     if (can_change && result.second) {
+        if (validPotential)
+            updatePotentials();
         u = t;
         while (p[u] != u) {
             addFlow(p[u], u, minc);
@@ -341,7 +325,6 @@ pair<Cost, bool> Graph::augment(int s, int t, bool can_change)
         }
         if (exist)
             addFlow(t, s, minc);
-        //for (int i=0;i<size();i++) potential[i] = d[i];
     }
 
     return result;
@@ -350,6 +333,11 @@ pair<Cost, bool> Graph::augment(int s, int t, bool can_change)
 void Graph::removeNegativeCycles(StoreCost& cost)
 {
 
+    // valid potentials ensure there is no negative cycle
+    if (validPotential)
+        return;
+
+    compress();
     int n = size();
     int pass[n];
 
@@ -361,8 +349,13 @@ void Graph::removeNegativeCycles(StoreCost& cost)
             Q.push_back(i);
         shortest_path(Q, nevloop);
 
-        if (!nevloop)
+        if (!nevloop) {
+            Cost* pot = StoreCost::storeArray(potential.data(), n);
+            for (int i = 0; i < n; i++)
+                pot[i] = d[i];
+            validPotential = true;
             break;
+        }
 
         int t = -1;
         for (int i = 0; i < n; i++) {
@@ -399,13 +392,13 @@ void Graph::removeNegativeCycles(StoreCost& cost)
             v = *(i + 1);
             Cost w = INF;
             Cost c = INF;
-            for (BTListWrapper<int>::iterator j = vertexList[u]->edgeList[v]->begin(); j != vertexList[u]->edgeList[v]->end(); ++j) {
-                List_Node& edge = *(adjlist[u][*j]);
-                if (edge.weight < w) {
-                    w = edge.weight;
-                    c = edge.cap;
+            findEdge(u, v, [&](int e) {
+                if (edgeWeight[e] < w) {
+                    w = edgeWeight[e];
+                    c = edgeCap[e];
                 }
-            }
+                return false;
+            });
             weight += w;
             if (minc > c)
                 minc = c;
@@ -415,13 +408,6 @@ void Graph::removeNegativeCycles(StoreCost& cost)
             for (vector<int>::iterator i = path.begin(); i != path.end() - 1; i++) {
                 u = *i;
                 v = *(i + 1);
-                Cost w = INF;
-                for (BTListWrapper<int>::iterator j = vertexList[u]->edgeList[v]->begin(); j != vertexList[u]->edgeList[v]->end(); ++j) {
-                    List_Node& edge = *(adjlist[u][*j]);
-                    if (edge.weight < w) {
-                        w = edge.weight;
-                    }
-                }
                 addFlow(u, v, minc);
             }
             cost += minc * weight;
@@ -432,38 +418,40 @@ void Graph::removeNegativeCycles(StoreCost& cost)
 void Graph::print(ostream& os)
 {
 
+    compress();
     for (int u = 0; u < gsize; u++) {
         os << u << ": ";
-        for (BTListWrapper<int>::iterator j = vertexList[u]->neighbor.begin(); j != vertexList[u]->neighbor.end(); ++j) {
-            os << *j << "(" << vertexList[u]->edgeList[*j]->size() << ") ";
+        for (node_iterator j = node_begin(u); j != node_end(u); ++j) {
+            int count = 0;
+            for (edge_iterator k = begin(u, *j); k != end(u, *j); ++k)
+                count++;
+            os << *j << "(" << count << ") ";
         }
         os << "\n";
     }
 
-    /*os << "==potential==\n";
+    os << "==potential==\n";
+    for (int u = 0; u < gsize; u++) {
+        os << u << ": " << potential[u] << " ";
+    }
+    os << ((validPotential) ? "(valid)" : "(invalid)") << "\n";
 
-	for (int u=0;u<gsize;u++) {
-		os << u << ": " << potential[u] << " ";
-	}
-	os << "\n";
-     */
     os << "==graph===\n";
 
     for (int i = 0; i < gsize; i++) {
         os << i << ":";
-        for (vector<List_Node*>::iterator ptr = adjlist[i].begin(); ptr != adjlist[i].end(); ++ptr) {
-            List_Node* j = *ptr;
-            if (j->cap > 0) {
-                if (j->tag != NO_TAG) {
-                    os << "(" << j->adj << "," << j->weight << "," << j->cap << "," << j->tag << ") ";
+        for (int e = rowStart[i]; e < rowStart[i + 1]; e++) {
+            if (edgeCap[e] > 0) {
+                if (edgeTag[e] != NO_TAG) {
+                    os << "(" << edgeAdj[e] << "," << edgeWeight[e] << "," << edgeCap[e] << "," << edgeTag[e] << ") ";
                 } else {
-                    os << "(" << j->adj << "," << j->weight << "," << j->cap << ",-) ";
+                    os << "(" << edgeAdj[e] << "," << edgeWeight[e] << "," << edgeCap[e] << ",-) ";
                 }
             } else {
-                if (j->tag != NO_TAG) {
-                    os << "[[" << j->adj << "," << j->weight << "," << j->cap << "," << j->tag << "]] ";
+                if (edgeTag[e] != NO_TAG) {
+                    os << "[[" << edgeAdj[e] << "," << edgeWeight[e] << "," << edgeCap[e] << "," << edgeTag[e] << "]] ";
                 } else {
-                    os << "[[" << j->adj << "," << j->weight << "," << j->cap << ",-]] ";
+                    os << "[[" << edgeAdj[e] << "," << edgeWeight[e] << "," << edgeCap[e] << ",-]] ";
                 }
             }
         }
@@ -474,6 +462,7 @@ void Graph::print(ostream& os)
 void Graph::shortest_path(list<int>& sources, bool& nevloop)
 {
 
+    compress();
     int n = size();
     for (int i = 0; i < n; i++) {
         p[i] = -1;
@@ -496,15 +485,14 @@ void Graph::shortest_path(list<int>& sources, bool& nevloop)
             break;
         }
         Q.pop_front();
-        for (BTListWrapper<int>::iterator j = vertexList[u]->neighbor.begin(); j != vertexList[u]->neighbor.end(); ++j) {
-            BTListWrapper<int>& edgeList = *(vertexList[u]->edgeList[*j]);
-            for (BTListWrapper<int>::iterator k = edgeList.begin(); k != edgeList.end(); ++k) {
-                List_Node& edge = *(adjlist[u][*k]);
-                if ((d[u] + edge.weight < d[edge.adj])) {
-                    d[edge.adj] = d[u] + edge.weight;
-                    p[edge.adj] = u;
-                    Q.push_back(edge.adj);
-                    counter[edge.adj]++;
+        for (int e = rowStart[u]; e < rowStart[u + 1]; e++) {
+            if (edgeCap[e] > 0) {
+                int v = edgeAdj[e];
+                if ((d[u] + edgeWeight[e] < d[v])) {
+                    d[v] = d[u] + edgeWeight[e];
+                    p[v] = u;
+                    Q.push_back(v);
+                    counter[v]++;
                 }
             }
         }
@@ -523,59 +511,87 @@ void Graph::printPath(int s, int t)
     cout << u << " <- " << endl;
 }
 
-// Not used due to error in updating potentials after argumentation
-/*
-void Graph::shortest_path_with_potential(int s) {
-
-	int n = size();
-	for (int i=0;i<n;i++) {
-		p[i] = -1;  
-		d[i] = INF; 
-		counter[i] = 0; 
-	}
-	d[s] = 0;   p[s] = s;
-
-	priority_queue<pair<Cost, int> > Q;
-	Q.push(make_pair(0, s));	
-	for (int i=0;i<n;i++) {
-		int u = -1;
-		while (!Q.empty()) {
-			pair<Cost, int> top = Q.top();
-			Q.pop();	
-			if (counter[top.second] == 0) {
-				u = top.second;
-				break;
-			}
-		}
-		if (u == -1) break;
-		counter[u]++;
-		for (BTListWrapper<int>::iterator j = vertexList[u]->neighbor.begin(); j !=
-						vertexList[u]->neighbor.end();++j) {
-			BTListWrapper<int> &edgeList = *(vertexList[u]->edgeList[*j]);
-			for (BTListWrapper<int>::iterator k = edgeList.begin(); k !=
-				edgeList.end();++k) {		
-				List_Node &edge = *(adjlist[u][*k]);
-				Cost weight = edge.weight + potential[u] - potential[edge.adj];
-				if (weight < 0) {
-					cout << "(u,v): " << u << " " << edge.adj << " weight: " <<
-					edge.weight << "\n";
-				}
-				assert(weight >= 0);
-				if ((d[u] + weight < d[edge.adj])) {
-					d[edge.adj] = d[u] + weight;
-					p[edge.adj] = u;
-					Q.push(make_pair(-d[edge.adj], edge.adj));
-				}
-			}
-		}
-	}	
-
-	for (int i=0;i<n;i++) {
-		d[i] = d[i] - potential[s] + potential[i];
-	}
+bool Graph::computePotentials()
+{
+
+    int n = size();
+    bool nevloop = false;
+    list<int> Q;
+    for (int i = 0; i < n; i++)
+        Q.push_back(i);
+    shortest_path(Q, nevloop);
+    if (nevloop)
+        return false;
 
+    Cost* pot = StoreCost::storeArray(potential.data(), n);
+    for (int i = 0; i < n; i++)
+        pot[i] = d[i];
+    validPotential = true;
+    return true;
+}
+
+void Graph::updatePotentials()
+{
+
+    // unreachable nodes are shifted by the largest reduced distance so that
+    // edges coming from them keep a non-negative reduced cost
+    int n = size();
+    Cost maxDist = 0;
+    for (int i = 0; i < n; i++) {
+        if (p[i] != -1 && reducedDist[i] > maxDist)
+            maxDist = reducedDist[i];
+    }
+    Cost* pot = StoreCost::storeArray(potential.data(), n);
+    for (int i = 0; i < n; i++) {
+        pot[i] += (p[i] != -1) ? reducedDist[i] : maxDist;
+    }
+}
+
+void Graph::shortest_path_with_potential(int s)
+{
+
+    assert(compressed && validPotential);
+    int n = size();
+    for (int i = 0; i < n; i++) {
+        p[i] = -1;
+        reducedDist[i] = INF;
+        counter[i] = 0;
+    }
+    reducedDist[s] = 0;
+    p[s] = s;
+
+    // binary heap with lazy deletion of the nodes already settled
+    greater<pair<Cost, int>> cmp;
+    heap.clear();
+    heap.push_back(make_pair(MIN_COST, s));
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), cmp);
+        int u = heap.back().second;
+        heap.pop_back();
+        if (counter[u] != 0)
+            continue;
+        counter[u]++;
+        Cost pu = potential[u];
+        for (int e = rowStart[u]; e < rowStart[u + 1]; e++) {
+            if (edgeCap[e] > 0) {
+                int v = edgeAdj[e];
+                Cost weight = (Cost)edgeWeight[e] + pu - (Cost)potential[v];
+                assert(weight >= 0);
+                if (reducedDist[u] + weight < reducedDist[v]) {
+                    reducedDist[v] = reducedDist[u] + weight;
+                    p[v] = u;
+                    heap.push_back(make_pair((Cost)reducedDist[v], v));
+                    push_heap(heap.begin(), heap.end(), cmp);
+                }
+            }
+        }
+    }
+
+    // real distances (same as Bellmanford)
+    for (int i = 0; i < n; i++) {
+        d[i] = (p[i] != -1) ? reducedDist[i] - (Cost)potential[s] + (Cost)potential[i] : INF;
+    }
 }
- */
 
 /*
    set<set<int> >& Graph::compute_scc() {
@@ -1,6 +1,10 @@
 /** \file tb2graph.hpp
- *  \brief Multiple-edged Graph using the adjacent list structure for modelling the flow model
- * 
+ *  \brief Multiple-edged Graph using a compressed sparse row structure for modelling the flow model
+ *
+ *  Edges are added first (see Graph::addEdge). They are stored contiguously per source node at the first flow computation,
+ *  sorted by adjacent node. Edge costs and residual capacities are backtrackable. An edge with a zero capacity is considered deleted.
+ *
+ *  \warning all the edges must be added before the first flow computation (see Graph::compress)
  */
 
 #ifndef TB2GRAPH
@@ -20,167 +24,82 @@
     }
 #define NO_TAG (INT_MAX >> 1)
 
-// BTList Wrapper for easier usage
-template <typename T>
-class DLinkStore {
-private:
-    int blkSize;
-    StoreInt curEmpty;
-    StoreInt curUsingBlkIndex;
-    vector<DLink<T>*> blockStore;
-
-public:
-    DLinkStore(int blkSize_)
-        : blkSize(blkSize_)
-        , curEmpty(0)
-        , curUsingBlkIndex(0)
-    {
-        blockStore.push_back(new DLink<T>[blkSize]);
-    }
-    ~DLinkStore()
-    {
-        for (vector<DLink<int>*>::iterator it = blockStore.begin();
-             it != blockStore.end(); it++) {
-            delete[] * it;
-        }
-        blockStore.clear();
-    }
-
-    DLink<T>* allocate(const T& ele)
-    {
-        if (curEmpty >= blkSize) {
-            curEmpty = 0;
-            curUsingBlkIndex = curUsingBlkIndex + 1;
-            if (curUsingBlkIndex >= (int)blockStore.size()) {
-                blockStore.push_back(new DLink<T>[blkSize]);
-            }
-        }
-        DLink<int>* container = &(blockStore[curUsingBlkIndex][curEmpty]);
-        container->content = ele;
-        curEmpty = curEmpty + 1;
-        return container;
-    }
-};
+class Graph {
 
-template <typename T>
-class BTListWrapper {
 private:
-    BTList<T> list;
-    DLinkStore<T>* dlinkStore;
+    // edges in compressed sparse row format: the edges going out of node u are
+    // [rowStart[u], rowStart[u+1]) sorted by adjacent node (in order of addition for multiple edges)
+    vector<int> rowStart;
+    vector<int> edgeAdj; // the node connecting to
+    vector<int> edgeTag; // the label of the edge
+    vector<int> edgeRev; // the index of the opposite edge (-1 if none)
+    // entities need to backtrack (not reallocated after compression)
+    vector<StoreCost> edgeWeight; // the weight
+    vector<StoreCost> edgeCap; // the capacity, if cap = 0, the edge is set to "deleted"
+
+    // edges added so far for each source node (before compression only)
+    vector<vector<int>> buildRows;
+    bool compressed;
+
+    // potentials: the reduced cost weight + potential[u] - potential[v] of every edge (u,v) with a positive capacity
+    // is non-negative if validPotential is true (no negative cycle in the residual graph)
+    vector<StoreCost> potential;
+    StoreInt validPotential;
 
-public:
-    typedef typename BTList<T>::iterator iterator;
+    // pre-allocated temporary structure
+    vector<int> p;
+    vector<int> counter;
+    vector<Cost> d;
+    vector<Cost> reducedDist; // shortest path distances using reduced costs (see shortest_path_with_potential)
+    vector<pair<Cost, int>> heap;
 
-    BTListWrapper(DLinkStore<int>* dlinkStore)
-        : list(&Store::storeIndexList)
-        , dlinkStore(dlinkStore)
-    {
-    }
+    // the number of node in the graph
+    int gsize;
 
-    ~BTListWrapper() {}
+    // do not allow copy
+    Graph(const Graph& g);
 
-    size_t size()
-    {
-        return list.getSize();
-    }
-    bool empty()
-    {
-        return list.getSize() == 0;
-    }
-    void push_back(const T& ele)
+    // store the edges contiguously per source node before the first flow computation
+    void compress()
     {
-        DLink<T>* container = dlinkStore->allocate(ele);
-        list.push_back(container, true);
+        if (!compressed)
+            compressEdges();
     }
-    void remove(const T& ele)
+    void compressEdges();
+
+    // call f(e) for each edge e from u to v with a positive capacity until f returns true
+    // return true if f returned true
+    template <typename F>
+    bool findEdge(int u, int v, F f)
     {
-        DLink<T>* target = NULL;
-        for (typename BTList<T>::iterator it = list.begin(); it != list.end()
-             && (target == NULL);
-             ++it) {
-            if (*it == ele) {
-                target = it.getElt();
+        if (compressed) {
+            for (int e = lower_bound(edgeAdj.begin() + rowStart[u], edgeAdj.begin() + rowStart[u + 1], v) - edgeAdj.begin(); e < rowStart[u + 1] && edgeAdj[e] == v; e++) {
+                if (edgeCap[e] > 0 && f(e))
+                    return true;
+            }
+        } else {
+            for (vector<int>::iterator it = buildRows[u].begin(); it != buildRows[u].end(); ++it) {
+                if (edgeAdj[*it] == v && edgeCap[*it] > 0 && f(*it))
+                    return true;
             }
         }
-        if (target != NULL) {
-            list.erase(target, true);
-        }
+        return false;
     }
-    void erase(iterator& it)
+
+    // invalidate the potentials if the reduced cost of edge e from u becomes negative
+    void checkReducedCost(int u, int e)
     {
-        list.erase(it.getElt(), true);
+        if (validPotential && edgeCap[e] > 0 && (Cost)edgeWeight[e] + (Cost)potential[u] - (Cost)potential[edgeAdj[e]] < 0)
+            validPotential = false;
     }
-    iterator begin() { return list.begin(); }
-    iterator end() { return list.end(); }
-};
-
-class Graph {
-
-private:
-    // structure representing an edge
-    struct List_Node {
-        // entities need to backtrack
-        StoreCost weight; // the weight
-        StoreCost cap; //the capacity, if cap = 0, the edge is set to "deleted"
-        // entities need not backtrack
-        int adj; //the node connecting to
-        int tag; // the label of the edge
-        int rEdgeIndex; // the pointer to the opposite edge
-        List_Node(int depth, int a = -1, Cost w = 0, Cost c = 0, int t = NO_TAG, int rIndex = -1)
-            : weight(w)
-            , cap(c)
-            , adj(a)
-            , tag(t)
-            , rEdgeIndex(rIndex)
-        {
-        }
-    };
-
-    // structure representing a node
-    typedef int EdgePtr;
-    struct Vertex {
-        // entities need to backtrack
-        vector<BTListWrapper<EdgePtr>*> edgeList;
-        BTListWrapper<int> neighbor;
-
-        Vertex(int n, int depth, DLinkStore<int>* dLinkStore)
-            : edgeList(n)
-            , neighbor(dLinkStore)
-        {
-            for (int i = 0; i < n; i++)
-                edgeList[i] = new BTListWrapper<int>(dLinkStore);
-        }
-
-        ~Vertex()
-        {
-            for (unsigned int i = 0; i < edgeList.size(); i++)
-                delete edgeList[i];
-        }
-    };
-
-    // native adjacent lists, storing all edges possibly appears during search
-    vector<vector<List_Node*>> adjlist;
-
-    // additional structure for speeding up traveral
-    vector<Vertex*> vertexList;
-
-    // potentials
-    //vector<StoreCost> potential;
-
-    // pre-allocated temporary structure
-    vector<int> p;
-    vector<int> counter;
-    vector<Cost> d;
 
-    // the number of node in the graph
-    int gsize;
-
-    // for backtractable structure
-    int depth;
-    DLinkStore<int> intDLinkStore;
+    // compute potentials from the shortest paths starting from all the nodes (using Bellmanford)
+    // return false if there is a negative cycle
+    bool computePotentials();
 
-    // do not allow copy
-    Graph(const Graph& g);
+    // add the reduced distances of the last shortest_path_with_potential to the potentials
+    // so that the edges of the shortest paths have a zero reduced cost
+    void updatePotentials();
 
 public:
     // constructor
@@ -268,6 +187,12 @@ public:
 
     void shortest_path(int source)
     {
+        compress();
+        if (validPotential || computePotentials()) {
+            shortest_path_with_potential(source);
+            return;
+        }
+
         list<int> sources;
         bool nevLoop;
 
@@ -289,14 +214,8 @@ public:
             pathCost[i] = d[i];
     }
 
-    // shortest path algorithm (using Dijkstra with reweighting)
-    // Not used due to error in computing potentials after argumentation
-    /*void shortest_path_with_potential(int source);
-		void shortest_path_with_potential(int source, vector<Cost> &pathCost) {
-			shortest_path_with_potential(source);
-			pathCost.resize(size());
-			for (int i=0;i<size();i++) pathCost[i] = d[i];	
-		}*/
+    // shortest path algorithm (using Dijkstra with reweighting by valid potentials)
+    void shortest_path_with_potential(int source);
 
     // just for checking
     void print()
@@ -306,18 +225,22 @@ public:
     void print(ostream& os);
     void printPath(int s, int t);
 
-    // iterate each in-coming edges
+    // iterate each out-going edges (including deleted edges)
     class iterator;
     friend class iterator;
     class iterator {
-        vector<List_Node*>::iterator next_edge;
+        Graph* g;
+        int next_edge;
 
     public:
         iterator()
+            : g(NULL)
+            , next_edge(0)
         {
         }
-        iterator(vector<List_Node*>::iterator _start)
-            : next_edge(_start)
+        iterator(Graph* _g, int _start)
+            : g(_g)
+            , next_edge(_start)
         {
         }
 
@@ -335,22 +258,22 @@ public:
 
         int adjNode()
         {
-            return (*next_edge)->adj;
+            return g->edgeAdj[next_edge];
         }
 
         Cost weight()
         {
-            return (*next_edge)->weight;
+            return g->edgeWeight[next_edge];
         }
 
         Cost capacity()
         {
-            return (*next_edge)->cap;
+            return g->edgeCap[next_edge];
         }
 
         int tag()
         {
-            return (*next_edge)->tag;
+            return g->edgeTag[next_edge];
         }
 
         // To see if you're at the end:
@@ -359,53 +282,63 @@ public:
     };
     iterator begin(int node)
     {
-        return iterator(adjlist[node].begin());
+        compress();
+        return iterator(this, rowStart[node]);
     }
     iterator end(int node)
     {
-        return iterator(adjlist[node].end());
+        compress();
+        return iterator(this, rowStart[node + 1]);
     }
 
-    // iterate each in-coming edges between two nodes
+    // iterate each out-going edges between two nodes
     class edge_iterator;
     friend class edge_iterator;
     class edge_iterator {
-        BTListWrapper<int>::iterator next_edge;
-        vector<List_Node*>& edgeInfo;
+        Graph* g;
+        int next_edge;
+        int last_edge;
+
+        void skipDeleted()
+        {
+            while (next_edge < last_edge && g->edgeCap[next_edge] <= 0)
+                next_edge++;
+        }
 
     public:
-        //edge_iterator() {}
-        edge_iterator(BTListWrapper<int>::iterator _start,
-            vector<List_Node*>& _edgeInfo)
-            : next_edge(_start)
-            , edgeInfo(_edgeInfo)
+        edge_iterator(Graph* _g, int _start, int _last)
+            : g(_g)
+            , next_edge(_start)
+            , last_edge(_last)
         {
+            skipDeleted();
         }
 
         edge_iterator& operator++()
         { // Prefix form
-            ++next_edge;
+            next_edge++;
+            skipDeleted();
             return *this;
         }
 
         int adjNode()
         {
-            return edgeInfo[*next_edge]->adj;
+            return g->edgeAdj[next_edge];
         }
 
         Cost weight()
         {
-            return edgeInfo[*next_edge]->weight;
+            return g->edgeWeight[next_edge];
         }
 
         Cost capacity()
         {
-            return edgeInfo[*next_edge]->cap;
+            return g->edgeCap[next_edge];
         }
 
         int tag()
         {
-            return edgeInfo[*next_edge]->tag;
+            return g->edgeTag[next_edge];
         }
 
         // To see if you're at the end:
@@ -414,47 +347,68 @@ public:
     };
     edge_iterator begin(int u, int v)
     {
-        return edge_iterator(vertexList[u]->edgeList[v]->begin(), adjlist[u]);
+        compress();
+        int first = lower_bound(edgeAdj.begin() + rowStart[u], edgeAdj.begin() + rowStart[u + 1], v) - edgeAdj.begin();
+        int last = upper_bound(edgeAdj.begin() + first, edgeAdj.begin() + rowStart[u + 1], v) - edgeAdj.begin();
+        return edge_iterator(this, first, last);
     }
     edge_iterator end(int u, int v)
     {
-        return edge_iterator(vertexList[u]->edgeList[v]->end(), adjlist[u]);
+        compress();
+        int last = upper_bound(edgeAdj.begin() + rowStart[u], edgeAdj.begin() + rowStart[u + 1], v) - edgeAdj.begin();
+        return edge_iterator(this, last, last);
     }
 
-    // iterate each neigbouring nodes
+    // iterate each neigbouring nodes (connected by at least one edge which is not deleted)
     class node_iterator;
     friend class node_iterator;
     class node_iterator {
-        BTListWrapper<int>::iterator next_node;
+        Graph* g;
+        int next_edge;
+        int last_edge;
+
+        void skipDeleted()
+        {
+            while (next_edge < last_edge && g->edgeCap[next_edge] <= 0)
+                next_edge++;
+        }
 
     public:
-        node_iterator(BTListWrapper<int>::iterator _start)
-            : next_node(_start)
+        node_iterator(Graph* _g, int _start, int _last)
+            : g(_g)
+            , next_edge(_start)
+            , last_edge(_last)
         {
+            skipDeleted();
         }
 
         node_iterator& operator++()
         { // Prefix form
-            ++next_node;
+            int node = g->edgeAdj[next_edge];
+            while (next_edge < last_edge && g->edgeAdj[next_edge] == node)
+                next_edge++;
+            skipDeleted();
             return *this;
         }
 
         int operator*()
         {
-            return *next_node;
+            return g->edgeAdj[next_edge];
         }
 
         // To see if you're at the end:
-        bool operator==(const node_iterator& iter) const { return next_node == iter.next_node; }
-        bool operator!=(const node_iterator& iter) const { return next_node != iter.next_node; }
+        bool operator==(const node_iterator& iter) const { return next_edge == iter.next_edge; }
+        bool operator!=(const node_iterator& iter) const { return next_edge != iter.next_edge; }
     };
     node_iterator node_begin(int node)
     {
-        return node_iterator(vertexList[node]->neighbor.begin());
+        compress();
+        return node_iterator(this, rowStart[node], rowStart[node + 1]);
     }
     node_iterator node_end(int node)
     {
-        return node_iterator(vertexList[node]->neighbor.end());
+        compress();
+        return node_iterator(this, rowStart[node + 1], rowStart[node + 1]);
     }
 };
 
@@ -3,15 +3,12 @@
 RegularDPConstraint::RegularDPConstraint(WCSP* wcsp, EnumeratedVariable** scope, int arity)
     : DPGlobalConstraint(wcsp, scope, arity)
     , top(0)
+    , upToDate(false)
 {
 }
 
 RegularDPConstraint::~RegularDPConstraint(void)
 {
-    deleteTable(f);
-    deleteTable(u);
-    deleteTable(invf);
-    deleteTable(curf);
 }
 
 void RegularDPConstraint::read(istream& file, bool mult)
@@ -54,10 +51,11 @@ void RegularDPConstraint::initMemoization()
 {
     dfa.finalize();
 
-    resizeTable(f, arity() + 1, dfa.size());
-    resizeTable(curf, arity() + 1, dfa.size());
-    resizeTable(invf, arity() + 1, dfa.size());
-    resizeTable(u, arity() + 1, dfa.symbol.size());
+    f.resize(arity() + 1, dfa.size());
+    curf.resize(arity() + 1, dfa.size());
+    invf.resize(arity() + 1, dfa.size());
+    u.resize(arity() + 1, dfa.symbol.size());
+    upToDate = false;
 
     top = max(wcsp->getUb(), MAX_COST);
 }
@@ -65,6 +63,7 @@ void RegularDPConstraint::initMemoization()
 Cost RegularDPConstraint::minCostOriginal()
 {
     int n = arity();
+    upToDate = false;
     for (int i = 1; i <= n; i++) {
         for (unsigned int j = 0; j < dfa.symbol.size(); j++) {
             u[i][j].val = top;
@@ -94,6 +93,7 @@ Cost RegularDPConstraint::minCostOriginal(int var, Value val, bool changed)
 Cost RegularDPConstraint::eval(const String& s)
 {
     int n = arity();
+    upToDate = false;
     for (int i = 1; i <= n; i++) {
         for (unsigned int j = 0; j < dfa.symbol.size(); j++) {
             u[i][j].val = unary(dfa.symbol[j], i - 1, s[i - 1] - CHAR_FIRST);
@@ -110,23 +110,41 @@ Cost RegularDPConstraint::eval(const String& s)
     return minCost - projectedCost;
 }
 
+// only the rows of the tables depending on modified unary costs are recomputed
 void RegularDPConstraint::recompute()
 {
     int n = arity();
+    int firstChangedRow = n + 1;
+    int lastChangedRow = 0;
     for (int i = 1; i <= n; i++) {
+        EnumeratedVariable* x = scope[i - 1];
         for (unsigned int j = 0; j < dfa.symbol.size(); j++) {
-            u[i][j].val = top;
-            u[i][j].source = -1;
-            EnumeratedVariable* x = scope[i - 1];
+            UnaryTableCell cell;
+            cell.val = top;
+            cell.source = -1;
             for (EnumeratedVariable::iterator it = x->begin(); it != x->end(); ++it) {
-                if (u[i][j].val > unary(dfa.symbol[j], i - 1, *it)) {
-                    u[i][j].val = unary(dfa.symbol[j], i - 1, *it);
-                    u[i][j].source = *it;
+                Cost ucost = unary(dfa.symbol[j], i - 1, *it);
+                if (cell.val > ucost) {
+                    cell.val = ucost;
+                    cell.source = *it;
                 }
             }
+            if (cell.val != u[i][j].val || cell.source != u[i][j].source) {
+                u[i][j] = cell;
+                firstChangedRow = min(firstChangedRow, i);
+                lastChangedRow = max(lastChangedRow, i);
+            }
         }
     }
-    recomputeTable(f, invf);
+
+    if (!upToDate) {
+        recomputeTable(f);
+        recomputeInvTable(invf);
+        upToDate = true;
+    } else if (firstChangedRow <= lastChangedRow) {
+        recomputeTable(f, firstChangedRow, lastChangedRow);
+        recomputeInvTable(invf, lastChangedRow, firstChangedRow);
+    }
 }
 
 DPGlobalConstraint::Result RegularDPConstraint::minCost(int var, Value val, bool changed)
@@ -147,7 +165,7 @@ DPGlobalConstraint::Result RegularDPConstraint::minCost(int var, Value val, bool
     return DPGlobalConstraint::Result(minCost, NULL);
 }
 
-void RegularDPConstraint::recomputeTable(DPTableCell** table, DPTableCell** invTable, int startRow)
+void RegularDPConstraint::recomputeTable(DPTable<DPTableCell>& table, int startRow, int lastChangedRow)
 {
     int n = arity();
 
@@ -164,37 +182,66 @@ void RegularDPConstraint::recomputeTable(DPTableCell** table, DPTableCell** invT
     }
 
     for (int i = startRow; i <= n; i++) {
+        DPTableCell* row = table[i];
+        DPTableCell* prev = table[i - 1];
+        UnaryTableCell* urow = u[i];
+        bool rowChanged = false;
         for (int j = 0; j < dfa.size(); j++) {
-            table[i][j].val = top;
-            table[i][j].source = make_pair(-1, -1);
-            for (vector<pair<int, int>>::iterator qk = dfa.invTransition[j].begin(); qk != dfa.invTransition[j].end(); qk++) {
-                int curCost = table[i - 1][qk->second].val + u[i][dfa.symbolIndex[qk->first]].val;
-                if (table[i][j].val > curCost) {
-                    table[i][j].val = curCost;
-                    table[i][j].source = make_pair(u[i][dfa.symbolIndex[qk->first]].source, qk->second);
+            DPTableCell cell;
+            cell.val = top;
+            cell.source = make_pair(-1, -1);
+            for (vector<pair<int, int>>::iterator qk = dfa.indexedInvTransition[j].begin(); qk != dfa.indexedInvTransition[j].end(); qk++) {
+                int curCost = prev[qk->second].val + urow[qk->first].val;
+                if (cell.val > curCost) {
+                    cell.val = curCost;
+                    cell.source = make_pair(urow[qk->first].source, qk->second);
                 }
             }
+            if (cell.val != row[j].val || cell.source != row[j].source) {
+                row[j] = cell;
+                rowChanged = true;
+            }
         }
+        if (!rowChanged && i >= lastChangedRow)
+            break;
     }
+}
+
+void RegularDPConstraint::recomputeInvTable(DPTable<DPTableCell>& invTable, int endRow, int firstChangedRow)
+{
+    int n = arity();
 
-    if (invTable != NULL) {
+    if (endRow < 0) {
         for (int j = 0; j < dfa.size(); j++)
             invTable[n][j].val = top;
         for (vector<int>::iterator it = dfa.final.begin(); it != dfa.final.end(); it++)
             invTable[n][*it].val = 0;
+        endRow = n;
+    }
 
-        for (int i = n - 1; i >= 0; i--) {
-            for (int j = 0; j < dfa.size(); j++) {
-                invTable[i][j].val = top;
-                for (vector<pair<int, int>>::iterator qj = dfa.transition[j].begin(); qj != dfa.transition[j].end(); qj++) {
-                    int curCost = invTable[i + 1][qj->second].val + u[i + 1][dfa.symbolIndex[qj->first]].val;
-                    if (invTable[i][j].val > curCost) {
-                        invTable[i][j].val = curCost;
-                        invTable[i][j].source = make_pair(u[i + 1][dfa.symbolIndex[qj->first]].source, qj->second);
-                    }
+    for (int i = endRow - 1; i >= 0; i--) {
+        DPTableCell* row = invTable[i];
+        DPTableCell* next = invTable[i + 1];
+        UnaryTableCell* urow = u[i + 1];
+        bool rowChanged = false;
+        for (int j = 0; j < dfa.size(); j++) {
+            DPTableCell cell;
+            cell.val = top;
+            cell.source = row[j].source;
+            for (vector<pair<int, int>>::iterator qj = dfa.indexedTransition[j].begin(); qj != dfa.indexedTransition[j].end(); qj++) {
+                int curCost = next[qj->second].val + urow[qj->first].val;
+                if (cell.val > curCost) {
+                    cell.val = curCost;
+                    cell.source = make_pair(urow[qj->first].source, qj->second);
                 }
             }
+            if (cell.val != row[j].val || cell.source != row[j].source) {
+                row[j] = cell;
+                rowChanged = true;
+            }
         }
+        if (!rowChanged && i < firstChangedRow)
+            break;
     }
 }
 
@@ -16,6 +16,8 @@ private:
         map<int, int> symbolIndex;
         vector<pair<int, int>>* transition;
         vector<pair<int, int>>* invTransition;
+        vector<vector<pair<int, int>>> indexedTransition; // same as transition with symbol indices instead of symbols (see finalize)
+        vector<vector<pair<int, int>>> indexedInvTransition; // same as invTransition with symbol indices
         int nstate;
 
         DFA()
@@ -58,6 +60,14 @@ private:
             for (vector<int>::iterator i = symbol.begin(); i != symbol.end(); i++) {
                 symbolIndex[*i] = i - symbol.begin();
             }
+            indexedTransition.assign(nstate, vector<pair<int, int>>());
+            indexedInvTransition.assign(nstate, vector<pair<int, int>>());
+            for (int s = 0; s < nstate; s++) {
+                for (vector<pair<int, int>>::iterator i = transition[s].begin(); i != transition[s].end(); i++)
+                    indexedTransition[s].push_back(make_pair(symbolIndex[i->first], i->second));
+                for (vector<pair<int, int>>::iterator i = invTransition[s].begin(); i != invTransition[s].end(); i++)
+                    indexedInvTransition[s].push_back(make_pair(symbolIndex[i->first], i->second));
+            }
         }
 
         void dump(ostream& os, bool original)
@@ -108,34 +118,22 @@ private:
     };
 
     typedef TableCell<pair<int, Value>> DPTableCell;
-    DPTableCell** f;
-    DPTableCell** curf;
-    DPTableCell** invf;
+    DPTable<DPTableCell> f; // forward table: row i gives the minimum cost to reach each state after the first i variables
+    DPTable<DPTableCell> curf;
+    DPTable<DPTableCell> invf; // backward table: row i gives the minimum cost to reach a final state from each state after the first i variables
 
     typedef TableCell<Value> UnaryTableCell;
-    UnaryTableCell** u;
+    DPTable<UnaryTableCell> u; // row i gives the minimum unary cost of variable i-1 for each symbol
 
     int top;
-
-    template <class T>
-    void resizeTable(T**& table, int width, int heigth)
-    {
-        table = new T*[width];
-        for (int i = 0; i <= arity(); i++) {
-            table[i] = new T[heigth];
-        }
-    }
-
-    template <class T>
-    void deleteTable(T**& table)
-    {
-        for (int i = 0; i <= arity(); i++)
-            delete[] table[i];
-        delete[] table;
-        table = NULL;
-    }
-
-    void recomputeTable(DPTableCell** table, DPTableCell** invTable = NULL, int startRow = 0);
+    bool upToDate; // true if f and invf correspond to u
+
+    // recompute the rows of table from startRow (from the initial row if zero)
+    // stop at the first unchanged row after lastChangedRow (last row of u which has changed)
+    void recomputeTable(DPTable<DPTableCell>& table, int startRow = 0, int lastChangedRow = INT_MAX);
+    // recompute the rows of invTable from endRow - 1 down to zero (from the final row if endRow is negative)
+    // stop at the first unchanged row before firstChangedRow (first row of u which has changed)
+    void recomputeInvTable(DPTable<DPTableCell>& invTable, int endRow = -1, int firstChangedRow = 0);
     void recompute();
 
     Cost unary(int ch, int var, Value v);
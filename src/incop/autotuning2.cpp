@@ -22,7 +22,7 @@ using namespace std;
 #include <unistd.h>
 
 extern ofstream* ofile; // le fichier de sortie
-extern Stat_GWW* Statistiques;
+extern thread_local Stat_GWW* Statistiques;
 
 Tuning::Tuning(int pinit, int seed1, int nbessai, int maxtun, int bmin, int bmax)
 {
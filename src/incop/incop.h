@@ -70,6 +70,8 @@
 /* les classes "abstraites" utilisées dans les paramètres des méthodes */
 class OpProblem;
 class IncompleteAlgorithm;
+class LSAlgorithm;
+class ParticleWalkers;
 class Metaheuristic;
 class NeighborhoodSearch;
 class Move;
@@ -376,6 +378,10 @@ public:
 	(utilisé dans les recherches locales des marches de GWW)*/
     /** a threshold can be used to forbid moves above this threshold (used in LSAlgorithms implementing walks inside GWW)*/
     Long threshold;
+    /* nombre de threads pour l'évaluation et les marches de la population (1 si l'évaluation du problème n'est pas réentrante) */
+    /** number of threads for evaluating and walking the population (1 if the problem evaluation is not reentrant) */
+    int nbthreads;
+    IncompleteAlgorithm() { nbthreads = 1; };
     virtual ~IncompleteAlgorithm(){};
     /* marche d'une particule */
     /** walk for a particule */
@@ -410,8 +416,17 @@ public:
     /* nombre de mouvements effectués */
     /** number of moves done */
     int nbmoves;
+    /* mouvements et meilleure configuration propres à la marche d'une particule de GWW (NULL : ceux du problème) */
+    /** moves and best configuration owned by the walk of a GWW particle (NULL to use those of the problem) */
+    Move* currentmove;
+    Move* firstmove;
+    Move* bestmove;
+    Configuration* best_config;
     LSAlgorithm(int nbmov);
     ~LSAlgorithm();
+    /* allocation des mouvements et de la meilleure configuration propres à la marche */
+    /** allocation of the moves and best configuration owned by the walk */
+    void allocate_walk(OpProblem* problem);
     /* faisabilité d'un mouvement  (sous ou au niveau du seuil pour marche de GWW) */
     /** feasability of a move (under or at threshold level pour GWW walks) */
     virtual int isfeasible(Move* move);
@@ -661,6 +676,16 @@ public:
     /* l'algorithme de recherche locale utilisé */
     /** the local search algorithm used */
     LSAlgorithm* walkalgorithm;
+    /* une recherche locale par particule, chacune avec son propre générateur aléatoire : les marches de la population
+       sont alors indépendantes et peuvent être exécutées en parallèle (utilisées seulement avec plusieurs threads,
+       sinon marches successives avec walkalgorithm) */
+    /** one local search per particle, each with its own random generator: the walks of the population are then
+        independent and can be run in parallel (used only with several threads, otherwise successive walks with walkalgorithm) */
+    vector<LSAlgorithm*> walkers;
+    /* threads exécutant les marches des particules pendant run (NULL si un seul thread) */
+    /** threads running the walks of the particles during run (NULL if only one thread) */
+    ParticleWalkers* particlethreads;
+    GWWAlgorithm() { particlethreads = NULL; };
     /* destructeur */
     ~GWWAlgorithm();
     /* recherche locale sur l'ensemble de la population */
@@ -672,6 +697,12 @@ public:
     /* une recherche locale pour une particule */
     /** a local search for a particle */
     void randomwalk(OpProblem* problem, Configuration* configuration);
+    /* marche d'une particule avec la recherche locale walker, le dernier mouvement étant limité par lastthreshold */
+    /** walk of a particle with the local search walker, the last move being limited by lastthreshold */
+    void walk(OpProblem* problem, Configuration* configuration, LSAlgorithm* walker, Long lastthreshold);
+    /* marches indépendantes de toutes les particules (une recherche locale par particule) */
+    /** independent walks of all the particles (one local search per particle) */
+    void particlesrandomwalk(OpProblem* problem, Configuration** population);
     /* initialisation du seuil */
     /** intialization of the threshold */
     void initthreshold(Configuration** population, int popsize);
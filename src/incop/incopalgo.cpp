@@ -7,6 +7,11 @@
 #include <string>
 #include <set>
 #include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
 
 using namespace std;
 #include <fstream>
@@ -18,7 +23,7 @@ using namespace std;
 #include "incoputil.h"
 
 // les variables globales
-extern Stat_GWW* Statistiques; // defini dans incoputil
+extern thread_local Stat_GWW* Statistiques; // defini dans incoputil
 extern int TRACEMODE; // indicateur de trace
 extern ofstream* ofile; // le fichier de sortie
 
@@ -27,6 +32,10 @@ extern ofstream* ofile; // le fichier de sortie
 LSAlgorithm::LSAlgorithm(int nbmov)
 {
     walklength = nbmov;
+    currentmove = NULL;
+    firstmove = NULL;
+    bestmove = NULL;
+    best_config = NULL;
 }
 
 LSAlgorithmGWW::LSAlgorithmGWW(int nbmov)
@@ -39,6 +48,20 @@ LSAlgorithm::~LSAlgorithm()
 {
     delete nbhsearch;
     delete mheur;
+    delete currentmove;
+    delete firstmove;
+    delete bestmove;
+    delete best_config;
+}
+
+void LSAlgorithm::allocate_walk(OpProblem* problem)
+{
+    currentmove = problem->create_move();
+    firstmove = problem->create_move();
+    bestmove = problem->create_move();
+    best_config = problem->create_configuration();
+    mheur->reinit(problem);
+    nbhsearch->initsearch();
 }
 
 NeighborhoodSearch::NeighborhoodSearch(int nbhmin, int nbhmax, int endnbh, int varconf, int valconf, double nbhr)
@@ -103,7 +126,12 @@ RandomSearch::RandomSearch() { ; }
 
 GreedySearch::GreedySearch() { ; }
 
-GWWAlgorithm::~GWWAlgorithm() { delete walkalgorithm; }
+GWWAlgorithm::~GWWAlgorithm()
+{
+    delete walkalgorithm;
+    for (int i = 0; i < (int)walkers.size(); i++)
+        delete walkers[i];
+}
 
 StandardGWWAlgorithm::StandardGWWAlgorithm(int popsize, int grtest, int derniermouv, int elitisme, int stop,
     double threshdescent, Long thresmin)
@@ -526,9 +554,9 @@ int LSAlgorithm::configurationmove(OpProblem* problem, Configuration* configurat
 {
     int nbtries = 0;
 
-    Move* bestmove = problem->bestmove;
-    Move* currentmove = problem->currentmove;
-    Move* firstmove = problem->firstmove;
+    Move* bestmove = (this->bestmove) ? this->bestmove : problem->bestmove;
+    Move* currentmove = (this->currentmove) ? this->currentmove : problem->currentmove;
+    Move* firstmove = (this->firstmove) ? this->firstmove : problem->firstmove;
 
     bestmove->valuation = LONG_MAX;
 
@@ -618,7 +646,7 @@ int LSAlgorithm::configurationmove(OpProblem* problem, Configuration* configurat
         if (bestfound)
         // stockage du nouveau meilleur
         {
-            problem->best_config->copy_element(configuration);
+            ((best_config) ? best_config : problem->best_config)->copy_element(configuration);
         }
         return 1; // mouvement effectué
     }
@@ -677,11 +705,22 @@ void LSAlgorithm::run(OpProblem* problem, Configuration** population)
 */
 
 void GWWAlgorithm::randomwalk(OpProblem* problem, Configuration* configuration)
+{
+    Long thresh1 = walkalgorithm->threshold;
+    if (lastmovedescent)
+        thresholdupdate(); // baisse lors du dernier mouvement (on suppose la meme baisse que la
+    //dernière effectuée)
+    Long lastthreshold = walkalgorithm->threshold;
+    walkalgorithm->threshold = thresh1; // remise du seuil
+    walk(problem, configuration, walkalgorithm, lastthreshold);
+}
+
+void GWWAlgorithm::walk(OpProblem* problem, Configuration* configuration, LSAlgorithm* walker, Long lastthreshold)
 {
     int val;
     if (configuration->regrouped)
-        for (int i = 0; i < walkalgorithm->walklength - 1; i++) {
-            val = walkalgorithm->configurationmove(problem, configuration);
+        for (int i = 0; i < walker->walklength - 1; i++) {
+            val = walker->configurationmove(problem, configuration);
             if (val)
                 Statistiques->nb_moves[Statistiques->current_try]++;
             if (nomovestop) // stagnation : arret de la marche de la particule
@@ -690,17 +729,12 @@ void GWWAlgorithm::randomwalk(OpProblem* problem, Configuration* configuration)
             if (configuration->valuation == problem->lower_bound)
                 return; // on a trouve une solution : arret
         }
-    Long thresh1 = walkalgorithm->threshold;
-    if (lastmovedescent)
-        thresholdupdate(); // baisse lors du dernier mouvement (on suppose la meme baisse que la
-    //dernière effectuée)
-    val = walkalgorithm->configurationmove(problem, configuration);
+    Long thresh1 = walker->threshold;
+    walker->threshold = lastthreshold;
+    val = walker->configurationmove(problem, configuration);
     if (val)
         Statistiques->nb_moves[Statistiques->current_try]++;
-    if (lastmovedescent)
-        walkalgorithm->threshold = thresh1; // remise du seuil
-    if (configuration->valuation == problem->lower_bound)
-        return; // on a trouve une solution : arret
+    walker->threshold = thresh1; // remise du seuil
 }
 
 /* nombre de particules au seuil avant la baisse du seuil (pour les statistiques) : la population etant triée à l'appel */
@@ -718,6 +752,104 @@ int ThresholdGWWAlgorithm::nb_threshold_population(Configuration** population)
     return nb_threshold;
 }
 
+/* Threads exécutant les marches des particules, créés pour toute la durée de GWWAlgorithm::run.
+   Les particules sont réparties dynamiquement entre le thread appelant et les autres threads.
+   Chaque autre thread a ses propres statistiques (Statistiques est local à chaque thread) dont
+   les nombres de mouvements sont reportés au thread appelant après chaque marche de la population. */
+class ParticleWalkers {
+    int nbthreads;
+    int current_try;
+    int maxtries;
+    mutex lock;
+    condition_variable changed;
+    int generation; // nombre de marches de la population commencées
+    int nbdone; // nombre d'autres threads ayant fini la marche courante
+    bool stop;
+    int nbparticles;
+    atomic<int> next; // prochaine particule à faire marcher
+    function<void(int)> walkparticle;
+    int nbmoves; // mouvements comptés par les autres threads pendant la marche courante
+    vector<thread> threads;
+
+    void particles()
+    {
+        int i;
+        while ((i = next++) < nbparticles)
+            walkparticle(i);
+    }
+
+    void work()
+    {
+        Stat_GWW stats(1, maxtries);
+        stats.init_try(current_try);
+        Statistiques = &stats;
+        int seen = 0;
+        while (true) {
+            {
+                unique_lock<mutex> guard(lock);
+                changed.wait(guard, [this, seen] { return stop || generation != seen; });
+                if (stop)
+                    return;
+                seen = generation;
+            }
+            particles();
+            {
+                lock_guard<mutex> guard(lock);
+                nbmoves += stats.nb_moves[current_try];
+                stats.nb_moves[current_try] = 0;
+                nbdone++;
+            }
+            changed.notify_all();
+        }
+    }
+
+public:
+    ParticleWalkers(int nbthreads_, int maxtries_, int current_try_)
+        : nbthreads(nbthreads_)
+        , current_try(current_try_)
+        , maxtries(maxtries_)
+        , generation(0)
+        , nbdone(0)
+        , stop(false)
+        , nbparticles(0)
+        , next(0)
+        , nbmoves(0)
+    {
+        for (int t = 1; t < nbthreads; t++)
+            threads.push_back(thread(&ParticleWalkers::work, this));
+    }
+
+    ~ParticleWalkers()
+    {
+        {
+            lock_guard<mutex> guard(lock);
+            stop = true;
+        }
+        changed.notify_all();
+        for (int t = 0; t < (int)threads.size(); t++)
+            threads[t].join();
+    }
+
+    /* appelle f(i) pour toutes les particules i, renvoie le nombre de mouvements comptés par les autres threads */
+    int run(int n, function<void(int)> f)
+    {
+        {
+            lock_guard<mutex> guard(lock);
+            walkparticle = f;
+            nbparticles = n;
+            next = 0;
+            nbdone = 0;
+            nbmoves = 0;
+            generation++;
+        }
+        changed.notify_all();
+        particles();
+        unique_lock<mutex> guard(lock);
+        changed.wait(guard, [this] { return nbdone == nbthreads - 1; });
+        return nbmoves;
+    }
+};
+
 /* l'algo GWW : boucle sur regroupement et marche aleatoire */
 void GWWAlgorithm::run(OpProblem* problem, Configuration** population)
 {
@@ -731,9 +863,17 @@ void GWWAlgorithm::run(OpProblem* problem, Configuration** population)
             population[i]->regrouped = 1;
     }
 
+    // marches indépendantes en parallèle seulement avec plusieurs threads (sinon marches séquentielles d'origine)
+    if (!walkers.empty() && nbthreads > 1) {
+        for (int i = 0; i < (int)walkers.size(); i++)
+            if (!walkers[i]->currentmove)
+                walkers[i]->allocate_walk(problem);
+        particlethreads = new ParticleWalkers(min(nbthreads, populationsize), Statistiques->max_tries, Statistiques->current_try);
+    }
+
     thresholdcomputedelta(population);
     thresholdupdate();
-    *ofile << " premier seuil " << walkalgorithm->threshold;
+    //    *ofile << " premier seuil " << walkalgorithm->threshold;
     if (walkalgorithm->threshold < meilleur)
         walkalgorithm->threshold = valeur_max(population, populationsize);
 
@@ -756,6 +896,8 @@ void GWWAlgorithm::run(OpProblem* problem, Configuration** population)
         thresholdchangesupdate();
         nb_pas--;
     }
+    delete particlethreads;
+    particlethreads = NULL;
     Statistiques->thresholdchanges += thresholdchanges;
     // ecriture_fin_gww(thresholdchanges, total_nbmoves);
 }
@@ -876,15 +1018,65 @@ void GWWAlgorithm::populationrandomwalk(OpProblem* problem, Configuration** popu
 {
     walkalgorithm->nhtries = 0;
     walkalgorithm->nbmoves = 0;
-    for (int i = 0; i < populationsize; i++) {
-        randomwalk(problem, population[i]);
-        if (population[i]->valuation == problem->lower_bound)
-            break; // arret : borne inferieure atteinte
-    }
+    if (particlethreads)
+        particlesrandomwalk(problem, population);
+    else
+        for (int i = 0; i < populationsize; i++) {
+            randomwalk(problem, population[i]);
+            if (population[i]->valuation == problem->lower_bound)
+                break; // arret : borne inferieure atteinte
+        }
     total_nhtries += walkalgorithm->nhtries;
     total_nbmoves += walkalgorithm->nbmoves;
 }
 
+/* Marches indépendantes : chaque particule a sa recherche locale et son générateur aléatoire (initialisé
+   à partir du générateur courant) et part du même meilleur coût connu, de sorte que le résultat ne dépend
+   pas du nombre de threads (au moins 2), sauf si la borne inférieure est atteinte : les particules suivantes
+   ne marchent plus. Le meilleur de la population est ensuite recherché dans l'ordre des particules. */
+void GWWAlgorithm::particlesrandomwalk(OpProblem* problem, Configuration** population)
+{
+    assert((int)walkers.size() == populationsize);
+    Long thresh1 = walkalgorithm->threshold;
+    if (lastmovedescent)
+        thresholdupdate();
+    Long lastthreshold = walkalgorithm->threshold;
+    walkalgorithm->threshold = thresh1;
+    int ntry = Statistiques->current_try;
+    Long best = Statistiques->cost_try[ntry];
+    vector<int> seeds(populationsize);
+    for (int i = 0; i < populationsize; i++)
+        seeds[i] = myrand();
+    int nextseed = myrand();
+    vector<Long> found(populationsize, best);
+    atomic<bool> lowerbound(false);
+    auto walkparticle = [&](int i) {
+        if (lowerbound)
+            return; // arret : borne inferieure atteinte
+        LSAlgorithm* walker = walkers[i];
+        walker->threshold = thresh1;
+        walker->nhtries = 0;
+        walker->nbmoves = 0;
+        mysrand(seeds[i]);
+        Statistiques->cost_try[ntry] = best;
+        walk(problem, population[i], walker, lastthreshold);
+        found[i] = Statistiques->cost_try[ntry];
+        if (population[i]->valuation == problem->lower_bound)
+            lowerbound = true;
+    };
+    Statistiques->nb_moves[ntry] += particlethreads->run(populationsize, walkparticle);
+    Statistiques->cost_try[ntry] = best;
+    for (int i = 0; i < populationsize; i++) {
+        if (found[i] < Statistiques->cost_try[ntry]) {
+            Statistiques->cost_try[ntry] = found[i];
+            problem->best_config->copy_element(walkers[i]->best_config);
+        }
+        walkalgorithm->nhtries += walkers[i]->nhtries;
+        walkalgorithm->nbmoves += walkers[i]->nbmoves;
+    }
+    mysrand(nextseed);
+}
+
 /* les méthodes d'interaction entre elements (travail sur la population) */
 
 void GWWAlgorithm::regrouping(Configuration** population)
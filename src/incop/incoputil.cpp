@@ -11,6 +11,7 @@ lecture des arguments des algos , ecriture,  lancement d'un essai,
 #include <string>
 #include <set>
 #include <algorithm>
+#include <thread>
 using namespace std;
 #include <iostream>
 #include <fstream>
@@ -26,7 +27,7 @@ using namespace std;
 
 ofstream* ofile = NULL; // le fichier de sortie
 
-Stat_GWW* Statistiques; //  l'objet pour les statistiques en variable globale
+thread_local Stat_GWW* Statistiques; //  l'objet pour les statistiques en variable globale (propre à chaque thread)
 // alloué dans le main() avec npb et nbessais
 
 int TRACEMODE = 0; // variable globale : niveau de trace
@@ -54,6 +55,17 @@ Stat_GWW::Stat_GWW(int number_problems, int number_tries)
     current_pb = 0;
 }
 
+Stat_GWW::~Stat_GWW()
+{
+    delete[] trouve;
+    delete[] cost_try;
+    delete[] nb_moves;
+    delete[] nb_moves_up;
+    delete[] nb_moves_down;
+    delete[] total_problem_time;
+    delete[] execution_time_try;
+}
+
 void Stat_GWW::init_pb(int t)
 {
     current_pb = t;
@@ -531,8 +543,15 @@ GWWAlgorithm* algo_gww(char** argv, int& narg, string& method, int& taille, list
     }
 
     arguments_gww_marche(argv, narg, walk_method, liste_methodes);
+    int walknarg = narg;
     algogww->walkalgorithm = algo_marche(argv, narg, walk_method, 1);
     algogww->walkalgorithm->methodname = method; // bizarrerie a modifier (utilisee pour la trace)
+    // une recherche locale par particule (mêmes arguments) pour des marches indépendantes
+    for (int i = 0; i < taille; i++) {
+        int n = walknarg;
+        algogww->walkers.push_back(algo_marche(argv, n, walk_method, 1));
+        algogww->walkers[i]->methodname = method;
+    }
     return algogww;
 }
 
@@ -794,11 +813,20 @@ void instanciation_aleatoire(OpProblem* problem, Configuration** population, int
         problem->random_configuration(population[i]);
 }
 
-// evaluation de la population
-void calcul_valeur_population(OpProblem* problem, Configuration** population, int taille)
+// evaluation de la population (les configurations sont réparties entre nbthreads threads)
+void calcul_valeur_population(OpProblem* problem, Configuration** population, int taille, int nbthreads)
 {
-    for (int i = 0; i < taille; i++)
+    nbthreads = min(nbthreads, taille);
+    vector<thread> threads;
+    for (int t = 1; t < nbthreads; t++)
+        threads.push_back(thread([=]() {
+            for (int i = t; i < taille; i += nbthreads)
+                population[i]->valuation = problem->config_evaluation(population[i]);
+        }));
+    for (int i = 0; i < taille; i += max(1, nbthreads))
         population[i]->valuation = problem->config_evaluation(population[i]);
+    for (int t = 0; t < (int)threads.size(); t++)
+        threads[t].join();
 }
 
 // execution d'un essai d'un algo sur un  probleme
@@ -824,7 +852,7 @@ void executer_essai(OpProblem* problem, IncompleteAlgorithm* algo, Configuration
     }
     //    *ofile << " population instanciee " << endl;
     // evaluation de la population
-    calcul_valeur_population(problem, population, taille);
+    calcul_valeur_population(problem, population, taille, algo->nbthreads);
     //    *ofile << " population evaluee " << endl;
     // tri de la population
     populationsort(population, taille);
@@ -5,10 +5,13 @@
 #include <string>
 #include <set>
 #include <algorithm>
+#include <iterator>
 
 using namespace std;
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <thread>
 
 #include "incop.h"
 #include "incoputil.h"
@@ -17,11 +20,13 @@ using namespace std;
 #include "autotuning2.h"
 
 extern ofstream* ofile; // le fichier de sortie
+extern int TRACEMODE;
 
-extern Stat_GWW* Statistiques;
+extern thread_local Stat_GWW* Statistiques;
 
 #include "search/tb2solver.hpp"
 #include "core/tb2wcsp.hpp"
+#include "core/tb2clausedb.hpp"
 
 INCOP::NaryCSProblem::NaryCSProblem(int nbvar, int nbconst)
     : CSProblem(nbvar, nbconst)
@@ -29,7 +34,14 @@ INCOP::NaryCSProblem::NaryCSProblem(int nbvar, int nbconst)
     ;
 }
 
-INCOP::NaryConstraint::NaryConstraint(int arit) { arity = arit; }
+INCOP::NaryConstraint::NaryConstraint(int arit)
+{
+    arity = arit;
+    ctr = NULL;
+    gap = MAX_COST;
+    clauseCost = 0;
+    clauseExtension = 0;
+}
 
 INCOP::NaryVariable::NaryVariable() { ; }
 
@@ -77,6 +89,18 @@ Long INCOP::NaryCSProblem::config_evaluation(Configuration* configuration)
 
 Long INCOP::NaryConstraint::constraint_value(Configuration* configuration)
 {
+    if (ctr) {
+        for (int i = 0; i < arity; i++)
+            tuple[positions[i]] = (*valueindexes[i])[configuration->config[constrainedvariables[i]]];
+        return min(gap, ctr->evalsubstr(tuple, ctr));
+    }
+    if (!clause.empty()) {
+        int nbtrue = 0;
+        for (int i = 0; i < arity; i++)
+            if (configuration->config[constrainedvariables[i]] == clause[i])
+                nbtrue++;
+        return min(gap, (nbtrue == 0) ? clauseCost : clauseExtension * (nbtrue - 1));
+    }
     int index = 0;
     for (int i = 0; i < arity; i++)
         index += configuration->config[constrainedvariables[i]] * multiplyers[i];
@@ -227,6 +251,78 @@ void wcspdomaines_file_read(WCSP* wcsp, int nbvar, vector<Value>* tabdomaines, v
     assert(size == nbvar);
 }
 
+/** lecture d'une contrainte : table des n-uplets si elle est petite, sinon évaluation directe de la fonction de coût */
+/* reads a cost function: tuple table if small enough, otherwise direct evaluation of the toulbar2 cost function */
+static void wcspdata_ctr_read(Constraint* ctr, Cost gap, vector<INCOP::NaryVariable*>* vv, vector<INCOP::NaryConstraint*>* vct,
+    vector<Value>* tabdomaines)
+{
+    int arity = 0;
+    for (int j = 0; j < ctr->arity(); j++)
+        if (ctr->getVar(j)->unassigned())
+            arity++;
+    INCOP::NaryConstraint* ct = new INCOP::NaryConstraint(arity);
+    vct->push_back(ct);
+    Long nbtuples = 1;
+    for (int j = 0; j < ctr->arity(); j++) {
+        EnumeratedVariable* var = (EnumeratedVariable*)ctr->getVar(j);
+        if (var->unassigned()) {
+            int numvar = var->getCurrentVarId();
+            ct->constrainedvariables.push_back(numvar);
+            ct->positions.push_back(j);
+            ct->valueindexes.push_back(&(*vv)[numvar]->valueindexes);
+            (*vv)[numvar]->constraints.push_back(ct);
+            if (nbtuples <= INCOP_MAX_TUPLES)
+                nbtuples *= tabdomaines[numvar].size();
+        }
+    }
+    assert(ct->constrainedvariables.size() == (unsigned int)arity);
+    if (nbtuples > INCOP_MAX_TUPLES) {
+        ct->ctr = ctr;
+        ct->gap = gap;
+        ct->tuple.resize(ctr->arity());
+        for (int j = 0; j < ctr->arity(); j++) {
+            EnumeratedVariable* var = (EnumeratedVariable*)ctr->getVar(j);
+            ct->tuple[j] = (var->unassigned()) ? CHAR_FIRST : var->toIndex(var->getValue()) + CHAR_FIRST;
+        }
+    } else {
+        ct->compute_indexmultiplyers(tabdomaines);
+        ct->tuplevalues.reserve(nbtuples);
+        String tuple;
+        Cost cost;
+        ctr->firstlex();
+        while (ctr->nextlex(tuple, cost)) {
+            ct->tuplevalues.push_back(min(gap, cost));
+        }
+        assert(ct->tuplevalues.size() == (size_t)nbtuples);
+    }
+}
+
+/** lecture des clauses d'une base de clauses (une contrainte par clause), retourne le nombre de clauses lues */
+static int wcspdata_clauses_read(WeightedClauseDatabase* db, Cost gap, vector<INCOP::NaryVariable*>* vv, vector<INCOP::NaryConstraint*>* vct,
+    vector<Value>* tabdomaines)
+{
+    int nbclauses = 0;
+    vector<pair<EnumeratedVariable*, Value>> lits;
+    Cost cost, extension;
+    for (unsigned int c = 0; c < db->numberOfClauses(); c++) {
+        if (!db->getClause(c, lits, cost, extension) || lits.empty())
+            continue;
+        INCOP::NaryConstraint* ct = new INCOP::NaryConstraint(lits.size());
+        vct->push_back(ct);
+        ct->gap = gap;
+        ct->clauseCost = cost;
+        ct->clauseExtension = extension;
+        for (unsigned int j = 0; j < lits.size(); j++) {
+            int numvar = lits[j].first->getCurrentVarId();
+            ct->constrainedvariables.push_back(numvar);
+            (*vv)[numvar]->constraints.push_back(ct);
+            ct->clause.push_back(find(tabdomaines[numvar].begin(), tabdomaines[numvar].end(), lits[j].second) - tabdomaines[numvar].begin());
+        }
+        nbclauses++;
+    }
+    return nbclauses;
+}
+
 /** lecture des contraintes */
 int wcspdata_constraint_read(WCSP* wcsp, int nbconst, vector<INCOP::NaryVariable*>* vv, vector<INCOP::NaryConstraint*>* vct,
     vector<int>* connexions, vector<Value>* tabdomaines)
@@ -234,74 +330,27 @@ int wcspdata_constraint_read(WCSP* wcsp, int nbconst, vector<INCOP::NaryVariable
     Cost gap = wcsp->getUb() - wcsp->getLb();
     int nbconst_ = 0;
     for (unsigned int i = 0; i < wcsp->numberOfConstraints(); i++) {
-        if (wcsp->getCtr(i)->connected() && !wcsp->getCtr(i)->isSep() && !wcsp->getCtr(i)->isGlobal() && wcsp->getCtr(i)->arity() <= ToulBar2::preprocessNary) {
-            int arity = 0;
-            for (int j = 0; j < wcsp->getCtr(i)->arity(); j++)
-                if (wcsp->getCtr(i)->getVar(j)->unassigned())
-                    arity++;
-            INCOP::NaryConstraint* ct = new INCOP::NaryConstraint(arity);
-            vct->push_back(ct);
-            int numvar = 0;
-            for (int j = 0; j < wcsp->getCtr(i)->arity(); j++)
-                if (wcsp->getCtr(i)->getVar(j)->unassigned()) {
-                    numvar = wcsp->getCtr(i)->getVar(j)->getCurrentVarId();
-                    ct->constrainedvariables.push_back(numvar);
-                    (*vv)[numvar]->constraints.push_back(ct);
-                }
-            assert(ct->constrainedvariables.size() == (unsigned int)arity);
-            ct->compute_indexmultiplyers(tabdomaines);
-            String tuple;
-            Cost cost;
-            wcsp->getCtr(i)->firstlex();
-            while (wcsp->getCtr(i)->nextlex(tuple, cost)) {
-                ct->tuplevalues.push_back(min(gap, cost));
-            }
+        WeightedClauseDatabase* db = dynamic_cast<WeightedClauseDatabase*>(wcsp->getCtr(i));
+        if (db && db->connected()) {
+            int nbclauses = wcspdata_clauses_read(db, gap, vv, vct, tabdomaines);
+            nbconst += nbclauses - 1; // counted as a single constraint by the caller
+            nbconst_ += nbclauses;
+        } else if (wcsp->getCtr(i)->connected() && !wcsp->getCtr(i)->isSep() && !wcsp->getCtr(i)->isGlobal() && wcsp->getCtr(i)->arity() <= ToulBar2::preprocessNary) {
+            wcspdata_ctr_read(wcsp->getCtr(i), gap, vv, vct, tabdomaines);
             nbconst_++;
         }
     }
     for (int i = 0; i < wcsp->getElimBinOrder(); i++) {
         Constraint* ctr = wcsp->getElimBinCtr(i);
         if (ctr->connected() && !ctr->isSep()) {
-            int arity = 2;
-            int numvar = 0;
-            INCOP::NaryConstraint* ct = new INCOP::NaryConstraint(arity);
-            vct->push_back(ct);
-            for (int j = 0; j < arity; j++)
-                if (ctr->getVar(j)->unassigned()) {
-                    numvar = ctr->getVar(j)->getCurrentVarId();
-                    ct->constrainedvariables.push_back(numvar);
-                    (*vv)[numvar]->constraints.push_back(ct);
-                }
-            ct->compute_indexmultiplyers(tabdomaines);
-            String tuple;
-            Cost cost;
-            ctr->firstlex();
-            while (ctr->nextlex(tuple, cost)) {
-                ct->tuplevalues.push_back(min(gap, cost));
-            }
+            wcspdata_ctr_read(ctr, gap, vv, vct, tabdomaines);
             nbconst_++;
         }
     }
     for (int i = 0; i < wcsp->getElimTernOrder(); i++) {
         Constraint* ctr = wcsp->getElimTernCtr(i);
         if (ctr->connected() && !ctr->isSep()) {
-            int arity = 3;
-            int numvar = 0;
-            INCOP::NaryConstraint* ct = new INCOP::NaryConstraint(arity);
-            vct->push_back(ct);
-            for (int j = 0; j < arity; j++)
-                if (ctr->getVar(j)->unassigned()) {
-                    numvar = ctr->getVar(j)->getCurrentVarId();
-                    ct->constrainedvariables.push_back(numvar);
-                    (*vv)[numvar]->constraints.push_back(ct);
-                }
-            ct->compute_indexmultiplyers(tabdomaines);
-            String tuple;
-            Cost cost;
-            ctr->firstlex();
-            while (ctr->nextlex(tuple, cost)) {
-                ct->tuplevalues.push_back(min(gap, cost));
-            }
+            wcspdata_ctr_read(ctr, gap, vv, vct, tabdomaines);
             nbconst_++;
         }
     }
@@ -325,80 +374,6 @@ int wcspdata_constraint_read(WCSP* wcsp, int nbconst, vector<INCOP::NaryVariable
     return nbconst_;
 }
 
-int split(char* str, char c, char*** arr)
-{
-    int count = 1;
-    int token_len = 1;
-    int i = 0;
-    char* p;
-    char* t;
-
-    p = str;
-    while (*p != '\0') {
-        if (*p == c)
-            count++;
-        p++;
-    }
-
-    *arr = (char**)malloc(sizeof(char*) * count);
-    if (*arr == NULL)
-        exit(1);
-
-    p = str;
-    while (*p != '\0') {
-        if (*p == c) {
-            (*arr)[i] = (char*)malloc(sizeof(char) * token_len);
-            if ((*arr)[i] == NULL)
-                exit(EXIT_FAILURE);
-
-            token_len = 0;
-            i++;
-        }
-        p++;
-        token_len++;
-    }
-    (*arr)[i] = (char*)malloc(sizeof(char) * token_len);
-    if ((*arr)[i] == NULL)
-        exit(EXIT_FAILURE);
-
-    i = 0;
-    p = str;
-    t = ((*arr)[i]);
-    while (*p != '\0') {
-        if (*p != c) {
-            *t = *p;
-            t++;
-        } else {
-            *t = '\0';
-            i++;
-            t = ((*arr)[i]);
-        }
-        p++;
-    }
-    *t = '\0';
-    return count;
-}
-
-void removeSpaces(string& str)
-{
-    /* remove multiple spaces */
-    int k = 0;
-    for (unsigned int j = 0; j < str.size(); ++j) {
-        if ((str[j] != ' ') || (str[j] == ' ' && str[j + 1] != ' ')) {
-            str[k] = str[j];
-            ++k;
-        }
-    }
-    str.resize(k);
-
-    /* remove space at the end */
-    if (str[k - 1] == ' ')
-        str.erase(str.end() - 1);
-    /* remove space at the begin */
-    if (str[0] == ' ')
-        str.erase(str.begin());
-}
-
 /// \brief solves the current problem using INCOP local search solver by Bertrand Neveu
 /// \return best solution cost found
 /// \param cmd command line argument for narycsp INCOP local search solver (cmd format: lowerbound randomseed nbiterations method nbmoves neighborhoodchoice neighborhoodchoice2 minnbneighbors maxnbneighbors  neighborhoodchoice3 autotuning tracemode)
@@ -408,29 +383,21 @@ Cost Solver::narycsp(string cmd, vector<Value>& bestsolution)
 {
     Long result = MAX_COST;
 
-    string filename = "/dev/stdin";
-    string outputfile = "/dev/stdout";
     int verbose = ToulBar2::verbose;
-    char line[1024];
-    char** argv = NULL;
     int tuningmode = 0; // no automatic tuning
-    int argc = 0;
-
-    // remove leading space  from incop command line
-    cmd.erase(cmd.begin(), std::find_if(cmd.begin(), cmd.end(), std::bind1st(std::not_equal_to<char>(), ' ')));
 
-    // remove multiples space in cmd
-    removeSpaces(cmd);
-
-    sprintf(line, "bin/Linux/narycsp %s %s %s", outputfile.c_str(), filename.c_str(), cmd.c_str());
-
-    argc = split(line, ' ', &argv);
+    // arguments of the INCOP command line (the first argument is read at argv[narg + 1])
+    istringstream cmdstream(cmd);
+    vector<string> args((istream_iterator<string>(cmdstream)), istream_iterator<string>());
+    vector<char*> argv;
+    for (unsigned int i = 0; i < args.size(); i++)
+        argv.push_back(&args[i][0]);
 
     if (verbose > 0) {
         cout << "---------------------------" << endl;
-        cout << "number of arguments for narycsp: " << argc << endl;
+        cout << "number of arguments for narycsp: " << argv.size() << endl;
         cout << "---------------------------" << endl;
-        for (int i = 0; i < argc; i++)
+        for (unsigned int i = 0; i < argv.size(); i++)
             cout << "arg #" << i << " --> " << argv[i] << endl;
         if (ToulBar2::verbose >= 3)
             cout << *wcsp;
@@ -443,24 +410,24 @@ Cost Solver::narycsp(string cmd, vector<Value>& bestsolution)
     Long lbound;
     int taille, nbessais;
     int graine1;
-    int narg = 2; // compteur des arguments
+    int narg = -1; // compteur des arguments
 
-    arguments_borneinf(argv, narg, lbound);
+    arguments_borneinf(argv.data(), narg, lbound);
     // lecture des paramètres de l'algo et création de l'objet algo
-    IncompleteAlgorithm* algo = algo_creation(argv, narg, taille, graine1, nbessais);
+    IncompleteAlgorithm* algo = algo_creation(argv.data(), narg, taille, graine1, nbessais);
 
     // allocation de l'objet pour les stats
     Statistiques = new Stat_GWW(1, nbessais);
 
     // argument pour la trace
-    arguments_tracemode(argv, narg);
+    arguments_tracemode(argv.data(), narg);
     // pour la recuperation du signal 10
     //  sigaction();
 
     // argument de temps maximum
     double maxtime;
     if (tuningmode)
-        arguments_tempscpu(argv, narg, maxtime);
+        arguments_tempscpu(argv.data(), narg, maxtime);
 
     // Declaration des variables contenant les structures de données des problemes
     string pbname;
@@ -501,6 +468,9 @@ Cost Solver::narycsp(string cmd, vector<Value>& bestsolution)
 
     for (int i = 0; i < nbvar; i++) {
         INCOP::NaryVariable* nv = new INCOP::NaryVariable();
+        EnumeratedVariable* var = (EnumeratedVariable*)((WCSP*)wcsp)->getVar(tabvars[i]);
+        for (unsigned int k = 0; k < tabdomaines[i].size(); k++)
+            nv->valueindexes.push_back(var->toIndex(tabdomaines[i][k]) + CHAR_FIRST);
         variables.push_back(nv);
     }
 
@@ -519,6 +489,15 @@ Cost Solver::narycsp(string cmd, vector<Value>& bestsolution)
 
     problem->init_population(population, taille);
 
+    // les tables de n-uplets sont en lecture seule : évaluations et marches de la population en parallèle
+    // (les fonctions de coût toulbar2 évaluées directement ne sont pas réentrantes)
+    bool reentrant = true;
+    for (unsigned int i = 0; i < constraints.size(); i++)
+        if (constraints[i]->ctr)
+            reentrant = false;
+    if (reentrant && ToulBar2::portfolio <= 1 && !TRACEMODE)
+        algo->nbthreads = max(1, min(taille, (int)std::thread::hardware_concurrency()));
+
     problem->allocate_moves();
 
     if (tuningmode)
@@ -554,6 +533,10 @@ Cost Solver::narycsp(string cmd, vector<Value>& bestsolution)
         //      ecriture_stat_probleme();
     }
     delete problem;
+    for (unsigned int i = 0; i < constraints.size(); i++)
+        delete constraints[i];
+    for (unsigned int i = 0; i < variables.size(); i++)
+        delete variables[i];
     delete[] tabdomaines;
     delete[] connexions;
 
@@ -1,4 +1,9 @@
 class WCSP;
+class Constraint;
+
+/* taille maximum de la table des n-uplets d'une contrainte, au-delà la fonction de coût toulbar2 est évaluée directement */
+/** maximum size of the table of tuples of a constraint, larger cost functions are evaluated directly on the toulbar2 cost function */
+const Long INCOP_MAX_TUPLES = 1 << 16;
 
 namespace INCOP {
 class NaryConstraint;
@@ -36,8 +41,8 @@ class NaryConstraint {
 public:
     int arity;
     NaryConstraint(int arit);
-    /* evaluation de la contrainte : recherche dans le tableau des n-uplets */
-    /** Constraint Evalution : searching in the tuple table */
+    /* evaluation de la contrainte : recherche dans le tableau des n-uplets ou evaluation de la fonction de coût toulbar2 */
+    /** Constraint Evalution : searching in the tuple table or evaluating the toulbar2 cost function */
     Long constraint_value(Configuration* configuration);
     int compute_index(int* values, vector<int>* tabdomaines);
     int compute_indexpart(int i, int vali, vector<int>* tabdomaines);
@@ -51,6 +56,18 @@ public:
     void compute_indexmultiplyers(vector<int>* tabdomaines);
     int compute_indexmultiplyer(int i, vector<int>* tabdomaines);
     int nbtuples(vector<int>* tabdomaines);
+    /* fonction de coût toulbar2 évaluée directement (NULL si la table des n-uplets est utilisée) */
+    /** toulbar2 cost function evaluated directly (NULL if the tuple table is used) */
+    Constraint* ctr;
+    String tuple; // current tuple of ctr (the value indexes of its assigned variables are fixed)
+    vector<int> positions; // position in the scope of ctr of each constrained variable
+    vector<const String*> valueindexes; // value indexes in ctr of each constrained variable
+    Long gap; // maximum cost returned by ctr
+    /* clause d'une base de clauses toulbar2 (vide sinon) */
+    /** clause of a toulbar2 clause database (empty otherwise) */
+    vector<int> clause; // index in the domain of each constrained variable of its value satisfying the literal
+    Long clauseCost; // cost if all the literals are false
+    Long clauseExtension; // extended cost of the clause, counted for each true literal but the first one
 };
 
 /* Variable liée à une contrainte n-aire */
@@ -58,6 +75,9 @@ public:
 class NaryVariable {
 public:
     vector<NaryConstraint*> constraints;
+    /* index toulbar2 (plus CHAR_FIRST) de chaque valeur du domaine */
+    /** toulbar2 value index (plus CHAR_FIRST) of each domain value */
+    String valueindexes;
     NaryVariable();
 };
 }
@@ -65,7 +85,7 @@ public:
 INCOP::NaryCSProblem* weighted_narycsp_creation(int nbvar, int nbconst, int maxdomsize,
     vector<INCOP::NaryVariable*>* vv, vector<INCOP::NaryConstraint*>* vct);
 
-void wcspdomaines_file_read(WCSP* wcsp, int nbvar, vector<int>* tabdomaines);
+void wcspdomaines_file_read(WCSP* wcsp, int nbvar, vector<Value>* tabdomaines, vector<Value>& initsolution, vector<int>& initconfig);
 
 int wcspdata_constraint_read(WCSP* wcsp, int nbconst, vector<INCOP::NaryVariable*>* vv, vector<INCOP::NaryConstraint*>* vct,
-    vector<int>* connexions, vector<int>* tabdomaines);
+    vector<int>* connexions, vector<Value>* tabdomaines);
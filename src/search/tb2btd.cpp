@@ -6,9 +6,7 @@
 #include "tb2solver.hpp"
 #include "core/tb2domain.hpp"
 #include "tb2clusters.hpp"
-#ifdef OPENMPI
-#include "vns/tb2cpdgvns.hpp"
-#endif
+#include "vns/tb2pdgvnscomm.hpp"
 
 /*
  * Variable ordering heuristics
@@ -354,10 +352,8 @@ pair<Cost, Cost> Solver::binaryChoicePoint(Cluster* cluster, Cost lbgood, Cost c
     nbBacktracks++;
     if (ToulBar2::restart > 0 && nbBacktracks > nbBacktracksLimit)
         throw NbBacktracksOut();
-#ifdef OPENMPI
-    if (ToulBar2::vnsParallel && ((nbBacktracks % 128) == 0) && MPI_interrupted())
+    if (ToulBar2::vnsParallel && ((nbBacktracks % 128) == 0) && pdgvnsInterrupted())
         throw TimeOut();
-#endif
     cluster->nbBacktracks++;
     try {
         Store::store();
@@ -450,10 +446,8 @@ BigInteger Solver::binaryChoicePointSBTD(Cluster* cluster, int varIndex, Value v
     nbBacktracks++;
     if (ToulBar2::restart > 0 && nbBacktracks > nbBacktracksLimit)
         throw NbBacktracksOut();
-#ifdef OPENMPI
-    if (ToulBar2::vnsParallel && ((nbBacktracks % 128) == 0) && MPI_interrupted())
+    if (ToulBar2::vnsParallel && ((nbBacktracks % 128) == 0) && pdgvnsInterrupted())
         throw TimeOut();
-#endif
     try {
         Store::store();
         assert(wcsp->getTreeDec()->getCurrentCluster() == cluster);
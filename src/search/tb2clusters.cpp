@@ -13,7 +13,7 @@
  *
  */
 
-int Cluster::clusterCounter = 0;
+std::atomic<int> Cluster::clusterCounter(0);
 
 bool CmpClusterStructBasic::operator()(const Cluster* lhs, const Cluster* rhs) const
 {
@@ -36,6 +36,10 @@ Separator::Separator(WCSP* wcsp, EnumeratedVariable** scope_in, int arity_in)
     , isUsed(false)
     , lbPrevious(MIN_COST)
     , optPrevious(false)
+    , nbHits(0)
+    , nbMisses(0)
+    , nbEvictions(0)
+    , sgClock(0)
 {
     Char* tbuf = new Char[arity_in + 1];
     tbuf[arity_in] = '\0';
@@ -70,6 +74,10 @@ Separator::Separator(WCSP* wcsp)
     , isUsed(false)
     , lbPrevious(MIN_COST)
     , optPrevious(false)
+    , nbHits(0)
+    , nbMisses(0)
+    , nbEvictions(0)
+    , sgClock(0)
 {
 }
 
@@ -238,6 +246,8 @@ void Separator::set(Cost clb, Cost cub, Solver::OpenList** open)
                 cout << " Learn nogood " << itng->second.first << ", cub= " << itng->second.second << ", delta= " << deltares << " on cluster " << cluster->getId() << endl;
         }
     }
+    if (ToulBar2::separatorMemoryMB > 0)
+        evictNogoods();
 }
 
 void Separator::setSg(Cost c, BigInteger nb)
@@ -261,7 +271,79 @@ void Separator::setSg(Cost c, BigInteger nb)
     assert(c + deltares >= MIN_COST);
     if (ToulBar2::verbose >= 1)
         cout << ") Learn #good with " << nb << " solutions" << endl; // /" << cluster->getVarsTree().size() << endl;
-    sgoods[t] = TPairSG(MAX(MIN_COST, c + deltares), nb);
+    sgoods[t] = make_triplet(MAX(MIN_COST, c + deltares), nb, ++sgClock);
+    if (ToulBar2::separatorMemoryMB > 0)
+        evictSgoods();
+}
+
+size_t Separator::recordSpace(size_t recordsize) const
+{
+    // approximate memory space of a record in a hash table: node with key and data, tuple characters, and bucket pointer
+    return recordsize + (arity_ + 1) * sizeof(Char) + 2 * sizeof(void*);
+}
+
+void Separator::evictNogoods()
+{
+    size_t maxspace = (size_t)(ToulBar2::separatorMemoryMB * 1024. * 1024.);
+    // open node lists of hybrid best-first search are stored with their nogoods and can be much larger than them
+    size_t space = 0;
+    for (TNoGoods::iterator it = nogoods.begin(); it != nogoods.end(); ++it)
+        space += nogoodSpace(it->second);
+    if (space <= maxspace)
+        return;
+    // the nogood of the current separator assignment and the one owning the open node list of the cluster are still in use
+    vector<TNoGoods::iterator> candidates;
+    candidates.reserve(nogoods.size());
+    size_t keptspace = 0;
+    for (TNoGoods::iterator it = nogoods.begin(); it != nogoods.end(); ++it) {
+        if (&it->second.third != cluster->open && it->first != t)
+            candidates.push_back(it);
+        else
+            keptspace += nogoodSpace(it->second);
+    }
+    // removes nogoods until half of the memory limit is used, keeping optimality proofs first and next the largest lower bounds
+    sort(candidates.begin(), candidates.end(), [](const TNoGoods::iterator& ng1, const TNoGoods::iterator& ng2) {
+        bool opt1 = (ng1->second.first >= ng1->second.second);
+        bool opt2 = (ng2->second.first >= ng2->second.second);
+        return (opt1 != opt2) ? opt1 : (ng1->second.first > ng2->second.first);
+    });
+    size_t nbkept = 0;
+    while (nbkept < candidates.size() && keptspace + nogoodSpace(candidates[nbkept]->second) <= maxspace / 2) {
+        keptspace += nogoodSpace(candidates[nbkept]->second);
+        nbkept++;
+    }
+    for (size_t i = nbkept; i < candidates.size(); i++) {
+        nogoods.erase(candidates[i]);
+        nbEvictions++;
+    }
+    if (ToulBar2::verbose >= 1)
+        cout << "Evict " << candidates.size() - nbkept << " nogoods on cluster " << cluster->getId() << endl;
+}
+
+void Separator::evictSgoods()
+{
+    size_t maxsize = max((size_t)2, (size_t)(ToulBar2::separatorMemoryMB * 1024. * 1024. / recordSpace(sizeof(TSGoods::value_type))));
+    if (sgoods.size() <= maxsize)
+        return;
+    // removes the least recently used #goods first, keeping half of them
+    vector<TSGoods::iterator> candidates;
+    candidates.reserve(sgoods.size());
+    for (TSGoods::iterator it = sgoods.begin(); it != sgoods.end(); ++it) {
+        if (it->first != t)
+            candidates.push_back(it);
+    }
+    size_t nbkept = maxsize / 2;
+    if (candidates.size() <= nbkept)
+        return;
+    nth_element(candidates.begin(), candidates.begin() + nbkept, candidates.end(), [](const TSGoods::iterator& sg1, const TSGoods::iterator& sg2) {
+        return sg1->second.third > sg2->second.third;
+    });
+    for (size_t i = nbkept; i < candidates.size(); i++) {
+        sgoods.erase(candidates[i]);
+        nbEvictions++;
+    }
+    if (ToulBar2::verbose >= 1)
+        cout << "Evict " << candidates.size() - nbkept << " #goods on cluster " << cluster->getId() << endl;
 }
 
 Cost Separator::getCurrentDelta()
@@ -318,6 +400,7 @@ bool Separator::get(Cost& clb, Cost& cub, Solver::OpenList** open)
     TNoGoods::iterator itng = nogoods.find(t);
     if (itng != nogoods.end()) {
         TPairNG& p = itng->second; // it is crucial here to get a reference to the data triplet object instead of a copy, otherwise open node list would be copied
+        nbHits++;
         if (ToulBar2::verbose >= 1)
             cout << ") Use nogood " << p.first << ", delta=" << clb << " (cub=" << p.second << ") on cluster " << cluster->getId() << " (active=" << cluster->isActive() << ")" << endl;
         assert(p.first < p.second || clb + p.first >= MIN_COST);
@@ -336,6 +419,7 @@ bool Separator::get(Cost& clb, Cost& cub, Solver::OpenList** open)
         }
         return true;
     } else {
+        nbMisses++;
         clb = (ToulBar2::btdMode >= 2) ? cluster->getLbRDS() : MIN_COST;
         cub = MAX_COST;
         cluster->setUb(MAX_COST);
@@ -366,7 +450,9 @@ BigInteger Separator::getSg(Cost& res, BigInteger& nb)
     }
     TSGoods::iterator itsg = sgoods.find(t);
     if (itsg != sgoods.end()) {
+        itsg->second.third = ++sgClock;
         TPairSG p = itsg->second;
+        nbHits++;
         if (ToulBar2::verbose >= 1)
             cout << ") Use #good  with nb = " << p.second << "solutions on cluster " << cluster->getId() << endl;
         /*		assert(res + p.first >= MIN_COST);
@@ -376,6 +462,7 @@ BigInteger Separator::getSg(Cost& res, BigInteger& nb)
         return nb;
     } else {
         /*res = MIN_COST;*/
+        nbMisses++;
         if (ToulBar2::verbose >= 1)
             cout << ") NOT FOUND for cluster " << cluster->getId() << endl;
         return nb = -1;
@@ -487,7 +574,7 @@ void Separator::print(ostream& os)
         totaltuples = totaltuples * scope[i]->getDomainInitSize();
     }
     os << ")    ";
-    os << " |nogoods| = " << nogoods.size() << " / " << totaltuples << " min:" << ((nogoods.size() == 0) ? MIN_COST : min_element(nogoods.begin(), nogoods.end(), nogoods.value_comp())->second.first) << " (" << cluster->getNbBacktracksClusterTree() << " bt)";
+    os << " |nogoods| = " << nogoods.size() << " / " << totaltuples << " min:" << ((nogoods.size() == 0) ? MIN_COST : min_element(nogoods.begin(), nogoods.end(), [](const TNoGoods::value_type& ng1, const TNoGoods::value_type& ng2) { return ng1.second.first < ng2.second.first; })->second.first) << " (" << cluster->getNbBacktracksClusterTree() << " bt)";
     if (ToulBar2::verbose >= 4) {
         os << "nogoods: {";
         TNoGoods::iterator it = nogoods.begin();
@@ -2371,6 +2458,27 @@ void TreeDecomposition::printStats(Cluster* c)
     }
 }
 
+void TreeDecomposition::printSeparatorStats()
+{
+    Long nbhits = 0;
+    Long nbmisses = 0;
+    Long nbevictions = 0;
+    Long nbrecords = 0;
+    for (unsigned int i = 0; i < clusters.size(); i++) {
+        Separator* sep = clusters[i]->getSep();
+        if (sep) {
+            nbhits += sep->getNbHits();
+            nbmisses += sep->getNbMisses();
+            nbevictions += sep->getNbEvictions();
+            nbrecords += sep->getNbRecords();
+        }
+    }
+    cout << "Separator nogoods: " << nbrecords << " recorded, " << nbhits << " hits, " << nbmisses << " misses, " << nbevictions << " evictions";
+    if (ToulBar2::separatorMemoryMB > 0)
+        cout << " (memory limit of " << ToulBar2::separatorMemoryMB << " MB per separator)";
+    cout << endl;
+}
+
 void TreeDecomposition::print(Cluster* c, int recnum)
 {
     if (!c) {
@@ -10,6 +10,7 @@
 #include "tb2solver.hpp"
 #include "core/tb2enumvar.hpp"
 #include "core/tb2naryconstr.hpp"
+#include "utils/tb2tuplemap.hpp"
 
 class Cluster;
 
@@ -31,12 +32,12 @@ typedef set<Cluster*, CmpClusterStruct> TClustersSorted;
 typedef triplet<Cost, Cost, Solver::OpenList> TPairNG;
 typedef pair<Cost, String> TPairSol;
 
-typedef map<String, TPairNG> TNoGoods;
-typedef map<String, TPairSol> TSols;
+typedef unordered_map<String, TPairNG, TupleHash> TNoGoods;
+typedef unordered_map<String, TPairSol, TupleHash> TSols;
 
 // for solution counting :
-typedef pair<Cost, BigInteger> TPairSG;
-typedef map<String, TPairSG> TSGoods;
+typedef triplet<Cost, BigInteger, Long> TPairSG; // the last field is the time of last use (see Separator::evictSgoods)
+typedef unordered_map<String, TPairSG, TupleHash> TSGoods;
 
 class Separator : public AbstractNaryConstraint {
 private:
@@ -50,12 +51,22 @@ private:
 
     TNoGoods nogoods;
     TSGoods sgoods; // for solution counting
-    TSols solutions;
+    TSols solutions; // never evicted (needed to rebuild the best solution)
     DLink<Separator*> linkSep; // link to insert the separator in PendingSeparator list
 
     String t; // temporary buffer for a separator tuple
     String s; // temporary buffer for a solution tuple
 
+    Long nbHits; // number of nogoods or #goods found by get or getSg
+    Long nbMisses; // number of nogoods or #goods not found by get or getSg
+    Long nbEvictions; // number of nogoods or #goods removed due to the memory limit ToulBar2::separatorMemoryMB
+    Long sgClock; // number of #goods recorded or found so far
+
+    size_t recordSpace(size_t recordsize) const; // approximate memory space of a recorded nogood (without its open node list) or #good
+    size_t nogoodSpace(const TPairNG& ng) const { return recordSpace(sizeof(TNoGoods::value_type)) + ng.third.size() * sizeof(Solver::OpenList::value_type); }
+    void evictNogoods(); // keeps nogoods with an optimality proof or the largest lower bounds if the memory limit is exceeded
+    void evictSgoods(); // keeps the most recently used #goods if the memory limit is exceeded
+
 public:
     Separator(WCSP* wcsp, EnumeratedVariable** scope_in, int arity_in);
     Separator(WCSP* wcsp);
@@ -80,6 +91,11 @@ public:
     void resetLb();
     void resetUb();
 
+    Long getNbHits() const { return nbHits; }
+    Long getNbMisses() const { return nbMisses; }
+    Long getNbEvictions() const { return nbEvictions; }
+    Long getNbRecords() const { return nogoods.size() + sgoods.size(); }
+
     void queueSep() { wcsp->queueSeparator(&linkSep); }
     void unqueueSep() { wcsp->unqueueSeparator(&linkSep); }
 
@@ -107,7 +123,7 @@ public:
 
 class Cluster {
 private:
-    static int clusterCounter; ///< count the number of instances of Cluster class
+    static std::atomic<int> clusterCounter; ///< count the number of instances of Cluster class
     int instance; ///< instance number
     TreeDecomposition* td;
     WCSP* wcsp;
@@ -414,6 +430,7 @@ public:
 
     void print(Cluster* c = NULL, int recnum = 0);
     void printStats(Cluster* c = NULL);
+    void printSeparatorStats(); // reports hits, misses and evictions of the nogoods and #goods recorded on all separators
     void dump(Cluster* c = NULL);
 };
 
@@ -0,0 +1,249 @@
+/*
+ * ****** Parallel portfolio of solvers with diverse configurations *******
+ */
+
+#include "tb2portfolio.hpp"
+#include "tb2solver.hpp"
+#include "core/tb2wcsp.hpp"
+#ifdef LINUX
+#include <signal.h>
+#endif
+
+static thread_local int portfolioThread = 0; // index of the calling thread inside the portfolio (zero for the thread which created it)
+
+Portfolio::Portfolio(int nbThreads, Loader loader_)
+    : loader(loader_)
+    , nbReady(0)
+    , ub(MAX_COST)
+    , proved(false)
+    , provedBy(-1)
+    , pool((ToulBar2::hbfsWorkStealing) ? new OpenNodePool(ub) : NULL)
+    , bestCost(MAX_COST)
+    , bestThread(-1)
+{
+    assert(nbThreads >= 1);
+    tb2getOptions(options);
+    for (int id = 1; id < nbThreads; id++) {
+        helpers.push_back(std::thread(&Portfolio::run, this, id));
+    }
+    // wait until every helper thread has its own copy of the options before letting the calling thread modify them
+    std::unique_lock<std::mutex> lock(readyMutex);
+    readyCondition.wait(lock, [this, nbThreads] { return nbReady == nbThreads - 1; });
+    if (ToulBar2::verbose >= 0) {
+        if (pool)
+            cout << "Parallel hybrid best-first search with " << nbThreads << " threads." << endl;
+        else
+            cout << "Parallel portfolio with " << nbThreads << " threads." << endl;
+    }
+}
+
+Portfolio::~Portfolio()
+{
+    ToulBar2::interrupted = true;
+    for (vector<std::thread>::iterator iter = helpers.begin(); iter != helpers.end(); ++iter) {
+        iter->join();
+    }
+    ToulBar2::interrupted = false;
+    if (ToulBar2::verbose >= 0 && proved && provedBy > 0 && !pool)
+        cout << "Search completed by portfolio thread " << provedBy << "." << endl;
+    delete pool;
+}
+
+/// \brief changes the search configuration of helper thread \a id (each bit of \a id toggles a different option)
+void Portfolio::diversify(int id)
+{
+    assert(id > 0);
+    if (ToulBar2::hbfsWorkStealing)
+        return; // all the solvers must have the same root node
+    ToulBar2::seed += id;
+    if (id & 1) { // conflict-directed variable ordering heuristic
+        ToulBar2::weightedDegree = (ToulBar2::weightedDegree) ? 0 : 1000000;
+    }
+    if (id & 2) { // hybrid best-first search
+        if (ToulBar2::hbfs) {
+            ToulBar2::hbfs = 0;
+            ToulBar2::hbfsGlobalLimit = 0;
+        } else if (ToulBar2::binaryBranching && ToulBar2::dichotomicBranching < 2 && !ToulBar2::lds && ToulBar2::btdMode < 2) {
+            ToulBar2::hbfs = 1;
+            ToulBar2::hbfsGlobalLimit = 10000;
+        }
+    }
+    if (id & 4) { // randomized variable ordering with restarts (depends on the seed)
+        if (ToulBar2::restart < 0 && ToulBar2::btdMode == 0)
+            ToulBar2::restart = 10000;
+    }
+    if (id & 8) { // virtual arc consistency in preprocessing
+        if (ToulBar2::vac)
+            ToulBar2::vac = 0;
+        else if (ToulBar2::LcLevel != LC_NC && ToulBar2::LcLevel != LC_DAC)
+            ToulBar2::vac = 1;
+    }
+    if (id & 16) { // local consistency level
+        ToulBar2::LcLevel = (ToulBar2::LcLevel == LC_EDAC) ? LC_FDAC : LC_EDAC;
+    }
+}
+
+void Portfolio::run(int id)
+{
+    portfolioThread = id;
+#ifdef LINUX
+    // time limit and user interruption are handled by the calling thread only
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGALRM);
+    sigaddset(&signals, SIGVTALRM);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, NULL);
+#endif
+    tb2setOptions(options);
+    {
+        std::lock_guard<std::mutex> lock(readyMutex);
+        nbReady++;
+    }
+    readyCondition.notify_one();
+
+    // helper threads are silent and do not write any file
+    ToulBar2::verbose = -1;
+    ToulBar2::showSolutions = 0;
+    ToulBar2::writeSolution = NULL;
+    ToulBar2::solutionFile = NULL;
+    ToulBar2::solution_uai_file = NULL;
+    ToulBar2::uaieval = false;
+    ToulBar2::maxsateval = false;
+    ToulBar2::dumpWCSP = 0;
+    ToulBar2::newsolution = NULL;
+    ToulBar2::incop_cmd = "";
+
+    diversify(id);
+    mysrand(ToulBar2::seed);
+
+    Solver* solver = (Solver*)WeightedCSPSolver::makeWeightedCSPSolver(MAX_COST);
+    solver->setPortfolio(this);
+    try {
+        loader(solver);
+        if (!ToulBar2::interrupted)
+            solver->solve();
+    } catch (Contradiction) {
+        endSearch(solver->getWCSP(), true);
+    } catch (TimeOut) {
+    }
+    delete solver;
+}
+
+void Portfolio::newSolution(WeightedCSP* wcsp)
+{
+    Cost cost = wcsp->getSolutionCost();
+    if (cost >= ub)
+        return;
+    std::lock_guard<std::mutex> lock(solutionMutex);
+    if (cost < bestCost) {
+        bestCost = cost;
+        bestThread = portfolioThread;
+        bestSolution.clear();
+        for (unsigned int i = 0; i < wcsp->numberOfVariables(); i++) {
+            bestSolution[i] = wcsp->getValue(i);
+        }
+        ub = cost;
+    }
+}
+
+void Portfolio::importSolution(WeightedCSP* wcsp)
+{
+    if (ub >= wcsp->getUb())
+        return;
+    std::lock_guard<std::mutex> lock(solutionMutex);
+    if (bestCost < wcsp->getUb() && bestThread != portfolioThread) {
+        wcsp->setSolution(bestCost, &bestSolution);
+        wcsp->updateUb(bestCost);
+        if (ToulBar2::verbose >= 0)
+            cout << "New solution: " << std::fixed << std::setprecision(ToulBar2::decimalPoint) << wcsp->Cost2ADCost(bestCost) << std::setprecision(DECIMAL_POINT) << " (from portfolio thread " << bestThread << ")" << endl;
+        if (ToulBar2::writeSolution && ToulBar2::solutionFile != NULL) {
+            rewind(ToulBar2::solutionFile);
+            wcsp->printSolution(ToulBar2::solutionFile);
+            fprintf(ToulBar2::solutionFile, "\n");
+        }
+    }
+}
+
+void Portfolio::endSearch(WeightedCSP* wcsp, bool complete)
+{
+    if (complete && !proved.exchange(true)) {
+        provedBy = portfolioThread;
+        ToulBar2::interrupted = true;
+    }
+    importSolution(wcsp);
+}
+
+int OpenNodePool::join()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    workersLb.push_back(MIN_COST);
+    return workersLb.size() - 1;
+}
+
+void OpenNodePool::push(Cost lb, const Solver::CPStore& cp, const Solver::OpenNode& nd)
+{
+    vector<Solver::ChoicePoint> branch(cp.begin() + nd.first, cp.begin() + nd.last);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        nodes.insert(make_pair(lb, std::move(branch)));
+        nbHungry = nbIdle - (int)nodes.size();
+    }
+    available.notify_one();
+}
+
+bool OpenNodePool::pop(int worker, Cost cub, Cost& lb, vector<Solver::ChoicePoint>& branch)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    workersLb[worker] = MAX_COST;
+    nbIdle++;
+    while (true) {
+        // open nodes which cannot improve the best solution found by any solver are closed
+        cub = MIN(cub, ub.load());
+        while (!nodes.empty() && nodes.begin()->first >= cub)
+            nodes.erase(nodes.begin());
+        if (!nodes.empty()) {
+            lb = nodes.begin()->first;
+            branch = std::move(nodes.begin()->second);
+            nodes.erase(nodes.begin());
+            workersLb[worker] = lb;
+            nbIdle--;
+            nbHungry = nbIdle - (int)nodes.size();
+            return true;
+        }
+        nbHungry = nbIdle;
+        if (nbIdle == (int)workersLb.size())
+            done = true;
+        if (done) {
+            available.notify_all();
+            return false;
+        }
+        if (ToulBar2::interrupted)
+            return false;
+        available.wait_for(lock, std::chrono::milliseconds(10));
+    }
+}
+
+void OpenNodePool::setLb(int worker, Cost lb)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    workersLb[worker] = lb;
+}
+
+Cost OpenNodePool::getLb()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Cost lb = (nodes.empty()) ? MAX_COST : nodes.begin()->first;
+    for (vector<Cost>::iterator iter = workersLb.begin(); iter != workersLb.end(); ++iter) {
+        lb = MIN(lb, *iter);
+    }
+    return lb;
+}
+
+/* Local Variables: */
+/* c-basic-offset: 4 */
+/* tab-width: 4 */
+/* indent-tabs-mode: nil */
+/* c-default-style: "k&r" */
+/* End: */
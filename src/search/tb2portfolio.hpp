@@ -0,0 +1,112 @@
+/** \file tb2portfolio.hpp
+ *  \brief Parallel portfolio of solvers with diverse configurations running in threads of the same process.
+ *
+ *  The calling thread solves the problem with the user configuration while helper threads solve their own copy of the problem
+ *  with different seeds, local consistency levels, search strategies and variable ordering heuristics (see Portfolio::diversify).
+ *  All the solvers share the best solution found so far through an atomic upper bound and stop as soon as one of them completes its search.
+ *
+ *  With option -ws, all the solvers keep the same configuration and share the open nodes of hybrid best-first search instead (see OpenNodePool).
+ *
+ *  \note each helper thread has its own copy of ToulBar2 global variables and its own trail context (see ::StoreContext)
+ *  \warning helper threads are silent: only the calling thread reports its search progress and the final result
+ */
+
+#ifndef TB2PORTFOLIO_HPP_
+#define TB2PORTFOLIO_HPP_
+
+#include "tb2solver.hpp"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/** Shared pool of open nodes for parallel hybrid best-first search with work stealing (without tree decomposition)
+ *
+ *  Each solver thread explores its own list of open nodes and gives its best open nodes to the pool when other solvers become idle.
+ *  An open node is copied as its branch of choice points because choice point positions are local to each solver (see Solver::CPStore).
+ *  The search is complete when all the solvers are idle and the pool is empty.
+ *
+ *  \warning all the solvers must start from the same root node (same problem, same options, and same preprocessing)
+ */
+class OpenNodePool {
+    std::mutex mutex;
+    std::condition_variable available;
+    multimap<Cost, vector<Solver::ChoicePoint>> nodes; // open nodes sorted by increasing lower bound
+    vector<Cost> workersLb; // lower bound of the open nodes owned by each solver (MAX_COST if idle)
+    int nbIdle;
+    bool done; // true if the search is complete
+    std::atomic<int> nbHungry; // number of idle solvers minus the number of open nodes in the pool
+    const std::atomic<Cost>& ub; // best solution cost found by any solver
+
+public:
+    OpenNodePool(const std::atomic<Cost>& ub_)
+        : nbIdle(0)
+        , done(false)
+        , nbHungry(0)
+        , ub(ub_)
+    {
+    }
+
+    int join(); ///< \brief registers a new solver and returns its index (the first solver starts from the root node, the others start idle)
+    bool hungry() const { return nbHungry > 0; } ///< \brief true if some idle solvers are waiting for open nodes
+
+    void push(Cost lb, const Solver::CPStore& cp, const Solver::OpenNode& nd); ///< \brief gives an open node to idle solvers
+    /// \brief waits for the best open node with lower bound strictly less than \a cub and the best solution cost
+    /// \return false if the search is complete or interrupted
+    bool pop(int worker, Cost cub, Cost& lb, vector<Solver::ChoicePoint>& branch);
+
+    void setLb(int worker, Cost lb); ///< \brief updates the lower bound of the open nodes owned by a solver
+    Cost getLb(); ///< \brief global lower bound of the problem
+};
+
+class Portfolio {
+public:
+    typedef std::function<void(WeightedCSPSolver*)> Loader; ///< \brief reads the problem into a new solver
+
+private:
+    Loader loader; // shared by all helper threads
+    vector<const void*> options; // ToulBar2 global variables of the calling thread
+    vector<std::thread> helpers;
+
+    std::mutex readyMutex;
+    std::condition_variable readyCondition;
+    int nbReady; // number of helper threads having copied the ToulBar2 global variables
+
+    std::atomic<Cost> ub; // best solution cost found by any solver
+    std::atomic<bool> proved; // true if one solver has completed its search
+    std::atomic<int> provedBy; // thread index of the first solver having completed its search
+
+    OpenNodePool* pool; // shared open nodes if hybrid best-first search with work stealing (NULL otherwise)
+
+    std::mutex solutionMutex; // protects the best solution
+    Cost bestCost;
+    TAssign bestSolution;
+    int bestThread;
+
+    void run(int id);
+    static void diversify(int id);
+
+public:
+    /// \param nbThreads total number of solvers including the calling thread
+    /// \param loader function used by each helper thread to read its own copy of the problem
+    /// \warning must be created before the calling thread reads the problem (ToulBar2 global variables are copied at creation)
+    Portfolio(int nbThreads, Loader loader);
+    ~Portfolio(); ///< \brief stops and joins helper threads
+
+    Cost getUb() const { return ub; }
+    bool isProved() const { return proved; }
+    OpenNodePool* getOpenNodePool() const { return pool; }
+
+    void newSolution(WeightedCSP* wcsp); ///< \brief shares a new solution found by the solver of the calling thread
+    void importSolution(WeightedCSP* wcsp); ///< \brief gets a better solution found by another solver if any
+    void endSearch(WeightedCSP* wcsp, bool complete); ///< \brief stops all the solvers if the search of the calling thread is complete
+};
+
+#endif /*TB2PORTFOLIO_HPP_*/
+
+/* Local Variables: */
+/* c-basic-offset: 4 */
+/* tab-width: 4 */
+/* indent-tabs-mode: nil */
+/* c-default-style: "k&r" */
+/* End: */
@@ -5,16 +5,19 @@
 
 #include "tb2solver.hpp"
 #include "core/tb2domain.hpp"
+#include "core/tb2binconstr.hpp"
+#include "core/tb2ternaryconstr.hpp"
+#include "utils/tb2tuplemap.hpp"
 #include "applis/tb2pedigree.hpp"
 #include "applis/tb2haplotype.hpp"
 #include "applis/tb2bep.hpp"
 #include "tb2clusters.hpp"
+#include "tb2portfolio.hpp"
 #include "vns/tb2vnsutils.hpp"
 #include "vns/tb2dgvns.hpp"
-#ifdef OPENMPI
+#include "vns/tb2pdgvnscomm.hpp"
 #include "vns/tb2cpdgvns.hpp"
 #include "vns/tb2rpdgvns.hpp"
-#endif
 #include <unistd.h>
 
 extern void setvalue(int wcspId, int varIndex, Value value, void* solver);
@@ -28,11 +31,8 @@ const string Solver::CPOperation[CP_MAX] = { "ASSIGN", "REMOVE", "INCREASE", "DE
 
 WeightedCSPSolver* WeightedCSPSolver::makeWeightedCSPSolver(Cost ub)
 {
-#ifdef OPENMPI
     MPIEnv env0;
-    MPI_Comm_size(MPI_COMM_WORLD, &env0.ntasks);
-    MPI_Comm_rank(MPI_COMM_WORLD, &env0.myrank);
-#endif
+    pdgvnsGetEnv(env0);
     WeightedCSPSolver* solver = NULL;
     switch (ToulBar2::searchMethod) {
     case VNS:
@@ -44,7 +44,6 @@ WeightedCSPSolver* WeightedCSPSolver::makeWeightedCSPSolver(Cost ub)
         exit(EXIT_FAILURE);
 #endif
         break;
-#ifdef OPENMPI
     case CPDGVNS:
 #ifdef BOOST
         solver = new CooperativeParallelDGVNS(ub, env0);
@@ -61,7 +60,6 @@ WeightedCSPSolver* WeightedCSPSolver::makeWeightedCSPSolver(Cost ub)
         exit(EXIT_FAILURE);
 #endif
         break;
-#endif
     case TREEDEC:
 #ifdef BOOST
         solver = new TreeDecRefinement(ub);
@@ -78,7 +76,10 @@ WeightedCSPSolver* WeightedCSPSolver::makeWeightedCSPSolver(Cost ub)
 }
 
 Solver::Solver(Cost initUpperBound)
-    : nbNodes(0)
+    : storeContext(new StoreContext(STORE_SIZE))
+    , portfolio(NULL)
+    , poolWorker(-1)
+    , nbNodes(0)
     , nbBacktracks(0)
     , nbBacktracksLimit(LONGLONG_MAX)
     , wcsp(NULL)
@@ -96,11 +97,16 @@ Solver::Solver(Cost initUpperBound)
     , nbHybridContinue(0)
     , nbHybridNew(0)
     , nbRecomputationNodes(0)
+    , resumed(NULL)
+    , checkpointTime(0.)
+    , checkpointBacktracks(0)
+    , checkpointSignature(0)
     , initialLowerBound(MIN_COST)
     , globalLowerBound(MIN_COST)
     , globalUpperBound(MAX_COST)
     , initialDepth(0)
 {
+    setStoreContext();
     searchSize = new StoreCost(MIN_COST);
     wcsp = WeightedCSP::makeWeightedCSP(initUpperBound, (void*)this);
 }
@@ -109,15 +115,20 @@ Solver::~Solver()
 {
     delete cp;
     delete open;
+    delete resumed;
     delete unassignedVars;
     delete[] allVars;
     delete wcsp;
     delete ((StoreCost*)searchSize);
+    StoreContext* previous = Store::setContext(NULL);
+    if (previous != storeContext)
+        Store::setContext(previous);
+    delete storeContext;
 }
 
 void Solver::initVarHeuristic()
 {
-    unassignedVars = new BTList<Value>(&Store::storeDomain);
+    unassignedVars = new BTList<Value>(&Store::getContext()->storeDomain);
     allVars = new DLink<Value>[wcsp->numberOfVariables()];
     for (unsigned int j = 0; j < wcsp->numberOfVariables(); j++) {
         unsigned int i = wcsp->getDACOrder(j);
@@ -136,12 +147,14 @@ void Solver::initVarHeuristic()
 
 Cost Solver::read_wcsp(const char* fileName)
 {
+    setStoreContext();
     ToulBar2::setvalue = NULL;
     return wcsp->read_wcsp(fileName);
 }
 
 void Solver::read_random(int n, int m, vector<int>& p, int seed, bool forceSubModular, string globalname)
 {
+    setStoreContext();
     ToulBar2::setvalue = NULL;
     wcsp->read_random(n, m, p, seed, forceSubModular, globalname);
 }
@@ -588,6 +601,8 @@ int Solver::getMostUrgent()
 /// \brief Enforce WCSP upper-bound and backtrack if ub <= lb or in the case of probabilistic inference if the contribution is too small
 void Solver::enforceUb()
 {
+    if (portfolio && !ToulBar2::btdMode)
+        portfolio->importSolution(wcsp);
     wcsp->enforceUb();
     if (ToulBar2::isZ) {
         Cost newCost = wcsp->getLb() + wcsp->getNegativeLb();
@@ -862,10 +877,8 @@ void Solver::binaryChoicePoint(int varIndex, Value value, Cost lb)
     nbBacktracks++;
     if (ToulBar2::restart > 0 && nbBacktracks > nbBacktracksLimit)
         throw NbBacktracksOut();
-#ifdef OPENMPI
-    if (ToulBar2::vnsParallel && ((nbBacktracks % 128) == 0) && MPI_interrupted())
+    if (ToulBar2::vnsParallel && ((nbBacktracks % 128) == 0) && pdgvnsInterrupted())
         throw TimeOut();
-#endif
     if (dichotomic) {
         if (ToulBar2::dichotomicBranching == 1) {
             if (increasing)
@@ -941,10 +954,8 @@ void Solver::binaryChoicePointLDS(int varIndex, Value value, int discrepancy)
         nbBacktracks++;
         if (ToulBar2::restart > 0 && nbBacktracks > nbBacktracksLimit)
             throw NbBacktracksOut();
-#ifdef OPENMPI
-        if (ToulBar2::vnsParallel && ((nbBacktracks % 128) == 0) && MPI_interrupted())
+        if (ToulBar2::vnsParallel && ((nbBacktracks % 128) == 0) && pdgvnsInterrupted())
             throw TimeOut();
-#endif
         if (dichotomic) {
             if (ToulBar2::dichotomicBranching == 1) {
                 if (increasing)
@@ -1025,10 +1036,8 @@ void Solver::scheduleOrPostpone(int varIndex)
     nbBacktracks++;
     if (ToulBar2::restart > 0 && nbBacktracks > nbBacktracksLimit)
         throw NbBacktracksOut();
-#ifdef OPENMPI
-    if (ToulBar2::vnsParallel && ((nbBacktracks % 128) == 0) && MPI_interrupted())
+    if (ToulBar2::vnsParallel && ((nbBacktracks % 128) == 0) && pdgvnsInterrupted())
         throw TimeOut();
-#endif
     if (reverse)
         assign(varIndex, xinf);
     else
@@ -1061,10 +1070,8 @@ void Solver::narySortedChoicePoint(int varIndex, Cost lb)
     nbBacktracks++;
     if (ToulBar2::restart > 0 && nbBacktracks > nbBacktracksLimit)
         throw NbBacktracksOut();
-#ifdef OPENMPI
-    if (ToulBar2::vnsParallel && ((nbBacktracks % 128) == 0) && MPI_interrupted())
+    if (ToulBar2::vnsParallel && ((nbBacktracks % 128) == 0) && pdgvnsInterrupted())
         throw TimeOut();
-#endif
 }
 
 void Solver::narySortedChoicePointLDS(int varIndex, int discrepancy)
@@ -1094,10 +1101,8 @@ void Solver::narySortedChoicePointLDS(int varIndex, int discrepancy)
     nbBacktracks++;
     if (ToulBar2::restart > 0 && nbBacktracks > nbBacktracksLimit)
         throw NbBacktracksOut();
-#ifdef OPENMPI
-    if (ToulBar2::vnsParallel && ((nbBacktracks % 128) == 0) && MPI_interrupted())
+    if (ToulBar2::vnsParallel && ((nbBacktracks % 128) == 0) && pdgvnsInterrupted())
         throw TimeOut();
-#endif
 }
 
 void Solver::singletonConsistency()
@@ -1183,6 +1188,8 @@ void Solver::newSolution()
     wcsp->restoreSolution();
     if (!ToulBar2::isZ)
         wcsp->setSolution(wcsp->getLb());
+    if (portfolio)
+        portfolio->newSolution(wcsp);
 
     if (ToulBar2::showSolutions) {
 
@@ -1382,14 +1389,26 @@ pair<Cost, Cost> Solver::hybridSolve(Cluster* cluster, Cost clb, Cost cub)
                 delete open;
             open = new OpenList();
             open_ = open;
+            if (resumed) { // continue with the open nodes saved in a checkpoint
+                cp->swap(resumed->cp);
+                cp->stop = cp->size();
+                *open = resumed->open;
+                delete resumed;
+                resumed = NULL;
+            }
         }
         cp_->store();
+        OpenNodePool* pool = (portfolio && !cluster) ? portfolio->getOpenNodePool() : NULL; // open nodes shared with other solver threads
+        if (pool && poolWorker < 0)
+            poolWorker = pool->join(); // registers once, even if hybrid best-first search is called several times
+        int worker = (pool) ? poolWorker : 0;
         if (open_->size() == 0 || (cluster && (clb >= open_->getClosedNodesLb(delta) || cub > open_->getUb(delta)))) { // start a new list of open nodes if needed
             if (open_->size() == 0 && (!cluster || cluster->getNbVars() > 0))
                 nbHybridNew++;
-            // reinitialize current open list and insert empty node
+            // reinitialize current open list and insert empty node (only for the first solver thread if open nodes are shared)
             *open_ = OpenList(MAX(MIN_COST, cub + delta), MAX(MIN_COST, cub + delta));
-            addOpenNode(*cp_, *open_, clb, delta);
+            if (worker == 0)
+                addOpenNode(*cp_, *open_, clb, delta);
         } else if (!cluster || cluster->getNbVars() > 0)
             nbHybridContinue++;
         if (!cluster || cluster->getNbVars() > 0)
@@ -1402,7 +1421,7 @@ pair<Cost, Cost> Solver::hybridSolve(Cluster* cluster, Cost clb, Cost cub)
         clb = MAX(clb, open_->getLb(delta));
         if (ToulBar2::verbose >= 1 && cluster)
             cout << "hybridSolve-2 C" << cluster->getId() << " " << clb << " " << cub << " " << delta << " " << open_->size() << " " << open_->top().getCost(delta) << " " << open_->getClosedNodesLb(delta) << " " << open_->getUb(delta) << endl;
-        while (clb < cub && !open_->finished() && (!cluster || (clb == initiallb && cub == initialub && nbBacktracks <= cluster->hbfsGlobalLimit))) {
+        while ((clb < cub && !open_->finished() && (!cluster || (clb == initiallb && cub == initialub && nbBacktracks <= cluster->hbfsGlobalLimit))) || (pool && stealOpenNode(*pool, worker, clb, cub))) {
             if (cluster) {
                 cluster->hbfsLimit = ((ToulBar2::hbfs > 0) ? (cluster->nbBacktracks + ToulBar2::hbfs) : LONGLONG_MAX);
                 assert(wcsp->getTreeDec()->getCurrentCluster() == cluster);
@@ -1455,7 +1474,16 @@ pair<Cost, Cost> Solver::hybridSolve(Cluster* cluster, Cost clb, Cost cub)
                     hbfsLimit = LONGLONG_MAX;
             }
             clb = MAX(clb, open_->getLb(delta));
-            showGap(clb, cub);
+            if (pool) {
+                while (open_->size() > 1 && pool->hungry()) { // give best open nodes to idle solvers
+                    OpenNode nd = open_->top();
+                    open_->pop();
+                    pool->push(nd.getCost(), *cp_, nd);
+                }
+                pool->setLb(worker, MIN(clb, cub));
+                showGap(pool->getLb(), cub);
+            } else
+                showGap(clb, cub);
             if (ToulBar2::hbfs && nbRecomputationNodes > 0) { // wait until a nonempty open node is restored (at least after first global solution is found)
                 assert(nbNodes > 0);
                 if (nbRecomputationNodes > nbNodes / ToulBar2::hbfsBeta && ToulBar2::hbfs <= ToulBar2::hbfsGlobalLimit)
@@ -1465,6 +1493,11 @@ pair<Cost, Cost> Solver::hybridSolve(Cluster* cluster, Cost clb, Cost cub)
                 if (ToulBar2::debug >= 2)
                     cout << "HBFS backtrack limit: " << ToulBar2::hbfs << endl;
             }
+            if (!cluster && !pool && ToulBar2::checkpointFile.size() > 0 && ((ToulBar2::checkpointBacktracks > 0) ? (nbBacktracks - checkpointBacktracks >= ToulBar2::checkpointBacktracks) : (cpuTime() - checkpointTime >= ToulBar2::checkpointPeriod))) {
+                saveCheckpoint(ToulBar2::checkpointFile.c_str());
+                checkpointTime = cpuTime();
+                checkpointBacktracks = nbBacktracks;
+            }
         }
         assert(clb >= initiallb && cub <= initialub);
     } else {
@@ -1485,8 +1518,240 @@ pair<Cost, Cost> Solver::hybridSolve(Cluster* cluster, Cost clb, Cost cub)
     return make_pair(clb, cub);
 }
 
+/*
+ * Checkpoints of hybrid best-first search (without tree decomposition)
+ *
+ * binary file containing the incumbent solution, the weighted degree counters of the original cost functions,
+ * some search statistics, and the choice points and open nodes of the current open list
+ *
+ * the problem must be read and preprocessed with the same options before resuming search
+ * (checked by a hash code of the domains and costs of the preprocessed problem)
+ *
+ */
+
+static const char CheckpointMagic[] = "toulbar2 checkpoint 2";
+
+// hash code of the current domains, unary costs, and cost functions (with the costs of binary, ternary, and n-ary table cost functions)
+static size_t checkpointProblemSignature(WCSP* wcsp)
+{
+    size_t h = TupleHash::first;
+    h = TupleHash::add(h, (size_t)wcsp->getLb());
+    for (unsigned int i = 0; i < wcsp->numberOfVariables(); i++) {
+        Variable* var = wcsp->getVar(i);
+        h = TupleHash::add(h, (size_t)var->getInf());
+        h = TupleHash::add(h, (size_t)var->getSup());
+        if (var->enumerated()) {
+            EnumeratedVariable* x = (EnumeratedVariable*)var;
+            h = TupleHash::add(h, x->getDomainInitSize());
+            for (EnumeratedVariable::iterator iter = x->begin(); iter != x->end(); ++iter) {
+                h = TupleHash::add(h, (size_t)*iter);
+                h = TupleHash::add(h, (size_t)x->getCost(*iter));
+            }
+        }
+    }
+    for (unsigned int i = 0; i < wcsp->numberOfConstraints(); i++) {
+        Constraint* ctr = wcsp->getCtr(i);
+        if (ctr->deconnected())
+            continue;
+        h = TupleHash::add(h, i);
+        for (int j = 0; j < ctr->arity(); j++)
+            h = TupleHash::add(h, ctr->getVar(j)->wcspIndex);
+        if (ctr->isBinary()) {
+            BinaryConstraint* bctr = (BinaryConstraint*)ctr;
+            EnumeratedVariable* x = (EnumeratedVariable*)bctr->getVar(0);
+            EnumeratedVariable* y = (EnumeratedVariable*)bctr->getVar(1);
+            for (EnumeratedVariable::iterator iterx = x->begin(); iterx != x->end(); ++iterx)
+                for (EnumeratedVariable::iterator itery = y->begin(); itery != y->end(); ++itery)
+                    h = TupleHash::add(h, (size_t)bctr->getCost(*iterx, *itery));
+        } else if (ctr->isTernary()) {
+            TernaryConstraint* tctr = (TernaryConstraint*)ctr;
+            EnumeratedVariable* x = (EnumeratedVariable*)tctr->getVar(0);
+            EnumeratedVariable* y = (EnumeratedVariable*)tctr->getVar(1);
+            EnumeratedVariable* z = (EnumeratedVariable*)tctr->getVar(2);
+            for (EnumeratedVariable::iterator iterx = x->begin(); iterx != x->end(); ++iterx)
+                for (EnumeratedVariable::iterator itery = y->begin(); itery != y->end(); ++itery)
+                    for (EnumeratedVariable::iterator iterz = z->begin(); iterz != z->end(); ++iterz)
+                        h = TupleHash::add(h, (size_t)tctr->getCost(*iterx, *itery, *iterz));
+        } else if (ctr->isNary() && ctr->extension()) {
+            String t;
+            Cost c;
+            ctr->first();
+            while (ctr->next(t, c)) {
+                h = TupleHash::add(h, TupleHash()(t));
+                h = TupleHash::add(h, (size_t)c);
+            }
+        } else {
+            h = TupleHash::add(h, (size_t)ctr->getMaxFiniteCost());
+        }
+    }
+    return h;
+}
+
+template <class T>
+static void writeCheckpoint(ostream& os, const T& x)
+{
+    os.write((const char*)&x, sizeof(T));
+}
+
+template <class T>
+static void readCheckpoint(istream& is, T& x)
+{
+    is.read((char*)&x, sizeof(T));
+}
+
+void Solver::saveCheckpoint(const char* fileName)
+{
+    assert(cp && open);
+    string tmpName = string(fileName) + ".tmp"; // the previous checkpoint stays valid until the new one is complete
+    ofstream file(tmpName.c_str(), ios::binary);
+    file.write(CheckpointMagic, sizeof(CheckpointMagic));
+    unsigned int nbvars = wcsp->numberOfVariables();
+    unsigned int nbctrs = wcsp->numberOfConstraints();
+    writeCheckpoint(file, nbvars);
+    writeCheckpoint(file, nbctrs);
+    writeCheckpoint(file, checkpointSignature);
+
+    Cost cost = MAX_COST;
+    const vector<Value>& solution = wcsp->getSolution(&cost);
+    bool isSolution = (cost < MAX_COST && !ToulBar2::sortDomains); // solution values are not saved in the sorted domain order
+    writeCheckpoint(file, isSolution);
+    if (isSolution) {
+        writeCheckpoint(file, cost);
+        writeCheckpoint(file, wcsp->getUb());
+        for (unsigned int i = 0; i < nbvars; i++)
+            writeCheckpoint(file, solution[i]);
+    }
+    for (unsigned int i = 0; i < nbctrs; i++)
+        writeCheckpoint(file, ((WCSP*)wcsp)->getCtr(i)->getConflictWeight());
+
+    writeCheckpoint(file, nbNodes);
+    writeCheckpoint(file, nbBacktracks);
+    writeCheckpoint(file, nbRecomputationNodes);
+    writeCheckpoint(file, ToulBar2::hbfs);
+
+    writeCheckpoint(file, open->getClosedNodesLb());
+    writeCheckpoint(file, open->getUb());
+    writeCheckpoint(file, cp->stop);
+    for (ptrdiff_t i = 0; i < cp->stop; i++) {
+        const ChoicePoint& choice = (*cp)[i];
+        writeCheckpoint(file, choice.op);
+        writeCheckpoint(file, choice.varIndex);
+        writeCheckpoint(file, choice.value);
+        writeCheckpoint(file, choice.reverse);
+    }
+    size_t nbopen = open->size();
+    writeCheckpoint(file, nbopen);
+    for (const OpenNode& nd : open->getNodes()) {
+        writeCheckpoint(file, nd.getCost());
+        writeCheckpoint(file, nd.first);
+        writeCheckpoint(file, nd.last);
+    }
+    file.close();
+    if (!file || rename(tmpName.c_str(), fileName) != 0) {
+        cerr << "Warning! Cannot write checkpoint file " << fileName << endl;
+        return;
+    }
+    if (ToulBar2::verbose >= 1)
+        cout << "Checkpoint saved in " << fileName << " with " << nbopen << " open nodes and " << cp->stop << " choice points (" << nbNodes << " nodes, " << cpuTime() - ToulBar2::startCpuTime << " seconds)" << endl;
+}
+
+void Solver::loadCheckpoint(const char* fileName)
+{
+    ifstream file(fileName, ios::binary);
+    char magic[sizeof(CheckpointMagic)];
+    unsigned int nbvars = 0;
+    unsigned int nbctrs = 0;
+    file.read(magic, sizeof(magic));
+    size_t signature = 0;
+    readCheckpoint(file, nbvars);
+    readCheckpoint(file, nbctrs);
+    readCheckpoint(file, signature);
+    if (!file || memcmp(magic, CheckpointMagic, sizeof(magic)) != 0 || nbvars != wcsp->numberOfVariables() || nbctrs != wcsp->numberOfConstraints() || signature != checkpointSignature) {
+        cerr << "Error: " << fileName << " is not a checkpoint of this problem." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    bool isSolution = false;
+    Cost cost = MAX_COST;
+    Cost ub = MAX_COST;
+    TAssign solution;
+    readCheckpoint(file, isSolution);
+    if (isSolution) {
+        readCheckpoint(file, cost);
+        readCheckpoint(file, ub);
+        for (unsigned int i = 0; i < nbvars; i++)
+            readCheckpoint(file, solution[i]);
+    }
+    vector<Long> weights(nbctrs);
+    for (unsigned int i = 0; i < nbctrs; i++)
+        readCheckpoint(file, weights[i]);
+    Long hbfs = 0;
+    readCheckpoint(file, nbNodes);
+    readCheckpoint(file, nbBacktracks);
+    checkpointBacktracks = nbBacktracks;
+    readCheckpoint(file, nbRecomputationNodes);
+    readCheckpoint(file, hbfs);
+
+    Cost clb = MAX_COST;
+    Cost cub = MAX_COST;
+    ptrdiff_t nbchoices = 0;
+    readCheckpoint(file, clb);
+    readCheckpoint(file, cub);
+    readCheckpoint(file, nbchoices);
+    resumed = new Checkpoint();
+    resumed->cp.reserve(nbchoices);
+    for (ptrdiff_t i = 0; i < nbchoices && file; i++) {
+        ChoicePoint choice(CP_ASSIGN, 0, 0, false);
+        readCheckpoint(file, choice.op);
+        readCheckpoint(file, choice.varIndex);
+        readCheckpoint(file, choice.value);
+        readCheckpoint(file, choice.reverse);
+        if (choice.op < CP_ASSIGN || choice.op >= CP_MAX || choice.varIndex < 0 || (unsigned int)choice.varIndex >= nbvars)
+            file.setstate(ios::failbit);
+        resumed->cp.push_back(choice);
+    }
+    size_t nbopen = 0;
+    readCheckpoint(file, nbopen);
+    resumed->open = OpenList(clb, cub);
+    for (size_t i = 0; i < nbopen && file; i++) {
+        Cost lb = MIN_COST;
+        ptrdiff_t first = 0;
+        ptrdiff_t last = 0;
+        readCheckpoint(file, lb);
+        readCheckpoint(file, first);
+        readCheckpoint(file, last);
+        if (first < 0 || first > last || last > nbchoices)
+            file.setstate(ios::failbit);
+        resumed->open.push(OpenNode(lb, first, last));
+    }
+    if (!file) {
+        cerr << "Error: checkpoint file " << fileName << " is truncated or corrupted." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    for (unsigned int i = 0; i < nbctrs; i++)
+        ((WCSP*)wcsp)->getCtr(i)->setConflictWeight(weights[i]);
+    if (hbfs > 0)
+        ToulBar2::hbfs = hbfs;
+    if (ToulBar2::verbose >= 0)
+        cout << "Resume search from " << fileName << " with " << nbopen << " open nodes (" << nbNodes << " nodes)" << endl;
+    if (isSolution && ub < wcsp->getUb()) {
+        wcsp->setSolution(cost, &solution);
+        wcsp->updateUb(ub);
+        if (ToulBar2::verbose >= 0)
+            cout << "New solution: " << std::fixed << std::setprecision(ToulBar2::decimalPoint) << wcsp->Cost2ADCost(cost) << std::setprecision(DECIMAL_POINT) << " (from checkpoint)" << endl;
+        if (ToulBar2::writeSolution && ToulBar2::solutionFile != NULL) {
+            rewind(ToulBar2::solutionFile);
+            wcsp->printSolution(ToulBar2::solutionFile);
+            fprintf(ToulBar2::solutionFile, "\n");
+        }
+    }
+}
+
 Cost Solver::beginSolve(Cost ub)
 {
+    setStoreContext();
+
     // Last-minute compatibility checks for ToulBar2 selected options
     if (ub <= MIN_COST) {
         cerr << "Error: wrong initial primal bound (negative or zero)." << endl;
@@ -1674,6 +1939,13 @@ bool Solver::solve()
     try {
         try {
             initialUpperBound = preprocessing(initialUpperBound);
+            if (ToulBar2::checkpointFile.size() > 0 || ToulBar2::resumeFile.size() > 0)
+                checkpointSignature = checkpointProblemSignature((WCSP*)wcsp);
+            if (ToulBar2::resumeFile.size() > 0) {
+                loadCheckpoint(ToulBar2::resumeFile.c_str());
+                enforceUb();
+                wcsp->propagate();
+            }
 
             Cost upperbound = MAX_COST;
             if (ToulBar2::restart >= 0) {
@@ -1862,9 +2134,14 @@ bool Solver::solve()
             wcsp->whenContradiction();
         }
     } catch (NbSolutionsOut) {
+    } catch (TimeOut) {
+        if (!portfolio)
+            throw;
     }
     //  Store::restore();         // see above for Store::store()
-    endSolve(wcsp->getSolutionCost() < initialUpperBound, wcsp->getSolutionCost(), !ToulBar2::limited);
+    if (portfolio)
+        portfolio->endSearch(wcsp, !ToulBar2::limited);
+    endSolve(wcsp->getSolutionCost() < initialUpperBound, wcsp->getSolutionCost(), !ToulBar2::limited || (portfolio && portfolio->isProved()));
     return (ToulBar2::isZ || ToulBar2::allSolutions || wcsp->getSolutionCost() < initialUpperBound);
 }
 
@@ -1890,6 +2167,10 @@ void Solver::endSolve(bool isSolution, Cost cost, bool isComplete)
         cout << (wcsp->LogSumExp(ToulBar2::logZ, ToulBar2::logU) + ToulBar2::markov_log) / Log(10.) << " in " << nbBacktracks << " backtracks and " << nbNodes << " nodes and " << cpuTime() - ToulBar2::startCpuTime << " seconds" << endl;
         return;
     }
+    if (ToulBar2::btdMode >= 1 && ToulBar2::verbose >= 1 && wcsp->getTreeDec())
+        wcsp->getTreeDec()->printSeparatorStats();
+    if (ToulBar2::verbose >= 1)
+        storeContext->printStats(cout, cpuTime() - ToulBar2::startCpuTime);
     if (ToulBar2::allSolutions) {
         if (ToulBar2::approximateCountingBTD)
             cout << "Number of solutions    : ~= " << std::fixed << std::setprecision(0) << nbSol << std::setprecision(DECIMAL_POINT) << endl;
@@ -2148,6 +2429,34 @@ void Solver::addOpenNode(CPStore& cp, OpenList& open, Cost lb, Cost delta)
     cp.stop = max(cp.stop, idx);
 }
 
+/// \brief replaces the current open list (finished) by the best open node left by other solver threads
+/// \note open nodes pruned by the best solution found by another solver are discarded and the next one is stolen
+/// \return false if the parallel search is complete
+/// \warning must be called at the root of hybrid best-first search (without tree decomposition)
+bool Solver::stealOpenNode(OpenNodePool& pool, int worker, Cost& clb, Cost& cub)
+{
+    vector<ChoicePoint> branch;
+    Cost lb = MIN_COST;
+    do {
+        if (!pool.pop(worker, cub, lb, branch)) {
+            if (ToulBar2::interrupted)
+                throw TimeOut();
+            return false;
+        }
+        portfolio->importSolution(wcsp);
+        cub = wcsp->getUb();
+        clb = MAX(wcsp->getLb(), MIN(lb, cub));
+    } while (clb >= cub);
+    *open = OpenList(cub, cub);
+    cp->store();
+    for (vector<ChoicePoint>::iterator iter = branch.begin(); iter != branch.end(); ++iter) {
+        cp->addChoicePoint(iter->op, iter->varIndex, iter->value, iter->reverse);
+    }
+    addOpenNode(*cp, *open, lb);
+    cp->store();
+    return true;
+}
+
 //// BUG: not compatible with boosting search by variable elimination (default dummy assignment may be incompatible with restored choice point)
 //void Solver::restore(CPStore &cp, OpenNode nd)
 //{
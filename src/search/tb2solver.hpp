@@ -14,6 +14,8 @@ class DLink;
 template <class T>
 class BTList;
 
+class Portfolio;
+class OpenNodePool;
 class NeighborhoodStructure;
 class RandomNeighborhoodChoice;
 class ClustersNeighborhoodStructure;
@@ -82,6 +84,7 @@ public:
         }
 
         size_type capacity() const { return c.capacity(); }
+        const vector<OpenNode>& getNodes() const { return c; } ///< \brief open nodes in heap order (for checkpoints)
     };
 
     typedef enum {
@@ -130,9 +133,15 @@ public:
         }
     };
 
+    struct Checkpoint {
+        CPStore cp; // choice points of the open nodes
+        OpenList open; // open nodes of hybrid best-first search
+    };
+
     void addChoicePoint(ChoicePointOp op, int varIndex, Value value, bool reverse);
     void addOpenNode(CPStore& cp, OpenList& open, Cost lb, Cost delta = MIN_COST); ///< \param delta cost moved out from the cluster by soft arc consistency
     void restore(CPStore& cp, OpenNode node);
+    bool stealOpenNode(OpenNodePool& pool, int worker, Cost& clb, Cost& cub);
 
 protected:
     friend class NeighborhoodStructure;
@@ -141,6 +150,9 @@ protected:
     friend class RandomClusterChoice;
     friend class ParallelRandomClusterChoice;
 
+    StoreContext* storeContext; // trail context owned by this solver instance
+    Portfolio* portfolio; // shares solutions with other solvers running in parallel (NULL if none)
+    int poolWorker; // index of this solver in the shared pool of open nodes (-1 if not registered yet)
     Long nbNodes;
     Long nbBacktracks;
     Long nbBacktracksLimit;
@@ -165,6 +177,13 @@ protected:
     Long nbHybridNew;
     Long nbRecomputationNodes;
 
+    Checkpoint* resumed; // open nodes read from ToulBar2::resumeFile (NULL if none or already used by hybridSolve)
+    double checkpointTime; // CPU time of the last checkpoint
+    Long checkpointBacktracks; // number of backtracks at the last checkpoint
+    size_t checkpointSignature; // hash code of the domains and costs of the problem after preprocessing (a checkpoint is rejected if it differs)
+    void saveCheckpoint(const char* fileName);
+    void loadCheckpoint(const char* fileName); ///< \warning must be called after preprocessing
+
     //only for pretty print of optimality gap information
     Cost initialLowerBound;
     Cost globalLowerBound;
@@ -233,6 +252,10 @@ public:
     Cost read_wcsp(const char* fileName);
     void read_random(int n, int m, vector<int>& p, int seed, bool forceSubModular = false, string globalname = "");
 
+    StoreContext* getStoreContext() const { return storeContext; }
+    void setStoreContext() { Store::setContext(storeContext); } ///< \brief makes the trail context of this solver the current context of the calling thread
+    void setPortfolio(Portfolio* p) { portfolio = p; } ///< \brief exchanges solutions with other solvers running in parallel
+
     Long getNbNodes() const FINAL { return nbNodes; }
     Long getNbBacktracks() const FINAL { return nbBacktracks; }
     set<int> getUnassignedVars() const;
@@ -0,0 +1,54 @@
+/**
+ * Random weighted partial Max-SAT generator for the clause database benchmark (see option -wcl and bench_clause.cmake)
+ *
+ * usage: tb2benchclause [number of variables] [number of hard clauses] [number of soft clauses] [maximum hard clause arity] [seed] > file.wcnf
+ *
+ * Hard clauses have between 4 and the maximum arity literals, soft clauses have between 1 and 3 literals and a weight between 1 and 10.
+ */
+
+#include "core/tb2types.hpp"
+#include <random>
+
+int main(int argc, char* argv[])
+{
+    int nbvar = (argc > 1) ? atoi(argv[1]) : 150;
+    int nbhard = (argc > 2) ? atoi(argv[2]) : 1100;
+    int nbsoft = (argc > 3) ? atoi(argv[3]) : 300;
+    int maxarity = (argc > 4) ? atoi(argv[4]) : 8;
+    int seed = (argc > 5) ? atoi(argv[5]) : 1;
+    if (nbvar < maxarity || maxarity < 4 || nbhard < 0 || nbsoft < 0) {
+        cerr << "Error: the maximum arity must be at least 4 and at most the number of variables." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> variable(1, nbvar);
+    std::uniform_int_distribution<int> sign(0, 1);
+    std::uniform_int_distribution<int> hardarity(4, maxarity);
+    std::uniform_int_distribution<int> softarity(1, 3);
+    std::uniform_int_distribution<int> weight(1, 10);
+    Long top = (Long)10 * nbsoft + 1;
+
+    cout << "p wcnf " << nbvar << " " << nbhard + nbsoft << " " << top << endl;
+    for (int c = 0; c < nbhard + nbsoft; c++) {
+        int arity = (c < nbhard) ? hardarity(generator) : softarity(generator);
+        vector<int> scope;
+        while ((int)scope.size() < arity) {
+            int var = variable(generator);
+            if (find(scope.begin(), scope.end(), var) == scope.end())
+                scope.push_back(var);
+        }
+        cout << ((c < nbhard) ? top : (Long)weight(generator));
+        for (int i = 0; i < arity; i++)
+            cout << " " << ((sign(generator)) ? scope[i] : -scope[i]);
+        cout << " 0" << endl;
+    }
+    return 0;
+}
+
+/* Local Variables: */
+/* c-basic-offset: 4 */
+/* tab-width: 4 */
+/* indent-tabs-mode: nil */
+/* c-default-style: "k&r" */
+/* End: */
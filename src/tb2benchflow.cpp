@@ -0,0 +1,79 @@
+/**
+ * Random instance generator with flow-based global cost functions for the flow benchmark (see bench_flow.cmake)
+ *
+ * usage: tb2benchflow [number of variables] [domain size] [seed] > file.cfn
+ *
+ * Random unary and binary cost functions, a salldiff with the variable-based metric on the first half of the variables,
+ * a salldiff with the decomposition-based metric on the second half (both halves overlapping on four variables),
+ * and a sgcc with the variable-based metric on all the variables allowing each value at most n/d times (rounded up).
+ */
+
+#include "core/tb2types.hpp"
+#include <random>
+
+int main(int argc, char* argv[])
+{
+    int nbvar = (argc > 1) ? atoi(argv[1]) : 24;
+    int domsize = (argc > 2) ? atoi(argv[2]) : 12;
+    int seed = (argc > 3) ? atoi(argv[3]) : 1;
+    if (nbvar < 4 || domsize < 2) {
+        cerr << "Error: at least 4 variables and 2 values are needed." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> variable(0, nbvar - 1);
+    std::uniform_int_distribution<int> unarycost(0, 9);
+    std::uniform_int_distribution<int> binarycost(0, 5);
+
+    cout << "{ problem: {name: benchflow, mustbe: <100000.0}" << endl;
+    cout << " variables: {";
+    for (int i = 0; i < nbvar; i++) {
+        cout << " x" << i << ": [";
+        for (int a = 0; a < domsize; a++)
+            cout << " v" << a;
+        cout << "]";
+    }
+    cout << "}" << endl;
+    cout << " functions: {" << endl;
+    for (int i = 0; i < nbvar; i++) {
+        cout << "  u" << i << ": {scope: [x" << i << "] costs: [";
+        for (int a = 0; a < domsize; a++)
+            cout << " " << unarycost(generator);
+        cout << "]}" << endl;
+    }
+    for (int i = 0; i < nbvar - 1; i++) {
+        int j = variable(generator);
+        if (j == i)
+            continue;
+        cout << "  b" << i << ": {scope: [x" << i << " x" << j << "] costs: [";
+        for (int a = 0; a < domsize * domsize; a++)
+            cout << " " << binarycost(generator);
+        cout << "]}" << endl;
+    }
+    cout << "  a1: {scope: [";
+    for (int i = 0; i < nbvar / 2 + 2; i++)
+        cout << " x" << i;
+    cout << "] type: salldiff params: {metric: var cost: 3.0}}" << endl;
+    cout << "  a2: {scope: [";
+    for (int i = nbvar / 2 - 2; i < nbvar; i++)
+        cout << " x" << i;
+    cout << "] type: salldiff params: {metric: dec cost: 2.0}}" << endl;
+    cout << "  g1: {scope: [";
+    for (int i = 0; i < nbvar; i++)
+        cout << " x" << i;
+    cout << "] type: sgcc params: {metric: var cost: 2.0 bounds: [";
+    for (int a = 0; a < domsize; a++)
+        cout << " [" << a << " 1 " << (nbvar + domsize - 1) / domsize << "]";
+    cout << "]}}" << endl;
+    cout << " }" << endl;
+    cout << "}" << endl;
+    return 0;
+}
+
+/* Local Variables: */
+/* c-basic-offset: 4 */
+/* tab-width: 4 */
+/* indent-tabs-mode: nil */
+/* c-default-style: "k&r" */
+/* End: */
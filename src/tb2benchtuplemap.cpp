@@ -0,0 +1,99 @@
+/**
+ * Memory and lookup benchmark of TupleMap against std::map (sparse n-ary cost tables, see NaryConstraint)
+ *
+ * usage: tb2benchtuplemap [number of tuples] [arity] [domain size] [number of lookups]
+ */
+
+#include "core/tb2types.hpp"
+#include "utils/tb2tuplemap.hpp"
+#include <chrono>
+#include <random>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+// heap memory currently allocated in bytes (zero if unknown)
+static Long heapSpace()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 info = mallinfo2();
+    return (Long)info.uordblks + (Long)info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+static double elapsed(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// inserts the tuples into an empty table then looks up the queries and reports time and memory space
+template <class M>
+static void bench(const char* name, const vector<String>& tuples, const vector<String>& queries)
+{
+    Long space = heapSpace();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    M* table = new M();
+    for (size_t i = 0; i < tuples.size(); i++)
+        (*table)[tuples[i]] = (Cost)i;
+    double inserttime = elapsed(start);
+    space = heapSpace() - space;
+
+    start = std::chrono::steady_clock::now();
+    Cost sum = MIN_COST;
+    size_t nbhits = 0;
+    for (size_t i = 0; i < queries.size(); i++) {
+        typename M::const_iterator iter = ((const M*)table)->find(queries[i]);
+        if (iter != ((const M*)table)->end()) {
+            sum += iter->second;
+            nbhits++;
+        }
+    }
+    double lookuptime = elapsed(start);
+
+    cout << name << ": " << table->size() << " tuples, insertion " << inserttime << " s, " << queries.size() << " lookups (" << nbhits << " hits, checksum " << sum << ") " << lookuptime << " s, memory " << space / 1048576. << " MB" << endl;
+    delete table;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t nbtuples = (argc > 1) ? atol(argv[1]) : 100000;
+    int arity = (argc > 2) ? atoi(argv[2]) : 8;
+    int domsize = (argc > 3) ? atoi(argv[3]) : 10;
+    size_t nblookups = (argc > 4) ? atol(argv[4]) : 10 * nbtuples;
+    if (arity <= 0 || domsize <= 0) {
+        cerr << "Error: arity and domain size must be positive." << endl;
+        exit(EXIT_FAILURE);
+    }
+
+    // random tuples in the NaryConstraint encoding (one character per value index), half of the lookups are misses
+    std::mt19937_64 generator(1);
+    std::uniform_int_distribution<int> value(0, domsize - 1);
+    vector<String> tuples(nbtuples, String(arity, CHAR_FIRST));
+    for (size_t i = 0; i < nbtuples; i++)
+        for (int j = 0; j < arity; j++)
+            tuples[i][j] = CHAR_FIRST + value(generator);
+    vector<String> queries(nblookups, String(arity, CHAR_FIRST));
+    std::uniform_int_distribution<size_t> position(0, nbtuples - 1);
+    for (size_t i = 0; i < nblookups; i++) {
+        if (i % 2 == 0 && nbtuples > 0) {
+            queries[i] = tuples[position(generator)];
+        } else {
+            for (int j = 0; j < arity; j++)
+                queries[i][j] = CHAR_FIRST + value(generator);
+        }
+    }
+
+    cout << "Tuples: " << nbtuples << ", arity: " << arity << ", domain size: " << domsize << ", string: " << sizeof(Char) << " byte(s) per value" << endl;
+    bench<map<String, Cost>>("std::map", tuples, queries);
+    bench<TupleMap<Cost>>("TupleMap", tuples, queries);
+    return 0;
+}
+
+/* Local Variables: */
+/* c-basic-offset: 4 */
+/* tab-width: 4 */
+/* indent-tabs-mode: nil */
+/* c-default-style: "k&r" */
+/* End: */
@@ -8,9 +8,11 @@
 #include "applis/tb2bep.hpp"
 #include "vns/tb2vnsutils.hpp"
 #include "vns/tb2dgvns.hpp"
+#include "search/tb2solver.hpp"
+#include "search/tb2portfolio.hpp"
+#include "vns/tb2pdgvnscomm.hpp"
 #ifdef OPENMPI
-#include "vns/tb2cpdgvns.hpp"
-#include "vns/tb2rpdgvns.hpp"
+#include <mpi.h>
 #endif
 #include <stdio.h>
 #include <stdlib.h>
@@ -104,6 +106,7 @@ enum {
     OPT_verbose = 0,
     OPT_debug,
     OPT_dumpWCSP,
+    OPT_dumpBinary,
     OPT_HELP,
     OPT_stdin,
 
@@ -141,6 +144,7 @@ enum {
     OPT_clusterdec_ext,
 
     OPT_qpbo_mult,
+    OPT_clauseDatabase,
     // search option
     OPT_SEARCH_METHOD,
     OPT_btdRootCluster,
@@ -150,6 +154,7 @@ enum {
     OPT_boostingBTD,
     NO_OPT_boostingBTD,
     OPT_minProperVarSize,
+    OPT_separatorMemoryMB,
     OPT_varOrder,
     OPT_problemsaved_filename,
     OPT_PARTIAL_ASSIGNMENT,
@@ -175,6 +180,8 @@ enum {
     NO_OPT_weightedDegree,
     OPT_weightedTightness,
     NO_OPT_weightedTightness,
+    OPT_weightedDegreeCache,
+    NO_OPT_weightedDegreeCache,
     OPT_nbDecisionVars,
     OPT_elimDegree,
     NO_OPT_elimDegree,
@@ -231,6 +238,13 @@ enum {
     OPT_epsilon,
     OPT_learning,
     OPT_timer,
+    OPT_para,
+    OPT_workstealing,
+    NO_OPT_workstealing,
+    OPT_checkpoint,
+    OPT_checkpointTime,
+    OPT_checkpointBacktracks,
+    OPT_resume,
 #ifndef NDEBUG
     OPT_verifyopt,
 #endif
@@ -250,12 +264,10 @@ enum {
     // VNS Methods
 #ifdef BOOST
     OPT_VNS_search,
-#ifdef OPENMPI
     OPT_CPDGVNS_search,
     OPT_RADGVNS_search,
     OPT_RSDGVNS_search,
     OPT_plimit,
-#endif
     OPT_TREEDEC_search,
     OPT_decfile,
     OPT_vns_output,
@@ -291,6 +303,7 @@ CSimpleOpt::SOption g_rgOptions[] = {
     { OPT_verbose, (char*)"-v", SO_OPT }, // verbose level
     { OPT_debug, (char*)"-Z", SO_OPT }, // debug level
     { OPT_dumpWCSP, (char*)"-z", SO_OPT }, // dump wcsp
+    { OPT_dumpBinary, (char*)"-dumpbin", SO_OPT }, // dump original problem in binary format
     //stdin format
     { OPT_stdin, (char*)"--stdin", SO_REQ_SEP },
 
@@ -326,6 +339,7 @@ CSimpleOpt::SOption g_rgOptions[] = {
     { OPT_clusterdec_ext, (char*)"--clusterdec_ext", SO_REQ_SEP },
 
     { OPT_qpbo_mult, (char*)"-qpmult", SO_REQ_SEP },
+    { OPT_clauseDatabase, (char*)"-wcl", SO_REQ_SEP },
     { OPT_SEARCH_METHOD, (char*)"-B", SO_REQ_SEP }, // -B [0,1,2] search method
     { OPT_SEARCH_METHOD, (char*)"--search", SO_REQ_SEP },
     { OPT_btdRootCluster, (char*)"-R", SO_REQ_SEP }, // root cluster used in BTD
@@ -336,6 +350,7 @@ CSimpleOpt::SOption g_rgOptions[] = {
     { OPT_maxSeparatorSize, (char*)"--maxSepSize", SO_REQ_CMB },
 
     { OPT_minProperVarSize, (char*)"-X", SO_REQ_SEP },
+    { OPT_separatorMemoryMB, (char*)"-sepmem", SO_REQ_SEP }, // memory limit on recorded nogoods per separator
     { OPT_PARTIAL_ASSIGNMENT, (char*)"-x", SO_OPT },
     { NO_OPT_PARTIAL_ASSIGNMENT, (char*)"-x:", SO_NONE },
     { OPT_boostingBTD, (char*)"-E", SO_OPT },
@@ -368,6 +383,8 @@ CSimpleOpt::SOption g_rgOptions[] = {
     { NO_OPT_solutionBasedPhaseSaving, (char*)"-solr:", SO_NONE },
     { OPT_weightedDegree, (char*)"-q", SO_OPT },
     { NO_OPT_weightedDegree, (char*)"-q:", SO_NONE },
+    { OPT_weightedDegreeCache, (char*)"-qc", SO_NONE },
+    { NO_OPT_weightedDegreeCache, (char*)"-qc:", SO_NONE },
     { OPT_weightedTightness, (char*)"-m", SO_OPT },
     { NO_OPT_weightedTightness, (char*)"-m:", SO_NONE },
     { OPT_nbDecisionVars, (char*)"-var", SO_REQ_SEP },
@@ -442,6 +459,13 @@ CSimpleOpt::SOption g_rgOptions[] = {
     { OPT_verifyopt, (char*)"-opt", SO_NONE }, // for debugging purposes, checks the given optimal solution (problem.sol) is not pruned during search
 #endif
     { OPT_timer, (char*)"-timer", SO_REQ_SEP }, // CPU timer
+    { OPT_para, (char*)"-para", SO_REQ_SEP }, // parallel portfolio
+    { OPT_workstealing, (char*)"-ws", SO_NONE }, // parallel HBFS with work stealing
+    { NO_OPT_workstealing, (char*)"-ws:", SO_NONE },
+    { OPT_checkpoint, (char*)"-checkpoint", SO_REQ_SEP }, // periodically saves HBFS search state
+    { OPT_checkpointTime, (char*)"-checkpointtime", SO_REQ_SEP },
+    { OPT_checkpointBacktracks, (char*)"-checkpointbt", SO_REQ_SEP },
+    { OPT_resume, (char*)"-resume", SO_REQ_SEP }, // resumes search from a checkpoint
 
     // random generator
     { OPT_seed, (char*)"-seed", SO_REQ_SEP },
@@ -453,13 +477,11 @@ CSimpleOpt::SOption g_rgOptions[] = {
     { OPT_VNS_search, (char*)"--vns", SO_NONE },
     { OPT_VNS_search, (char*)"-dgvns", SO_NONE },
     { OPT_VNS_search, (char*)"--dgvns", SO_NONE },
-#ifdef OPENMPI
     { OPT_CPDGVNS_search, (char*)"--cpdgvns", SO_NONE },
     { OPT_RADGVNS_search, (char*)"-radgvns", SO_NONE },
     { OPT_RADGVNS_search, (char*)"--radgvns", SO_NONE },
     { OPT_RSDGVNS_search, (char*)"--rsdgvns", SO_NONE },
     { OPT_plimit, (char*)"--plimit", SO_NONE },
-#endif
     { OPT_TREEDEC_search, (char*)"--treedec", SO_NONE },
     { OPT_decfile, (char*)"--decfile", SO_REQ_SEP },
     { OPT_vns_output, (char*)"--foutput", SO_REQ_SEP },
@@ -628,6 +650,7 @@ void help_msg(char* toulbar2filename)
     cout << "   *.wcnf : Weighted Partial Max-SAT format (see Max-SAT Evaluation)" << endl;
     cout << "   *.cnf : (Max-)SAT format" << endl;
     cout << "   *.qpbo : quadratic pseudo-Boolean optimization (unconstrained quadratic programming) format (see also option -qpmult)" << endl;
+    cout << "   *.wbin : toulbar2 binary format, loaded by memory mapping (see option -dumpbin)" << endl;
     cout << "   *.uai : Bayesian network and Markov Random Field format (see UAI'08 Evaluation) followed by an optional evidence filename (performs MPE task, see -logz for PR task, and write its solution in file .MPE or .PR using the same directory as toulbar2)" << endl;
     cout << "   *.LG : Bayesian network and Markov Random Field format using logarithms instead of probabilities" << endl;
 #ifdef XMLFLAG
@@ -664,6 +687,7 @@ void help_msg(char* toulbar2filename)
     cout << "   -w=[filename] : writes last/all solutions in filename (or \"sol\" if no parameter is given)" << endl;
     cout << "   -precision=[integer] defines the number of digits that should be representable on probabilities in uai/pre files (default value is " << ToulBar2::resolution << ")" << endl;
     cout << "   -qpmult=[double] defines coefficient multiplier for quadratic terms (default value is " << ToulBar2::qpboQuadraticCoefMultiplier << ")" << endl;
+    cout << "   -wcl=[integer] stores the clauses of arity [integer] or more (at least 2) of cnf/wcnf files in a single database with two watched literals per clause (unit propagation, node consistency and unary cost extension, no BTD) (default value is " << ToulBar2::clauseDatabase << ", no database)" << endl;
 #else
     cout << "   -w=[mode] : writes last solution found" << endl;
     cout << "               mode=0: saves pedigree with erroneous genotypings removed" << endl;
@@ -685,8 +709,13 @@ void help_msg(char* toulbar2filename)
 #endif
 #ifndef MENDELSOFT
 #ifdef LINUX
-    cout << "   -timer=[integer] : CPU time limit in seconds" << endl;
+    cout << "   -timer=[integer] : CPU time limit in seconds (wall-clock time limit if option -para is used)" << endl;
 #endif
+    cout << "   -para=[integer] : solves the problem using a portfolio of the given number of threads with diverse search parameters sharing their solutions, or with the given number of parallel DGVNS threads if option -vns is used (required by --cpdgvns, --radgvns, and --rsdgvns without MPI) (default value is " << ToulBar2::portfolio << ")" << endl;
+    cout << "   -ws : with option -para, solver threads share the open nodes of hybrid best-first search (work stealing) instead of using diverse search parameters";
+    if (ToulBar2::hbfsWorkStealing)
+        cout << " (default option)";
+    cout << endl;
     cout << "   -seed=[integer] : random seed non-negative value or use current time if a negative value is given (default value is " << ToulBar2::seed << ")" << endl;
     cout << "   --stdin=[format] : read file from pipe ; e.g., cat example.wcsp | toulbar2 --stdin=wcsp" << endl;
     cout << "   -var=[integer] : searches by branching only on the first -the given value- decision variables, assuming the remaining variables are intermediate variables completely assigned by the decision variables (use a zero if all variables are decision variables) (default value is " << ToulBar2::nbDecisionVars << ")" << endl;
@@ -703,6 +732,10 @@ void help_msg(char* toulbar2filename)
         cout << " (default option)";
     cout << endl;
     cout << "   -q=[integer] : weighted degree variable ordering heuristic if the number of cost functions is less than the given value (default value is " << ToulBar2::weightedDegree << ")" << endl;
+    cout << "   -qc : caches the weighted degree of each variable until its cost functions or their conflict weights change (same variable ordering)";
+    if (ToulBar2::weightedDegreeCache)
+        cout << " (default option)";
+    cout << endl;
     cout << "   -m=[integer] : variable ordering heuristic based on mean (m=1) or median (m=2) costs (in conjunction with weighted degree heuristic -q) (default value is " << ToulBar2::weightedTightness << ")" << endl;
     cout << "   -d=[integer] : searches using dichotomic branching (d=1 splitting in the middle of domain range, d=2 splitting in the middle of sorted unary costs) instead of binary branching when current domain size is strictly greater than " << ToulBar2::dichotomicBranchingSize << " (default value is " << ToulBar2::dichotomicBranching << ")" << endl;
     cout << "   -sortd : sorts domains based on increasing unary costs (warning! works only for binary WCSPs)";
@@ -755,6 +788,8 @@ void help_msg(char* toulbar2filename)
     //    cout << "   -cpdgvns : initial upperbound found by cooperative parallel DGVNS (usage: \"mpirun -n [NbOfProcess] toulbar2 -cpdgvns problem.wcsp\")" << endl;
     //    cout << "   -rsdgvns : initial upperbound found by replicated synchronous DGVNS (usage: \"mpirun -n [NbOfProcess] toulbar2 -rsdgvns problem.wcsp\")" << endl;
     cout << " (usage for parallel version: \"mpirun -n [NbOfProcess] toulbar2 -vns problem.wcsp\")";
+#else
+    cout << " (usage for parallel version: \"toulbar2 -vns -para=[NbOfThreads] problem.wcsp\")";
 #endif
     cout << endl;
     cout << "   -vnsini=[integer] : initial solution for VNS-like methods found (-1) at random, (-2) min domain values, (-3) max domain values, (-4) first solution found by a complete method, (k=0 or more) tree search with k discrepancy max (" << ToulBar2::vnsInitSol << " by default)" << endl;
@@ -770,6 +805,7 @@ void help_msg(char* toulbar2filename)
     cout << "   -z=[filename] : saves problem in wcsp format in filename (or \"problem.wcsp\"  if no parameter is given)" << endl;
     cout << "                   writes also the  graphviz dot file  and the degree distribution of the input problem" << endl;
     cout << "   -z=[integer] : 1: saves original instance (by default), 2: saves after preprocessing" << endl;
+    cout << "   -dumpbin=[filename] : saves original instance (as read, before preprocessing) in binary format in filename (or \"problem.wbin\" if no parameter is given) for faster loading" << endl;
     cout << "   -Z=[integer] : debug mode (save problem at each node if verbosity option -v=num >= 1 and -Z=num >=3)" << endl;
 #ifndef NDEBUG
     cout << "   -opt filename.sol : checks a given optimal solution (given as input filename with \".sol\" extension) is never pruned by propagation (works only if compiled with debug)" << endl;
@@ -777,7 +813,7 @@ void help_msg(char* toulbar2filename)
     cout << "   -x=[(,i=a)*] : assigns variable of index i to value a (multiple assignments are separated by a comma and no space) (without any argument, a complete assignment -- used as initial upper bound and as value heuristic -- read from default file \"sol\" taken as a certificate or given as input filename with \".sol\" extension)" << endl
          << endl;
     cout << "   -M=[integer] : preprocessing only: Min Sum Diffusion algorithm (default number of iterations is " << ToulBar2::minsumDiffusion << ")" << endl;
-    cout << "   -A=[integer] : enforces VAC at each search node with a search depth less than a given value (default value is " << ToulBar2::vac << ")" << endl;
+    cout << "   -A=[integer] : enforces VAC at each search node with a search depth less than a given value (-1: at every search node) (default value is " << ToulBar2::vac << ")" << endl;
     cout << "   -T=[decimal] : threshold cost value for VAC (default value is " << ToulBar2::costThreshold << ")" << endl;
     cout << "   -P=[decimal] : threshold cost value for VAC during the preprocessing phase (default value is " << ToulBar2::costThresholdPre << ")" << endl;
     cout << "   -C=[float] : multiplies all costs internally by this number when loading the problem (default value is " << ToulBar2::costMultiplier << ")" << endl;
@@ -814,6 +850,7 @@ void help_msg(char* toulbar2filename)
     cout << "   -X=[integer] : limit on minimum number of proper variables in a cluster (merge cluster with its father otherwise, use a zero for no limit) (default value is " << ToulBar2::minProperVarSize << ")" << endl;
     cout << "   -E=[float] : merges leaf clusters with their fathers if small local treewidth (in conjunction with option \"-e\" and positive threshold value) or ratio of number of separator variables by number of cluster variables above a given threshold (in conjunction with option \"-vns\") (default value is " << ToulBar2::boostingBTD << ")" << endl;
     cout << "   -R=[integer] : choice for a specific root cluster number" << endl;
+    cout << "   -sepmem=[float] : memory limit in MB for the nogoods (with their open node lists) and #goods recorded on each separator, removing nogoods without optimality proof and with the smallest lower bounds first, and the least recently used #goods first (0: no limit) (default value is " << ToulBar2::separatorMemoryMB << ")" << endl;
     cout << "   -I=[integer] : choice for solving only a particular rooted cluster subtree (with RDS-BTD only)" << endl
          << endl;
     cout << "   -a=[integer] : finds at most a given number of solutions with a cost strictly lower than the initial upper bound and stops, or if no integer is given, finds all solutions (or counts the number of zero-cost satisfiable solutions in conjunction with BTD)";
@@ -829,6 +866,10 @@ void help_msg(char* toulbar2filename)
     cout << endl;
     cout << "   -hbfs=[integer] : hybrid best-first search, restarting from the root after a given number of backtracks (default value is " << hbfsgloballimit << ")" << endl;
     cout << "   -open=[integer] : hybrid best-first search limit on the number of open nodes (default value is " << ToulBar2::hbfsOpenNodeLimit << ")" << endl;
+    cout << "   -checkpoint=[filename] : periodically saves the current solution, hybrid best-first search open nodes, and weighted degrees in a binary file (sequential HBFS without tree decomposition only)" << endl;
+    cout << "   -checkpointtime=[integer] : minimum CPU time in seconds between two checkpoints (default value is " << ToulBar2::checkpointPeriod << ")" << endl;
+    cout << "   -checkpointbt=[integer] : minimum number of backtracks between two checkpoints instead of CPU time if positive (default value is " << ToulBar2::checkpointBacktracks << ")" << endl;
+    cout << "   -resume=[filename] : resumes search from a checkpoint file saved with the same problem and options" << endl;
     cout << "---------------------------" << endl;
     cout << "Alternatively one can call the random problem generator with the following options: " << endl;
     cout << endl;
@@ -927,6 +968,7 @@ int _tmain(int argc, TCHAR* argv[])
     file_extension_map["qpbo_ext"] = ".qpbo";
     file_extension_map["qpbogz_ext"] = ".qpbo.gz";
     file_extension_map["qpboxz_ext"] = ".qpbo.xz";
+    file_extension_map["wbin_ext"] = ".wbin";
     file_extension_map["treedec_ext"] = ".cov";
     file_extension_map["clusterdec_ext"] = ".dec";
 
@@ -993,7 +1035,6 @@ int _tmain(int argc, TCHAR* argv[])
                 ToulBar2::vnsNeighborVarHeur = CLUSTERRAND;
 #endif
             }
-#ifdef OPENMPI
             if (args.OptionId() == OPT_CPDGVNS_search) {
                 ToulBar2::searchMethod = CPDGVNS;
                 ToulBar2::vnsParallel = true;
@@ -1011,7 +1052,6 @@ int _tmain(int argc, TCHAR* argv[])
                 ToulBar2::vnsNeighborVarHeur = MASTERCLUSTERRAND;
                 ToulBar2::vnsParallelSync = true;
             }
-#endif
             if (args.OptionId() == OPT_TREEDEC_search) {
                 ToulBar2::searchMethod = TREEDEC;
             }
@@ -1108,11 +1148,9 @@ int _tmain(int argc, TCHAR* argv[])
             if (args.OptionId() == OPT_neighbor_synch) {
                 ToulBar2::vnsNeighborSizeSync = true;
             }
-#ifdef OPENMPI
             if (args.OptionId() == OPT_plimit) {
                 ToulBar2::vnsParallelLimit = true;
             }
-#endif
             if (args.OptionId() == OPT_optimum) {
                 if (args.OptionArg() != NULL)
                     //                    ToulBar2::vnsOptimum = atoll(args.OptionArg());
@@ -1182,6 +1220,12 @@ int _tmain(int argc, TCHAR* argv[])
                 if (minpvarsize >= 0)
                     ToulBar2::minProperVarSize = minpvarsize;
             }
+            // memory limit on nogoods recorded by BTD-like methods
+            if (args.OptionId() == OPT_separatorMemoryMB) {
+                double sepmem = atof(args.OptionArg());
+                if (sepmem >= 0)
+                    ToulBar2::separatorMemoryMB = sepmem;
+            }
             // -help print command line HELP
             if (args.OptionId() == OPT_HELP) {
                 //	ShowUsage();
@@ -1345,6 +1389,12 @@ int _tmain(int argc, TCHAR* argv[])
                 ToulBar2::weightedTightness = 0;
             }
 
+            if (args.OptionId() == OPT_weightedDegreeCache) {
+                ToulBar2::weightedDegreeCache = true;
+            } else if (args.OptionId() == NO_OPT_weightedDegreeCache) {
+                ToulBar2::weightedDegreeCache = false;
+            }
+
             // weitghted Degree (var ordering )
             if (args.OptionId() == OPT_weightedDegree and args.OptionArg() != NULL) {
                 int weighteddegree = atol(args.OptionArg());
@@ -1422,6 +1472,8 @@ int _tmain(int argc, TCHAR* argv[])
                     int depth = atoi(args.OptionArg());
                     if (depth >= 1)
                         ToulBar2::vac = depth;
+                    else if (depth < 0)
+                        ToulBar2::vac = INT_MAX; // at every search node
                 }
                 if (ToulBar2::debug)
                     cout << "VAC propagation ON" << endl;
@@ -1457,6 +1509,12 @@ int _tmain(int argc, TCHAR* argv[])
                     ToulBar2::qpboQuadraticCoefMultiplier = co;
             }
 
+            if (args.OptionId() == OPT_clauseDatabase) {
+                int arity = atoi(args.OptionArg());
+                if (arity >= 0)
+                    ToulBar2::clauseDatabase = (arity == 1) ? 2 : arity;
+            }
+
             if (args.OptionId() == OPT_singletonConsistency)
                 ToulBar2::singletonConsistency = true;
             if (args.OptionId() == OPT_vacValueHeuristic)
@@ -1767,6 +1825,11 @@ int _tmain(int argc, TCHAR* argv[])
                         cout << "dump after preprocessing in problem.wcsp (see also Graphviz and degree distribution)" << endl;
                 }
             }
+            if (args.OptionId() == OPT_dumpBinary) {
+                ToulBar2::binaryDumpFile = (args.OptionArg() != NULL) ? args.OptionArg() : "problem.wbin";
+                if (ToulBar2::debug)
+                    cout << "original problem dump in binary format in " << ToulBar2::binaryDumpFile << endl;
+            }
             //   Z: debug mode (save problem at each node if verbosity option set!)
             //		for (int j=0; argv[i][j] != 0; j++) if (argv[i][j]=='Z') ToulBar2::debug++;
 
@@ -1820,6 +1883,44 @@ int _tmain(int argc, TCHAR* argv[])
                 }
             }
 
+            if (args.OptionId() == OPT_para) {
+                int nbthreads = atoi(args.OptionArg());
+                if (nbthreads >= 1)
+                    ToulBar2::portfolio = nbthreads;
+                if (ToulBar2::debug)
+                    cout << "Portfolio threads = " << ToulBar2::portfolio << endl;
+            }
+            if (args.OptionId() == OPT_workstealing) {
+                ToulBar2::hbfsWorkStealing = true;
+            } else if (args.OptionId() == NO_OPT_workstealing) {
+                ToulBar2::hbfsWorkStealing = false;
+            }
+
+            // checkpoints
+            if (args.OptionId() == OPT_checkpoint) {
+                ToulBar2::checkpointFile = args.OptionArg();
+                if (ToulBar2::debug)
+                    cout << "Checkpoint file = " << ToulBar2::checkpointFile << endl;
+            }
+            if (args.OptionId() == OPT_checkpointTime) {
+                double period = atof(args.OptionArg());
+                if (period >= 0)
+                    ToulBar2::checkpointPeriod = period;
+            }
+            if (args.OptionId() == OPT_checkpointBacktracks) {
+                Long backtracks = atoll(args.OptionArg());
+                if (backtracks >= 0)
+                    ToulBar2::checkpointBacktracks = backtracks;
+            }
+            if (args.OptionId() == OPT_resume) {
+                ToulBar2::resumeFile = args.OptionArg();
+                ifstream resumefile(ToulBar2::resumeFile.c_str());
+                if (!resumefile) {
+                    cerr << "File " << ToulBar2::resumeFile << " not found!" << endl;
+                    exit(EXIT_FAILURE);
+                }
+            }
+
             //////////RANDOM GENERATOR///////
             if (args.OptionId() == OPT_seed) {
                 int seed = atoi(args.OptionArg());
@@ -2091,6 +2192,15 @@ int _tmain(int argc, TCHAR* argv[])
                 ToulBar2::xz = true;
             }
 
+            // binary file
+            if (check_file_ext(problem, file_extension_map["wbin_ext"])) {
+                if (ToulBar2::verbose >= 0)
+                    cout << "loading binary file: " << problem << endl;
+                ToulBar2::binaryFormat = true;
+                strext = ".wbin";
+                strfile = problem;
+            }
+
             // upperbound file
 
             if (check_file_ext(problem, file_extension_map["ub_ext"])) {
@@ -2268,6 +2378,24 @@ int _tmain(int argc, TCHAR* argv[])
 
     //TODO: If --show_options then dump ToulBar2 object here
 
+#ifndef OPENMPI
+    // parallel DGVNS using threads instead of MPI processes
+    if (ToulBar2::searchMethod == DGVNS && ToulBar2::portfolio > 1) {
+        ToulBar2::searchMethod = RPDGVNS;
+        ToulBar2::vnsParallel = true;
+        ToulBar2::vnsNeighborVarHeur = MASTERCLUSTERRAND;
+        ToulBar2::vnsParallelSync = false;
+    }
+    if (ToulBar2::vnsParallel && ToulBar2::portfolio <= 1) {
+        cerr << "Error: parallel DGVNS without MPI needs the number of threads (add -para=[integer] option with at least 2 threads)." << endl;
+        exit(1);
+    }
+    if (ToulBar2::vnsParallel && (ToulBar2::dumpWCSP == 1 || ToulBar2::binaryDumpFile.size() > 0 || (certificate && certificateString == NULL && ToulBar2::btdMode < 2))) {
+        cerr << "Error: parallel DGVNS does not search when dumping the problem or checking a solution (remove -para option)." << endl;
+        exit(1);
+    }
+#endif
+
     ToulBar2::startCpuTime = cpuTime();
 
     initCosts();
@@ -2347,6 +2475,35 @@ int _tmain(int argc, TCHAR* argv[])
     }
 
     tb2checkOptions();
+    Portfolio* portfolio = NULL;
+#ifndef OPENMPI
+    ParallelDGVNSThreads* pdgvnsThreads = NULL;
+#endif
+    if (ToulBar2::portfolio > 1 && ToulBar2::dumpWCSP != 1 && ToulBar2::binaryDumpFile.size() == 0 && (!certificate || certificateString != NULL || ToulBar2::btdMode >= 2)) {
+        int seed = ToulBar2::seed;
+        Portfolio::Loader loader = [=](WeightedCSPSolver* helper) {
+            if (randomproblem) {
+                vector<int> q(p);
+                helper->read_random(n, m, q, seed, forceSubModular, randomglobal);
+            } else
+                helper->read_wcsp((char*)strfile.c_str());
+            if (certificate) {
+                if (certificateFilename != NULL)
+                    helper->read_solution(certificateFilename, updateValueHeuristic);
+                else
+                    helper->parse_solution(certificateString);
+            }
+        };
+#ifndef OPENMPI
+        if (ToulBar2::vnsParallel) {
+            pdgvnsThreads = new ParallelDGVNSThreads(ToulBar2::portfolio, loader);
+        } else
+#endif
+        {
+            portfolio = new Portfolio(ToulBar2::portfolio, loader);
+            ((Solver*)solver)->setPortfolio(portfolio);
+        }
+    }
     try {
         if (randomproblem)
             solver->read_random(n, m, p, ToulBar2::seed, forceSubModular, randomglobal);
@@ -2356,6 +2513,8 @@ int _tmain(int argc, TCHAR* argv[])
             cerr << "Error: wrong initial primal bound (negative or zero)." << endl;
             exit(1);
         }
+        if (ToulBar2::verbose >= 1)
+            cout << "Reading time: " << cpuTime() - ToulBar2::startCpuTime << " seconds." << endl;
 
         //TODO: If --show_options then dump ToulBar2 object here
 
@@ -2365,7 +2524,14 @@ int _tmain(int argc, TCHAR* argv[])
             else
                 solver->parse_solution(certificateString);
         }
-        if (ToulBar2::dumpWCSP == 1) {
+        if (ToulBar2::binaryDumpFile.size() > 0) {
+            ofstream pb(ToulBar2::binaryDumpFile.c_str(), ios::binary);
+            if (!pb) {
+                cerr << "Could not open file " << ToulBar2::binaryDumpFile << endl;
+                exit(EXIT_FAILURE);
+            }
+            solver->getWCSP()->dumpBinary(pb);
+        } else if (ToulBar2::dumpWCSP == 1) {
             string problemname = ToulBar2::problemsaved_filename;
             if (ToulBar2::uaieval) {
                 problemname = ToulBar2::solution_uai_filename;
@@ -2399,6 +2565,10 @@ int _tmain(int argc, TCHAR* argv[])
             cout << "s UNSATISFIABLE" << endl;
         }
     }
+    delete portfolio;
+#ifndef OPENMPI
+    delete pdgvnsThreads;
+#endif
     if (ToulBar2::verbose >= 0)
         cout << "end." << endl;
 
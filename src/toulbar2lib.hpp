@@ -364,6 +364,7 @@ public:
     virtual void read_uai2008(const char* fileName) = 0; ///< \brief load problem in UAI 2008 format (see http://graphmod.ics.uci.edu/uai08/FileFormat and http://www.cs.huji.ac.il/project/UAI10/fileFormat.php) \warning UAI10 evidence file format not recognized by toulbar2 as it does not allow multiple evidence (you should remove the first value in the file)
     virtual void read_random(int n, int m, vector<int>& p, int seed, bool forceSubModular = false, string globalname = "") = 0; ///< \brief create a random WCSP with \e n variables, domain size \e m, array \e p where the first element is a percentage of tuples with a nonzero cost and next elements are the number of random cost functions for each different arity (starting with arity two), random seed, a flag to have a percentage (last element in the array \e p) of the binary cost functions being permutated submodular, and a string to use a specific global cost function instead of random cost functions in extension
     virtual void read_wcnf(const char* fileName) = 0; ///< \brief load problem in (w)cnf format (see http://www.maxsat.udl.cat/08/index.php?disp=requirements)
+    virtual void read_binary(const char* fileName) = 0; ///< \brief load problem in binary format (see tb2binformat.hpp and WCSP::dumpBinary) using a memory-mapped file
     virtual void read_qpbo(const char* fileName) = 0; ///< \brief load quadratic pseudo-Boolean optimization problem in unconstrained quadratic programming text format (first text line with n, number of variables and m, number of triplets, followed by the m triplets (x,y,cost) describing the sparse symmetric nXn cost matrix with variable indexes such that x <= y and any positive or negative real numbers for costs)
 
     virtual const Cost getSolutionCost() = 0; ///< \brief returns current best solution cost or MAX_COST if no solution found
@@ -374,6 +375,7 @@ public:
 
     virtual void print(ostream& os) = 0; ///< \brief print current domains and active cost functions (see \ref verbosity)
     virtual void dump(ostream& os, bool original = true) = 0; ///< \brief output the current WCSP into a file in wcsp format \param os output file \param original if true then keeps all variables with their original domain size else uses unassigned variables and current domains recoding variable indexes
+    virtual void dumpBinary(ostream& os) = 0; ///< \brief output the current WCSP with original domains into a file in binary format (see tb2binformat.hpp) \param os output file opened in binary mode
 
     // -----------------------------------------------------------
     // Functions dealing with all representations of Costs
@@ -532,6 +534,11 @@ public:
 extern void tb2init();
 /// \brief checks compatibility between selected options of ToulBar2 (needed by numberjack/toulbar2)
 extern void tb2checkOptions();
+/// \brief collects the addresses of ToulBar2 global variables of the calling thread
+/// \warning the calling thread must not modify nor exit before the other threads have called ::tb2setOptions
+extern void tb2getOptions(vector<const void*>& options);
+/// \brief copies ToulBar2 global variables of another thread (collected by ::tb2getOptions) into the calling thread
+extern void tb2setOptions(const vector<const void*>& options);
 #endif /*TOULBAR2LIB_HPP_*/
 
 /* Local Variables: */
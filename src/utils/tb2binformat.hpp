@@ -0,0 +1,158 @@
+/** \file tb2binformat.hpp
+ *  \brief Binary problem format for fast loading of large instances (see WCSP::dumpBinary and WCSP::read_binary).
+ *
+ * Convention:
+ *
+ * the file starts with a BinaryProblemHeader followed by the variables and the cost functions
+ * numbers are written in native byte order, every array starts at a multiple of 8 bytes
+ * so that cost tables are used in place when the file is memory-mapped
+ *
+ * costs are stored as internal costs (already multiplied by ToulBar2::costMultiplier)
+ *
+ * variable: kind (::BIN_ENUMERATED or ::BIN_INTERVAL), name, and
+ *  - enumerated: domain size, domain values, value names, and unary costs
+ *  - interval: lower and upper bounds
+ *
+ * cost function: kind (::BIN_DENSE, ::BIN_SPARSE, or ::BIN_TEXT), and
+ *  - dense: arity, scope, and costs of all the tuples of initial domains in lexicographic order
+ *  - sparse: arity, scope, default cost, number of tuples, tuples (arrays of value indexes), and their costs
+ *  - text: cost function in wcsp format (monolithic global cost functions and weighted clauses)
+ *
+ */
+
+#ifndef TB2BINFORMAT_HPP_
+#define TB2BINFORMAT_HPP_
+
+#include "core/tb2types.hpp"
+
+const char BinaryProblemMagic[8] = "tb2bin";
+const unsigned int BinaryProblemVersion = 1;
+
+enum BinaryVariableKind {
+    BIN_ENUMERATED = 0,
+    BIN_INTERVAL = 1
+};
+
+enum BinaryCostFunctionKind {
+    BIN_DENSE = 0,
+    BIN_SPARSE = 1,
+    BIN_TEXT = 2
+};
+
+struct BinaryProblemHeader {
+    char magic[8];
+    unsigned int version;
+    unsigned int costSize; // sizeof(Cost) of the toulbar2 executable which wrote the file
+    unsigned int nbvars;
+    unsigned int nbctrs;
+    unsigned int decimalPoint;
+    Cost ub;
+    Cost lb; // zero-arity cost function
+    Cost negCost; // negative cost shifting
+    double costMultiplier;
+};
+
+class BinaryProblemWriter {
+    ostream& os;
+    size_t pos; // number of bytes written
+
+public:
+    BinaryProblemWriter(ostream& os_)
+        : os(os_)
+        , pos(0)
+    {
+    }
+
+    void align()
+    {
+        static const char padding[8] = { 0 };
+        if (pos % 8 != 0) {
+            os.write(padding, 8 - pos % 8);
+            pos += 8 - pos % 8;
+        }
+    }
+
+    template <class T>
+    void write(const T& x)
+    {
+        os.write((const char*)&x, sizeof(T));
+        pos += sizeof(T);
+    }
+
+    template <class T>
+    void writeArray(const T* a, size_t n)
+    {
+        align();
+        os.write((const char*)a, n * sizeof(T));
+        pos += n * sizeof(T);
+        align();
+    }
+
+    void writeString(const string& s)
+    {
+        write((unsigned int)s.size());
+        writeArray(s.data(), s.size());
+    }
+};
+
+class BinaryProblemReader {
+    const char* data;
+    size_t size;
+    size_t pos; // number of bytes read
+
+    void check(size_t n)
+    {
+        if (pos + n > size) {
+            cerr << "Error: truncated binary problem file." << endl;
+            exit(EXIT_FAILURE);
+        }
+    }
+
+public:
+    BinaryProblemReader(const char* data_, size_t size_)
+        : data(data_)
+        , size(size_)
+        , pos(0)
+    {
+    }
+
+    void align() { pos = (pos + 7) & ~((size_t)7); }
+
+    template <class T>
+    T read()
+    {
+        check(sizeof(T));
+        T x;
+        memcpy(&x, data + pos, sizeof(T));
+        pos += sizeof(T);
+        return x;
+    }
+
+    /// \warning returns a pointer inside the file contents (no copy)
+    template <class T>
+    const T* readArray(size_t n)
+    {
+        align();
+        check(n * sizeof(T));
+        const T* a = (const T*)(data + pos);
+        pos += n * sizeof(T);
+        align();
+        return a;
+    }
+
+    string readString()
+    {
+        unsigned int n = read<unsigned int>();
+        const char* s = readArray<char>(n);
+        return string(s, n);
+    }
+};
+
+#endif /*TB2BINFORMAT_HPP_*/
+
+/* Local Variables: */
+/* c-basic-offset: 4 */
+/* tab-width: 4 */
+/* indent-tabs-mode: nil */
+/* c-default-style: "k&r" */
+/* End: */
@@ -238,14 +238,15 @@ typedef BTList<Separator*> SeparatorList;
  */
 
 template <class T, class V>
-template <class Q>
-void StoreStack<T, V>::restore(BTList<Q>** l, DLink<Q>** elt, ptrdiff_t& x)
+void StoreStack<T, V>::restoreList(ptrdiff_t& x)
 {
-    if (elt[x] == NULL) {
-        l[x]->undoPushBack();
+    Entry& e = at(x);
+    if (e.content == NULL) {
+        e.pointer->undoPushBack();
     } else {
-        assert(l[x] == l[x - 1]);
-        l[x]->undoErase(elt[x], elt[x - 1]);
+        Entry& prev = at(x - 1);
+        assert(e.pointer == prev.pointer);
+        e.pointer->undoErase(e.content, prev.content);
         x--;
     }
 }
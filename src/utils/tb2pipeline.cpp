@@ -0,0 +1,102 @@
+/*
+ * ****** Input stream buffer filled by a separate thread *******
+ */
+
+#include "tb2pipeline.hpp"
+
+PipelineStreamBuffer::PipelineStreamBuffer(streambuf* source_, bool threaded_)
+    : source(source_)
+    , threaded(threaded_)
+    , nbFull(0)
+    , produced(0)
+    , consumed(0)
+    , reading(false)
+    , stop(false)
+{
+    if (threaded) {
+        chunks.resize(PIPELINE_CHUNKS, vector<char>(READ_BUFFER_SIZE + 1));
+        sizes.resize(PIPELINE_CHUNKS, 0);
+        producer = std::thread(&PipelineStreamBuffer::produce, this);
+    }
+}
+
+PipelineStreamBuffer::~PipelineStreamBuffer()
+{
+    if (threaded) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        changed.notify_all();
+        producer.join();
+    }
+}
+
+void PipelineStreamBuffer::produce()
+{
+    streamsize n;
+    do {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [this] { return stop || nbFull < PIPELINE_CHUNKS; });
+            if (stop)
+                return;
+        }
+        // the chunk is not visible to the consumer until it is counted as full
+        try {
+            n = source->sgetn(chunks[produced].data() + 1, READ_BUFFER_SIZE);
+        } catch (...) {
+            error = std::current_exception();
+            n = 0;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            sizes[produced] = n;
+            produced = (produced + 1) % PIPELINE_CHUNKS;
+            nbFull++;
+        }
+        changed.notify_all();
+    } while (n > 0);
+}
+
+PipelineStreamBuffer::int_type PipelineStreamBuffer::underflow()
+{
+    if (gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+    std::unique_lock<std::mutex> lock(mutex);
+    char last = 0;
+    if (reading) {
+        if (sizes[consumed] == 0)
+            return traits_type::eof(); // end of the source already reached
+        last = *(egptr() - 1);
+        reading = false;
+        consumed = (consumed + 1) % PIPELINE_CHUNKS;
+        nbFull--;
+        changed.notify_all();
+    }
+    changed.wait(lock, [this] { return nbFull > 0; });
+    reading = true;
+    if (sizes[consumed] == 0) {
+        if (error) {
+            try {
+                std::rethrow_exception(error);
+            } catch (const std::exception& e) {
+                cerr << "Error: cannot read compressed file (" << e.what() << ")." << endl;
+            }
+            exit(EXIT_FAILURE);
+        }
+        setg(NULL, NULL, NULL);
+        return traits_type::eof();
+    }
+    char* chunk = chunks[consumed].data();
+    chunk[0] = last;
+    setg(chunk, chunk + 1, chunk + 1 + sizes[consumed]);
+    return traits_type::to_int_type(*gptr());
+}
+
+/* Local Variables: */
+/* c-basic-offset: 4 */
+/* tab-width: 4 */
+/* indent-tabs-mode: nil */
+/* c-default-style: "k&r" */
+/* End: */
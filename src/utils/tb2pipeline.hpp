@@ -0,0 +1,59 @@
+/** \file tb2pipeline.hpp
+ *  \brief Input stream buffer filled by a separate thread (decompression of gzip'd or xz compressed problem files).
+ *
+ *  A producer thread reads the source stream buffer (typically a boost filtering stream buffer with a decompressor)
+ *  into a bounded ring of chunks while the calling thread parses the previous chunks.
+ *
+ *  \note the producer thread only calls the source stream buffer: it does not access ToulBar2 global variables
+ *  \note an exception thrown by the source (e.g., corrupted compressed data) is reported as an error by the reading thread
+ */
+
+#ifndef TB2PIPELINE_HPP_
+#define TB2PIPELINE_HPP_
+
+#include "tb2tokenizer.hpp"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+const int PIPELINE_CHUNKS = 4; ///< \brief number of chunks in the ring (the consumer owns one chunk, the producer fills the others in advance)
+
+class PipelineStreamBuffer : public std::streambuf {
+    streambuf* source;
+    bool threaded;
+    vector<vector<char>> chunks; // the first character of each chunk is kept for putback of the last character of the previous chunk
+    vector<streamsize> sizes; // number of characters read in each full chunk (zero at the end of the source)
+    int nbFull; // number of full chunks including the chunk being read by the consumer
+    int produced; // next chunk to be filled
+    int consumed; // chunk being read by the consumer (or next chunk to be read if none)
+    bool reading; // true if the consumer owns a chunk
+    bool stop; // true if the producer must stop
+    std::exception_ptr error; // exception thrown by the source
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::thread producer;
+
+    void produce();
+
+protected:
+    int_type underflow();
+
+public:
+    /// \param source stream buffer to be read
+    /// \param threaded_ if false then the source is read directly by the calling thread (see PipelineStreamBuffer::input)
+    PipelineStreamBuffer(streambuf* source, bool threaded_ = true);
+    ~PipelineStreamBuffer();
+
+    streambuf* input() { return (threaded) ? this : source; } ///< \brief stream buffer to be used by the readers
+};
+
+#endif /*TB2PIPELINE_HPP_*/
+
+/* Local Variables: */
+/* c-basic-offset: 4 */
+/* tab-width: 4 */
+/* indent-tabs-mode: nil */
+/* c-default-style: "k&r" */
+/* End: */
@@ -26,6 +26,13 @@ void Queue::remove(DLink<VariableWithTimeStamp>* elt)
     erase(elt, false);
 }
 
+void Queue::peek(vector<Variable*>& vars, int n)
+{
+    vars.clear();
+    for (iterator iter = rbegin(); iter != end() && (int)vars.size() < n; --iter)
+        vars.push_back((*iter).var);
+}
+
 Variable* Queue::pop()
 {
     assert(!empty());
@@ -39,6 +39,8 @@ public:
 
     void remove(DLink<VariableWithTimeStamp>* elt);
 
+    void peek(vector<Variable*>& vars, int n); ///< \brief returns the next variables (at most \a n) in popping order
+
     Variable* pop();
     Variable* pop(int* incdec);
     Variable* pop_min();
@@ -12,11 +12,14 @@
 #include "tb2randomgen.hpp"
 #include "core/tb2globaldecomposable.hpp"
 #include "core/tb2clqcover.hpp"
+#include "core/tb2clausedb.hpp"
+#include "tb2binformat.hpp"
+#include "tb2tokenizer.hpp"
+#include "tb2pipeline.hpp"
 
 #ifdef BOOST
 #define BOOST_IOSTREAMS_NO_LIB
 #include <boost/version.hpp>
-#include <boost/tokenizer.hpp>
 #include <boost/iostreams/filtering_streambuf.hpp>
 #include <boost/iostreams/copy.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
@@ -29,6 +32,13 @@
 #include <boost/compressed_pair.hpp>
 #endif
 
+#ifdef LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 typedef struct {
     EnumeratedVariable* var;
     vector<Cost> costs;
@@ -295,6 +305,7 @@ public:
     ~CFNStreamReader();
 
     std::pair<int, string> getNextToken();
+    int getNextToken(string& token); // reuses the token memory and returns its line number
     void skipOBrace(); // checks if next token is an opening brace and spits an error otherwise.
     void skipCBrace(); // checks if next token is a  closing brace and spits an error otherwise.
     void testJSONTag(const std::pair<int, string>& token, const string& tag);
@@ -324,31 +335,24 @@ public:
     std::vector<Cost> readFunctionCostTable(vector<int> scope, bool all, Cost defaultCost, Cost& minCost);
     void enforceUB(Cost ub);
 
-    std::map<std::string, int> varNameToIdx;
-    std::vector<std::map<std::string, int>> varValNameToIdx;
+    std::unordered_map<std::string, int> varNameToIdx;
+    std::vector<std::unordered_map<std::string, int>> varValNameToIdx;
     std::map<std::string, std::vector<pair<string, std::vector<int>>>> tableShares;
     vector<TemporaryUnaryConstraint> unaryCFs;
 
 private:
     istream& iStream;
     WCSP* wcsp;
-    bool getNextLine();
-    unsigned int lineCount;
-    string currentLine;
-    boost::char_separator<char> sep;
-    boost::tokenizer<boost::char_separator<char>>* tok;
-    boost::tokenizer<boost::char_separator<char>>::iterator tok_iter;
+    StreamTokenizer tokenizer;
     bool JSONMode;
 };
 
 CFNStreamReader::CFNStreamReader(istream& stream, WCSP* wcsp)
     : iStream(stream)
     , wcsp(wcsp)
+    , tokenizer(stream, " \n\f\r\t\":,", "{}[]", true)
 {
-    this->lineCount = 0;
     this->JSONMode = false;
-    this->tok = nullptr;
-    this->sep = boost::char_separator<char>(" \n\f\r\t\":,", "{}[]");
     Cost upperBound = readHeader();
     if (ToulBar2::costThresholdS.size())
         ToulBar2::costThreshold = wcsp->decimalToCost(ToulBar2::costThresholdS, 0);
@@ -409,52 +413,17 @@ CFNStreamReader::CFNStreamReader(istream& stream, WCSP* wcsp)
         cout << "Read " << nvar << " variables, with " << nval << " values at most, and " << ncf << " cost functions, with maximum arity " << maxarity << "." << endl;
 }
 
-// Reads a line. Skips comment lines starting with '#' and // too.
-bool CFNStreamReader::getNextLine()
+// Reads a token, skipping comment lines starting with '#' and comments after //
+std::pair<int, string> CFNStreamReader::getNextToken()
 {
-    string line;
-    lineCount++;
-    std::getline(iStream, line);
-
-    while (line == "" || line.at(0) == '#') {
-        if (std::getline(iStream, line))
-            lineCount++;
-        else
-            return false;
-    }
-    size_t posJSONcomments = line.find("//");
-    if (posJSONcomments == string::npos) {
-        this->currentLine = line;
-        return true;
-    } else if (posJSONcomments != 0) {
-        this->currentLine = line.substr(0, posJSONcomments);
-        return true;
-    } else
-        return getNextLine(); // tail recurse
+    string token;
+    int lineNumber = tokenizer.next(token);
+    return make_pair(lineNumber, token);
 }
 
-// Reads a token using lazily updated line by line reads
-std::pair<int, string> CFNStreamReader::getNextToken()
+int CFNStreamReader::getNextToken(string& token)
 {
-    if (tok != nullptr) {
-        if (tok_iter != tok->end()) {
-            string token = *tok_iter;
-            tok_iter = std::next(tok_iter);
-            return make_pair(lineCount, token);
-        } else {
-            delete tok;
-            tok = nullptr;
-            return getNextToken();
-        }
-    } else {
-        if (this->getNextLine()) {
-            tok = new boost::tokenizer<boost::char_separator<char>>(currentLine, sep);
-            tok_iter = tok->begin();
-            return getNextToken();
-        } else {
-            return make_pair(-1, "");
-        }
-    }
+    return tokenizer.next(token);
 }
 
 CFNStreamReader::~CFNStreamReader()
@@ -473,7 +442,7 @@ void CFNStreamReader::skipOBrace()
     int l;
     string token;
 
-    std::tie(l, token) = this->getNextToken();
+    l = this->getNextToken(token);
     if (!isOBrace(token)) {
         cerr << "Error: expected a '{' or '[' instead of '" << token << "' at line " << l << endl;
         exit(EXIT_FAILURE);
@@ -486,7 +455,7 @@ void CFNStreamReader::skipCBrace()
     int l;
     string token;
 
-    std::tie(l, token) = this->getNextToken();
+    l = this->getNextToken(token);
     if (!isCBrace(token)) {
         cerr << "Error: expected a '} or ']' instead of '" << token << "' at line " << l << endl;
         exit(EXIT_FAILURE);
@@ -517,10 +486,10 @@ void CFNStreamReader::testAndSkipFirstOBrace()
     int l;
     string token;
 
-    std::tie(l, token) = this->getNextToken();
+    l = this->getNextToken(token);
     if (token == "problem") {
         JSONMode = true;
-        std::tie(l, token) = this->getNextToken();
+        l = this->getNextToken(token);
     }
 
     if (!isOBrace(token)) {
@@ -547,7 +516,7 @@ Cost CFNStreamReader::readHeader()
     skipOBrace();
     testAndSkipFirstOBrace(); // check if we are in JSON mode
     skipJSONTag("name");
-    std::tie(lineNumber, token) = this->getNextToken();
+    lineNumber = this->getNextToken(token);
 
     // TODO pas de méthode WCSP pour écrire le nom du problème
     if (ToulBar2::verbose >= 1)
@@ -556,7 +525,7 @@ Cost CFNStreamReader::readHeader()
     skipJSONTag("mustbe");
     Cost pbBound;
 
-    std::tie(lineNumber, token) = this->getNextToken();
+    lineNumber = this->getNextToken(token);
     if ((token[0] == '<') || token[0] == '>') {
 
         auto pos = token.find('.');
@@ -627,7 +596,7 @@ unsigned CFNStreamReader::readVariable(unsigned i)
 
     string token;
     int lineNumber;
-    std::tie(lineNumber, token) = this->getNextToken();
+    lineNumber = this->getNextToken(token);
 
     if (isCBrace(token)) { // End of variable list
         return 0;
@@ -639,7 +608,7 @@ unsigned CFNStreamReader::readVariable(unsigned i)
         varName = to_string(i);
     } else {
         varName = token;
-        std::tie(lineNumber, token) = this->getNextToken();
+        lineNumber = this->getNextToken(token);
     }
     // This is a list of symbols, read it
     if (isOBrace(token)) {
@@ -686,7 +655,7 @@ int CFNStreamReader::readDomain(std::vector<string>& valueNames)
 {
     int l;
     string token;
-    std::tie(l, token) = this->getNextToken();
+    l = this->getNextToken(token);
 
     while (!isCBrace(token)) {
         if (isdigit(token[0])) { // not a symbol !
@@ -695,7 +664,7 @@ int CFNStreamReader::readDomain(std::vector<string>& valueNames)
         } else {
             valueNames.push_back(token);
         }
-        std::tie(l, token) = this->getNextToken();
+        l = this->getNextToken(token);
     }
     return valueNames.size();
 }
@@ -705,12 +674,12 @@ void CFNStreamReader::readIntervalUnaryTable(int varIdx, vector<Value>& authoriz
     int lineNumber;
     string token;
 
-    tie(lineNumber, token) = this->getNextToken();
+    lineNumber = this->getNextToken(token);
     while (!isCBrace(token)) {
         unsigned int valueIdx = getValueIdx(varIdx, token, lineNumber);
         authorized.push_back(valueIdx);
 
-        tie(lineNumber, token) = this->getNextToken();
+        lineNumber = this->getNextToken(token);
         Cost cost = wcsp->decimalToCost(token, lineNumber);
         if (cost != MIN_COST) {
             cerr << "Error: Unary cost function with non zero non default cost at line " << lineNumber << endl;
@@ -740,7 +709,7 @@ std::vector<Cost> CFNStreamReader::readFunctionCostTable(vector<int> scope, bool
     costVector.resize(costVecSize);
     fill(costVector.begin(), costVector.end(), defaultCost);
 
-    std::tie(lineNumber, token) = this->getNextToken();
+    lineNumber = this->getNextToken(token);
     if (!all) { // will be a tuple:cost table
         int arity = scope.size();
         int scopeIdx = 0; // position in the scope
@@ -780,7 +749,7 @@ std::vector<Cost> CFNStreamReader::readFunctionCostTable(vector<int> scope, bool
             } else {
                 scopeIdx++;
             }
-            std::tie(lineNumber, token) = this->getNextToken();
+            lineNumber = this->getNextToken(token);
         }
 
         if (nbCostInserted < costVecSize) // there are some defaultCost remaining
@@ -800,7 +769,7 @@ std::vector<Cost> CFNStreamReader::readFunctionCostTable(vector<int> scope, bool
             costVector[tableIdx] = cost;
             tableIdx++;
 
-            std::tie(lineNumber, token) = this->getNextToken();
+            lineNumber = this->getNextToken(token);
         }
         if (tableIdx != costVecSize) {
             cerr << "Error: incorrect number of costs in cost table ending at line " << lineNumber << endl;
@@ -857,7 +826,7 @@ void CFNStreamReader::enforceUB(Cost bound)
 int CFNStreamReader::getValueIdx(int variableIdx, const string& token, int lineNumber)
 {
     if (not isdigit(token[0])) {
-        std::map<std::string, int>::iterator it;
+        std::unordered_map<std::string, int>::iterator it;
 
         if ((it = varValNameToIdx[variableIdx].find(token)) != varValNameToIdx[variableIdx].end()) {
             return it->second;
@@ -889,11 +858,11 @@ void CFNStreamReader::readScope(vector<int>& scope)
     int lineNumber;
     string token;
 
-    std::tie(lineNumber, token) = this->getNextToken();
+    lineNumber = this->getNextToken(token);
     while (!isCBrace(token)) {
         // It's a name, convert to index
         if (not isdigit(token[0])) {
-            map<string, int>::iterator it;
+            unordered_map<string, int>::iterator it;
             if ((it = varNameToIdx.find(token)) != varNameToIdx.end()) {
                 scope.push_back(it->second);
             } else {
@@ -916,7 +885,7 @@ void CFNStreamReader::readScope(vector<int>& scope)
             }
         }
         // prepare for next iteration (will ultimately read final CBrace)
-        std::tie(lineNumber, token) = this->getNextToken();
+        lineNumber = this->getNextToken(token);
     }
 }
 // Reads all cost functions.
@@ -932,7 +901,7 @@ pair<unsigned, unsigned> CFNStreamReader::readCostFunctions()
     skipJSONTag("functions");
     skipOBrace();
 
-    std::tie(lineNumber, token) = this->getNextToken(); // start the token pump!
+    lineNumber = this->getNextToken(token); // start the token pump!
 
     while ((lineNumber != -1) && !isCBrace(token)) {
         //  Read function name (if any) and move after next OBrace
@@ -971,12 +940,12 @@ pair<unsigned, unsigned> CFNStreamReader::readCostFunctions()
         //  Test if a defaultCost is there (and tuples will be expected later)
         bool skipDefaultCost = false;
         Cost defaultCost = MIN_COST;
-        std::tie(lineNumber, token) = this->getNextToken();
+        lineNumber = this->getNextToken(token);
 
         if (JSONMode) {
             if (token == "defaultcost") {
                 // read the defaultCost
-                std::tie(lineNumber, token) = this->getNextToken();
+                lineNumber = this->getNextToken(token);
             } else {
                 skipDefaultCost = true;
             }
@@ -986,7 +955,7 @@ pair<unsigned, unsigned> CFNStreamReader::readCostFunctions()
 
         if (!skipDefaultCost) { // Set default cost and skip to next token
             defaultCost = wcsp->decimalToCost(token, lineNumber);
-            std::tie(lineNumber, token) = this->getNextToken();
+            lineNumber = this->getNextToken(token);
         }
 
         if (isUnaryInterval && defaultCost == MIN_COST) {
@@ -1002,7 +971,7 @@ pair<unsigned, unsigned> CFNStreamReader::readCostFunctions()
             if (token == "type") { // This is a global/arithmetic
                 isGlobal = true;
                 // read type
-                std::tie(lineNumber, token) = this->getNextToken();
+                lineNumber = this->getNextToken(token);
                 skipJSONTag("params");
                 skipOBrace();
                 // ready to read params (after OBrace)
@@ -1010,7 +979,7 @@ pair<unsigned, unsigned> CFNStreamReader::readCostFunctions()
                 cerr << "Error: expected tag 'costs' instead of '" << token << "' at line " << lineNumber << endl;
                 exit(EXIT_FAILURE);
             } else { // cost table: can be reused or explicit
-                std::tie(lineNumber, token) = this->getNextToken();
+                lineNumber = this->getNextToken(token);
                 isReused = !isOBrace(token); // no brace, so reused
                 if (isReused) {
                     if (!skipDefaultCost) {
@@ -1142,7 +1111,7 @@ pair<unsigned, unsigned> CFNStreamReader::readCostFunctions()
         } else if (isGlobal) {
             this->readGlobalCostFunction(scope, token, lineNumber);
         }
-        std::tie(lineNumber, token) = this->getNextToken();
+        lineNumber = this->getNextToken(token);
     } // end of while (token != closing braces = EOF)
 
     return make_pair(nbcf, maxarity);
@@ -1156,7 +1125,7 @@ void CFNStreamReader::readZeroAryCostFunction(bool all, Cost defaultCost)
     string token;
     int lineNumber;
 
-    std::tie(lineNumber, token) = this->getNextToken();
+    lineNumber = this->getNextToken(token);
     Cost zeroAryCost = 0;
 
     if (!isCBrace(token)) { // We have a cost
@@ -1209,7 +1178,7 @@ void CFNStreamReader::readNaryCostFunction(vector<int>& scope, bool all, Cost de
     }
 
     // Start reading
-    std::tie(lineNumber, token) = this->getNextToken();
+    lineNumber = this->getNextToken(token);
     if (not all) {
         unsigned int scopeIdx = 0; // Index of the cost table tuple
         while (!isCBrace(token)) {
@@ -1238,7 +1207,7 @@ void CFNStreamReader::readNaryCostFunction(vector<int>& scope, bool all, Cost de
             }
 
             scopeIdx = ((scopeIdx == arity) ? 0 : scopeIdx + 1);
-            std::tie(lineNumber, token) = this->getNextToken();
+            lineNumber = this->getNextToken(token);
         }
         // Is there any remaining default cost (either too many tuples or less than we need)
         if ((logCard > log(std::numeric_limits<unsigned long>::max())) || nbTuples < card) {
@@ -1272,7 +1241,7 @@ void CFNStreamReader::readNaryCostFunction(vector<int>& scope, bool all, Cost de
             costs.push_back(cost);
             minCost = min(minCost, cost);
             nbTuples++;
-            std::tie(lineNumber, token) = this->getNextToken();
+            lineNumber = this->getNextToken(token);
         }
 
         // Test if all tuples have been read
@@ -1519,7 +1488,7 @@ void CFNStreamReader::generateGCFStreamFromTemplate(vector<int>& scope, const st
         // ---------- Read keyword and add it to stream
         else if (GCFTemplate[i] == 'K') {
 
-            std::tie(lineNumber, token) = this->getNextToken();
+            lineNumber = this->getNextToken(token);
             streamContentVec.push_back(std::make_pair('K', token));
 
             // Special case of sgcc
@@ -1535,7 +1504,7 @@ void CFNStreamReader::generateGCFStreamFromTemplate(vector<int>& scope, const st
         // ---------- Read cost, transform it to cost and add it to stream
         else if (GCFTemplate[i] == 'C' || GCFTemplate[i] == 'c') {
 
-            std::tie(lineNumber, token) = this->getNextToken();
+            lineNumber = this->getNextToken(token);
             Cost cost = wcsp->decimalToCost(token, lineNumber);
             if (GCFTemplate[i] == 'c' && cost < 0) {
                 cerr << "Error: the global cost function " << funcType << " cannot accept negative costs at line " << lineNumber << endl;
@@ -1546,7 +1515,7 @@ void CFNStreamReader::generateGCFStreamFromTemplate(vector<int>& scope, const st
         // ---------- Read variable and add it to stream
         else if (GCFTemplate[i] == 'V') {
 
-            std::tie(lineNumber, token) = this->getNextToken();
+            lineNumber = this->getNextToken(token);
 
             if (not isdigit(token[0])) {
                 auto it = varNameToIdx.find(token);
@@ -1563,7 +1532,7 @@ void CFNStreamReader::generateGCFStreamFromTemplate(vector<int>& scope, const st
         // ---------- Read value and add it to stream
         else if (GCFTemplate[i] == 'v') {
 
-            std::tie(lineNumber, token) = this->getNextToken();
+            lineNumber = this->getNextToken(token);
             // V0 : value MUST be a number
             for (char c : token) {
                 if (!isdigit(c)) {
@@ -1577,7 +1546,7 @@ void CFNStreamReader::generateGCFStreamFromTemplate(vector<int>& scope, const st
         // ---------- Read number and add it to stream
         else if (GCFTemplate[i] == 'N') {
 
-            std::tie(lineNumber, token) = this->getNextToken();
+            lineNumber = this->getNextToken(token);
             for (char c : token) {
                 if (!isdigit(c)) {
                     cerr << "Error: number required at line " << lineNumber << " but read " << token << endl;
@@ -1605,7 +1574,7 @@ void CFNStreamReader::generateGCFStreamFromTemplate(vector<int>& scope, const st
             skipOBrace();
             // Inside the list of parameter tuples
 
-            std::tie(lineNumber, token) = this->getNextToken();
+            lineNumber = this->getNextToken(token);
             while (token != "]") {
                 // Each (non unary) tuple is inside []. Skip first [
                 if (repeatedSymbols.size() > 1 || variableRepeat) {
@@ -1613,7 +1582,7 @@ void CFNStreamReader::generateGCFStreamFromTemplate(vector<int>& scope, const st
                         cerr << "Error: expected '[/{' but read " << token << " at line " << lineNumber << endl;
                         exit(EXIT_FAILURE);
                     } else
-                        std::tie(lineNumber, token) = this->getNextToken();
+                        lineNumber = this->getNextToken(token);
                 }
 
                 size_t repeatIndex = 0;
@@ -1672,7 +1641,7 @@ void CFNStreamReader::generateGCFStreamFromTemplate(vector<int>& scope, const st
                     }
 
                     repeatIndex++;
-                    std::tie(lineNumber, token) = this->getNextToken();
+                    lineNumber = this->getNextToken(token);
                 }
 
                 if (repeatedSymbols.size() > 1 || variableRepeat) {
@@ -1680,7 +1649,7 @@ void CFNStreamReader::generateGCFStreamFromTemplate(vector<int>& scope, const st
                         cerr << "Error: expected ']/}' but read " << token << " at line " << lineNumber << endl;
                         exit(EXIT_FAILURE);
                     } else
-                        std::tie(lineNumber, token) = this->getNextToken();
+                        lineNumber = this->getNextToken(token);
                 }
                 if (variableRepeat) { // we must push the size of the repeat and its contents
                     repeatedContentVec.push_back(std::make_pair('N', std::to_string(variableRepeatVec.size())));
@@ -1779,7 +1748,7 @@ void CFNStreamReader::generateGCFStreamSgrammar(vector<int>& scope, stringstream
     vector<string> non_terminal_rules;
 
     skipJSONTag("metric");
-    std::tie(lineNumber, token) = this->getNextToken();
+    lineNumber = this->getNextToken(token);
     metric = token;
     if (metric != "var" && metric != "weight") {
         cerr << "Error: sgrammar metric must be either 'var' or 'weight' at line " << lineNumber << endl;
@@ -1787,7 +1756,7 @@ void CFNStreamReader::generateGCFStreamSgrammar(vector<int>& scope, stringstream
     }
     // Read cost
     skipJSONTag("cost");
-    std::tie(lineNumber, token) = this->getNextToken();
+    lineNumber = this->getNextToken(token);
     Cost cost = wcsp->decimalToCost(token, lineNumber);
     if (cost < 0) {
         cerr << "Error: sgrammar at line " << lineNumber << "uses a negative cost." << endl;
@@ -1795,36 +1764,36 @@ void CFNStreamReader::generateGCFStreamSgrammar(vector<int>& scope, stringstream
     }
     // Read Nb Symbols
     skipJSONTag("nb_symbols");
-    std::tie(lineNumber, token) = this->getNextToken();
+    lineNumber = this->getNextToken(token);
     string nb_symbols = token;
     // Read Nb Values
     skipJSONTag("nb_values");
-    std::tie(lineNumber, token) = this->getNextToken();
+    lineNumber = this->getNextToken(token);
     string nb_values = token;
     // Read start symbol
     skipJSONTag("start");
-    std::tie(lineNumber, token) = this->getNextToken();
+    lineNumber = this->getNextToken(token);
     string start_symbol = token;
 
     skipJSONTag("terminals"); // 0 or 2
-    std::tie(lineNumber, token) = this->getNextToken();
+    lineNumber = this->getNextToken(token);
     isOBrace(token); // First [
-    std::tie(lineNumber, token) = this->getNextToken(); // Second [ or ]
+    lineNumber = this->getNextToken(token); // Second [ or ]
     while (token != "]") {
 
         string terminal_rule;
         isOBrace(token);
         // Read terminal_symbol
-        std::tie(lineNumber, token) = this->getNextToken();
+        lineNumber = this->getNextToken(token);
         terminal_rule += token + " ";
 
         // Read value
-        std::tie(lineNumber, token) = this->getNextToken();
+        lineNumber = this->getNextToken(token);
         terminal_rule += token + " ";
 
         if (metric == "weight") {
             // Read weight
-            std::tie(lineNumber, token) = this->getNextToken();
+            lineNumber = this->getNextToken(token);
             Cost tcost = wcsp->decimalToCost(token, lineNumber);
             if (cost < 0) {
                 cerr << "Error: sgrammar at line " << lineNumber << "uses a negative cost." << endl;
@@ -1835,35 +1804,35 @@ void CFNStreamReader::generateGCFStreamSgrammar(vector<int>& scope, stringstream
 
         terminal_rules.push_back(terminal_rule);
 
-        std::tie(lineNumber, token) = this->getNextToken();
+        lineNumber = this->getNextToken(token);
         isCBrace(token);
-        std::tie(lineNumber, token) = this->getNextToken();
+        lineNumber = this->getNextToken(token);
     }
 
     skipJSONTag("non_terminals"); // 1 or 3
-    std::tie(lineNumber, token) = this->getNextToken();
+    lineNumber = this->getNextToken(token);
     isOBrace(token); // First [
-    std::tie(lineNumber, token) = this->getNextToken(); // Second [ or ]
+    lineNumber = this->getNextToken(token); // Second [ or ]
     while (token != "]") {
 
         string non_terminal_rule;
         isOBrace(token);
 
         // Read nonterminal_in
-        std::tie(lineNumber, token) = this->getNextToken();
+        lineNumber = this->getNextToken(token);
         non_terminal_rule += token + " ";
 
         // Read nonterminal_out_left
-        std::tie(lineNumber, token) = this->getNextToken();
+        lineNumber = this->getNextToken(token);
         non_terminal_rule += token + " ";
 
         // Read nonterminal_out_right
-        std::tie(lineNumber, token) = this->getNextToken();
+        lineNumber = this->getNextToken(token);
         non_terminal_rule += token + " ";
 
         if (metric == "weight") {
             // Read weight
-            std::tie(lineNumber, token) = this->getNextToken();
+            lineNumber = this->getNextToken(token);
             Cost tcost = wcsp->decimalToCost(token, lineNumber);
             if (cost < 0) {
                 cerr << "Error: sgrammar at line " << lineNumber << "uses a negative cost." << endl;
@@ -1874,9 +1843,9 @@ void CFNStreamReader::generateGCFStreamSgrammar(vector<int>& scope, stringstream
 
         non_terminal_rules.push_back(non_terminal_rule);
 
-        std::tie(lineNumber, token) = this->getNextToken();
+        lineNumber = this->getNextToken(token);
         isCBrace(token);
-        std::tie(lineNumber, token) = this->getNextToken();
+        lineNumber = this->getNextToken(token);
     }
 
     // End of function, write to stream
@@ -1920,19 +1889,19 @@ void CFNStreamReader::generateGCFStreamSsame(vector<int>& scope, stringstream& s
     vector<string> variables2;
 
     skipJSONTag("cost");
-    std::tie(lineNumber, token) = this->getNextToken();
+    lineNumber = this->getNextToken(token);
     Cost cost = wcsp->decimalToCost(token, lineNumber);
     // TODO Cost should be >= 0
 
     skipJSONTag("vars1");
-    std::tie(lineNumber, token) = this->getNextToken();
+    lineNumber = this->getNextToken(token);
     isOBrace(token);
-    std::tie(lineNumber, token) = this->getNextToken();
+    lineNumber = this->getNextToken(token);
 
     while (token != "]") {
 
         if (not isdigit(token[0])) {
-            map<string, int>::iterator it;
+            unordered_map<string, int>::iterator it;
             if ((it = varNameToIdx.find(token)) != varNameToIdx.end()) {
                 token = std::to_string(it->second);
             } else {
@@ -1942,18 +1911,18 @@ void CFNStreamReader::generateGCFStreamSsame(vector<int>& scope, stringstream& s
         }
         variables1.push_back(token);
 
-        std::tie(lineNumber, token) = this->getNextToken();
+        lineNumber = this->getNextToken(token);
     }
 
     skipJSONTag("vars2");
-    std::tie(lineNumber, token) = this->getNextToken();
+    lineNumber = this->getNextToken(token);
     isOBrace(token);
-    std::tie(lineNumber, token) = this->getNextToken();
+    lineNumber = this->getNextToken(token);
 
     while (token != "]") {
 
         if (not isdigit(token[0])) {
-            map<string, int>::iterator it;
+            unordered_map<string, int>::iterator it;
             if ((it = varNameToIdx.find(token)) != varNameToIdx.end()) {
                 token = std::to_string(it->second);
             } else {
@@ -1963,7 +1932,7 @@ void CFNStreamReader::generateGCFStreamSsame(vector<int>& scope, stringstream& s
         }
         variables2.push_back(token);
 
-        std::tie(lineNumber, token) = this->getNextToken();
+        lineNumber = this->getNextToken(token);
     }
 
     // End of params
@@ -1997,7 +1966,9 @@ Cost WCSP::read_wcsp(const char* fileName)
 
     if (ToulBar2::cfn && !ToulBar2::gz && !ToulBar2::xz) {
 #ifdef BOOST
+        vector<char> readBuffer(READ_BUFFER_SIZE);
         ifstream Rfile;
+        Rfile.rdbuf()->pubsetbuf(readBuffer.data(), READ_BUFFER_SIZE);
         istream& stream = (ToulBar2::stdin_format.length() > 0) ? cin : Rfile;
         if (ToulBar2::stdin_format.compare("cfn") == 0) {
             CFNStreamReader fileReader(stream, this);
@@ -2023,9 +1994,10 @@ Cost WCSP::read_wcsp(const char* fileName)
         ifstream Rfile(fileName, std::ios_base::in | std::ios_base::binary);
         istream& file = Rfile;
         boost::iostreams::filtering_streambuf<boost::iostreams::input> inbuf;
-        inbuf.push(boost::iostreams::gzip_decompressor());
+        inbuf.push(boost::iostreams::gzip_decompressor(), READ_BUFFER_SIZE);
         inbuf.push(file);
-        std::istream stream(&inbuf);
+        PipelineStreamBuffer pipeline(&inbuf); // decompression in a separate thread
+        std::istream stream(pipeline.input());
 
         if (!file) {
             cerr << "Could not open cfn.gz file : " << fileName << endl;
@@ -2046,9 +2018,10 @@ Cost WCSP::read_wcsp(const char* fileName)
         ifstream Rfile(fileName, std::ios_base::in | std::ios_base::binary);
         istream& file = Rfile;
         boost::iostreams::filtering_streambuf<boost::iostreams::input> inbuf;
-        inbuf.push(boost::iostreams::lzma_decompressor());
+        inbuf.push(boost::iostreams::lzma_decompressor(), READ_BUFFER_SIZE);
         inbuf.push(file);
-        std::istream stream(&inbuf);
+        PipelineStreamBuffer pipeline(&inbuf); // decompression in a separate thread
+        std::istream stream(pipeline.input());
 
         if (!file) {
             cerr << "Could not open cfn.xz file : " << fileName << endl;
@@ -2115,6 +2088,9 @@ Cost WCSP::read_wcsp(const char* fileName)
     } else if (ToulBar2::qpbo) {
         read_qpbo(fileName);
         return getUb();
+    } else if (ToulBar2::binaryFormat) {
+        read_binary(fileName);
+        return getUb();
     }
     // TOOLBAR WCSP LEGACY PARSER
     string pbname;
@@ -2142,21 +2118,25 @@ Cost WCSP::read_wcsp(const char* fileName)
     vector<vector<String>> sharedTuples;
     vector<String> emptyTuples;
 
-    ifstream rfile(fileName, (ToulBar2::gz || ToulBar2::xz) ? (std::ios_base::in | std::ios_base::binary) : (std::ios_base::in));
+    vector<char> readBuffer(READ_BUFFER_SIZE);
+    ifstream rfile;
+    rfile.rdbuf()->pubsetbuf(readBuffer.data(), READ_BUFFER_SIZE);
+    rfile.open(fileName, (ToulBar2::gz || ToulBar2::xz) ? (std::ios_base::in | std::ios_base::binary) : (std::ios_base::in));
 #ifdef BOOST
     boost::iostreams::filtering_streambuf<boost::iostreams::input> zfile;
     if (ToulBar2::gz) {
-        zfile.push(boost::iostreams::gzip_decompressor());
+        zfile.push(boost::iostreams::gzip_decompressor(), READ_BUFFER_SIZE);
     } else if (ToulBar2::xz) {
 #if (BOOST_VERSION >= 106500)
-        zfile.push(boost::iostreams::lzma_decompressor());
+        zfile.push(boost::iostreams::lzma_decompressor(), READ_BUFFER_SIZE);
 #else
         cerr << "Error: compiling with Boost version 1.65 or higher is needed to allow to read xz compressed wcsp format files." << endl;
         exit(EXIT_FAILURE);
 #endif
     }
     zfile.push(rfile);
-    istream ifile(&zfile);
+    PipelineStreamBuffer pipeline(&zfile, ToulBar2::gz || ToulBar2::xz); // decompression in a separate thread
+    istream ifile(pipeline.input());
 
     if (ToulBar2::stdin_format.length() == 0 && !rfile) {
         cerr << "Could not open wcsp file : " << fileName << endl;
@@ -2174,6 +2154,7 @@ Cost WCSP::read_wcsp(const char* fileName)
     }
     istream& file = (ToulBar2::stdin_format.length() > 0) ? cin : rfile;
 #endif
+    StreamTokenizer tokens(file); // fast reading of cost tables
 
     // ---------- PROBLEM HEADER ----------
     // read problem name and sizes
@@ -2276,11 +2257,11 @@ Cost WCSP::read_wcsp(const char* fileName)
                     for (t = 0; t < ntuples; t++) {
                         if (!reused) {
                             for (i = 0; i < arity; i++) {
-                                file >> j;
+                                tokens.read(j);
                                 buf[i] = j + CHAR_FIRST;
                             }
                             buf[i] = '\0';
-                            file >> cost;
+                            tokens.read(cost);
                             Cost tmpcost = MULT(cost, K);
                             if (CUT(tmpcost, getUb()) && (tmpcost < MEDIUM_COST * getUb()) && getUb() < (MAX_COST / MEDIUM_COST))
                                 tmpcost *= MEDIUM_COST;
@@ -2358,10 +2339,10 @@ Cost WCSP::read_wcsp(const char* fileName)
                     }
                 }
                 for (t = 0; t < ntuples; t++) {
-                    file >> a;
-                    file >> b;
-                    file >> c;
-                    file >> cost;
+                    tokens.read(a);
+                    tokens.read(b);
+                    tokens.read(c);
+                    tokens.read(cost);
                     Cost tmpcost = MULT(cost, K);
                     if (CUT(tmpcost, getUb()) && (tmpcost < MEDIUM_COST * getUb()) && getUb() < (MAX_COST / MEDIUM_COST))
                         tmpcost *= MEDIUM_COST;
@@ -2448,9 +2429,9 @@ Cost WCSP::read_wcsp(const char* fileName)
                     }
                 }
                 for (k = 0; k < ntuples; k++) {
-                    file >> a;
-                    file >> b;
-                    file >> cost;
+                    tokens.read(a);
+                    tokens.read(b);
+                    tokens.read(cost);
                     Cost tmpcost = MULT(cost, K);
                     if (CUT(tmpcost, getUb()) && (tmpcost < MEDIUM_COST * getUb()) && getUb() < (MAX_COST / MEDIUM_COST))
                         tmpcost *= MEDIUM_COST;
@@ -2561,8 +2542,8 @@ Cost WCSP::read_wcsp(const char* fileName)
                         unaryconstr.costs.push_back(tmpcost);
                     }
                     for (k = 0; k < ntuples; k++) {
-                        file >> a;
-                        file >> cost;
+                        tokens.read(a);
+                        tokens.read(cost);
                         Cost tmpcost = MULT(cost, K);
                         if (CUT(tmpcost, getUb()) && (tmpcost < MEDIUM_COST * getUb()) && getUb() < (MAX_COST / MEDIUM_COST))
                             tmpcost *= MEDIUM_COST;
@@ -2704,7 +2685,8 @@ void WCSP::read_uai2008(const char* fileName)
 #endif
     }
     zfile.push(rfile);
-    istream ifile(&zfile);
+    PipelineStreamBuffer pipeline(&zfile, ToulBar2::gz || ToulBar2::xz); // decompression in a separate thread
+    istream ifile(pipeline.input());
 
     if (ToulBar2::stdin_format.length() == 0 && !rfile) {
         cerr << "Could not open uai file : " << fileName << endl;
@@ -3160,21 +3142,25 @@ void WCSP::solution_XML(bool opt)
 
 void WCSP::read_wcnf(const char* fileName)
 {
-    ifstream rfile(fileName, (ToulBar2::gz || ToulBar2::xz) ? (std::ios_base::in | std::ios_base::binary) : (std::ios_base::in));
+    vector<char> readBuffer(READ_BUFFER_SIZE);
+    ifstream rfile;
+    rfile.rdbuf()->pubsetbuf(readBuffer.data(), READ_BUFFER_SIZE);
+    rfile.open(fileName, (ToulBar2::gz || ToulBar2::xz) ? (std::ios_base::in | std::ios_base::binary) : (std::ios_base::in));
 #ifdef BOOST
     boost::iostreams::filtering_streambuf<boost::iostreams::input> zfile;
     if (ToulBar2::gz) {
-        zfile.push(boost::iostreams::gzip_decompressor());
+        zfile.push(boost::iostreams::gzip_decompressor(), READ_BUFFER_SIZE);
     } else if (ToulBar2::xz) {
 #if (BOOST_VERSION >= 106500)
-        zfile.push(boost::iostreams::lzma_decompressor());
+        zfile.push(boost::iostreams::lzma_decompressor(), READ_BUFFER_SIZE);
 #else
         cerr << "Error: compiling with Boost version 1.65 or higher is needed to allow to read xz compressed cnf/wcnf format files." << endl;
         exit(EXIT_FAILURE);
 #endif
     }
     zfile.push(rfile);
-    istream ifile(&zfile);
+    PipelineStreamBuffer pipeline(&zfile, ToulBar2::gz || ToulBar2::xz); // decompression in a separate thread
+    istream ifile(pipeline.input());
 
     if (ToulBar2::stdin_format.length() == 0 && !rfile) {
         cerr << "Could not open wcnf file : " << fileName << endl;
@@ -3192,6 +3178,7 @@ void WCSP::read_wcnf(const char* fileName)
     }
     istream& file = (ToulBar2::stdin_format.length() > 0) ? cin : rfile;
 #endif
+    StreamTokenizer tokens(file); // fast reading of clauses
 
     double K = ToulBar2::costMultiplier;
     Cost inclowerbound = MIN_COST;
@@ -3199,6 +3186,9 @@ void WCSP::read_wcnf(const char* fileName)
 
     int maxarity = 0;
     vector<TemporaryUnaryConstraint> unaryconstrs;
+    vector<int> dbliterals; // clauses stored in a WeightedClauseDatabase (see option -wcl), a literal being its variable index times two plus the value index satisfying it
+    vector<unsigned int> dbstarts(1, 0);
+    vector<Cost> dbweights;
 
     int nbvar, nbclauses;
     string dummy, sflag;
@@ -3261,10 +3251,14 @@ void WCSP::read_wcnf(const char* fileName)
         int j = 0;
         Cost cost = UNIT_COST;
         if (format == "wcnf")
-            file >> cost;
+            tokens.read(cost);
         bool tautology = false;
+        bool complete = true;
         do {
-            file >> j;
+            if (!tokens.read(j)) {
+                complete = false;
+                break;
+            }
             if (j != 0 && !tautology) {
                 scopeIndex[arity] = abs(j) - 1;
                 buf[arity] = ((j > 0) ? 0 : 1) + CHAR_FIRST;
@@ -3290,12 +3284,21 @@ void WCSP::read_wcnf(const char* fileName)
         } while (j != 0);
         if (ToulBar2::verbose >= 3)
             cout << endl;
+        if (!complete) {
+            cerr << "Warning: EOF reached before reading all the clauses (initial number of clauses too large?)" << endl;
+            break;
+        }
         if (tautology)
             continue;
         buf[arity] = '\0';
         maxarity = max(maxarity, arity);
 
-        if (arity > 3) {
+        if (ToulBar2::clauseDatabase >= 2 && arity >= ToulBar2::clauseDatabase) {
+            for (int i = 0; i < arity; i++)
+                dbliterals.push_back(2 * scopeIndex[i] + 1 - (buf[i] - CHAR_FIRST));
+            dbstarts.push_back(dbliterals.size());
+            dbweights.push_back(MULT(cost, K));
+        } else if (arity > 3) {
             int index = postNaryConstraintBegin(scopeIndex, arity, MIN_COST, 1);
             String tup = buf;
             postNaryConstraintTuple(index, tup, MULT(cost, K));
@@ -3351,6 +3354,24 @@ void WCSP::read_wcnf(const char* fileName)
     for (unsigned int u = 0; u < unaryconstrs.size(); u++) {
         postUnaryConstraint(unaryconstrs[u].var->wcspIndex, unaryconstrs[u].costs);
     }
+    if (dbweights.size() > 0) {
+        vector<int> dbindex(nbvar, -1); // position of each variable in the scope of the database
+        vector<EnumeratedVariable*> dbscope;
+        for (unsigned int k = 0; k < dbliterals.size(); k++) {
+            int var = dbliterals[k] >> 1;
+            if (dbindex[var] < 0) {
+                dbindex[var] = dbscope.size();
+                dbscope.push_back((EnumeratedVariable*)vars[var]);
+            }
+            dbliterals[k] = 2 * dbindex[var] + (dbliterals[k] & 1);
+        }
+        WeightedClauseDatabase* db = new WeightedClauseDatabase(this, dbscope.data(), dbscope.size());
+        for (unsigned int c = 0; c < dbweights.size(); c++)
+            db->addClause(&dbliterals[dbstarts[c]], dbstarts[c + 1] - dbstarts[c], dbweights[c]);
+        db->propagate();
+        if (ToulBar2::verbose >= 0)
+            cout << "c " << db->numberOfClauses() << " clauses of arity " << ToulBar2::clauseDatabase << " or more stored in a clause database with " << dbliterals.size() << " literals on " << dbscope.size() << " variables." << endl;
+    }
     sortConstraints();
     if (ToulBar2::verbose >= 0)
         cout << "c Read " << nbvar << " variables, with 2 values at most, and " << nbclauses << " clauses, with maximum arity " << maxarity << "." << endl;
@@ -3379,7 +3400,8 @@ void WCSP::read_qpbo(const char* fileName)
 #endif
     }
     zfile.push(rfile);
-    istream ifile(&zfile);
+    PipelineStreamBuffer pipeline(&zfile, ToulBar2::gz || ToulBar2::xz); // decompression in a separate thread
+    istream ifile(pipeline.input());
 
     if (ToulBar2::stdin_format.length() == 0 && !rfile) {
         cerr << "Could not open qpbo file : " << fileName << endl;
@@ -3566,6 +3588,170 @@ void WCSP::read_qpbo(const char* fileName)
     }
 }
 
+/// \brief reads a problem saved by WCSP::dumpBinary (see tb2binformat.hpp)
+/// \note the file is memory-mapped on Linux and cost tables are read in place before being copied into the cost functions
+void WCSP::read_binary(const char* fileName)
+{
+    const char* data = NULL;
+    size_t size = 0;
+#ifdef LINUX
+    int fd = open(fileName, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        cerr << "Could not open binary file : " << fileName << endl;
+        exit(EXIT_FAILURE);
+    }
+    size = st.st_size;
+    void* mapped = (size > 0) ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        cerr << "Could not map binary file : " << fileName << endl;
+        exit(EXIT_FAILURE);
+    }
+    madvise(mapped, size, MADV_SEQUENTIAL);
+    data = (const char*)mapped;
+#else
+    ifstream rfile(fileName, std::ios_base::in | std::ios_base::binary);
+    if (!rfile) {
+        cerr << "Could not open binary file : " << fileName << endl;
+        exit(EXIT_FAILURE);
+    }
+    vector<char> contents((istreambuf_iterator<char>(rfile)), istreambuf_iterator<char>());
+    data = contents.data();
+    size = contents.size();
+#endif
+    BinaryProblemReader file(data, size);
+
+    // ---------- PROBLEM HEADER ----------
+    BinaryProblemHeader header = file.read<BinaryProblemHeader>();
+    if (memcmp(header.magic, BinaryProblemMagic, sizeof(header.magic)) != 0 || header.version != BinaryProblemVersion) {
+        cerr << "Error: " << fileName << " is not a binary problem file of this toulbar2 version." << endl;
+        exit(EXIT_FAILURE);
+    }
+    if (header.costSize != sizeof(Cost)) {
+        cerr << "Error: binary problem file " << fileName << " was saved with " << 8 * header.costSize << "-bit costs." << endl;
+        exit(EXIT_FAILURE);
+    }
+    ToulBar2::nbvar = header.nbvars;
+    ToulBar2::decimalPoint = header.decimalPoint;
+    ToulBar2::costMultiplier = header.costMultiplier; // costs are already multiplied
+    updateUb(header.ub);
+
+    assert(vars.empty());
+    assert(constrs.empty());
+
+    // ---------- VARIABLES ----------
+    unsigned int maxdomsize = 0;
+    vector<const Cost*> unarycosts(header.nbvars, NULL);
+    for (unsigned int i = 0; i < header.nbvars; i++) {
+        unsigned int kind = file.read<unsigned int>();
+        string varname = file.readString();
+        if (kind == BIN_ENUMERATED) {
+            unsigned int domsize = file.read<unsigned int>();
+            const Value* values = file.readArray<Value>(domsize);
+            vector<Value> domain(values, values + domsize); // sorted in place by the domain constructor
+            int x = makeEnumeratedVariable(varname, domain.data(), domsize);
+            assert(x == (int)i);
+            unsigned int nbnames = file.read<unsigned int>();
+            for (unsigned int a = 0; a < nbnames; a++)
+                vars[x]->newValueName(file.readString());
+            unarycosts[x] = file.readArray<Cost>(domsize);
+            maxdomsize = max(maxdomsize, domsize);
+        } else {
+            Value inf = file.read<Value>();
+            Value sup = file.read<Value>();
+            makeIntervalVariable(varname, inf, sup);
+            maxdomsize = max(maxdomsize, (unsigned int)(sup - inf + 1));
+        }
+    }
+
+    // ---------- COST FUNCTIONS ----------
+    int maxarity = 0;
+    vector<Cost> costs;
+    for (unsigned int c = 0; c < header.nbctrs; c++) {
+        unsigned int kind = file.read<unsigned int>();
+        if (kind == BIN_TEXT) {
+            istringstream text(file.readString());
+            int arity;
+            text >> arity;
+            vector<int> scope(arity);
+            for (int i = 0; i < arity; i++)
+                text >> scope[i];
+            Cost defval;
+            text >> defval;
+            if (defval == -1) {
+                string gcname;
+                text >> gcname;
+                postGlobalConstraint(scope.data(), arity, gcname, text, NULL, false);
+            } else {
+                Long ntuples;
+                text >> ntuples;
+                int naryIndex = postNaryConstraintBegin(scope.data(), arity, defval, ntuples);
+                vector<Value> tuple(arity);
+                for (Long t = 0; t < ntuples; t++) {
+                    for (int i = 0; i < arity; i++)
+                        text >> tuple[i];
+                    Cost cost;
+                    text >> cost;
+                    postNaryConstraintTuple(naryIndex, tuple.data(), arity, cost);
+                }
+                postNaryConstraintEnd(naryIndex);
+            }
+            maxarity = max(maxarity, arity);
+            continue;
+        }
+        int arity = file.read<int>();
+        const int* scope = file.readArray<int>(arity);
+        maxarity = max(maxarity, arity);
+        if (kind == BIN_DENSE) {
+            size_t ntuples = 1;
+            for (int i = 0; i < arity; i++)
+                ntuples *= ((EnumeratedVariable*)vars[scope[i]])->getDomainInitSize();
+            const Cost* table = file.readArray<Cost>(ntuples);
+            costs.assign(table, table + ntuples);
+            if (arity == 2)
+                postBinaryConstraint(scope[0], scope[1], costs);
+            else
+                postTernaryConstraint(scope[0], scope[1], scope[2], costs);
+        } else {
+            assert(kind == BIN_SPARSE);
+            Cost defval = file.read<Cost>();
+            Long ntuples = file.read<Long>();
+            const Value* tuples = file.readArray<Value>(ntuples * arity);
+            const Cost* tuplecosts = file.readArray<Cost>(ntuples);
+            int naryIndex = postNaryConstraintBegin((int*)scope, arity, defval, ntuples);
+            String tuple(arity, CHAR_FIRST);
+            for (Long t = 0; t < ntuples; t++) {
+                for (int i = 0; i < arity; i++)
+                    tuple[i] = tuples[t * arity + i] + CHAR_FIRST;
+                postNaryConstraintTuple(naryIndex, tuple, tuplecosts[t]);
+            }
+            postNaryConstraintEnd(naryIndex);
+        }
+    }
+
+    // apply basic initial propagation AFTER complete network loading
+    increaseLb(header.lb);
+    if (header.negCost < MIN_COST)
+        decreaseLb(header.negCost);
+    for (unsigned int i = 0; i < header.nbvars; i++) {
+        if (unarycosts[i]) {
+            unsigned int domsize = ((EnumeratedVariable*)vars[i])->getDomainInitSize();
+            if (std::any_of(unarycosts[i], unarycosts[i] + domsize, [](Cost cost) { return cost != MIN_COST; })) {
+                costs.assign(unarycosts[i], unarycosts[i] + domsize);
+                postUnaryConstraint(i, costs);
+            }
+        }
+    }
+    sortConstraints();
+
+#ifdef LINUX
+    munmap(mapped, size);
+#endif
+    if (ToulBar2::verbose >= 0)
+        cout << "Read " << header.nbvars << " variables, with " << maxdomsize << " values at most, and " << header.nbctrs << " cost functions, with maximum arity " << maxarity << "." << endl;
+}
+
 /* Local Variables: */
 /* c-basic-offset: 4 */
 /* tab-width: 4 */
@@ -6,25 +6,36 @@
  *  Allows to copy / restore the current state using Store::store and Store::restore methods.
  *  All storable data modifications are trailed into specific stacks.
  *
- *  Trailing stacks are associated to each storable type:
- *  - Store::storeValue for storable domain values ::StoreValue (value supports, etc)
- *  - Store::storeCost for storable costs ::StoreCost (inside cost functions, etc)
- *  - Store::storeDomain for enumerated domains (to manage holes inside domains)
- *  - Store::storeConstraint for backtrackable lists of constraints
- *  - Store::storeVariable for backtrackable lists of variables
- *  - Store::storeSeparator for backtrackable lists of separators (see tree decomposition methods)
- *  - Store::storeBigInteger for very large integers ::StoreBigInteger used in solution counting methods
+ *  Trailing stacks are grouped inside a trail context (::StoreContext), one for each solver instance.
+ *  Each trail context contains a stack for each storable type:
+ *  - StoreContext::storeValue for storable domain values ::StoreValue (value supports, etc)
+ *  - StoreContext::storeCost for storable costs ::StoreCost (inside cost functions, etc)
+ *  - StoreContext::storeDomain for enumerated domains (to manage holes inside domains)
+ *  - StoreContext::storeBits for bitmasks ::StoreBits (small enumerated domains, see ::Domain)
+ *  - StoreContext::storeConstraint for backtrackable lists of constraints
+ *  - StoreContext::storeVariable for backtrackable lists of variables
+ *  - StoreContext::storeSeparator for backtrackable lists of separators (see tree decomposition methods)
+ *  - StoreContext::storeBigInteger for very large integers ::StoreBigInteger used in solution counting methods
  *
- *  Memory for each stack is dynamically allocated by part of \f$2^x\f$ with \e x initialized to ::STORE_SIZE and increased when needed.
+ *  The trail context used by storable data is the current context of the calling thread (see Store::getContext and Store::setContext).
+ *  If no context has been set, a default context is created for the thread.
+ *  Each storable basic type caches the stack of the current context in a thread-local pointer (see StoreBasic::stack),
+ *  so that a trailed write costs a single thread-local load. Before any context is used at depth zero, it points to
+ *  an empty stack on which trailing does nothing.
+ *  Several solver instances can run in parallel as soon as each one is used by its own thread with its own trail context.
+ *
+ *  Memory for each stack is dynamically allocated by segments of \f$2^x\f$ entries with \e x equal to ::STORE_SIZE, a new segment being added when needed (existing segments are never copied).
  *  \note storable data are not trailed at depth 0.
- *  \warning ::StoreInt uses Store::storeValue stack (it assumes Value is encoded as int!).
- *  \warning Current storable data management is not multi-threading safe! (Store is a static virtual class relying on StoreBasic<T> static members)
+ *  \warning ::StoreInt uses StoreContext::storeValue stack (it assumes Value is encoded as int!).
+ *  \warning storable data must always be modified by the thread having the trail context of their solver instance as its current context.
  */
 
 #ifndef TB2STORE_HPP_
 #define TB2STORE_HPP_
 
 #include "core/tb2types.hpp"
+#include <new>
+#include <type_traits>
 
 #ifndef NUMBERJACK
 #ifdef BOOST
@@ -51,19 +62,82 @@ class ConstraintLink;
 /*
  * Storable stack
  *
+ * Trailed entries (address, old value) are kept in a segmented arena: segments of 2^powbckmemory entries
+ * are allocated when needed and never copied nor freed before the stack is destroyed.
+ * Entries of basic types are restored segment by segment in a tight loop.
+ *
  */
+template <class T>
+struct StoreIsList : std::false_type {
+};
+template <class Q>
+struct StoreIsList<BTList<Q>> : std::true_type {
+};
+
 template <class T, class V>
 class StoreStack {
-    T** pointers;
-    V* content;
+    struct Entry {
+        T* pointer;
+        V content;
+    };
+
+    vector<Entry*> segments;
+    int segmentBits;
+    ptrdiff_t segmentMask;
     ptrdiff_t index;
     ptrdiff_t indexMax;
     ptrdiff_t base;
 
+    ptrdiff_t peak; // maximum number of entries
+    Long nbRestored; // number of entries restored
+
     // make it private because we don't want copy nor assignment
     StoreStack(const StoreStack& s);
     StoreStack& operator=(const StoreStack& s);
 
+    Entry& at(ptrdiff_t i) { return segments[i >> segmentBits][i & segmentMask]; }
+
+    void printAllocated()
+    {
+        cout << "c " << getBytes() << " Bytes allocated for "
+#ifndef NUMBERJACK
+#if (BOOST_VERSION >= 105600)
+             << boost::typeindex::type_id<T>().pretty_name()
+#else
+             << typeid(T).name()
+#endif
+#endif
+             << " stack." << endl;
+    }
+
+    // restores entries of a single segment from last down to first
+    void restoreSegment(Entry* segment, ptrdiff_t first, ptrdiff_t last)
+    {
+        for (ptrdiff_t i = last; i >= first; i--) {
+            *segment[i].pointer = segment[i].content;
+        }
+    }
+
+    // restores entries from x down to y + 1, basic types
+    void restoreEntries(ptrdiff_t x, ptrdiff_t y, std::false_type)
+    {
+        while (x > y) {
+            ptrdiff_t first = max(y + 1, x & ~segmentMask);
+            restoreSegment(segments[x >> segmentBits], first & segmentMask, x & segmentMask);
+            x = first - 1;
+        }
+    }
+
+    // restores entries from x down to y + 1, backtrackable lists (an erased element uses two consecutive entries)
+    void restoreEntries(ptrdiff_t x, ptrdiff_t y, std::true_type)
+    {
+        x++;
+        while (--x != y) {
+            restoreList(x);
+        }
+    }
+    void restoreList(ptrdiff_t& x);
+
 public:
     StoreStack(int powbckmemory = STORE_SIZE)
     {
@@ -71,35 +145,29 @@ public:
             cerr << "command-line initial memory size parameter " << powbckmemory << " power of two too large!" << endl;
             exit(EXIT_FAILURE);
         }
-        indexMax = (ptrdiff_t)pow(2., powbckmemory);
-        pointers = new T*[indexMax];
-        content = new V[indexMax];
+        segmentBits = powbckmemory;
+        segmentMask = ((ptrdiff_t)1 << segmentBits) - 1;
+        segments.push_back(new Entry[segmentMask + 1]);
+        indexMax = segmentMask + 1;
         index = 0;
         base = 0;
+        peak = 0;
+        nbRestored = 0;
         if (ToulBar2::verbose > 0) {
-            cout << "c " << indexMax * (sizeof(V) + sizeof(T*)) << " Bytes allocated for "
-#ifndef NUMBERJACK
-#if (BOOST_VERSION >= 105600)
-                 << boost::typeindex::type_id<T>().pretty_name()
-#else
-                 << typeid(T).name()
-#endif
-#endif
-                 << " stack." << endl;
+            printAllocated();
         }
     }
 
     ~StoreStack()
     {
-        delete[] pointers;
-        delete[] content;
+        for (size_t i = 0; i < segments.size(); i++)
+            delete[] segments[i];
     }
 
     void realloc()
     {
-        T** newpointers = new T*[indexMax * 2];
-        V* newcontent = new V[indexMax * 2];
-        if (!newpointers || !newcontent) {
+        Entry* segment = new (nothrow) Entry[segmentMask + 1];
+        if (!segment) {
             cerr
 #ifndef NUMBERJACK
 #if (BOOST_VERSION >= 105600)
@@ -111,24 +179,10 @@ public:
                 << " stack out of memory!" << endl;
             exit(EXIT_FAILURE);
         }
-        std::copy(pointers, pointers + indexMax, newpointers);
-        std::copy(content, content + indexMax, newcontent);
-
-        delete[] pointers;
-        delete[] content;
-        pointers = newpointers;
-        content = newcontent;
-        indexMax *= 2;
-        if (ToulBar2::verbose >= 0) {
-            cout << "c " << indexMax * (sizeof(V) + sizeof(T*)) << " Bytes allocated for "
-#ifndef NUMBERJACK
-#if (BOOST_VERSION >= 105600)
-                 << boost::typeindex::type_id<T>().pretty_name()
-#else
-                 << typeid(T).name()
-#endif
-#endif
-                 << " stack." << endl;
+        segments.push_back(segment);
+        indexMax += segmentMask + 1;
+        if (ToulBar2::verbose >= 0 && (segments.size() & (segments.size() - 1)) == 0) { // reports each doubling of the stack size
+            printAllocated();
         }
     }
 
@@ -138,8 +192,9 @@ public:
             index++;
             if (index >= indexMax)
                 realloc();
-            content[index] = y;
-            pointers[index] = x;
+            Entry& e = at(index);
+            e.content = y;
+            e.pointer = x;
         }
     }
 
@@ -149,8 +204,24 @@ public:
             index++;
             if (index >= indexMax)
                 realloc();
-            content[index] = *x;
-            pointers[index] = x;
+            Entry& e = at(index);
+            e.content = *x;
+            e.pointer = x;
+        }
+    }
+
+    // trails n consecutive values at once (same entries as n calls to store(x + i))
+    void storeArray(T* x, ptrdiff_t n)
+    {
+        if (index > 0) {
+            while (index + n >= indexMax)
+                realloc();
+            for (ptrdiff_t i = 0; i < n; i++) {
+                Entry& e = at(index + 1 + i);
+                e.pointer = x + i;
+                e.content = x[i];
+            }
+            index += n;
         }
     }
 
@@ -159,48 +230,26 @@ public:
         index++;
         if (index >= indexMax)
             realloc();
-        pointers[index] = (T*)(intptr_t)base;
+        at(index).pointer = (T*)(intptr_t)base;
         base = index;
     }
 
-    //	void restore(int **adr, int *val, ptrdiff_t x) {
-    //		*adr[x] = val[x];
-    //	}
-
-    void restore(Value** adr, Value* val, ptrdiff_t x)
-    {
-        *adr[x] = val[x];
-    }
-
-#ifndef INT_COST
-    void restore(Cost** adr, Cost* val, ptrdiff_t x)
-    {
-        *adr[x] = val[x];
-    }
-#endif
-
-    void restore(BigInteger** adr, BigInteger* val, ptrdiff_t x)
-    {
-        *adr[x] = val[x];
-    }
-    template <class Q>
-    void restore(BTList<Q>** l, DLink<Q>** elt, ptrdiff_t& x);
-
     void restore()
     {
         if (index > 0) { // do nothing if already at depth = 0
-            ptrdiff_t x, y;
-
-            x = index + 1;
-            y = base;
-            while (--x != y) {
-                restore(pointers, content, x);
-            }
-
+            if (index > peak)
+                peak = index;
+            ptrdiff_t y = base;
+            nbRestored += index - y;
+            restoreEntries(index, y, StoreIsList<T>());
             index = y - 1;
-            base = (ptrdiff_t)pointers[y];
+            base = (ptrdiff_t)at(y).pointer;
         }
     }
+
+    ptrdiff_t getPeak() const { return max(peak, index); } ///< \return maximum number of trailed entries
+    Long getBytes() const { return (Long)segments.size() * (segmentMask + 1) * sizeof(Entry); } ///< \return memory allocated for the stack
+    Long getNbRestored() const { return nbRestored; } ///< \return number of trailed entries restored so far
 };
 
 /*
@@ -210,6 +259,10 @@ template <class T>
 class StoreBasic {
     T v;
 
+    friend class Store;
+    static thread_local StoreStack<T, T>* stack; // stack of the current trail context of the calling thread (see Store::selectStacks)
+    static StoreStack<T, T> depthZeroStack; // empty stack used when no trail context has been selected (always at depth zero, never trails anything)
+
 public:
     StoreBasic(T vv)
         : v(vv)
@@ -226,13 +279,10 @@ public:
     {
     }
 
-    static void store() { mystore.store(); };
-    static void restore() { mystore.restore(); };
-
     StoreBasic& operator=(const StoreBasic& elt)
     { ///< \note assignment has to be backtrackable
         if (&elt != this) {
-            mystore.store(&v);
+            mystore().store(&v);
             v = elt.v;
         }
         return *this;
@@ -240,89 +290,239 @@ public:
 
     StoreBasic& operator=(const T vv)
     {
-        mystore.store(&v);
+        mystore().store(&v);
         v = vv;
         return *this;
     }
     StoreBasic& operator+=(const T vv)
     {
-        mystore.store(&v);
+        mystore().store(&v);
         v += vv;
         return *this;
     }
     StoreBasic& operator-=(const T vv)
     {
-        mystore.store(&v);
+        mystore().store(&v);
         v -= vv;
         return *this;
     }
 
-    static StoreStack<T, T> mystore;
-};
+    static StoreStack<T, T>& mystore(); ///< \return the stack of the current trail context associated to type T
 
-template <class T>
-StoreStack<T, T> StoreBasic<T>::mystore(STORE_SIZE);
+    /// \brief trails n consecutive storable data and gives them as a plain array of T
+    /// \note the array can be modified directly (without trailing each element) until the next Store::store
+    static T* storeArray(StoreBasic* first, ptrdiff_t n)
+    {
+        mystore().storeArray(&first->v, n);
+        return &first->v;
+    }
+};
 
 typedef StoreBasic<Value> StoreValue;
 typedef StoreValue StoreInt;
 typedef StoreBasic<Cost> StoreCost;
 typedef StoreBasic<BigInteger> StoreBigInteger;
+typedef StoreBasic<uint64_t> StoreBits;
+
+// a vector of storable data is a plain contiguous array of the underlying type (old values are kept in the trailing stacks only)
+static_assert(sizeof(StoreCost) == sizeof(Cost), "StoreCost must have the same layout as Cost");
+static_assert(sizeof(StoreValue) == sizeof(Value), "StoreValue must have the same layout as Value");
 
 /*
- * Container for all storable stacks
+ * Trail context: container for all storable stacks of a solver instance
  */
-class Store {
-protected:
-    virtual ~Store() = 0; // Trick to avoid any instantiation of Store
+class StoreContext {
+    // make it private because we don't want copy nor assignment
+    StoreContext(const StoreContext& s);
+    StoreContext& operator=(const StoreContext& s);
 
 public:
-    static int depth;
-    static StoreStack<BTList<Value>, DLink<Value>*> storeDomain;
-    static StoreStack<BTList<ConstraintLink>, DLink<ConstraintLink>*> storeConstraint;
-    static StoreStack<BTList<Variable*>, DLink<Variable*>*> storeVariable;
-    static StoreStack<BTList<Separator*>, DLink<Separator*>*> storeSeparator;
+    int depth;
+    StoreStack<Value, Value> storeValue;
+#ifndef INT_COST
+    StoreStack<Cost, Cost> storeCost;
+#endif
+    StoreStack<BigInteger, BigInteger> storeBigInteger;
+    StoreStack<uint64_t, uint64_t> storeBits;
+    StoreStack<BTList<Value>, DLink<Value>*> storeDomain;
+    StoreStack<BTList<ConstraintLink>, DLink<ConstraintLink>*> storeConstraint;
+    StoreStack<BTList<Variable*>, DLink<Variable*>*> storeVariable;
+    StoreStack<BTList<Separator*>, DLink<Separator*>*> storeSeparator;
+
+    StoreContext(int powbckmemory = STORE_SIZE)
+        : depth(0)
+        , storeValue(powbckmemory)
+#ifndef INT_COST
+        , storeCost(powbckmemory)
+#endif
+        , storeBigInteger(powbckmemory)
+        , storeBits(powbckmemory)
+        , storeDomain(powbckmemory)
+        , storeConstraint(powbckmemory)
+        , storeVariable(powbckmemory)
+        , storeSeparator(powbckmemory)
+    {
+    }
 
-    /// \return the current (backtrack / tree search) depth
-    static int getDepth()
+    template <class T>
+    StoreStack<T, T>& getStack();
+
+    /// prints the peak number of entries, allocated memory and restored entries (also per second of the given time) of each stack
+    void printStats(ostream& os, double time)
     {
-        return depth;
+        printStats(os, time, "value", storeValue);
+#ifndef INT_COST
+        printStats(os, time, "cost", storeCost);
+#endif
+        printStats(os, time, "big integer", storeBigInteger);
+        printStats(os, time, "bitmask", storeBits);
+        printStats(os, time, "domain", storeDomain);
+        printStats(os, time, "constraint list", storeConstraint);
+        printStats(os, time, "variable list", storeVariable);
+        printStats(os, time, "separator list", storeSeparator);
+    }
+    template <class T, class V>
+    void printStats(ostream& os, double time, const char* name, const StoreStack<T, V>& s)
+    {
+        os << "c " << name << " stack: " << s.getPeak() << " peak entries, " << s.getBytes() << " Bytes, " << s.getNbRestored() << " restored entries";
+        if (time > 0)
+            os << " (" << (Long)(s.getNbRestored() / time) << " per second)";
+        os << endl;
     }
 
-    /// makes a copy of the current state
-    static void store()
+    void store()
     {
         depth++;
-        StoreValue::store();
-        StoreCost::store();
-        StoreBigInteger::store();
+        storeValue.store();
+#ifndef INT_COST
+        storeCost.store();
+#endif
+        storeBigInteger.store();
+        storeBits.store();
         storeDomain.store();
         storeConstraint.store();
         storeVariable.store();
         storeSeparator.store();
     }
 
-    /// restores the current state to the last copy
-    static void restore()
+    void restore()
     {
         depth--;
-        StoreValue::restore();
-        StoreCost::restore();
-        StoreBigInteger::restore();
+        storeValue.restore();
+#ifndef INT_COST
+        storeCost.restore();
+#endif
+        storeBigInteger.restore();
+        storeBits.restore();
         storeDomain.restore();
         storeConstraint.restore();
         storeVariable.restore();
         storeSeparator.restore();
     }
+};
+
+template <>
+inline StoreStack<Value, Value>& StoreContext::getStack<Value>() { return storeValue; }
+#ifndef INT_COST
+template <>
+inline StoreStack<Cost, Cost>& StoreContext::getStack<Cost>() { return storeCost; }
+#endif
+template <>
+inline StoreStack<BigInteger, BigInteger>& StoreContext::getStack<BigInteger>() { return storeBigInteger; }
+template <>
+inline StoreStack<uint64_t, uint64_t>& StoreContext::getStack<uint64_t>() { return storeBits; }
+
+/*
+ * Access to the current trail context of the calling thread
+ */
+class Store {
+protected:
+    virtual ~Store() = 0; // Trick to avoid any instantiation of Store
+
+    static thread_local StoreContext* current; // current trail context of the calling thread (NULL if not yet defined)
+    static thread_local StoreContext* defaultContext; // default trail context of the calling thread (NULL if not yet created)
+    static StoreContext* getDefaultContext(); // default trail context of the calling thread (created at first call)
+    static void selectStacks(StoreContext* context); // caches the stacks of the given trail context in each storable basic type (empty stacks if NULL)
+
+public:
+    /// \return the current trail context of the calling thread
+    static StoreContext* getContext()
+    {
+        if (!current) {
+            current = getDefaultContext();
+            selectStacks(current);
+        }
+        return current;
+    }
+
+    /// sets the current trail context of the calling thread (NULL to use its default context)
+    /// \return the previous current trail context
+    static StoreContext* setContext(StoreContext* context)
+    {
+        StoreContext* previous = current;
+        current = context;
+        selectStacks((context) ? context : defaultContext);
+        return previous;
+    }
+
+    /// \return the current (backtrack / tree search) depth
+    static int getDepth()
+    {
+        return getContext()->depth;
+    }
+
+    /// makes a copy of the current state
+    static void store()
+    {
+        getContext()->store();
+    }
+
+    /// restores the current state to the last copy
+    static void restore()
+    {
+        getContext()->restore();
+    }
 
     /// restore the current state to the copy made at depth \c newDepth
     static void restore(int newDepth)
     {
-        assert(depth >= newDepth);
-        while (depth > newDepth)
-            restore();
+        StoreContext* context = getContext();
+        assert(context->depth >= newDepth);
+        while (context->depth > newDepth)
+            context->restore();
     }
 };
 
+inline void Store::selectStacks(StoreContext* context)
+{
+    if (context) {
+        StoreBasic<Value>::stack = &context->storeValue;
+#ifndef INT_COST
+        StoreBasic<Cost>::stack = &context->storeCost;
+#endif
+        StoreBasic<BigInteger>::stack = &context->storeBigInteger;
+        StoreBasic<uint64_t>::stack = &context->storeBits;
+    } else {
+        StoreBasic<Value>::stack = &StoreBasic<Value>::depthZeroStack;
+#ifndef INT_COST
+        StoreBasic<Cost>::stack = &StoreBasic<Cost>::depthZeroStack;
+#endif
+        StoreBasic<BigInteger>::stack = &StoreBasic<BigInteger>::depthZeroStack;
+        StoreBasic<uint64_t>::stack = &StoreBasic<uint64_t>::depthZeroStack;
+    }
+}
+
+template <class T>
+StoreStack<T, T> StoreBasic<T>::depthZeroStack(0);
+template <class T>
+thread_local StoreStack<T, T>* StoreBasic<T>::stack = &StoreBasic<T>::depthZeroStack;
+
+template <class T>
+inline StoreStack<T, T>& StoreBasic<T>::mystore()
+{
+    return *stack;
+}
+
 #define storeIndexList storeDomain
 
 #endif /*TB2STORE_HPP_*/
@@ -12,6 +12,10 @@ const char* PrintFormatProb = "%Lf";
 #else
 const char* PrintFormatProb = "%lf";
 #endif
+
+#ifdef LINUX
+thread_local unsigned short myrandstate[3] = { 0x330E, 0xABCD, 0x1234 }; // default lrand48 initial state
+#endif
 /* --------------------------------------------------------------------
 // Timer management functions
 // -------------------------------------------------------------------- */
@@ -32,7 +36,7 @@ const char* PrintFormatProb = "%lf";
 
 double cpuTime()
 {
-    static struct rusage buf;
+    struct rusage buf;
 
     getrusage(RUSAGE_SELF, &buf);
     double res = (double)(buf.ru_utime.tv_sec + buf.ru_stime.tv_sec) + (buf.ru_utime.tv_usec + buf.ru_stime.tv_usec) / 1000000.;
@@ -66,16 +70,16 @@ void timeOut(int sig)
 
 static struct itimerval thetimer = { { 0, 0 }, { 0, 0 } };
 
-/* set a timer (in seconds) */
+/* set a timer (in seconds, using wall-clock time instead of cpu time if several solver threads are running in parallel) */
 void timer(int t)
 {
     ToulBar2::interrupted = false;
-    signal(SIGVTALRM, timeOut);
+    signal((ToulBar2::portfolio > 1) ? SIGALRM : SIGVTALRM, timeOut);
     thetimer.it_interval.tv_sec = 0;
     thetimer.it_interval.tv_usec = 0;
     thetimer.it_value.tv_sec = t;
     thetimer.it_value.tv_usec = 0;
-    setitimer(ITIMER_VIRTUAL, &thetimer, NULL);
+    setitimer((ToulBar2::portfolio > 1) ? ITIMER_REAL : ITIMER_VIRTUAL, &thetimer, NULL);
 }
 
 /* stop the current timer */
@@ -83,7 +87,7 @@ void timerStop()
 {
     thetimer.it_value.tv_sec = 0;
     thetimer.it_value.tv_usec = 0;
-    setitimer(ITIMER_VIRTUAL, &thetimer, NULL);
+    setitimer((ToulBar2::portfolio > 1) ? ITIMER_REAL : ITIMER_VIRTUAL, &thetimer, NULL);
     ToulBar2::interrupted = false;
 }
 
@@ -12,6 +12,12 @@
 #define FINAL
 #endif
 
+#ifdef __GNUC__
+#define ALWAYS_INLINE inline __attribute__((always_inline)) ///< \brief for small functions inside hot loops which the compiler may refuse to inline
+#else
+#define ALWAYS_INLINE inline
+#endif
+
 extern const char* PrintFormatProb;
 
 double cpuTime(); ///< \brief return CPU time in seconds with high resolution (microseconds) if available
@@ -62,13 +68,17 @@ const Long LONGLONG_MAX = 0x7FFFFFFFFFFFFFFFLL;
 typedef long double Double;
 
 #ifdef LINUX
+extern thread_local unsigned short myrandstate[3]; // random generator state of the calling thread (same sequence as lrand48)
 inline void mysrand(int seed)
 {
-    return srand48(seed);
+    // same initial state as srand48(seed)
+    myrandstate[0] = 0x330E;
+    myrandstate[1] = (unsigned short)seed;
+    myrandstate[2] = (unsigned short)((unsigned int)seed >> 16);
 }
-inline int myrand() { return lrand48(); }
-inline Long myrandl() { return (Long)((Long)lrand48() /**LONGLONG_MAX*/); }
-inline double mydrand() { return drand48(); }
+inline int myrand() { return nrand48(myrandstate); }
+inline Long myrandl() { return (Long)((Long)nrand48(myrandstate) /**LONGLONG_MAX*/); }
+inline double mydrand() { return erand48(myrandstate); }
 #endif
 #ifdef WINDOWS
 inline void mysrand(int seed)
@@ -0,0 +1,99 @@
+/** \file tb2tensor.hpp
+ *  \brief Dense cost table kernels used by variable elimination (see WCSP::sum, WCSP::project, and NaryConstraint::project).
+ *
+ * Convention:
+ *
+ * a dense table stores the costs of all the tuples of the initial domains of its scope in lexicographic order (last variable varies first)
+ *
+ * several dense tables are scanned together by enumerating the tuples of a common set of dimensions (variables),
+ * each dimension having a stride in each table (zero if the table does not depend on this variable)
+ *
+ * positions in the tables are updated incrementally (one addition per table and per tuple, no tuple to string conversion)
+ * and the last dimension is scanned in a tight inner loop
+ *
+ */
+
+#ifndef TB2TENSOR_HPP_
+#define TB2TENSOR_HPP_
+
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <cassert>
+
+template <size_t N>
+struct DenseDimension {
+    unsigned int size; ///< \brief initial domain size
+    std::vector<bool> available; ///< \brief true if the corresponding value index belongs to the current domain
+    std::array<ptrdiff_t, N> strides; ///< \brief stride in each table (zero if the table does not depend on this dimension)
+
+    /// \brief dimension of an enumerated variable with null strides
+    template <class V>
+    explicit DenseDimension(V* var)
+        : size(var->getDomainInitSize())
+        , available(size)
+        , strides()
+    {
+        for (unsigned int k = 0; k < size; k++)
+            available[k] = var->canbe(var->toValue(k));
+    }
+};
+
+/// \brief calls \a f(positions, available) for every tuple of the given dimensions in lexicographic order
+/// \param dims dimensions to be enumerated (at least one)
+/// \param origin positions in the tables of the first tuple
+/// \param f function called with the positions of the current tuple in each table and true if all its values are available
+template <size_t N, class F>
+void denseForEach(const std::vector<DenseDimension<N>>& dims, const std::array<ptrdiff_t, N>& origin, F f)
+{
+    int a = dims.size();
+    assert(a >= 1);
+    for (int i = 0; i < a; i++)
+        if (dims[i].size == 0)
+            return;
+    std::vector<unsigned int> t(a, 0);
+    std::array<ptrdiff_t, N> pos = origin;
+    int unavailable = 0; // number of unavailable values in the current tuple except the last dimension
+    for (int i = 0; i < a - 1; i++)
+        if (!dims[i].available[0])
+            unavailable++;
+    const DenseDimension<N>& last = dims[a - 1];
+    std::array<ptrdiff_t, N> p;
+    while (true) {
+        p = pos;
+        for (unsigned int k = 0; k < last.size; k++) {
+            f(p, unavailable == 0 && last.available[k]);
+            for (size_t j = 0; j < N; j++)
+                p[j] += last.strides[j];
+        }
+        int i = a - 2;
+        while (i >= 0 && t[i] == dims[i].size - 1) {
+            if (!dims[i].available[t[i]])
+                unavailable--;
+            for (size_t j = 0; j < N; j++)
+                pos[j] -= (ptrdiff_t)t[i] * dims[i].strides[j];
+            t[i] = 0;
+            if (!dims[i].available[0])
+                unavailable++;
+            i--;
+        }
+        if (i < 0)
+            return;
+        if (!dims[i].available[t[i]])
+            unavailable--;
+        t[i]++;
+        if (!dims[i].available[t[i]])
+            unavailable++;
+        for (size_t j = 0; j < N; j++)
+            pos[j] += dims[i].strides[j];
+    }
+}
+
+#endif /*TB2TENSOR_HPP_*/
+
+/* Local Variables: */
+/* c-basic-offset: 4 */
+/* tab-width: 4 */
+/* indent-tabs-mode: nil */
+/* c-default-style: "k&r" */
+/* End: */
@@ -0,0 +1,187 @@
+/** \file tb2tokenizer.hpp
+ *  \brief Streaming tokenizer used by the problem readers (see tb2reader.cpp).
+ *
+ * Convention:
+ *
+ * characters are read directly from the stream buffer of the input stream (plain file or gzip/xz decompressor)
+ * without copying lines, so that reading tokens and numbers does not allocate memory (the returned token reuses its capacity)
+ *
+ * since no character is consumed in advance, formatted input (\e operator>>) on the same stream can be freely mixed with the tokenizer
+ *
+ * a character is either a separator (skipped), a punctuation (a token by itself), or part of a token
+ *
+ * if comments are enabled, lines starting with '#' and the end of lines after "//" are skipped
+ *
+ */
+
+#ifndef TB2TOKENIZER_HPP_
+#define TB2TOKENIZER_HPP_
+
+#include "core/tb2types.hpp"
+
+const std::streamsize READ_BUFFER_SIZE = 1 << 20; ///< \brief size of the stream buffers used when reading problem files
+
+class StreamTokenizer {
+    enum CharKind {
+        TOKEN_CHAR = 0,
+        SEPARATOR_CHAR = 1,
+        PUNCTUATION_CHAR = 2
+    };
+
+    streambuf* buf;
+    unsigned char kind[256];
+    bool comments;
+    int line; // current line number starting from 1
+    bool lineStart; // true if no character of the current line has been read
+    bool slash; // true if a '/' starting the next token has been read by skip()
+
+    static int toChar(int c) { return (unsigned char)c; }
+
+    /// \brief consumes the current character and returns the next one
+    int advance(int c)
+    {
+        if (c == '\n') {
+            line++;
+            lineStart = true;
+        } else {
+            lineStart = false;
+        }
+        return buf->snextc();
+    }
+
+    /// \brief skips until the end of the current line (excluded) and returns the next character
+    int skipLine()
+    {
+        int c = buf->sgetc();
+        while (c != EOF && c != '\n')
+            c = buf->snextc();
+        return c;
+    }
+
+    /// \brief skips separators and comments and returns the first character of the next token (or EOF)
+    /// \note a single '/' already consumed is reported in \e slash
+    int skip()
+    {
+        int c = buf->sgetc();
+        while (c != EOF) {
+            if (comments && c == '#' && lineStart) {
+                c = skipLine();
+            } else if (comments && c == '/') {
+                lineStart = false;
+                c = buf->snextc();
+                if (c == '/') {
+                    c = skipLine();
+                } else {
+                    slash = true;
+                    return c;
+                }
+            } else if (kind[toChar(c)] == SEPARATOR_CHAR) {
+                c = advance(c);
+            } else {
+                return c;
+            }
+        }
+        return c;
+    }
+
+public:
+    /// \param is input stream to be tokenized
+    /// \param separators characters separating tokens (the end of line is always a separator)
+    /// \param punctuation characters forming a token by themselves
+    /// \param comments_ if true then skips comments
+    StreamTokenizer(istream& is, const char* separators = " \t\n\r\f\v", const char* punctuation = "", bool comments_ = false)
+        : buf(is.rdbuf())
+        , comments(comments_)
+        , line(1)
+        , lineStart(true)
+        , slash(false)
+    {
+        memset(kind, TOKEN_CHAR, sizeof(kind));
+        for (const char* s = separators; *s; s++)
+            kind[toChar(*s)] = SEPARATOR_CHAR;
+        for (const char* s = punctuation; *s; s++)
+            kind[toChar(*s)] = PUNCTUATION_CHAR;
+        kind[toChar('\n')] = SEPARATOR_CHAR;
+    }
+
+    int getLine() const { return line; }
+
+    /// \brief reads the next token
+    /// \return the line number of the token or -1 at the end of the stream (with an empty token)
+    int next(string& token)
+    {
+        token.clear();
+        int c = skip();
+        int tokenLine = line;
+        if (slash) {
+            slash = false;
+            token.push_back('/');
+        } else if (c == EOF) {
+            return -1;
+        } else if (kind[toChar(c)] == PUNCTUATION_CHAR) {
+            token.push_back(c);
+            advance(c);
+            return tokenLine;
+        }
+        while (c != EOF && kind[toChar(c)] == TOKEN_CHAR) {
+            if (comments && c == '/') {
+                c = buf->snextc();
+                if (c == '/') {
+                    skipLine();
+                    return tokenLine;
+                }
+                token.push_back('/');
+                continue;
+            }
+            token.push_back(c);
+            c = advance(c);
+        }
+        return tokenLine;
+    }
+
+    /// \brief reads a signed integer in decimal notation as with \e operator>>
+    /// \return false if the next token does not start with an integer (only a sign may have been read)
+    template <class T>
+    bool readInteger(T& x)
+    {
+        int c = skip();
+        bool negative = (c == '-');
+        if (c == '-' || c == '+') {
+            c = buf->snextc();
+            if (c == EOF || !isdigit(c))
+                return false;
+        } else if (c == EOF || !isdigit(c)) {
+            return false;
+        }
+        T value = 0;
+        do {
+            value = value * 10 + (c - '0');
+            c = advance(c);
+        } while (c != EOF && isdigit(c));
+        x = (negative) ? -value : value;
+        return true;
+    }
+
+    bool read(int& x) { return readInteger(x); }
+    bool read(unsigned int& x) { return readInteger(x); }
+    bool read(Long& x) { return readInteger(x); }
+
+    /// \brief reads any other type by its \e operator>> directly from the stream buffer
+    template <class T>
+    bool read(T& x)
+    {
+        skip();
+        istream is(buf);
+        is >> x;
+        return !is.fail();
+    }
+};
+
+#endif /*TB2TOKENIZER_HPP_*/
+
+/* Local Variables: */
+/* c-basic-offset: 4 */
+/* tab-width: 4 */
+/* indent-tabs-mode: nil */
+/* c-default-style: "k&r" */
+/* End: */
@@ -0,0 +1,167 @@
+/** \file tb2tuplemap.hpp
+ *  \brief Hash table of tuples for sparse cost functions.
+ *
+ * Convention:
+ *
+ * tuples are stored contiguously in insertion order with the hash code of their String
+ * an open-addressing table (linear probing) gives the position of each tuple in this array
+ * a stored hash code is compared before the String itself, so a lookup usually makes one String comparison
+ *
+ * tuples cannot be removed individually (only clear())
+ * sort() reorders the tuples lexicographically (for read-only tables which need an ordered traversal)
+ *
+ */
+
+#ifndef TB2TUPLEMAP_HPP_
+#define TB2TUPLEMAP_HPP_
+
+#include "tb2utils.hpp"
+
+// FNV-1a hash function on tuples (also usable with std::unordered_map)
+struct TupleHash {
+    static const size_t first = (size_t)UINT64_C(14695981039346656037); ///< \brief hash code of an empty sequence
+    static size_t add(size_t h, size_t x) { return (h ^ x) * (size_t)UINT64_C(1099511628211); } ///< \brief hash code of a sequence extended by \a x
+
+    size_t operator()(const String& t) const
+    {
+        size_t h = first;
+        for (size_t i = 0; i < t.size(); i++) {
+            h = add(h, (size_t)t[i]);
+        }
+        return h;
+    }
+};
+
+template <class T>
+class TupleMap {
+public:
+    typedef pair<String, T> value_type;
+    typedef typename vector<value_type>::iterator iterator;
+    typedef typename vector<value_type>::const_iterator const_iterator;
+
+private:
+    vector<value_type> tuples; // tuples and their associated values in insertion order (or lexicographic order after sort())
+    vector<size_t> codes; // codes[i] is the hash code of tuples[i].first
+    vector<ptrdiff_t> slots; // position in tuples or -1 if empty, size is a power of two
+    size_t mask; // slots.size() - 1
+
+    static size_t hashCode(const String& t) { return TupleHash()(t); }
+
+    // returns the slot containing t or the first empty slot where t should be inserted
+    size_t lookup(const String& t, size_t code) const
+    {
+        size_t s = code & mask;
+        while (slots[s] >= 0 && (codes[slots[s]] != code || tuples[slots[s]].first != t)) {
+            s = (s + 1) & mask;
+        }
+        return s;
+    }
+
+    void rehash(size_t nbslots)
+    {
+        assert((nbslots & (nbslots - 1)) == 0);
+        slots.assign(nbslots, -1);
+        mask = nbslots - 1;
+        for (size_t i = 0; i < tuples.size(); i++) {
+            size_t s = codes[i] & mask;
+            while (slots[s] >= 0) {
+                s = (s + 1) & mask;
+            }
+            slots[s] = i;
+        }
+    }
+
+public:
+    TupleMap()
+        : slots(16, -1)
+        , mask(15)
+    {
+    }
+
+    size_t size() const { return tuples.size(); }
+    bool empty() const { return tuples.empty(); }
+
+    iterator begin() { return tuples.begin(); }
+    iterator end() { return tuples.end(); }
+    const_iterator begin() const { return tuples.begin(); }
+    const_iterator end() const { return tuples.end(); }
+
+    void clear()
+    {
+        tuples.clear();
+        codes.clear();
+        slots.assign(16, -1);
+        mask = 15;
+    }
+
+    // prepares the table to hold n tuples without rehashing
+    void reserve(size_t n)
+    {
+        tuples.reserve(n);
+        codes.reserve(n);
+        size_t nbslots = slots.size();
+        while (nbslots < 2 * n)
+            nbslots *= 2;
+        if (nbslots > slots.size())
+            rehash(nbslots);
+    }
+
+    iterator find(const String& t)
+    {
+        ptrdiff_t pos = slots[lookup(t, hashCode(t))];
+        return (pos >= 0) ? (tuples.begin() + pos) : tuples.end();
+    }
+
+    const_iterator find(const String& t) const
+    {
+        ptrdiff_t pos = slots[lookup(t, hashCode(t))];
+        return (pos >= 0) ? (tuples.begin() + pos) : tuples.end();
+    }
+
+    T& operator[](const String& t)
+    {
+        size_t code = hashCode(t);
+        size_t s = lookup(t, code);
+        if (slots[s] >= 0)
+            return tuples[slots[s]].second;
+        slots[s] = tuples.size();
+        tuples.push_back(value_type(t, T()));
+        codes.push_back(code);
+        if (2 * tuples.size() > slots.size()) { // keeps load factor below 1/2
+            rehash(2 * slots.size());
+        }
+        return tuples.back().second;
+    }
+
+    // sorts tuples in lexicographic order (invalidates iterators)
+    void sort()
+    {
+        vector<size_t> order(tuples.size());
+        for (size_t i = 0; i < order.size(); i++)
+            order[i] = i;
+        std::sort(order.begin(), order.end(), [this](size_t i, size_t j) { return tuples[i].first < tuples[j].first; });
+        vector<value_type> sortedtuples;
+        vector<size_t> sortedcodes;
+        sortedtuples.reserve(tuples.size());
+        sortedcodes.reserve(codes.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            sortedtuples.push_back(tuples[order[i]]);
+            sortedcodes.push_back(codes[order[i]]);
+        }
+        tuples.swap(sortedtuples);
+        codes.swap(sortedcodes);
+        rehash(slots.size());
+    }
+
+    // memory space used by the table (not taking into account String space overhead)
+    Long space() const { return (Long)tuples.capacity() * sizeof(value_type) + (Long)codes.capacity() * sizeof(size_t) + (Long)slots.size() * sizeof(ptrdiff_t); }
+};
+
+#endif /*TB2TUPLEMAP_HPP_*/
+
+/* Local Variables: */
+/* c-basic-offset: 4 */
+/* tab-width: 4 */
+/* indent-tabs-mode: nil */
+/* c-default-style: "k&r" */
+/* End: */
@@ -28,12 +28,14 @@
 #include <limits>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <sstream>
 #include <set>
 #include <list>
 #include <queue>
 #include <stack>
 #include <functional>
+#include <atomic>
 #include <algorithm>
 #include <numeric>
 using namespace std;
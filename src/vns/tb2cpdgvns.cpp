@@ -8,7 +8,7 @@
 
 #include "tb2cpdgvns.hpp"
 #include "core/tb2wcsp.hpp"
-#ifdef OPENMPI
+#ifdef BOOST
 
 // Conversion Tools
 // Solution to Message
@@ -83,11 +83,11 @@ bool CooperativeParallelDGVNS::solve()
             endSolve(lastUb < MAX_COST, lastUb, true);
         }
         /* Shut down MPI */
-        MPI_Finalize();
+        pdgvnsFinalize();
         return (lastUb < MAX_COST);
     }
 
-    MPI_Barrier(MPI_COMM_WORLD); /* IMPORTANT */
+    pdgvnsBarrier(); /* IMPORTANT */
 
     env0.buffsize = (int)wcsp->numberOfVariables() + 107; // 3 : cluster + k + cost, second time, msecond time, localtime,the rest is the size of solution
     env0.sendbuff = new int[env0.buffsize];
@@ -104,13 +104,13 @@ bool CooperativeParallelDGVNS::solve()
         slave();
     }
 
-    if (ToulBar2::vnsOutput)
+    if (ToulBar2::vnsOutput && env0.myrank == 0)
         ToulBar2::vnsOutput << "Search end"
                             << " " << cpuTime() << endl;
 
     /* Shut down MPI */
-    //    MPI_Barrier(MPI_COMM_WORLD); /* IMPORTANT */
-    MPI_Finalize();
+    //    pdgvnsBarrier(); /* IMPORTANT */
+    pdgvnsFinalize();
 
     return (bestUb < MAX_COST);
 }
@@ -124,7 +124,7 @@ void CooperativeParallelDGVNS::master()
 
     // MPI data
     int rank;
-    MPI_Status status;
+    int source, tag;
 
     // verify the number of processes and number of clusters
     if (env0.ntasks > h->getSize()) {
@@ -139,7 +139,7 @@ void CooperativeParallelDGVNS::master()
     bestSolution.clear();
     bestUb = generateInitSolution(ToulBar2::vnsInitSol, bestSolution, complete);
     BestTimeS = (int)cpuTime();
-    BestTimeMS = (int)(((Long)cpuTime() * 1000LL) % 1000LL);
+    BestTimeMS = (int)(((Long)(cpuTime() * 1000.)) % 1000LL);
     // Get all clusters from the tree decomposition of constraint graph
     file = h->getClustersIndex();
 
@@ -159,12 +159,7 @@ void CooperativeParallelDGVNS::master()
             BestTimeMS, bestSolution);
 
         /* Send Initial Solution to each process */
-        MPI_Send(&env0.sendbuff[0], /* message buffer */
-            env0.buffsize, /* buffer size */
-            MPI_INT, /* data item is an integer */
-            rank, /* destination process rank */
-            WORKTAG, /* user chosen message tag */
-            MPI_COMM_WORLD); /* default communicator */
+        pdgvnsSend(&env0.sendbuff[0], env0.buffsize, rank, WORKTAG);
     }
 
     /* Loop over getting new Best Solutions */
@@ -174,13 +169,7 @@ void CooperativeParallelDGVNS::master()
     while (finished < worker) {
 
         /* Receive result (new better solution) from a slave */
-        MPI_Recv(&env0.recvbuff[0], /* message buffer */
-            env0.buffsize, /* size of data */
-            MPI_INT, /* data item is an integer */
-            MPI_ANY_SOURCE, /* receive from any sender */
-            MPI_ANY_TAG, /* any type of message */
-            MPI_COMM_WORLD, /* default communicator */
-            &status); /* info about the received message */
+        pdgvnsRecv(&env0.recvbuff[0], env0.buffsize, PDGVNS_ANY_SOURCE, source, tag);
         /* setting up the best solution in memory, and checkout if we continue or not */
         // Parsing the received buffer
         uint scluster = 0;
@@ -198,8 +187,7 @@ void CooperativeParallelDGVNS::master()
         file.push_back(scluster);
         scluster = getCluster();
         //Updating
-        if (sbestUb <= bestUb
-            && !(BestTimeS == sBestTimeS && BestTimeMS == sBestTimeMS)) {
+        if (sbestUb < bestUb || (sbestUb == bestUb && !(BestTimeS == sBestTimeS && BestTimeMS == sBestTimeMS))) {
             bestUb = sbestUb;
             BestTimeS = sBestTimeS;
             BestTimeMS = sBestTimeMS;
@@ -210,7 +198,7 @@ void CooperativeParallelDGVNS::master()
                 skmax = h->getClustersSize(scluster, snumberclu);
             }
             for (uint v = 0; v < wcsp->numberOfVariables(); v++) {
-                bestSolution[v] = lastSolution[v];
+                bestSolution[v] = slastSolution[v];
             }
             if (ToulBar2::vnsOutput) {
                 ToulBar2::vnsOutput
@@ -248,28 +236,22 @@ void CooperativeParallelDGVNS::master()
             SolToMsg(env0, scluster, snumberclu, ToulBar2::vnsKmin, skmax, bestUb,
                 BestTimeS, BestTimeMS, bestSolution);
             /* Send the best solution to the received slave, for next the search */
-            MPI_Send(&env0.sendbuff[0], /* message buffer */
-                env0.buffsize, /* size of data */
-                MPI_INT, /* data item is an integer */
-                status.MPI_SOURCE, /* to who we just received from */
-                WORKTAG, /* user chosen message tag */
-                MPI_COMM_WORLD); /* default communicator */
+            pdgvnsSend(&env0.sendbuff[0], env0.buffsize, source, WORKTAG);
         } else {
             finished++;
-            MPI_Send(0, 0, MPI_INT, status.MPI_SOURCE, DIETAG, MPI_COMM_WORLD);
+            pdgvnsSend(NULL, 0, source, DIETAG);
         }
     }
-    MPI_Request requests[env0.ntasks];
     for (rank = 1; rank < env0.ntasks; ++rank) {
         //printf("Send finish empty msg to finish with %d\n",rank);
-        MPI_Isend(0, 0, MPI_INT, rank, DIETAG, MPI_COMM_WORLD, &requests[rank]);
+        pdgvnsSend(NULL, 0, rank, DIETAG);
     }
 }
 
 void CooperativeParallelDGVNS::slave()
 {
 
-    MPI_Status status;
+    int source, tag;
 
     // Structure de voisinage basée sur la notion des clusters
     //ParallelRandomClusterChoice* h = NeighborhoodStructure::NeighborhoodStructureFactory(VariableHeuristic(hname), static_cast<WCSP*>(wcsp), this);
@@ -287,16 +269,10 @@ void CooperativeParallelDGVNS::slave()
     wcsp->setUb(MAX_COST);
     while (true) {
         /* Receive a message from the master */
-        MPI_Recv(&env0.recvbuff[0], /* message buffer */
-            env0.buffsize, /* one data item */
-            MPI_INT, /* of type integer */
-            0, /* receive from master */
-            MPI_ANY_TAG, /* any type of message */
-            MPI_COMM_WORLD, /* default communicator */
-            &status); /* info about the received message */
+        pdgvnsRecv(&env0.recvbuff[0], env0.buffsize, 0, source, tag);
         //cout << env0.myrank <<" slave begin" << endl ;
         /* Check the tag of the received message. */
-        if (status.MPI_TAG == DIETAG) {
+        if (tag == DIETAG) {
             return;
         }
 
@@ -304,9 +280,7 @@ void CooperativeParallelDGVNS::slave()
         VnsLdsCP(env0, btime, h);
 
         /* Send the result back */
-        MPI_Request request;
-        MPI_Isend(&env0.sendbuff[0], env0.buffsize, MPI_INT, 0, 0,
-            MPI_COMM_WORLD, &request);
+        pdgvnsSend(&env0.sendbuff[0], env0.buffsize, 0, 0);
 
         //cout << env0.myrank <<" slave end" << endl ;
     }
@@ -356,7 +330,7 @@ void CooperativeParallelDGVNS::VnsLdsCP(MPIEnv& env0, double btime, ParallelRand
             int v = *iter;
             if (neighborhood.find(v) == neighborhood.end()) {
                 variables.push_back(v);
-                values.push_back(lastSolution[v]);
+                values.push_back(bestSolution[v]);
             }
         }
         //repair
@@ -371,7 +345,7 @@ void CooperativeParallelDGVNS::VnsLdsCP(MPIEnv& env0, double btime, ParallelRand
         } else {
             bestUb = lastUb;
             BestTimeS = (int)cpuTime();
-            BestTimeMS = (int)(((Long)cpuTime() * 1000LL) % 1000LL);
+            BestTimeMS = (int)(((Long)(cpuTime() * 1000.)) % 1000LL);
             k = kinit;
             for (uint v = 0; v < wcsp->numberOfVariables(); v++) {
                 bestSolution[v] = lastSolution[v];
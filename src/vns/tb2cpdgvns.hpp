@@ -8,37 +8,10 @@
 
 #ifndef TB2CPDGVNS_HPP_
 #define TB2CPDGVNS_HPP_
-#ifdef OPENMPI
-
-//#include <omp.h> // include OpenMP Header for parallel execution
-#include <mpi.h> // include MPI Header for parallel execution
+#ifdef BOOST
 
 #include "tb2vns.hpp"
-
-// MPI definitions
-const int WORKTAG = 1; // also used to return the search was complete
-const int DIETAG = 2;
-
-inline bool MPI_interrupted()
-{
-    MPI_Status status;
-    int flag = 0;
-    MPI_Iprobe(MPI_ANY_SOURCE, DIETAG, MPI_COMM_WORLD, &flag, &status);
-    return flag;
-}
-
-typedef int* unit_of_work_t;
-typedef int* unit_result_t;
-
-class MPIEnv {
-public:
-    int ntasks;
-    int myrank; // rang du processus
-    int processes; // number of process to be initialize according to the number of cluster
-    int buffsize;
-    int* sendbuff;
-    int* recvbuff;
-};
+#include "tb2pdgvnscomm.hpp"
 
 class NeighborhoodStructure;
 class ParallelRandomClusterChoice;
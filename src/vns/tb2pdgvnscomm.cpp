@@ -0,0 +1,260 @@
+/*
+ * ****** Message passing between the master and the slaves of parallel DGVNS methods *******
+ */
+
+#include "tb2pdgvnscomm.hpp"
+#include "search/tb2solver.hpp"
+#include "core/tb2wcsp.hpp"
+#ifdef OPENMPI
+#include <mpi.h>
+#else
+#include <chrono>
+#ifdef LINUX
+#include <signal.h>
+#endif
+#endif
+
+#ifdef OPENMPI
+
+void pdgvnsGetEnv(MPIEnv& env0)
+{
+    MPI_Comm_size(MPI_COMM_WORLD, &env0.ntasks);
+    MPI_Comm_rank(MPI_COMM_WORLD, &env0.myrank);
+}
+
+void pdgvnsSend(const int* buff, int size, int dest, int tag)
+{
+    int myrank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &myrank);
+    if (myrank == 0) {
+        MPI_Send((void*)buff, size, MPI_INT, dest, tag, MPI_COMM_WORLD);
+    } else { // the master may not receive the last result of a slave
+        MPI_Request request;
+        MPI_Isend((void*)buff, size, MPI_INT, dest, tag, MPI_COMM_WORLD, &request);
+        MPI_Request_free(&request);
+    }
+}
+
+void pdgvnsRecv(int* buff, int size, int source, int& from, int& tag)
+{
+    MPI_Status status;
+    MPI_Recv(buff, size, MPI_INT, (source == PDGVNS_ANY_SOURCE) ? MPI_ANY_SOURCE : source, MPI_ANY_TAG, MPI_COMM_WORLD, &status);
+    from = status.MPI_SOURCE;
+    tag = status.MPI_TAG;
+}
+
+bool pdgvnsInterrupted()
+{
+    MPI_Status status;
+    int flag = 0;
+    MPI_Iprobe(MPI_ANY_SOURCE, DIETAG, MPI_COMM_WORLD, &flag, &status);
+    return flag;
+}
+
+void pdgvnsBarrier()
+{
+    MPI_Barrier(MPI_COMM_WORLD);
+}
+
+double pdgvnsWtime()
+{
+    return MPI_Wtime();
+}
+
+double pdgvnsTotalCpuTime()
+{
+    double elapsedCPUTime = cpuTime() - ToulBar2::startCpuTime;
+    double totalCPUTime = 0.;
+    MPI_Reduce(&elapsedCPUTime, &totalCPUTime, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    return totalCPUTime;
+}
+
+void pdgvnsFinalize()
+{
+    MPI_Finalize();
+}
+
+#else
+
+static ParallelDGVNSThreads* pdgvnsThreads = NULL; // master and slaves of the current parallel DGVNS (NULL if none)
+static thread_local int pdgvnsRank = 0; // rank of the calling thread (zero for the master)
+
+ParallelDGVNSThreads::ParallelDGVNSThreads(int nbThreads_, Loader loader_)
+    : loader(loader_)
+    , nbThreads(nbThreads_)
+    , mailboxes(new Mailbox[nbThreads_])
+    , stop(false)
+    , nbReady(0)
+    , nbWaiting(0)
+    , barrierGeneration(0)
+{
+    assert(nbThreads >= 1);
+    assert(pdgvnsThreads == NULL);
+    pdgvnsThreads = this;
+    tb2getOptions(options);
+    for (int rank = 1; rank < nbThreads; rank++) {
+        slaves.push_back(std::thread(&ParallelDGVNSThreads::run, this, rank));
+    }
+    // wait until every helper thread has its own copy of the options before letting the calling thread modify them
+    std::unique_lock<std::mutex> lock(readyMutex);
+    readyCondition.wait(lock, [this] { return nbReady == nbThreads - 1; });
+    if (ToulBar2::verbose >= 0)
+        cout << "Parallel DGVNS with " << nbThreads << " threads." << endl;
+}
+
+ParallelDGVNSThreads::~ParallelDGVNSThreads()
+{
+    // releases the slaves still searching or waiting for a message or at a barrier
+    ToulBar2::interrupted = true;
+    stop = true;
+    for (int rank = 0; rank < nbThreads; rank++) {
+        std::lock_guard<std::mutex> lock(mailboxes[rank].mutex);
+        mailboxes[rank].arrived.notify_all();
+    }
+    {
+        std::lock_guard<std::mutex> lock(barrierMutex);
+        barrierCondition.notify_all();
+    }
+    for (vector<std::thread>::iterator iter = slaves.begin(); iter != slaves.end(); ++iter) {
+        iter->join();
+    }
+    ToulBar2::interrupted = false;
+    delete[] mailboxes;
+    pdgvnsThreads = NULL;
+}
+
+void ParallelDGVNSThreads::run(int rank)
+{
+    pdgvnsRank = rank;
+#ifdef LINUX
+    // time limit and user interruption are handled by the calling thread only
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGALRM);
+    sigaddset(&signals, SIGVTALRM);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, NULL);
+#endif
+    tb2setOptions(options);
+    {
+        std::lock_guard<std::mutex> lock(readyMutex);
+        nbReady++;
+    }
+    readyCondition.notify_one();
+
+    // slaves are silent and do not write any file (same as MPI slave processes)
+    ToulBar2::verbose = -1;
+    ToulBar2::showSolutions = 0;
+    ToulBar2::writeSolution = NULL;
+    ToulBar2::solutionFile = NULL;
+    ToulBar2::solution_uai_file = NULL;
+    ToulBar2::uaieval = false;
+    ToulBar2::maxsateval = false;
+    ToulBar2::dumpWCSP = 0;
+    ToulBar2::newsolution = NULL;
+    ToulBar2::incop_cmd = "";
+
+    WeightedCSPSolver* solver = WeightedCSPSolver::makeWeightedCSPSolver(MAX_COST);
+    try {
+        loader(solver);
+        if (!stop)
+            solver->solve();
+    } catch (Contradiction) {
+    } catch (TimeOut) {
+    }
+    delete solver;
+}
+
+void pdgvnsGetEnv(MPIEnv& env0)
+{
+    env0.ntasks = (pdgvnsThreads) ? pdgvnsThreads->nbThreads : max(1, ToulBar2::portfolio);
+    env0.myrank = pdgvnsRank;
+}
+
+void pdgvnsSend(const int* buff, int size, int dest, int tag)
+{
+    assert(pdgvnsThreads);
+    assert(dest >= 0 && dest < pdgvnsThreads->nbThreads);
+    ParallelDGVNSThreads::Mailbox& mailbox = pdgvnsThreads->mailboxes[dest];
+    {
+        std::lock_guard<std::mutex> lock(mailbox.mutex);
+        mailbox.messages.push_back(ParallelDGVNSThreads::Message());
+        ParallelDGVNSThreads::Message& msg = mailbox.messages.back();
+        msg.source = pdgvnsRank;
+        msg.tag = tag;
+        msg.data.assign(buff, buff + size);
+        if (tag == DIETAG)
+            mailbox.nbDie++;
+    }
+    mailbox.arrived.notify_one();
+}
+
+void pdgvnsRecv(int* buff, int size, int source, int& from, int& tag)
+{
+    assert(pdgvnsThreads);
+    ParallelDGVNSThreads::Mailbox& mailbox = pdgvnsThreads->mailboxes[pdgvnsRank];
+    std::unique_lock<std::mutex> lock(mailbox.mutex);
+    std::deque<ParallelDGVNSThreads::Message>::iterator msg;
+    mailbox.arrived.wait(lock, [&] {
+        for (msg = mailbox.messages.begin(); msg != mailbox.messages.end(); ++msg) {
+            if (source == PDGVNS_ANY_SOURCE || msg->source == source)
+                return true;
+        }
+        return (bool)pdgvnsThreads->stop;
+    });
+    if (msg == mailbox.messages.end()) { // the master has ended
+        from = 0;
+        tag = DIETAG;
+        return;
+    }
+    from = msg->source;
+    tag = msg->tag;
+    std::copy(msg->data.begin(), msg->data.begin() + min(size, (int)msg->data.size()), buff);
+    if (tag == DIETAG)
+        mailbox.nbDie--;
+    mailbox.messages.erase(msg);
+}
+
+bool pdgvnsInterrupted()
+{
+    return pdgvnsThreads && (pdgvnsThreads->mailboxes[pdgvnsRank].nbDie > 0 || pdgvnsThreads->stop);
+}
+
+void pdgvnsBarrier()
+{
+    assert(pdgvnsThreads);
+    std::unique_lock<std::mutex> lock(pdgvnsThreads->barrierMutex);
+    int generation = pdgvnsThreads->barrierGeneration;
+    if (++pdgvnsThreads->nbWaiting == pdgvnsThreads->nbThreads) {
+        pdgvnsThreads->nbWaiting = 0;
+        pdgvnsThreads->barrierGeneration++;
+        pdgvnsThreads->barrierCondition.notify_all();
+    } else {
+        pdgvnsThreads->barrierCondition.wait(lock, [generation] { return pdgvnsThreads->barrierGeneration != generation || pdgvnsThreads->stop; });
+    }
+}
+
+double pdgvnsWtime()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+double pdgvnsTotalCpuTime()
+{
+    pdgvnsBarrier();
+    return cpuTime() - ToulBar2::startCpuTime; // already counts all the threads of the process
+}
+
+void pdgvnsFinalize()
+{
+}
+
+#endif
+
+/* Local Variables: */
+/* c-basic-offset: 4 */
+/* tab-width: 4 */
+/* indent-tabs-mode: nil */
+/* c-default-style: "k&r" */
+/* End: */
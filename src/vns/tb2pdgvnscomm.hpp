@@ -0,0 +1,130 @@
+/** \file tb2pdgvnscomm.hpp
+ *  \brief Message passing between the master and the slaves of parallel DGVNS methods (see CooperativeParallelDGVNS and ReplicatedParallelDGVNS).
+ *
+ *  A message is a buffer of integers (see MPIEnv::sendbuff and MPIEnv::recvbuff) with a tag (::WORKTAG or ::DIETAG).
+ *
+ *  If compiled with OpenMPI, the master and the slaves are MPI processes (usage: "mpirun -n [NbOfProcess] toulbar2 -vns problem.wcsp").
+ *  Otherwise, they are threads of the same process (usage: "toulbar2 -vns -para=[NbOfThreads] problem.wcsp"):
+ *  the calling thread is the master and each helper thread is a slave solving its own copy of the problem (see ParallelDGVNSThreads).
+ *
+ *  \note with threads, every process rank has its own mailbox and a pending ::DIETAG message is detected without locking during search (see ::pdgvnsInterrupted)
+ */
+
+#ifndef TB2PDGVNSCOMM_HPP_
+#define TB2PDGVNSCOMM_HPP_
+
+#include "core/tb2types.hpp"
+
+#ifndef OPENMPI
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <functional>
+#endif
+
+// message tags
+const int WORKTAG = 1; // also used to return the search was complete
+const int DIETAG = 2;
+
+const int PDGVNS_ANY_SOURCE = -1; ///< \brief receives a message from any process (see ::pdgvnsRecv)
+
+typedef int* unit_of_work_t;
+typedef int* unit_result_t;
+
+class MPIEnv {
+public:
+    int ntasks;
+    int myrank; // rang du processus
+    int processes; // number of process to be initialize according to the number of cluster
+    int buffsize;
+    int* sendbuff;
+    int* recvbuff;
+};
+
+void pdgvnsGetEnv(MPIEnv& env0); ///< \brief sets the number of processes and the rank of the calling process
+void pdgvnsSend(const int* buff, int size, int dest, int tag); ///< \brief sends \a size integers to process \a dest (slaves do not wait for the reception by the master)
+/// \brief waits for a message from process \a source (or ::PDGVNS_ANY_SOURCE) and copies at most \a size integers into \a buff
+/// \param from process which sent the message
+/// \param tag tag of the message
+void pdgvnsRecv(int* buff, int size, int source, int& from, int& tag);
+bool pdgvnsInterrupted(); ///< \brief true if a ::DIETAG message is waiting for the calling process
+void pdgvnsBarrier(); ///< \brief waits until all the processes reach this barrier
+double pdgvnsWtime(); ///< \brief elapsed real time in seconds (only differences are meaningful)
+double pdgvnsTotalCpuTime(); ///< \brief CPU time used by all the processes since ToulBar2::startCpuTime (result on the master only, must be called by all the processes)
+void pdgvnsFinalize(); ///< \brief ends message passing for the calling process
+
+#ifndef OPENMPI
+class WeightedCSPSolver;
+
+/** Master and slaves of parallel DGVNS running in threads of the same process
+ *
+ *  The calling thread (rank 0) is the master. Every helper thread (rank 1 to \e nbThreads-1) copies ToulBar2 global variables of the calling thread,
+ *  reads its own copy of the problem and runs the slave side of the parallel DGVNS method selected by ToulBar2::searchMethod.
+ *
+ *  \warning must be created before the calling thread reads the problem (ToulBar2 global variables are copied at creation)
+ *  \warning helper threads are silent and do not write any file
+ */
+class ParallelDGVNSThreads {
+public:
+    typedef std::function<void(WeightedCSPSolver*)> Loader; ///< \brief reads the problem into a new solver
+
+private:
+    struct Message {
+        int source;
+        int tag;
+        vector<int> data;
+    };
+
+    struct Mailbox {
+        std::mutex mutex;
+        std::condition_variable arrived;
+        std::deque<Message> messages; // in order of arrival
+        std::atomic<int> nbDie; // number of pending DIETAG messages (polled without locking)
+        Mailbox()
+            : nbDie(0)
+        {
+        }
+    };
+
+    Loader loader;
+    vector<const void*> options; // ToulBar2 global variables of the calling thread
+    vector<std::thread> slaves;
+    int nbThreads;
+    Mailbox* mailboxes; // one per rank
+    std::atomic<bool> stop; // true if the master has ended (waiting slaves are released)
+
+    std::mutex readyMutex;
+    std::condition_variable readyCondition;
+    int nbReady; // number of helper threads having copied the ToulBar2 global variables
+
+    std::mutex barrierMutex;
+    std::condition_variable barrierCondition;
+    int nbWaiting; // number of threads waiting at the current barrier
+    int barrierGeneration;
+
+    void run(int rank);
+
+    friend void pdgvnsGetEnv(MPIEnv& env0);
+    friend void pdgvnsSend(const int* buff, int size, int dest, int tag);
+    friend void pdgvnsRecv(int* buff, int size, int source, int& from, int& tag);
+    friend bool pdgvnsInterrupted();
+    friend void pdgvnsBarrier();
+
+public:
+    /// \param nbThreads_ total number of processes including the master (calling thread)
+    /// \param loader_ function used by each helper thread to read its own copy of the problem
+    ParallelDGVNSThreads(int nbThreads_, Loader loader_);
+    ~ParallelDGVNSThreads(); ///< \brief stops and joins helper threads
+};
+#endif
+
+#endif /*TB2PDGVNSCOMM_HPP_*/
+
+/* Local Variables: */
+/* c-basic-offset: 4 */
+/* tab-width: 4 */
+/* indent-tabs-mode: nil */
+/* c-default-style: "k&r" */
+/* End: */
@@ -8,6 +8,9 @@
 #include "tb2rpdgvns.hpp"
 #include "core/tb2wcsp.hpp"
 #ifdef OPENMPI
+#include <mpi.h>
+#endif
+#ifdef BOOST
 
 // Conversion Tools
 // Solution to Message
@@ -104,12 +107,14 @@ void ReplicatedParallelDGVNS::MsgToSol2(
     }
 }
 //---------------- Class Definition --------------------------//
+#ifdef OPENMPI
 void timeOut()
 {
     MPI_Abort(MPI_COMM_WORLD, 0);
     //    MPI_Finalize();
     //    exit(0);
 }
+#endif
 
 bool ReplicatedParallelDGVNS::solve()
 {
@@ -127,7 +132,7 @@ bool ReplicatedParallelDGVNS::solve()
             endSolve(lastUb < MAX_COST, lastUb, true);
         }
         /* Shut down MPI */
-        MPI_Finalize();
+        pdgvnsFinalize();
         return (lastUb < MAX_COST);
     }
 
@@ -147,9 +152,11 @@ bool ReplicatedParallelDGVNS::solve()
 
     mysrand(abs(ToulBar2::seed) + env0.myrank);
 
-    MPI_Barrier(MPI_COMM_WORLD); /* IMPORTANT */
-    startTime = MPI_Wtime();
+    pdgvnsBarrier(); /* IMPORTANT */
+    startTime = pdgvnsWtime();
+#ifdef OPENMPI
     ToulBar2::timeOut = timeOut;
+#endif
 
     env0.buffsize = (int)wcsp->numberOfVariables() + 108; // 3 : cluster + k + cost, second time, msecond time, localtime,the rest is the size of solution
     env0.sendbuff = new int[env0.buffsize];
@@ -167,23 +174,21 @@ bool ReplicatedParallelDGVNS::solve()
         complete = slave();
     }
 
-    if (ToulBar2::vnsOutput)
+    if (ToulBar2::vnsOutput && env0.myrank == 0)
         ToulBar2::vnsOutput << "Search end"
                             << " " << cpuTime() << endl;
-    if (ToulBar2::vnsOutput)
+    if (ToulBar2::vnsOutput && env0.myrank == 0)
         ToulBar2::vnsOutput.close(); // close the output file
 
     /* Shut down MPI */
-    MPI_Barrier(MPI_COMM_WORLD); /* IMPORTANT */
-    double elapsedTime = MPI_Wtime() - startTime;
-    double elapsedCPUTime = cpuTime() - ToulBar2::startCpuTime;
-    double totalCPUTime = 0.;
-    MPI_Reduce(&elapsedCPUTime, &totalCPUTime, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    pdgvnsBarrier(); /* IMPORTANT */
+    double elapsedTime = pdgvnsWtime() - startTime;
+    double totalCPUTime = pdgvnsTotalCpuTime();
     if (ToulBar2::verbose >= 0 && env0.myrank == 0) { /* use time on master node */
         cout << "Total CPU time = " << totalCPUTime << " seconds" << endl;
         cout << "Solving real-time = " << elapsedTime << " seconds (not including preprocessing time)" << endl;
     }
-    MPI_Finalize();
+    pdgvnsFinalize();
 
     return (bestUb < MAX_COST);
 }
@@ -207,7 +212,7 @@ bool ReplicatedParallelDGVNS::radgvns()
     }
 
     // MPI data
-    MPI_Status status;
+    int source, tag;
 
     // verify the number of processes and number of clusters
     env0.processes = env0.ntasks - 1;
@@ -248,16 +253,16 @@ bool ReplicatedParallelDGVNS::radgvns()
             pr_p.synch = false;
             vecPR.push_back(pr_p);
             SolToMsg(env0, pr_p.cl, pr_p.k, pr_p.lds, bestUb, bestSolution);
-            MPI_Send(&env0.sendbuff[0], env0.buffsize, MPI_INT, p, WORKTAG, MPI_COMM_WORLD);
+            pdgvnsSend(&env0.sendbuff[0], env0.buffsize, p, WORKTAG);
             c = (c + 1) % file.size();
         }
     }
     Cost pbestUb = MAX_COST;
     map<int, Value> pbestSolution;
     while (npr && !complete && bestUb > ToulBar2::vnsOptimum) {
-        MPI_Recv(&env0.recvbuff[0], env0.buffsize, MPI_INT, MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &status);
-        int pindex = status.MPI_SOURCE - 1;
-        complete = (status.MPI_TAG == WORKTAG);
+        pdgvnsRecv(&env0.recvbuff[0], env0.buffsize, PDGVNS_ANY_SOURCE, source, tag);
+        int pindex = source - 1;
+        complete = (tag == WORKTAG);
         if ((vecPR[pindex].lds >= ToulBar2::vnsLDSmax || ToulBar2::restart == 1) && vecPR[pindex].k >= ToulBar2::vnsKmax)
             npr = 0;
         MsgToSol2(env0, wcsp->numberOfVariables(), pbestUb, pbestSolution);
@@ -265,15 +270,12 @@ bool ReplicatedParallelDGVNS::radgvns()
         //        if (ToulBar2::restart==1 && find(clusterKmax.begin(), clusterKmax.end(), false) == clusterKmax.end()) npr = 0;
         if (!complete && bestUb > ToulBar2::vnsOptimum) {
             SolToMsg(env0, vecPR[pindex].cl, vecPR[pindex].k, vecPR[pindex].lds, bestUb, bestSolution);
-            MPI_Send(&env0.sendbuff[0], env0.buffsize, MPI_INT, status.MPI_SOURCE, WORKTAG, MPI_COMM_WORLD);
+            pdgvnsSend(&env0.sendbuff[0], env0.buffsize, source, WORKTAG);
         }
     }
 
-    MPI_Request requests[env0.ntasks];
     for (int p = 1; p < env0.ntasks; ++p) {
-        //        MPI_Isend(0, 0, MPI_INT, p, DIETAG, MPI_COMM_WORLD);
-
-        MPI_Isend(NULL, 0, MPI_INT, p, DIETAG, MPI_COMM_WORLD, &requests[p]);
+        pdgvnsSend(NULL, 0, p, DIETAG);
     }
 
     return complete && (bestUb < MAX_COST);
@@ -297,7 +299,7 @@ bool ReplicatedParallelDGVNS::rsdgvns()
     }
 
     // MPI data
-    MPI_Status status;
+    int source, tag;
 
     // Initialization
     map<int, Value> bestInterSolution;
@@ -351,7 +353,7 @@ bool ReplicatedParallelDGVNS::rsdgvns()
 
             for (int p = 1; p < npr + 1; ++p) {
                 SolToMsg(env0, c, k, lds, bestUb, bestSolution);
-                MPI_Send(&env0.sendbuff[0], env0.buffsize, MPI_INT, p, WORKTAG, MPI_COMM_WORLD);
+                pdgvnsSend(&env0.sendbuff[0], env0.buffsize, p, WORKTAG);
                 c = (c + 1) % file.size();
             }
 
@@ -361,7 +363,7 @@ bool ReplicatedParallelDGVNS::rsdgvns()
             map<int, Value> pBestSolution;
 
             while (finished < npr) {
-                MPI_Recv(&env0.recvbuff[0], env0.buffsize, MPI_INT, MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &status);
+                pdgvnsRecv(&env0.recvbuff[0], env0.buffsize, PDGVNS_ANY_SOURCE, source, tag);
                 MsgToSol2(env0, wcsp->numberOfVariables(), pBestUb, pBestSolution);
                 if (pBestUb < bestInterUb) {
                     bestInterUb = pBestUb;
@@ -436,10 +438,8 @@ bool ReplicatedParallelDGVNS::rsdgvns()
         }
     }
 
-    MPI_Request requests[env0.ntasks];
     for (int p = 1; p < env0.ntasks; ++p) {
-        //        MPI_Isend(0, 0, MPI_INT, p, DIETAG, MPI_COMM_WORLD);
-        MPI_Isend(NULL, 0, MPI_INT, p, DIETAG, MPI_COMM_WORLD, &requests[p]);
+        pdgvnsSend(NULL, 0, p, DIETAG);
     }
 
     return complete && (bestUb < MAX_COST);
@@ -452,19 +452,18 @@ bool ReplicatedParallelDGVNS::slave()
     h->init(wcsp, this);
 
     // MPI data
-    MPI_Status status;
+    int source, tag;
 
     // loop for getting new initial solution to initialize the search process
     bool complete = false;
     while (true) {
-        MPI_Recv(&env0.recvbuff[0], env0.buffsize, MPI_INT, 0, MPI_ANY_TAG, MPI_COMM_WORLD, &status);
-        if (status.MPI_TAG == DIETAG)
+        pdgvnsRecv(&env0.recvbuff[0], env0.buffsize, 0, source, tag);
+        if (tag == DIETAG)
             return complete; // warning! always wait for DIETAG before stopping
         /* launch Vns/Lds+cp */
         complete = complete || VnsLdsCP(env0, h);
         /* Send the result back */
-        MPI_Request request;
-        MPI_Isend(&env0.sendbuff[0], env0.buffsize, MPI_INT, 0, complete, MPI_COMM_WORLD, &request);
+        pdgvnsSend(&env0.sendbuff[0], env0.buffsize, 0, complete);
     }
     return complete;
 }
@@ -684,7 +683,7 @@ void ReplicatedParallelDGVNS::DumpBestSol(bool improved)
     wcsp->setSolution(bestUb, &bestSolution);
     if (ToulBar2::vnsOutput) {
         //cout << "# ------------------------------------------" << endl;
-        ToulBar2::vnsOutput << "InstanceVnsBestTime " << MPI_Wtime() - startTime << endl;
+        ToulBar2::vnsOutput << "InstanceVnsBestTime " << pdgvnsWtime() - startTime << endl;
         ToulBar2::vnsOutput << "Cost " << std::fixed << std::setprecision(ToulBar2::decimalPoint) << wcsp->Cost2ADCost(bestUb) << std::setprecision(DECIMAL_POINT) << endl;
         ToulBar2::vnsOutput << "Solution ";
         for (map<int, Value>::iterator it = bestSolution.begin();
@@ -706,9 +705,9 @@ void ReplicatedParallelDGVNS::DumpBestSol(bool improved)
     }
     if (improved && ToulBar2::verbose >= 0) {
         if (!ToulBar2::bayesian)
-            cout << "New solution: " << std::fixed << std::setprecision(ToulBar2::decimalPoint) << wcsp->Cost2ADCost(bestUb) << std::setprecision(DECIMAL_POINT) << " in " << (MPI_Wtime() - startTime) << " seconds." << endl;
+            cout << "New solution: " << std::fixed << std::setprecision(ToulBar2::decimalPoint) << wcsp->Cost2ADCost(bestUb) << std::setprecision(DECIMAL_POINT) << " in " << (pdgvnsWtime() - startTime) << " seconds." << endl;
         else
-            cout << "New solution: " << bestUb << " energy: " << -(wcsp->Cost2LogProb(bestUb) + ToulBar2::markov_log) << " prob: " << wcsp->Cost2Prob(bestUb) * Exp(ToulBar2::markov_log) << " in " << MPI_Wtime() - startTime << " seconds." << endl;
+            cout << "New solution: " << bestUb << " energy: " << -(wcsp->Cost2LogProb(bestUb) + ToulBar2::markov_log) << " prob: " << wcsp->Cost2Prob(bestUb) * Exp(ToulBar2::markov_log) << " in " << pdgvnsWtime() - startTime << " seconds." << endl;
     }
     if (improved && ToulBar2::showSolutions) {
         wcsp->printSolution(cout);
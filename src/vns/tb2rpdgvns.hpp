@@ -8,7 +8,7 @@
 
 #ifndef TB2RPDGVNS_HPP_
 #define TB2RPDGVNS_HPP_
-#ifdef OPENMPI
+#ifdef BOOST
 
 #include "tb2cpdgvns.hpp"
 